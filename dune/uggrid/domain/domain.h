@@ -201,8 +201,32 @@ typedef struct mesh MESH;
 
 
 
+/** \brief Set the BVP used by the deprecated functions without BVP argument
+
+   The functions of the domain interface used to work on a current BVP set
+   by this function or by BVP_Init. They now get the BVP as their first
+   argument, usually MG_BVP of the multigrid, so that several multigrids and
+   threads can use the domain at the same time. The old signatures below are
+   kept for one release. They use the current BVP and are not thread-safe.
+ */
+[[deprecated("Pass the BVP to the domain functions instead")]]
 void Set_Current_BVP(BVP* theBVP);
 
+[[deprecated("Pass the BVP as first argument")]]
+INT         BNDP_SaveInsertedBndP (BNDP *theBndP, char *data, INT max_data_size);
+[[deprecated("Pass the BVP as first argument")]]
+INT         BNDP_Global           (const BNDP *theBndP, Dune::FieldVector<DOUBLE,DIM>& global);
+[[deprecated("Pass the BVP as first argument")]]
+INT         BNDP_BndPDesc         (BNDP *theBndP, INT *move);
+[[deprecated("Pass the BVP as first argument")]]
+BNDS*       BNDP_CreateBndS       (NS_PREFIX HEAP *Heap, BNDP **theBndP, INT n);
+[[deprecated("Pass the BVP as first argument")]]
+BNDP*       BNDP_CreateBndP       (NS_PREFIX HEAP *Heap, BNDP *theBndP0, BNDP *theBndP1, DOUBLE lcoord);
+[[deprecated("Pass the BVP as first argument")]]
+INT         BNDS_BndSDesc         (BNDS *theBndS, INT *id, INT *nbid);
+[[deprecated("Pass the BVP as first argument")]]
+BNDP*       BNDS_CreateBndP       (NS_PREFIX HEAP *Heap, BNDS *theBndS, const FieldVector<DOUBLE,DIM_OF_BND>& local);
+
 /****************************************************************************/
 /** \brief Initialize a BVP and return a mesh
  *
@@ -217,6 +241,7 @@ void BVP_Init (BVP theBVP, NS_PREFIX HEAP *theHeap, MESH *Mesh, INT MarkKey);
 /****************************************************************************/
 /** \brief Write command to insert this BNDP
  *
+ * @param theBVP - BVP structure
  * @param theBndP - BNDP structure
  * @param data - string to store command
  * @param max_data_size - maximal datasize to use
@@ -228,11 +253,12 @@ void BVP_Init (BVP theBVP, NS_PREFIX HEAP *theHeap, MESH *Mesh, INT MarkKey);
  *   <li> 1 if error.
  * </ul> */
 /****************************************************************************/
-INT         BNDP_SaveInsertedBndP (BNDP *theBndP, char *data, INT max_data_size);
+INT         BNDP_SaveInsertedBndP (BVP *theBVP, BNDP *theBndP, char *data, INT max_data_size);
 
 /****************************************************************************/
 /** \brief Return global coordinates of BNDP
  *
+ * @param theBVP - BVP structure
  * @param theBndP - BNDP structure
  * @param global - global coordinates
 
@@ -243,11 +269,31 @@ INT         BNDP_SaveInsertedBndP (BNDP *theBndP, char *data, INT max_data_size)
  *   <li> 1 if error. </li>
  * </ul> */
 /****************************************************************************/
-INT         BNDP_Global           (const BNDP *theBndP, Dune::FieldVector<DOUBLE,DIM>& global);
+INT         BNDP_Global           (BVP *theBVP, const BNDP *theBndP, Dune::FieldVector<DOUBLE,DIM>& global);
+
+/****************************************************************************/
+/** \brief Return global coordinates of many BNDPs
+ *
+ * @param theBVP - BVP structure
+ * @param theBndP - n BNDP structures
+ * @param n - number of BNDPs
+ * @param global - global coordinates of the n BNDPs
+
+   This function does the same as BNDP_Global for n BNDPs. Boundary
+   segments with a batch function are evaluated with one call per
+   segment for all its BNDPs.
+
+ * @return <ul>
+ *   <li> 0 if ok </li>
+ *   <li> 1 if error. </li>
+ * </ul> */
+/****************************************************************************/
+INT         BNDP_GlobalBatch      (BVP *theBVP, BNDP **theBndP, INT n, Dune::FieldVector<DOUBLE,DIM> *global);
 
 /****************************************************************************/
 /** \brief Sets descriptor for BNDP
  *
+ * @param theBVP - BVP structure
  * @param theBndP - BNDP structure
  * @param move  - movable flag (0: no, 1:yes)
 
@@ -258,7 +304,7 @@ INT         BNDP_Global           (const BNDP *theBndP, Dune::FieldVector<DOUBLE
  *   <li> 1 if error. </li>
  * </ul> */
 /****************************************************************************/
-INT         BNDP_BndPDesc         (BNDP *theBndP, INT *move);
+INT         BNDP_BndPDesc         (BVP *theBVP, BNDP *theBndP, INT *move);
 
 /****************************************************************************/
 /** \brief Sets descriptor for BNDE (boundary edge)
@@ -278,6 +324,7 @@ INT         BNDP_BndEDesc         (BNDP *theBndP0, BNDP *theBndP1);
 /****************************************************************************/
 /** \brief Creates a BNDS from a nb of BNDPs
  *
+ * @param theBVP - BVP structure
  * @param Heap  - heap to allocate from
  * @param theBndP - Pointer to list of BNDP structures
  * @param n     - Number of BNDPs
@@ -289,11 +336,13 @@ INT         BNDP_BndEDesc         (BNDP *theBndP0, BNDP *theBndP1);
  *   <li> NULL if the points describe an inner side </li>
  * </ul> */
 /****************************************************************************/
-BNDS* BNDP_CreateBndS (NS_PREFIX HEAP *Heap, BNDP **theBndP, INT n);
+BNDS* BNDP_CreateBndS (BVP *theBVP, NS_PREFIX HEAP *Heap, BNDP **theBndP, INT n);
 
 /****************************************************************************/
 /** \brief Sets BNDP from a two of BNDPs
  *
+ * @param theBVP - BVP structure
+ * @param Heap  - heap to allocate from
  * @param theBndP0 - first BNDP
  * @param theBndP1 - second BNDP
  * @param lcoord - local coordinate between P0 and P1 where the BNDP will be created
@@ -305,7 +354,7 @@ BNDS* BNDP_CreateBndS (NS_PREFIX HEAP *Heap, BNDP **theBndP, INT n);
  *   <li> NULL if the points describe an inner point </li>
  * </ul> */
 /****************************************************************************/
-BNDP*       BNDP_CreateBndP (NS_PREFIX HEAP *Heap, BNDP *theBndP0, BNDP *theBndP1, DOUBLE lcoord);
+BNDP*       BNDP_CreateBndP (BVP *theBVP, NS_PREFIX HEAP *Heap, BNDP *theBndP0, BNDP *theBndP1, DOUBLE lcoord);
 
 /****************************************************************************/
 /** \brief Dispose a BNDP
@@ -359,6 +408,7 @@ BNDP       *BNDP_LoadBndP_Ext     (void);
 /****************************************************************************/
 /** \brief Sets descriptor for BNDS
  *
+ * @param theBVP - BVP structure
  * @param theBndS - BNDS structure
  * @param id  - subdomain ID of the element with aBndS
  * @param nbid  - subdomain ID of the neighbour element (across the boundary)
@@ -371,11 +421,12 @@ BNDP       *BNDP_LoadBndP_Ext     (void);
  * </ul>
  */
 /****************************************************************************/
-INT         BNDS_BndSDesc         (BNDS *theBndS, INT *id, INT *nbid);
+INT         BNDS_BndSDesc         (BVP *theBVP, BNDS *theBndS, INT *id, INT *nbid);
 
 /****************************************************************************/
 /** \brief Create BNDP on BNDS
  *
+ * @param theBVP - BVP structure
  * @param Heap  - heap to allocate from
  * @param theBndS - BNDS structure
  * @param local - local coordinate on BNDS
@@ -387,7 +438,7 @@ INT         BNDS_BndSDesc         (BNDS *theBndS, INT *id, INT *nbid);
  *   <li> 1 if error. </li>
  * </ul> */
 /****************************************************************************/
-BNDP*       BNDS_CreateBndP       (NS_PREFIX HEAP *Heap, BNDS *theBndS, const FieldVector<DOUBLE,DIM_OF_BND>& local);
+BNDP*       BNDS_CreateBndP       (BVP *theBVP, NS_PREFIX HEAP *Heap, BNDS *theBndS, const FieldVector<DOUBLE,DIM_OF_BND>& local);
 
 /****************************************************************************/
 /** \brief Dispose BNDS
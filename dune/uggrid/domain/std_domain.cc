@@ -51,8 +51,11 @@
 #include <cmath>
 
 /* standard C++ library */
+#include <algorithm>
 /* set needed in BVP_Init */
 #include <set>
+#include <utility>
+#include <vector>
 
 #include <dune/common/fvector.hh>
 
@@ -115,7 +118,9 @@ USING_UGDIM_NAMESPACE
 /*                                                                          */
 /****************************************************************************/
 
-static STD_BVP *currBVP;
+/* BVP of the last BVP_Init or Set_Current_BVP, only used by the deprecated
+   functions without BVP argument */
+static BVP *currBVP = nullptr;
 
 
 /****************************************************************************/
@@ -125,8 +130,9 @@ static STD_BVP *currBVP;
 boundary_segment::boundary_segment(INT idA,
                                    const INT* pointsA,
                                    BndSegFuncPtr bndSegFuncA,
-                                   void *dataA)
-: id(idA), BndSegFunc(bndSegFuncA), data(dataA)
+                                   void *dataA,
+                                   BndSegBatchFuncPtr bndSegBatchFuncA)
+: id(idA), BndSegFunc(bndSegFuncA), data(dataA), BndSegBatchFunc(bndSegBatchFuncA)
 {
   for (INT i = 0; i < CORNERS_OF_BND_SEG; i++)
     points[i] = pointsA[i];
@@ -150,18 +156,19 @@ linear_segment::linear_segment(INT idA,
     points[i] = point[i];
 }
 
-UINT NS_DIM_PREFIX GetBoundarySegmentId(BNDS* boundarySegment)
+UINT NS_DIM_PREFIX GetBoundarySegmentId(BVP* theBVP, BNDS* boundarySegment)
 {
+  const STD_BVP *bvp = GetSTD_BVP(theBVP);
   const BND_PS *ps = (BND_PS*)boundarySegment;
-  const PATCH *patch = currBVP->patches[ps->patch_id];
+  const PATCH *patch = bvp->patches[ps->patch_id];
   if (patch == nullptr) {
     PrintErrorMessageF ('E', "GetBoundarySegmentId", "invalid argument");
     return 0;
   }
 
   /* The ids in the patch data structure are consecutive but they
-     start at currBVP->sideoffset instead of zero. */
-  return PATCH_ID(patch) - currBVP->sideoffset;
+     start at bvp->sideoffset instead of zero. */
+  return PATCH_ID(patch) - bvp->sideoffset;
 }
 
 static INT
@@ -204,7 +211,7 @@ GetPatchId (const PATCH * p, INT i)
 }
 
 static BNDP *
-CreateBndPOnPoint (HEAP * Heap, PATCH * p)
+CreateBndPOnPoint (HEAP * Heap, const STD_BVP * theBVP, PATCH * p)
 {
   BND_PS *ps;
   PATCH *pp;
@@ -227,7 +234,7 @@ CreateBndPOnPoint (HEAP * Heap, PATCH * p)
 
   for (j = 0; j < m; j++)
   {
-    pp = currBVP->patches[POINT_PATCH_PID (p, j)];
+    pp = theBVP->patches[POINT_PATCH_PID (p, j)];
     if (PATCH_TYPE (pp) == PARAMETRIC_PATCH_TYPE)
     {
       PRINTDEBUG (dom, 1, ("cp r %f %f %f %f\n",
@@ -314,7 +321,7 @@ CreateCornerPoints (HEAP * Heap, STD_BVP * theBVP, BNDP ** bndp)
 
   for (i = 0; i < theBVP->ncorners; i++)
   {
-    bndp[i] = CreateBndPOnPoint (Heap, theBVP->patches[i]);
+    bndp[i] = CreateBndPOnPoint (Heap, theBVP, theBVP->patches[i]);
     if (bndp[i] == NULL)
       REP_ERR_RETURN (1);
   }
@@ -440,7 +447,7 @@ BVP_Init (STD_BVP* theBVP, HEAP * Heap, MESH * Mesh, INT MarkKey)
 #       endif
 
   assert(theBVP);
-  currBVP = theBVP;
+  currBVP = (BVP*)theBVP;
 
   auto& theDomain = theBVP->Domain;
   assert(theDomain);
@@ -475,6 +482,7 @@ BVP_Init (STD_BVP* theBVP, HEAP * Heap, MESH * Mesh, INT MarkKey)
     }
     PARAM_PATCH_BS (thePatch) = theSegment.BndSegFunc;
     PARAM_PATCH_BSD (thePatch) = theSegment.data;
+    PARAM_PATCH_BBS (thePatch) = theSegment.BndSegBatchFunc;
     sides[theSegment.id] = thePatch;
     PRINTDEBUG (dom, 1, ("sides id %d type %d left %d right %d\n",
                          PATCH_ID (thePatch), PATCH_TYPE (thePatch),
@@ -737,7 +745,70 @@ NS_DIM_PREFIX std_BoundaryValueProblem::~std_BoundaryValueProblem()
 void NS_DIM_PREFIX
 Set_Current_BVP(BVP* theBVP)
 {
-  currBVP = (STD_BVP*)theBVP;
+  currBVP = theBVP;
+}
+
+/* deprecated functions without BVP argument, they use currBVP */
+
+UINT NS_DIM_PREFIX GetBoundarySegmentId(BNDS* boundarySegment)
+{
+  return GetBoundarySegmentId(currBVP, boundarySegment);
+}
+
+INT NS_DIM_PREFIX
+BNDS_BndSDesc (BNDS * theBndS, INT * id, INT * nbid)
+{
+  return BNDS_BndSDesc(currBVP, theBndS, id, nbid);
+}
+
+BNDP *NS_DIM_PREFIX
+BNDS_CreateBndP (HEAP * Heap, BNDS * aBndS, const FieldVector<DOUBLE,DIM_OF_BND>& local)
+{
+  return BNDS_CreateBndP(currBVP, Heap, aBndS, local);
+}
+
+INT NS_DIM_PREFIX
+BNDP_Global (const BNDP * aBndP, FieldVector<DOUBLE,DIM>& global)
+{
+  return BNDP_Global(currBVP, aBndP, global);
+}
+
+INT NS_DIM_PREFIX
+BNDP_BndPDesc (BNDP * theBndP, INT * move)
+{
+  return BNDP_BndPDesc(currBVP, theBndP, move);
+}
+
+BNDS *NS_DIM_PREFIX
+BNDP_CreateBndS (HEAP * Heap, BNDP ** aBndP, INT n)
+{
+  return BNDP_CreateBndS(currBVP, Heap, aBndP, n);
+}
+
+BNDP *NS_DIM_PREFIX
+BNDP_CreateBndP (HEAP * Heap, BNDP * aBndP0, BNDP * aBndP1, DOUBLE lcoord)
+{
+  return BNDP_CreateBndP(currBVP, Heap, aBndP0, aBndP1, lcoord);
+}
+
+INT NS_DIM_PREFIX
+BNDP_SaveInsertedBndP (BNDP * theBndP, char *data, INT max_data_size)
+{
+  return BNDP_SaveInsertedBndP(currBVP, theBndP, data, max_data_size);
+}
+
+/* declared in gm.h, but it needs currBVP as well */
+INT NS_DIM_PREFIX InnerBoundary (ELEMENT *t, INT side)
+{
+  INT left,right;
+
+  ASSERT(OBJT(t) == BEOBJ);
+  ASSERT(SIDE_ON_BND(t,side));
+
+  if (BNDS_BndSDesc(currBVP,ELEM_BNDS(t,side),&left,&right))
+    return(0);
+
+  return((left != 0) && (right != 0));
 }
 
 static INT
@@ -780,7 +851,7 @@ GetCommonPatchId (const PATCH * p0, const PATCH * p1, INT k)
 }
 
 static INT
-GetCommonLinePatchId (PATCH * p0, PATCH * p1)
+GetCommonLinePatchId (const STD_BVP * theBVP, PATCH * p0, PATCH * p1)
 {
   INT i, k, l, cnt, cnt1;
 
@@ -794,9 +865,9 @@ GetCommonLinePatchId (PATCH * p0, PATCH * p1)
   if (cnt < 1)
     return (-1);
 
-  for (k = currBVP->ncorners; k < currBVP->sideoffset; k++)
+  for (k = theBVP->ncorners; k < theBVP->sideoffset; k++)
   {
-    PATCH *p = currBVP->patches[k];
+    PATCH *p = theBVP->patches[k];
     if (LINE_PATCH_N (p) != cnt)
       continue;
     cnt1 = 0;
@@ -861,9 +932,9 @@ PatchGlobal (const PATCH * p, DOUBLE * lambda, Dune::FieldVector<DOUBLE,DIM>& gl
 }
 
 static INT
-local2lambda (BND_PS * ps, const Dune::FieldVector<DOUBLE,DIM_OF_BND>& local, DOUBLE lambda[])
+local2lambda (const STD_BVP * theBVP, BND_PS * ps, const Dune::FieldVector<DOUBLE,DIM_OF_BND>& local, DOUBLE lambda[])
 {
-  const PATCH *p = currBVP->patches[ps->patch_id];
+  const PATCH *p = theBVP->patches[ps->patch_id];
 
   if ((PATCH_TYPE (p) == PARAMETRIC_PATCH_TYPE)
       || (PATCH_TYPE (p) == LINEAR_PATCH_TYPE))
@@ -929,14 +1000,15 @@ SideIsCooriented (BND_PS * ps)
 
 /* domain interface function: for description see domain.h */
 INT NS_DIM_PREFIX
-BNDS_BndSDesc (BNDS * theBndS, INT * id, INT * nbid)
+BNDS_BndSDesc (BVP * theBVP, BNDS * theBndS, INT * id, INT * nbid)
 {
+  const STD_BVP *bvp = GetSTD_BVP (theBVP);
   BND_PS *ps;
   PATCH *p;
   INT left, right;
 
   ps = (BND_PS *) theBndS;
-  p = currBVP->patches[ps->patch_id];
+  p = bvp->patches[ps->patch_id];
 
   if (PATCH_TYPE (p) == PARAMETRIC_PATCH_TYPE)
   {
@@ -970,7 +1042,7 @@ BNDS_BndSDesc (BNDS * theBndS, INT * id, INT * nbid)
 
 /* domain interface function: for description see domain.h */
 BNDP *NS_DIM_PREFIX
-BNDS_CreateBndP (HEAP * Heap, BNDS * aBndS, const FieldVector<DOUBLE,DIM_OF_BND>& local)
+BNDS_CreateBndP (BVP * theBVP, HEAP * Heap, BNDS * aBndS, const FieldVector<DOUBLE,DIM_OF_BND>& local)
 {
   BND_PS *ps, *pp;
 
@@ -986,7 +1058,7 @@ BNDS_CreateBndP (HEAP * Heap, BNDS * aBndS, const FieldVector<DOUBLE,DIM_OF_BND>
   pp->patch_id = ps->patch_id;
   pp->n = 1;
 
-  if (local2lambda (ps, local, pp->local[0]))
+  if (local2lambda (GetSTD_BVP (theBVP), ps, local, pp->local[0]))
     return (NULL);
 
   PRINTDEBUG (dom, 1, (" BNDP s %d\n", pp->patch_id));
@@ -1004,16 +1076,17 @@ BNDS_CreateBndP (HEAP * Heap, BNDS * aBndS, const FieldVector<DOUBLE,DIM_OF_BND>
 
 /* domain interface function: for description see domain.h */
 INT NS_DIM_PREFIX
-BNDP_Global (const BNDP * aBndP, FieldVector<DOUBLE,DIM>& global)
+BNDP_Global (BVP * theBVP, const BNDP * aBndP, FieldVector<DOUBLE,DIM>& global)
 {
   using std::abs;
+  const STD_BVP *bvp = GetSTD_BVP (theBVP);
   BND_PS *ps;
   PATCH *p, *s;
   INT j, k;
   FieldVector<DOUBLE,DIM> pglobal;
 
   ps = (BND_PS *) aBndP;
-  p = currBVP->patches[ps->patch_id];
+  p = bvp->patches[ps->patch_id];
 
   PRINTDEBUG (dom, 1, (" bndp pid %d %d %d\n", ps->patch_id,
                        PATCH_ID (p), PATCH_TYPE (p)));
@@ -1025,7 +1098,7 @@ BNDP_Global (const BNDP * aBndP, FieldVector<DOUBLE,DIM>& global)
     return (PatchGlobal (p, ps->local[0], global));
   case POINT_PATCH_TYPE :
 
-    s = currBVP->patches[POINT_PATCH_PID (p, 0)];
+    s = bvp->patches[POINT_PATCH_PID (p, 0)];
 
     PRINTDEBUG (dom, 1, (" bndp n %d %d loc %f %f gl \n",
                          POINT_PATCH_N (p),
@@ -1036,7 +1109,7 @@ BNDP_Global (const BNDP * aBndP, FieldVector<DOUBLE,DIM>& global)
 
     for (j = 1; j < POINT_PATCH_N (p); j++)
     {
-      s = currBVP->patches[POINT_PATCH_PID (p, j)];
+      s = bvp->patches[POINT_PATCH_PID (p, j)];
 
       if (PatchGlobal(s, ps->local[j], pglobal))
         REP_ERR_RETURN (1);
@@ -1054,7 +1127,7 @@ BNDP_Global (const BNDP * aBndP, FieldVector<DOUBLE,DIM>& global)
     return (0);
 #ifdef UG_DIM_3
   case LINE_PATCH_TYPE :
-    s = currBVP->patches[LINE_PATCH_PID (p, 0)];
+    s = bvp->patches[LINE_PATCH_PID (p, 0)];
 
     if (PatchGlobal(s, ps->local[0], global))
       REP_ERR_RETURN (1);
@@ -1066,7 +1139,7 @@ BNDP_Global (const BNDP * aBndP, FieldVector<DOUBLE,DIM>& global)
                          ps->local[0][1], global[0], global[1], global[2]));
     for (j = 1; j < LINE_PATCH_N (p); j++)
     {
-      s = currBVP->patches[LINE_PATCH_PID (p, j)];
+      s = bvp->patches[LINE_PATCH_PID (p, j)];
 
       if (PatchGlobal(s, ps->local[j], pglobal))
         REP_ERR_RETURN (1);
@@ -1089,13 +1162,60 @@ BNDP_Global (const BNDP * aBndP, FieldVector<DOUBLE,DIM>& global)
 
 /* domain interface function: for description see domain.h */
 INT NS_DIM_PREFIX
-BNDP_BndPDesc (BNDP * theBndP, INT * move)
+BNDP_GlobalBatch (BVP * theBVP, BNDP ** theBndP, INT n, FieldVector<DOUBLE,DIM> * global)
+{
+  const STD_BVP *bvp = GetSTD_BVP (theBVP);
+  /* (patch, index) of the points on patches with a batch function */
+  std::vector<std::pair<INT,INT> > batched;
+  std::vector<DOUBLE> lambda;
+  std::vector<FieldVector<DOUBLE,DIM> > result;
+
+  for (INT i = 0; i < n; i++)
+  {
+    const BND_PS *ps = (BND_PS *) theBndP[i];
+    const PATCH *p = bvp->patches[ps->patch_id];
+
+    if (PATCH_TYPE (p) == PARAMETRIC_PATCH_TYPE && PARAM_PATCH_BBS (p) != NULL)
+      batched.emplace_back (ps->patch_id, i);
+    else if (BNDP_Global (theBVP, theBndP[i], global[i]))
+      REP_ERR_RETURN (1);
+  }
+  std::sort (batched.begin (), batched.end ());
+
+  /* one call per patch */
+  std::size_t last;
+  for (std::size_t first = 0; first < batched.size (); first = last)
+  {
+    const PATCH *p = bvp->patches[batched[first].first];
+
+    lambda.clear ();
+    for (last = first; last < batched.size ()
+         && batched[last].first == batched[first].first; last++)
+    {
+      const BND_PS *ps = (BND_PS *) theBndP[batched[last].second];
+      lambda.insert (lambda.end (), ps->local[0], ps->local[0] + DIM_OF_BND);
+    }
+    result.resize (last - first);
+
+    if ((*PARAM_PATCH_BBS (p))(PARAM_PATCH_BSD (p), last - first,
+                               lambda.data (), result.data ()))
+      REP_ERR_RETURN (1);
+    for (std::size_t k = first; k < last; k++)
+      global[batched[k].second] = result[k - first];
+  }
+
+  return (0);
+}
+
+/* domain interface function: for description see domain.h */
+INT NS_DIM_PREFIX
+BNDP_BndPDesc (BVP * theBVP, BNDP * theBndP, INT * move)
 {
   BND_PS *ps;
   PATCH *p;
 
   ps = (BND_PS *) theBndP;
-  p = STD_BVP_PATCH (currBVP, ps->patch_id);
+  p = STD_BVP_PATCH (GetSTD_BVP (theBVP), ps->patch_id);
 
   switch (PATCH_TYPE (p))
   {
@@ -1133,8 +1253,9 @@ BNDP_BndEDesc (BNDP * aBndP0, BNDP * aBndP1)
 
 /* domain interface function: for description see domain.h */
 BNDS *NS_DIM_PREFIX
-BNDP_CreateBndS (HEAP * Heap, BNDP ** aBndP, INT n)
+BNDP_CreateBndS (BVP * theBVP, HEAP * Heap, BNDP ** aBndP, INT n)
 {
+  const STD_BVP *bvp = GetSTD_BVP (theBVP);
   BND_PS *bp[4], *bs;
   PATCH *p[4];
   DOUBLE *lambda[4];
@@ -1147,7 +1268,7 @@ BNDP_CreateBndS (HEAP * Heap, BNDP ** aBndP, INT n)
   for (i = 0; i < n; i++)
   {
     bp[i] = (BND_PS *) aBndP[i];
-    p[i] = currBVP->patches[bp[i]->patch_id];
+    p[i] = bvp->patches[bp[i]->patch_id];
 
     PRINTDEBUG (dom, 1, (" bp %d p %d n %d\n",
                          bp[i]->patch_id, PATCH_ID (p[i]), n));
@@ -1236,8 +1357,9 @@ BNDP_CreateBndS (HEAP * Heap, BNDP ** aBndP, INT n)
 
 /* domain interface function: for description see domain.h */
 BNDP *NS_DIM_PREFIX
-BNDP_CreateBndP (HEAP * Heap, BNDP * aBndP0, BNDP * aBndP1, DOUBLE lcoord)
+BNDP_CreateBndP (BVP * theBVP, HEAP * Heap, BNDP * aBndP0, BNDP * aBndP1, DOUBLE lcoord)
 {
+  const STD_BVP *bvp = GetSTD_BVP (theBVP);
   BND_PS *bp0, *bp1, *bp;
   PATCH *p0, *p1;
   INT i, j, k, l, cnt;
@@ -1248,8 +1370,8 @@ BNDP_CreateBndP (HEAP * Heap, BNDP * aBndP0, BNDP * aBndP1, DOUBLE lcoord)
   if ((bp0 == NULL) || (bp1 == NULL))
     return (NULL);
 
-  p0 = currBVP->patches[bp0->patch_id];
-  p1 = currBVP->patches[bp1->patch_id];
+  p0 = bvp->patches[bp0->patch_id];
+  p1 = bvp->patches[bp1->patch_id];
 
   PRINTDEBUG (dom, 1, ("   bp0 %d pid %d\n", bp0->patch_id, PATCH_ID (p0)));
   for (l = 0; l < GetNumberOfPatches (p0); l++)
@@ -1274,10 +1396,10 @@ BNDP_CreateBndP (HEAP * Heap, BNDP * aBndP0, BNDP * aBndP1, DOUBLE lcoord)
   if (cnt > 1)
   {
     PATCH *p;
-    k = GetCommonLinePatchId (p0, p1);
-    if ((k < currBVP->ncorners) || (k >= currBVP->sideoffset))
+    k = GetCommonLinePatchId (bvp, p0, p1);
+    if ((k < bvp->ncorners) || (k >= bvp->sideoffset))
       return (NULL);
-    p = currBVP->patches[k];
+    p = bvp->patches[k];
     bp->patch_id = k;
 
     PRINTDEBUG (dom, 1, (" Create BNDP line %d cnt %d\n", k, cnt));
@@ -1329,8 +1451,9 @@ BNDP_CreateBndP (HEAP * Heap, BNDP * aBndP0, BNDP * aBndP1, DOUBLE lcoord)
 
 /* domain interface function: for description see domain.h */
 INT NS_DIM_PREFIX
-BNDP_SaveInsertedBndP (BNDP * theBndP, char *data, INT max_data_size)
+BNDP_SaveInsertedBndP (BVP * theBVP, BNDP * theBndP, char *data, INT max_data_size)
 {
+  const STD_BVP *bvp = GetSTD_BVP (theBVP);
   BND_PS *bp;
   PATCH *p;
   INT pid;
@@ -1341,20 +1464,20 @@ BNDP_SaveInsertedBndP (BNDP * theBndP, char *data, INT max_data_size)
     return (1);
 
   pid = bp->patch_id;
-  p = currBVP->patches[pid];
+  p = bvp->patches[pid];
 
   switch (PATCH_TYPE (p))
   {
   case PARAMETRIC_PATCH_TYPE :
   case LINEAR_PATCH_TYPE :
-    pid -= currBVP->sideoffset;
+    pid -= bvp->sideoffset;
     break;
   case POINT_PATCH_TYPE :
-    pid = POINT_PATCH_PID (p, 0) - currBVP->sideoffset;
+    pid = POINT_PATCH_PID (p, 0) - bvp->sideoffset;
     break;
 #ifdef UG_DIM_3
   case LINE_PATCH_TYPE :
-    pid = LINE_PATCH_PID (p, 0) - currBVP->sideoffset;
+    pid = LINE_PATCH_PID (p, 0) - bvp->sideoffset;
     break;
 #endif
   }
@@ -68,6 +68,17 @@ START_UGDIM_NAMESPACE
  */
 typedef INT (*BndSegFuncPtr)(void *,DOUBLE *, FieldVector<DOUBLE,DIM>&);
 
+/** \brief Data type of the functions mapping many parameters to world space at once
+ *
+ * The first argument is the user data pointer from the corresponding
+ * BOUNDARY_SEGMENT, the second one the number n of points. The third
+ * parameter provides n times DIM_OF_BND parameters, one point after the
+ * other, and the results are placed in the n entries of the fourth one.
+ * The function has to give the same results as the BndSegFunc of the
+ * segment, and returns 0 if ok.
+ */
+typedef INT (*BndSegBatchFuncPtr)(void *, INT, const DOUBLE *, FieldVector<DOUBLE,DIM> *);
+
 
 /** \brief Data structure defining part of the boundary of a domain
 
@@ -93,11 +104,13 @@ struct boundary_segment
    * @param  point - the endpoints of the boundary segment
    * @param  BndSegFunc - function mapping parameters
    * @param  data - user defined space
+   * @param  BndSegBatchFunc - function mapping many parameters at once, optional
    */
   boundary_segment(INT id,
                    const INT* point,
                    BndSegFuncPtr BndSegFunc,
-                   void *data);
+                   void *data,
+                   BndSegBatchFuncPtr BndSegBatchFunc = nullptr);
 
   /** \brief Number of the boundary segment beginning with zero */
   INT id;
@@ -120,6 +133,14 @@ struct boundary_segment
    * e.g. from a CAD system.
    */
   void *data;
+
+  /** \brief Pointer to a function mapping many parameters at once, or nullptr
+   *
+   * The boundary points created by the refinement of a grid level are
+   * mapped with one call per segment, see BNDP_GlobalBatch. Segments
+   * without this function are evaluated point by point with BndSegFunc.
+   */
+  BndSegBatchFuncPtr BndSegBatchFunc;
 };
 
 
@@ -232,6 +253,7 @@ enum PatchType {POINT_PATCH_TYPE,
 #define PARAM_PATCH_RANGE(p)    (p)->pa.range
 #define PARAM_PATCH_BS(p)       (p)->pa.BndSegFunc
 #define PARAM_PATCH_BSD(p)      (p)->pa.bs_data
+#define PARAM_PATCH_BBS(p)      (p)->pa.BndSegBatchFunc
 #define LINEAR_PATCH_LEFT(p)    (p)->lp.left
 #define LINEAR_PATCH_RIGHT(p)   (p)->lp.right
 #define LINEAR_PATCH_N(p)       (p)->lp.corners
@@ -418,6 +440,9 @@ struct parameter_patch {
   /** \brief Can be used by applic to find data */
   void *bs_data;
 
+  /** \brief Pointer to the definition function for many points, or nullptr */
+  BndSegBatchFuncPtr BndSegBatchFunc;
+
   /*@}*/
 };
 
@@ -474,6 +499,10 @@ typedef struct bnd_ps BND_PS;
 /* --- public functions --- */
 
 /** \brief Access the id of the segment (used by DUNE) */
+UINT GetBoundarySegmentId(BVP* theBVP, BNDS* boundarySegment);
+
+/** \brief Access the id of the segment of the current BVP, see Set_Current_BVP */
+[[deprecated("Pass the BVP as first argument")]]
 UINT GetBoundarySegmentId(BNDS* boundarySegment);
 
 END_UGDIM_NAMESPACE
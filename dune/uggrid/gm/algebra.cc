@@ -186,6 +186,8 @@ INT NS_DIM_PREFIX DisposeVector (GRID *theGrid, VECTOR *theVector)
 
   /* now remove vector from vector list */
   GRID_UNLINK_VECTOR(theGrid,theVector);
+  if (FINE_GRID_DOF(theVector))
+    theGrid->nFineGridDof--;
 
   /* reset count flags */
   SETVCOUNT(theVector,0);
@@ -415,10 +417,14 @@ INT NS_DIM_PREFIX SetSurfaceClasses (MULTIGRID *theMG)
   for (level=TOPLEVEL(theMG); level>=0; level--)
   {
     theGrid = GRID_ON_LEVEL(theMG,level);
+    theGrid->nFineGridDof = 0;
     for (v=PFIRSTVECTOR(theGrid); v!= NULL; v=SUCCVC(v)) {
       SETFINE_GRID_DOF(v,((VCLASS(v)>=2)&&(VNCLASS(v)<=1)));
       if (FINE_GRID_DOF(v))
+      {
+        theGrid->nFineGridDof++;
         fullrefine = level;
+      }
     }
   }
         #ifdef ModelP
@@ -430,6 +436,78 @@ INT NS_DIM_PREFIX SetSurfaceClasses (MULTIGRID *theMG)
   return(0);
 }
 
+/****************************************************************************/
+/** \brief Update the vector classes around some elements
+
+ * @param theMG - pointer to multigrid
+ * @param elements - elements whose node classes or refinement have changed
+
+   This function does the same as SetSurfaceClasses for the side vectors
+   of the given elements only, which must include all new elements. The
+   top level must not have changed since the last SetSurfaceClasses.
+   The FULLREFINELEVEL is computed from the number of fine grid dofs of
+   each level.
+
+ * @return <ul>
+ *   <li>    0 if ok </li>
+ *   <li>    1 if error occurred. </li>
+   </ul>
+ */
+/****************************************************************************/
+
+INT NS_DIM_PREFIX UpdateSurfaceClasses (MULTIGRID *theMG, const std::vector<ELEMENT*>& elements)
+{
+  const INT toplevel = TOPLEVEL(theMG);
+
+        #ifdef UG_DIM_3
+  for (ELEMENT *theElement : elements)
+  {
+    GRID *theGrid = GRID_ON_LEVEL(theMG,LEVEL(theElement));
+    if (!VEC_DEF_IN_OBJ_OF_GRID(theGrid,SIDEVEC))
+      continue;
+
+    for (INT i=0; i<SIDES_OF_ELEM(theElement); i++)
+    {
+      VECTOR *v = SVECTOR(theElement,i);
+      if (v == NULL) continue;
+
+      /* the classes of a side vector are seeded by both its elements */
+      INT seed = MinNodeClass(theElement);
+      INT nextSeed = MinNextNodeClass(theElement);
+      ELEMENT *theNeighbor = NBELEM(theElement,i);
+      if (theNeighbor != NULL)
+        for (INT j=0; j<SIDES_OF_ELEM(theNeighbor); j++)
+          if (SVECTOR(theNeighbor,j) == v)
+          {
+            seed = std::max(seed,MinNodeClass(theNeighbor));
+            nextSeed = std::max(nextSeed,MinNextNodeClass(theNeighbor));
+            break;
+          }
+
+      if (toplevel > 0)
+      {
+        if (LEVEL(theElement) > 0)
+          SETVCLASS(v,(seed==3) ? 3 : 0);
+        if ((INT)LEVEL(theElement) < toplevel)
+          SETVNCLASS(v,(nextSeed==3) ? 3 : 0);
+      }
+
+      const INT fine = ((VCLASS(v)>=2)&&(VNCLASS(v)<=1));
+      theGrid->nFineGridDof += fine - (INT)FINE_GRID_DOF(v);
+      SETFINE_GRID_DOF(v,fine);
+    }
+  }
+        #endif
+
+  INT fullrefine = toplevel;
+  for (INT level=toplevel; level>=0; level--)
+    if (GRID_ON_LEVEL(theMG,level)->nFineGridDof > 0)
+      fullrefine = level;
+  FULLREFINELEVEL(theMG) = fullrefine;
+
+  return(0);
+}
+
 /****************************************************************************/
 /** \brief Creates the algebra for a grid
 
@@ -551,8 +629,9 @@ INT NS_DIM_PREFIX CreateAlgebra (MULTIGRID *theMG)
     MG_COARSE_FIXED(theMG) = true;
   }
 
-  /* now we should be safe to clear the InsertElement face map */
-  theMG->facemap.clear();
+  /* now we should be safe to clear the InsertElement face map,
+     and to release its buckets too */
+  decltype(theMG->facemap)().swap(theMG->facemap);
 
     #ifdef ModelP
   /* update VNEW-flags */
@@ -86,6 +86,7 @@ INT             GetElementInfoFromSideVector    (const VECTOR *theVector, ELEMEN
 /** @name Gridwise functions */
 /*@{*/
 INT             SetSurfaceClasses                               (MULTIGRID *theMG);
+INT             UpdateSurfaceClasses                    (MULTIGRID *theMG, const std::vector<ELEMENT*>& elements);
 INT         CreateAlgebra                               (MULTIGRID *theMG);
 /*@}*/
 
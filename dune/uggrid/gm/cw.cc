@@ -133,21 +133,23 @@ CONTROL_ENTRY NS_DIM_PREFIX control_entries[MAX_CONTROL_ENTRIES];
 // The order of the entries here has to match the GM_CW enumeration in gm.h
 
 constexpr INT MAX_CONTROL_WORDS = GM_N_CW;
-static CONTROL_WORD control_words[MAX_CONTROL_WORDS] = {
-  {VECTOR_OFFSET,               CW_VEOBJ,   0b0},
-  {VERTEX_OFFSET,               CW_VXOBJS,  0b0},
-  {NODE_OFFSET,                 CW_NDOBJ,   0b0},
-  {LINK_OFFSET,                 CW_EDOBJ,   0b0},
-  {EDGE_OFFSET,                 CW_EDOBJ,   0b0},
-  {ELEMENT_OFFSET,              CW_ELOBJS,  0b0},
-  {FLAG_OFFSET,                 CW_ELOBJS,  0b0},
-  {PROPERTY_OFFSET,             CW_ELOBJS,  0b0},
-  {GRID_OFFSET,                 CW_GROBJ,   0b0},
-  {GRID_STATUS_OFFSET,          CW_GROBJ,   0b0},
-  {MULTIGRID_STATUS_OFFSET,     CW_MGOBJ,   0b0}
+static constexpr CONTROL_WORD_PREDEF cw_predefines[MAX_CONTROL_WORDS] = {
+  {VECTOR_CW,                   VECTOR_OFFSET,               CW_VEOBJ},
+  {VERTEX_CW,                   VERTEX_OFFSET,               CW_VXOBJS},
+  {NODE_CW,                     NODE_OFFSET,                 CW_NDOBJ},
+  {LINK_CW,                     LINK_OFFSET,                 CW_EDOBJ},
+  {EDGE_CW,                     EDGE_OFFSET,                 CW_EDOBJ},
+  {ELEMENT_CW,                  ELEMENT_OFFSET,              CW_ELOBJS},
+  {FLAG_CW,                     FLAG_OFFSET,                 CW_ELOBJS},
+  {PROPERTY_CW,                 PROPERTY_OFFSET,             CW_ELOBJS},
+  {GRID_CW,                     GRID_OFFSET,                 CW_GROBJ},
+  {GRID_STATUS_CW,              GRID_STATUS_OFFSET,          CW_GROBJ},
+  {MULTIGRID_STATUS_CW,         MULTIGRID_STATUS_OFFSET,     CW_MGOBJ}
 };
 
-static CONTROL_ENTRY_PREDEF ce_predefines[MAX_CONTROL_ENTRIES] = {
+static CONTROL_WORD control_words[MAX_CONTROL_WORDS];
+
+static constexpr CONTROL_ENTRY_PREDEF ce_predefines[MAX_CONTROL_ENTRIES] = {
   CE_INIT(CE_LOCKED,      VECTOR_,                VOTYPE_,                CW_VEOBJ),
   CE_INIT(CE_LOCKED,      VECTOR_,                VCOUNT_,                CW_VEOBJ),
   CE_INIT(CE_LOCKED,      VECTOR_,                VECTORSIDE_,    CW_VEOBJ),
@@ -209,11 +211,82 @@ static CONTROL_ENTRY_PREDEF ce_predefines[MAX_CONTROL_ENTRIES] = {
         #endif /* ModelP */
 };
 
+/* the accessor macros of gm.h use the layout of the predefines at compile
+   time (CW_READ_STATIC), so check it here rather than in InitCW */
+static constexpr bool PredefinedControlEntriesFit ()
+{
+  for (INT i=0; i<MAX_CONTROL_WORDS; i++)
+    if (cw_predefines[i].control_word_id!=i)
+      return false;
+
+  for (INT i=0; i<MAX_CONTROL_ENTRIES; i++)
+  {
+    const CONTROL_ENTRY_PREDEF& ce = ce_predefines[i];
+    if (!ce.used)
+      continue;
+    if (ce.length<=0 || ce.offset_in_word<0 || ce.offset_in_word+ce.length>32)
+      return false;
+    if (!(ce.objt_used & cw_predefines[ce.control_word].objt_used))
+      return false;
+  }
+
+  return true;
+}
+
+static constexpr UINT PredefinedMask (const CONTROL_ENTRY_PREDEF& ce)
+{
+  return (~UINT(0) >> (32-ce.length)) << ce.offset_in_word;
+}
+
+/* pairs of predefined entries that share bits on purpose */
+static constexpr INT shared_bits[][2] = {
+  {ONSIDE_CE,       ONEDGE_CE},           /* alternatives, see gm.h */
+  {ONNBSIDE_CE,     ONEDGE_CE},
+  {SIDEPATTERN_CE,  MARK_CE},
+#ifdef ModelP
+  {XFERVECTOR_CE,   FINE_GRID_DOF_CE},
+#endif
+};
+
+static constexpr bool SharedBits (INT a, INT b)
+{
+  for (const auto& pair : shared_bits)
+    if ((pair[0]==a && pair[1]==b) || (pair[0]==b && pair[1]==a))
+      return true;
+
+  return false;
+}
+
+/* no two predefined entries share a bit of a control word of an object */
+static constexpr bool PredefinedControlEntriesDisjoint ()
+{
+  for (INT i=0; i<MAX_CONTROL_ENTRIES; i++)
+    for (INT j=0; j<i; j++)
+    {
+      const CONTROL_ENTRY_PREDEF& a = ce_predefines[i];
+      const CONTROL_ENTRY_PREDEF& b = ce_predefines[j];
+      if (!a.used || !b.used || !(a.objt_used & b.objt_used))
+        continue;
+      if (SharedBits(a.control_entry_id,b.control_entry_id))
+        continue;
+      if (cw_predefines[a.control_word].offset_in_object!=cw_predefines[b.control_word].offset_in_object)
+        continue;
+      if (PredefinedMask(a) & PredefinedMask(b))
+        return false;
+    }
+
+  return true;
+}
+
+static_assert(PredefinedControlEntriesFit(), "predefined control entry does not fit its control word");
+static_assert(PredefinedControlEntriesDisjoint(), "predefined control entries overlap");
+
 /****************************************************************************/
 /** \brief Initialize control word entries
 
-   This function initializes the predefined control word entries. Predefined
-   entries are not checked for overlap.
+   This function initializes the predefined control words and control word
+   entries. Overlapping predefined entries are rejected at compile time,
+   except for the pairs listed in shared_bits.
 
  * @return <ul>
  * <li> GM_OK if ok </li>
@@ -226,11 +299,17 @@ static INT InitPredefinedControlEntries (void)
 {
   CONTROL_ENTRY *ce,*test_ce;
   CONTROL_WORD *cw;
-  CONTROL_ENTRY_PREDEF *pce,*test_pce;
+  const CONTROL_ENTRY_PREDEF *pce,*test_pce;
   INT i,j,k,mask,error,nused;
 
   /* clear everything */
   memset(control_entries,0,MAX_CONTROL_ENTRIES*sizeof(CONTROL_ENTRY));
+  for (i=0; i<MAX_CONTROL_WORDS; i++)
+  {
+    control_words[i].offset_in_object = cw_predefines[i].offset_in_object;
+    control_words[i].objt_used = cw_predefines[i].objt_used;
+    control_words[i].used_mask = 0;
+  }
 
   error = 0;
   nused = 0;
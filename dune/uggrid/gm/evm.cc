@@ -31,6 +31,7 @@
 /****************************************************************************/
 
 #include <config.h>
+#include <algorithm>
 #include <cmath>
 #include <cassert>
 #include <cstdlib>
@@ -382,3 +383,516 @@ DOUBLE NS_DIM_PREFIX ElementVolume (const ELEMENT *elem)
 
   return (GeneralElementVolume(TAG(elem),x_co));
 }
+
+/* the volume from the geometry cache of theGrid if the element has an
+   entry there, see SetGeometryCache */
+DOUBLE NS_DIM_PREFIX ElementVolume (const GRID *theGrid, const ELEMENT *elem)
+{
+  const INT k = GeometryCacheSlot(theGrid,elem);
+  if (k<0)
+    return ElementVolume(elem);
+
+  return theGrid->geometryCache->volume[k];
+}
+
+/****************************************************************************/
+/****************************************************************************/
+/****************************************************************************/
+/****																	 ****/
+/****		batched routines                                                                                 ****/
+/****																	 ****/
+/****************************************************************************/
+/****************************************************************************/
+/****************************************************************************/
+
+/* The following functions treat n elements of one tag at once. The corner
+   coordinates are given in structure of arrays layout: x[DIM*i+d][e] is
+   coordinate d of corner i of element e. The elements are treated in blocks
+   of BATCH_BLOCK whose results are collected in local arrays first. These
+   cannot overlap the arguments, so the compiler can vectorize the loops
+   over the elements of a block. The arithmetic is the same as in the
+   functions for a single element. */
+
+#define BATCH_BLOCK 64
+
+/* corner i of element e */
+static inline void BatchCorner (const DOUBLE *const x[], INT i, INT e, DOUBLE c[DIM])
+{
+  for (INT d=0; d<DIM; d++)
+    c[d] = x[DIM*i+d][e];
+}
+
+/****************************************************************************/
+/*D
+   GatherCornerCoordinates - Copy corner coordinates of elements into a batch
+
+   SYNOPSIS:
+   INT GatherCornerCoordinates (INT n, const ELEMENT *const elem[], DOUBLE *const x[]);
+
+   PARAMETERS:
+   .  n - number of elements
+   .  elem - elements, all of the same tag
+   .  x - DIM*CORNERS_OF_TAG arrays of n entries each
+
+   DESCRIPTION:
+   This function fills x[DIM*i+d][e] with coordinate d of corner i of elem[e].
+
+   RETURN VALUE:
+   INT
+   .n    0 when ok
+   .n    1 when the elements do not have the same tag.
+   D*/
+/****************************************************************************/
+
+INT NS_DIM_PREFIX GatherCornerCoordinates (INT n, const ELEMENT *const elem[], DOUBLE *const x[])
+{
+  if (n<=0)
+    return(0);
+
+  const INT tag = TAG(elem[0]);
+  for (INT e=0; e<n; e++)
+  {
+    if (INT(TAG(elem[e]))!=tag)
+      return(1);
+    for (INT i=0; i<CORNERS_OF_TAG(tag); i++)
+    {
+      const DOUBLE_VECTOR& c = CVECT(MYVERTEX(CORNER(elem[e],i)));
+      for (INT d=0; d<DIM; d++)
+        x[DIM*i+d][e] = c[d];
+    }
+  }
+
+  return(0);
+}
+
+#ifdef UG_DIM_3
+/* volumes of the prisms with corners c[0..5] of a block, see V_pr */
+static void PrismVolumes (INT first, INT m, const DOUBLE *const x[], const INT c[6], DOUBLE volume[])
+{
+  for (INT e=0; e<m; e++)
+  {
+    DOUBLE x0[3],x1[3],x2[3],x3[3],x4[3],x5[3];
+    DOUBLE a[3],b[3],cc[3],d[3],h[3],mm[3],nn[3];
+
+    BatchCorner(x,c[0],first+e,x0); BatchCorner(x,c[1],first+e,x1);
+    BatchCorner(x,c[2],first+e,x2); BatchCorner(x,c[3],first+e,x3);
+    BatchCorner(x,c[4],first+e,x4); BatchCorner(x,c[5],first+e,x5);
+    V3_SUBTRACT(x4,x0,a);
+    V3_SUBTRACT(x1,x3,b);
+    V3_SUBTRACT(x1,x0,cc);
+    V3_SUBTRACT(x2,x0,d);
+    V3_SUBTRACT(x5,x0,h);
+    V3_VECTOR_PRODUCT(a,b,mm);
+    V3_VECTOR_PRODUCT(cc,d,nn);
+    V3_ADD(nn,mm,nn);
+
+    volume[e] = OneSixth*V3_SCAL_PROD(nn,h);
+  }
+}
+#endif
+
+/* volumes of a block, see GeneralElementVolume */
+static INT BlockVolumes (INT tag, INT first, INT m, const DOUBLE *const x[], DOUBLE volume[])
+{
+  switch (tag)
+  {
+#               ifdef UG_DIM_2
+  case TRIANGLE :
+    for (INT e=0; e<m; e++)
+    {
+      DOUBLE x0[2],x1[2],x2[2];
+      BatchCorner(x,0,first+e,x0); BatchCorner(x,1,first+e,x1); BatchCorner(x,2,first+e,x2);
+      volume[e] = 0.5*fabs((x1[1]-x0[1])*(x2[0]-x0[0])-(x1[0]-x0[0])*(x2[1]-x0[1]));
+    }
+    return(0);
+
+  case QUADRILATERAL :
+    for (INT e=0; e<m; e++)
+    {
+      DOUBLE x0[2],x1[2],x2[2],x3[2];
+      BatchCorner(x,0,first+e,x0); BatchCorner(x,1,first+e,x1);
+      BatchCorner(x,2,first+e,x2); BatchCorner(x,3,first+e,x3);
+      volume[e] = 0.5*fabs( (x3[1]-x1[1])*(x2[0]-x0[0])-(x3[0]-x1[0])*(x2[1]-x0[1]) );
+    }
+    return(0);
+#               endif
+
+#               ifdef UG_DIM_3
+  case TETRAHEDRON :
+    for (INT e=0; e<m; e++)
+    {
+      DOUBLE x0[3],x1[3],x2[3],x3[3],a[3],b[3],h[3],nn[3];
+      BatchCorner(x,0,first+e,x0); BatchCorner(x,1,first+e,x1);
+      BatchCorner(x,2,first+e,x2); BatchCorner(x,3,first+e,x3);
+      V3_SUBTRACT(x1,x0,a);
+      V3_SUBTRACT(x2,x0,b);
+      V3_SUBTRACT(x3,x0,h);
+      V3_VECTOR_PRODUCT(a,b,nn);
+      volume[e] = OneSixth*V3_SCAL_PROD(nn,h);
+    }
+    return(0);
+
+  case PYRAMID :
+    for (INT e=0; e<m; e++)
+    {
+      DOUBLE x0[3],x1[3],x2[3],x3[3],x4[3],a[3],b[3],h[3],nn[3];
+      BatchCorner(x,0,first+e,x0); BatchCorner(x,1,first+e,x1); BatchCorner(x,2,first+e,x2);
+      BatchCorner(x,3,first+e,x3); BatchCorner(x,4,first+e,x4);
+      V3_SUBTRACT(x2,x0,a);
+      V3_SUBTRACT(x3,x1,b);
+      V3_SUBTRACT(x4,x0,h);
+      V3_VECTOR_PRODUCT(a,b,nn);
+      volume[e] = OneSixth*V3_SCAL_PROD(nn,h);
+    }
+    return(0);
+
+  case PRISM :
+    {
+      const INT c[6] = {0,1,2,3,4,5};
+      PrismVolumes(first,m,x,c,volume);
+    }
+    return(0);
+
+  case HEXAHEDRON :
+    {
+      const INT c0[6] = {0,1,2,4,5,6}, c1[6] = {0,2,3,4,6,7};
+      DOUBLE v[BATCH_BLOCK];
+      PrismVolumes(first,m,x,c0,volume);
+      PrismVolumes(first,m,x,c1,v);
+      for (INT e=0; e<m; e++)
+        volume[e] += v[e];
+    }
+    return(0);
+#                       endif
+  }
+
+  return(1);
+}
+
+/****************************************************************************/
+/*D
+   GeneralElementVolumes - Compute the volumes of a batch of elements
+
+   SYNOPSIS:
+   void GeneralElementVolumes (INT tag, INT n, const DOUBLE *const x[], DOUBLE *volume);
+
+   PARAMETERS:
+   .  tag - tag of all elements
+   .  n - number of elements
+   .  x - corner coordinates, see GatherCornerCoordinates
+   .  volume - n volumes
+
+   DESCRIPTION:
+   This function computes what GeneralElementVolume computes for every
+   element of the batch.
+   D*/
+/****************************************************************************/
+
+void NS_DIM_PREFIX GeneralElementVolumes (INT tag, INT n, const DOUBLE *const x[], DOUBLE *volume)
+{
+  for (INT first=0; first<n; first+=BATCH_BLOCK)
+  {
+    const INT m = std::min(n-first,BATCH_BLOCK);
+    DOUBLE v[BATCH_BLOCK];
+
+    if (BlockVolumes(tag,first,m,x,v))
+    {
+      PrintErrorMessage('E',"GeneralElementVolumes","unknown element");
+      std::fill(volume,volume+n,0.0);
+      return;
+    }
+    for (INT e=0; e<m; e++)
+      volume[first+e] = v[e];
+  }
+}
+
+/****************************************************************************/
+/*D
+   M3_InvertBatch - Calculate inverses of a batch of 3x3 DOUBLE matrices
+
+   SYNOPSIS:
+   INT M3_InvertBatch (INT n, const DOUBLE *const Matrix[9], DOUBLE *const Inverse[9]);
+
+   PARAMETERS:
+   .  n - number of matrices
+   .  Matrix - Matrix[k][e] is entry k of matrix e, ordered as for M3_Invert
+   .  Inverse - inverses, in the same layout
+
+   DESCRIPTION:
+   This function calculates what M3_Invert calculates for every matrix of the
+   batch. The inverses of nearly singular matrices are set to 0.
+
+   RETURN VALUE:
+   INT
+   .n    number of nearly singular matrices
+   D*/
+/****************************************************************************/
+
+INT NS_DIM_PREFIX M3_InvertBatch (INT n, const DOUBLE *const Matrix[9], DOUBLE *const Inverse[9])
+{
+  INT singular = 0;
+
+  for (INT first=0; first<n; first+=BATCH_BLOCK)
+  {
+    const INT m = std::min(n-first,BATCH_BLOCK);
+    DOUBLE Inv[9][BATCH_BLOCK], invdet[BATCH_BLOCK], numerator[BATCH_BLOCK];
+
+    /* cofactors */
+    for (INT i=0; i<3; i++)
+    {
+      const INT i1 = (i+1)%3;
+      const INT i2 = (i+2)%3;
+      for (INT j=0; j<3; j++)
+      {
+        const INT j1 = (j+1)%3;
+        const INT j2 = (j+2)%3;
+        const DOUBLE *const M11 = Matrix[i1+3*j1]+first, *const M22 = Matrix[i2+3*j2]+first;
+        const DOUBLE *const M12 = Matrix[i1+3*j2]+first, *const M21 = Matrix[i2+3*j1]+first;
+        for (INT e=0; e<m; e++)
+          Inv[j+3*i][e] = M11[e]*M22[e] - M12[e]*M21[e];
+      }
+    }
+
+    /* check the determinant, select before dividing because the
+       compiler does not vectorize a conditional division */
+    const DOUBLE *const M0 = Matrix[0]+first, *const M1 = Matrix[1]+first, *const M2 = Matrix[2]+first;
+    for (INT e=0; e<m; e++)
+    {
+      const DOUBLE determinant = Inv[0+3*0][e]*M0[e] + Inv[0+3*1][e]*M1[e] + Inv[0+3*2][e]*M2[e];
+      const bool regular = fabs(determinant) > MIN_DETERMINANT;
+      invdet[e] = regular ? determinant : 1.0;
+      numerator[e] = regular ? 1.0 : 0.0;
+      singular += !regular;
+    }
+    for (INT e=0; e<m; e++)
+      invdet[e] = numerator[e]/invdet[e];
+
+    for (INT k=0; k<9; k++)
+      for (INT e=0; e<m; e++)
+        Inverse[k][first+e] = Inv[k][e]*invdet[e];
+  }
+
+  return(singular);
+}
+
+#ifdef UG_DIM_3
+/****************************************************************************/
+/*D
+   TetraSideNormalsBatch - Calculate inner normals of a batch of tetrahedra
+
+   SYNOPSIS:
+   INT TetraSideNormalsBatch (INT n, const DOUBLE *const x[], DOUBLE *const theNormals[], INT *degenerate);
+
+   PARAMETERS:
+   .  n - number of tetrahedra
+   .  x - corner coordinates, see GatherCornerCoordinates
+   .  theNormals - theNormals[3*k+d][e] is coordinate d of the normal of side k
+   .  degenerate - if not NULL, degenerate[e] is set when TetraSideNormals fails for e
+
+   DESCRIPTION:
+   This function calculates what TetraSideNormals calculates for every
+   tetrahedron of the batch.
+
+   RETURN VALUE:
+   INT
+   .n    number of degenerate tetrahedra
+   D*/
+/****************************************************************************/
+
+INT NS_DIM_PREFIX TetraSideNormalsBatch (INT n, const DOUBLE *const x[], DOUBLE *const theNormals[], INT *degenerate)
+{
+  INT count = 0;
+
+  for (INT first=0; first<n; first+=BATCH_BLOCK)
+  {
+    const INT m = std::min(n-first,BATCH_BLOCK);
+    DOUBLE Normals[4][3][BATCH_BLOCK], norm[BATCH_BLOCK];
+    INT bad[BATCH_BLOCK];
+
+    for (INT e=0; e<m; e++)
+      bad[e] = 0;
+
+    for (INT j=0; j<4; j++)
+    {
+      const INT c0 = j, c1 = (j+1)%4, c2 = (j+2)%4, c3 = (j+3)%4;
+      DOUBLE (*const N)[BATCH_BLOCK] = Normals[j];
+
+      for (INT e=0; e<m; e++)
+      {
+        DOUBLE x1[3],x2[3],x3[3],a[3],b[3],n[3];
+        BatchCorner(x,c1,first+e,x1); BatchCorner(x,c2,first+e,x2); BatchCorner(x,c3,first+e,x3);
+        V3_SUBTRACT(x1,x2,a)
+        V3_SUBTRACT(x1,x3,b)
+        V3_VECTOR_PRODUCT(a,b,n)
+        for (INT d=0; d<3; d++)
+          N[d][e] = n[d];
+        norm[e] = V3_SCAL_PROD(n,n);
+      }
+      /* sqrt sets errno and is not vectorized unless -fno-math-errno,
+         short normals are not scaled (V3_Normalize) */
+      for (INT e=0; e<m; e++)
+      {
+        const DOUBLE length = sqrt((double)norm[e]);
+        norm[e] = (length < SMALL_C) ? 1.0 : length;
+      }
+      for (INT e=0; e<m; e++)
+      {
+        DOUBLE x0[3],x1[3],a[3],n[3],h;
+        BatchCorner(x,c0,first+e,x0); BatchCorner(x,c1,first+e,x1);
+        const DOUBLE scale = 1.0/norm[e];
+        for (INT d=0; d<3; d++)
+          n[d] = scale*N[d][e];
+        V3_SUBTRACT(x0,x1,a)
+        V3_SCALAR_PRODUCT(n,a,h);
+        bad[e] |= (std::abs(h)<SMALL_C);
+        const DOUBLE sign = (h<0.0) ? -1.0 : 1.0;
+        for (INT d=0; d<3; d++)
+          N[d][e] = sign*n[d];
+      }
+    }
+
+    for (INT j=0; j<4; j++)
+    {
+      const INT k = SIDE_OPP_TO_CORNER_TAG(TETRAHEDRON,j);
+      for (INT d=0; d<3; d++)
+        for (INT e=0; e<m; e++)
+          theNormals[3*k+d][first+e] = Normals[j][d][e];
+    }
+    for (INT e=0; e<m; e++)
+    {
+      count += bad[e];
+      if (degenerate!=NULL)
+        degenerate[first+e] = bad[e];
+    }
+  }
+
+  return(count);
+}
+
+/****************************************************************************/
+/*D
+   TetAngleAndLengthBatch - Calculate side angles and edge lengths of a batch of tetrahedra
+
+   SYNOPSIS:
+   INT TetAngleAndLengthBatch (INT n, const DOUBLE *const x[], DOUBLE *const Angle[], DOUBLE *const Length[], INT *degenerate);
+
+   PARAMETERS:
+   .  n - number of tetrahedra
+   .  x - corner coordinates, see GatherCornerCoordinates
+   .  Angle - Angle[j][e] is the side angle at edge j of tetrahedron e
+   .  Length - Length[j][e] is the length of edge j of tetrahedron e
+   .  degenerate - if not NULL, degenerate[e] is set when TetAngleAndLength fails for e
+
+   DESCRIPTION:
+   This function calculates what TetAngleAndLength calculates for every
+   tetrahedron of the batch.
+
+   RETURN VALUE:
+   INT
+   .n    number of degenerate tetrahedra
+   D*/
+/****************************************************************************/
+
+INT NS_DIM_PREFIX TetAngleAndLengthBatch (INT n, const DOUBLE *const x[], DOUBLE *const Angle[], DOUBLE *const Length[], INT *degenerate)
+{
+  INT count = 0;
+
+  for (INT first=0; first<n; first+=BATCH_BLOCK)
+  {
+    const INT m = std::min(n-first,BATCH_BLOCK);
+    DOUBLE theEdge[MAX_EDGES_OF_ELEM][3][BATCH_BLOCK];
+    DOUBLE theNormals[MAX_SIDES_OF_ELEM][3][BATCH_BLOCK];
+    DOUBLE W[BATCH_BLOCK];
+    INT bad[BATCH_BLOCK];
+
+    for (INT e=0; e<m; e++)
+      bad[e] = 0;
+
+    for (INT j=0; j<EDGES_OF_TAG(TETRAHEDRON); j++)
+    {
+      const INT c0 = CORNER_OF_EDGE_TAG(TETRAHEDRON,j,0);
+      const INT c1 = CORNER_OF_EDGE_TAG(TETRAHEDRON,j,1);
+      for (INT d=0; d<3; d++)
+      {
+        const DOUBLE *const x0 = x[3*c0+d]+first, *const x1 = x[3*c1+d]+first;
+        for (INT e=0; e<m; e++)
+          theEdge[j][d][e] = x1[e]-x0[e];
+      }
+      for (INT e=0; e<m; e++)
+      {
+        const DOUBLE E[3] = {theEdge[j][0][e], theEdge[j][1][e], theEdge[j][2][e]};
+        W[e] = V3_SCAL_PROD(E,E);
+      }
+      /* sqrt sets errno and is not vectorized unless -fno-math-errno */
+      for (INT e=0; e<m; e++)
+        Length[j][first+e] = sqrt((double)W[e]);
+    }
+
+    for (INT j=0; j<SIDES_OF_TAG(TETRAHEDRON); j++)
+    {
+      const INT e0 = EDGE_OF_SIDE_TAG(TETRAHEDRON,j,0);
+      const INT e1 = EDGE_OF_SIDE_TAG(TETRAHEDRON,j,1);
+      const INT opp = CORNER_OPP_TO_SIDE_TAG(TETRAHEDRON,j);
+      const INT k = EDGE_OF_CORNER_TAG(TETRAHEDRON,opp,0);
+      const bool flipBelow = (CORNER_OF_EDGE_TAG(TETRAHEDRON,k,1)==opp);
+      const bool flipAbove = (CORNER_OF_EDGE_TAG(TETRAHEDRON,k,0)==opp);
+
+      for (INT e=0; e<m; e++)
+      {
+        const DOUBLE A[3] = {theEdge[e0][0][e], theEdge[e0][1][e], theEdge[e0][2][e]};
+        const DOUBLE B[3] = {theEdge[e1][0][e], theEdge[e1][1][e], theEdge[e1][2][e]};
+        DOUBLE N[3];
+
+        V3_VECTOR_PRODUCT(A,B,N)
+        for (INT d=0; d<3; d++)
+          theNormals[j][d][e] = N[d];
+        W[e] = V3_SCAL_PROD(N,N);
+      }
+      for (INT e=0; e<m; e++)
+      {
+        const DOUBLE length = sqrt((double)W[e]);
+        W[e] = (length < SMALL_C) ? 1.0 : length;
+      }
+      for (INT e=0; e<m; e++)
+      {
+        const DOUBLE K[3] = {theEdge[k][0][e], theEdge[k][1][e], theEdge[k][2][e]};
+        DOUBLE N[3],h;
+
+        const DOUBLE scale = 1.0/W[e];
+        for (INT d=0; d<3; d++)
+          N[d] = scale*theNormals[j][d][e];
+        V3_SCALAR_PRODUCT(N,K,h)
+        bad[e] |= (std::abs(h)<SMALL_C);
+        const bool flip = (flipBelow & (h<0.0)) | (flipAbove & (h>0.0));
+        const DOUBLE sign = flip ? -1.0 : 1.0;
+        for (INT d=0; d<3; d++)
+          theNormals[j][d][e] = sign*N[d];
+      }
+    }
+
+    for (INT j=0; j<EDGES_OF_TAG(TETRAHEDRON); j++)
+    {
+      const INT s0 = SIDE_WITH_EDGE_TAG(TETRAHEDRON,j,0);
+      const INT s1 = SIDE_WITH_EDGE_TAG(TETRAHEDRON,j,1);
+      for (INT e=0; e<m; e++)
+      {
+        const DOUBLE N0[3] = {theNormals[s0][0][e], theNormals[s0][1][e], theNormals[s0][2][e]};
+        const DOUBLE N1[3] = {theNormals[s1][0][e], theNormals[s1][1][e], theNormals[s1][2][e]};
+        W[e] = std::clamp(V3_SCAL_PROD(N0,N1), -1.0, 1.0);
+      }
+      /* acos is not vectorized without vector math libraries */
+      for (INT e=0; e<m; e++)
+        Angle[j][first+e] = (DOUBLE)acos((double)W[e]);
+    }
+
+    for (INT e=0; e<m; e++)
+    {
+      count += bad[e];
+      if (degenerate!=NULL)
+        degenerate[first+e] = bad[e];
+    }
+  }
+
+  return(count);
+}
+#endif
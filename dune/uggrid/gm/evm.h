@@ -243,6 +243,16 @@ INT             V3_Normalize
 /* volume calculations*/
 DOUBLE GeneralElementVolume                            (INT tag, DOUBLE *x_co[]);
 DOUBLE          ElementVolume                                           (const ELEMENT *elem);
+DOUBLE          ElementVolume                                           (const GRID *theGrid, const ELEMENT *elem);
+
+/* batched routines, corner coordinates in structure of arrays layout */
+INT             GatherCornerCoordinates                         (INT n, const ELEMENT *const elem[], DOUBLE *const x[]);
+void            GeneralElementVolumes                           (INT tag, INT n, const DOUBLE *const x[], DOUBLE *volume);
+INT             M3_InvertBatch                                  (INT n, const DOUBLE *const Matrix[9], DOUBLE *const Inverse[9]);
+#ifdef UG_DIM_3
+INT             TetraSideNormalsBatch                           (INT n, const DOUBLE *const x[], DOUBLE *const theNormals[], INT *degenerate);
+INT             TetAngleAndLengthBatch                          (INT n, const DOUBLE *const x[], DOUBLE *const Angle[], DOUBLE *const Length[], INT *degenerate);
+#endif
 
 END_UGDIM_NAMESPACE
 
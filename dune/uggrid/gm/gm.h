@@ -48,12 +48,15 @@
 
 #include <climits>
 #include <cassert>
+#include <cstddef>
 #include <cstdlib>
 #include <ctime>
 #include <cmath>
 #include <memory>
 
 #include <unordered_map>
+#include <utility>
+#include <vector>
 #include <array>
 #include <numeric>
 
@@ -1662,6 +1665,68 @@ typedef struct
   UINT VecCollectStatus[MAXMATRICES][MAX_NDOF_MOD_32];
 } DATA_STATUS;
 
+/** \brief Hash index of the edges of a grid level
+
+   The keys are the two end nodes of an edge in ascending order of their
+   addresses, see GetEdge.
+ */
+struct EdgeIndexHasher {
+  std::size_t operator() (const std::pair<const struct node*,const struct node*>& key) const {
+    std::hash<const struct node*> hasher;
+    return hasher(key.first)*0x9e3779b97f4a7c15ull ^ hasher(key.second);
+  }
+};
+typedef std::unordered_map<std::pair<const struct node*,const struct node*>,
+                           struct edge*, EdgeIndexHasher> EDGE_INDEX;
+
+/** \brief Cached geometry of the elements of a grid level
+
+   Structure of arrays with one entry per element of the level, in list
+   order when the cache was built. 'slotOfId' maps the id of an element
+   minus 'firstId' to its entry, and 'element' confirms the entry.
+   Elements created later are appended by UpdateGeometryCache, disposed
+   elements lose their entries.
+   See SetGeometryCache.
+ */
+struct GeometryCache {
+  /** \brief smallest element id of the level */
+  INT firstId;
+  /** \brief entry of an element by its id, -1 if none */
+  std::vector<INT> slotOfId;
+  /** \brief element of an entry, NULL if disposed */
+  std::vector<const union element*> element;
+  /** \brief center of mass, one array per coordinate */
+  std::vector<DOUBLE> center[DIM];
+  /** \brief volume, see ElementVolume */
+  std::vector<DOUBLE> volume;
+  /** \brief inverse of the Jacobian of the map from the reference element
+      at local coordinate 0, one array per matrix entry, see UG_GlobalToLocal */
+  std::vector<DOUBLE> inverseJacobian[DIM][DIM];
+  /** \brief determinant of the Jacobian at local coordinate 0, 0 if singular */
+  std::vector<DOUBLE> det;
+};
+typedef struct GeometryCache GEOMETRY_CACHE;
+
+/** \brief Center vertex of a boundary element which ProjectBoundaryVertices
+   places again
+
+   Holds the vertices on the edges of the element when the center vertex
+   was created. A mid node which no son needs any more may be disposed
+   before the level is projected, then its saved position is used.
+   See CreateCenterNode.
+ */
+struct UnplacedCenterVertex {
+  /** \brief the center vertex */
+  union vertex *vertex;
+  /** \brief bit mask of the edges with a mid node */
+  INT edges;
+  /** \brief bit mask of the edges whose mid vertex has moved */
+  INT moved;
+  /** \brief position of the mid vertex of each edge */
+  std::array<DOUBLE_VECTOR,MAX_EDGES_OF_ELEM> midVertex;
+};
+typedef struct UnplacedCenterVertex UNPLACED_CENTER_VERTEX;
+
 /** \brief Data type giving access to all objects on a grid level
 
 The \ref grid data type provides access to all objects defined on a grid level.
@@ -1699,6 +1764,9 @@ struct grid {
   /** \brief Number of vectors on this grid level */
   INT nVector[NS_DIM_PREFIX MAX_PRIOS];
 
+  /** \brief Number of vectors with FINE_GRID_DOF, see SetSurfaceClasses */
+  INT nFineGridDof;
+
   DATA_STATUS data_status;          /* memory management for vectors|matrix */
                                     /* status for consistent and collect    */
   /* pointers */
@@ -1714,6 +1782,14 @@ struct grid {
   struct grid *coarser, *finer;         /* coarser and finer grids                              */
   struct multigrid *mg;                         /* corresponding multigrid structure    */
 
+  /** \brief Optional edge index of this level, NULL if not used.
+      See SetEdgeIndex */
+  EDGE_INDEX *edgeIndex;
+
+  /** \brief Optional geometry cache of this level, NULL if not used.
+      See SetGeometryCache */
+  GEOMETRY_CACHE *geometryCache;
+
   const PPIF::PPIFContext& ppifContext() const;
 
 #ifdef ModelP
@@ -1836,6 +1912,68 @@ struct multigrid {
   /** \brief coarse grid MarkKey for SIMPLE_HEAP Mark/Release     */
   INT MarkKey;
 
+  /** \brief compact the grid levels after FixCoarseGrid and AdaptMultiGrid,
+      see CompactMultiGrid */
+  INT compactStorage;
+
+  /** \brief keep an edge index on all grid levels, see SetEdgeIndex */
+  INT edgeIndex;
+
+  /** \brief keep a geometry cache on all grid levels, see SetGeometryCache */
+  INT geometryCache;
+
+  /** \brief compute the closure from a worklist of the elements near marked
+      ones instead of sweeping all elements, see AdaptMultiGrid */
+  INT closureWorklist;
+
+  /** \brief adapt only the region around the elements marked since the
+      last adaption, see AdaptMultiGrid */
+  INT adaptIncremental;
+
+  /** \brief elements marked since the last AdaptMultiGrid, see
+      NoteMarkedElement */
+  std::vector<union element*> markedElements;
+
+  /** \brief all marks since the last AdaptMultiGrid are in markedElements */
+  bool marksRecorded;
+
+  /** \brief flag of the last AdaptMultiGrid */
+  INT markedFlag;
+
+  /** \brief the element lists of all levels are in the order of the ids,
+      until CompactGrid reorders them */
+  INT elementsInIdOrder;
+
+  /** \brief elements created by the last AdaptMultiGrid */
+  std::vector<union element*> createdElements;
+
+  /** \brief elements visited by the worklist closure, see GridClosure */
+  std::vector<union element*> closureList;
+
+  /** \brief refined elements whose neighbors join the worklist closure */
+  std::vector<union element*> closureSeeds;
+
+  /** \brief grid level with edge patterns set by the last GridClosure */
+  const struct grid *closureGrid;
+
+  /** \brief the last GridClosure visited all elements of closureGrid */
+  bool closureSweep;
+
+  /** \brief all edges have no closure patterns, see ResetClosurePatterns */
+  bool closurePatternsReset;
+
+  /** \brief evaluate the boundary vertices created on a level together after
+      its refinement, see ProjectBoundaryVertices */
+  INT boundaryBatch;
+
+  /** \brief boundary vertices of the level being refined whose position
+      is not evaluated yet */
+  std::vector<union vertex*> unprojectedVertices;
+
+  /** \brief center vertices of boundary elements of the level being refined
+      which move with the vertices on their edges, see CreateCenterNode */
+  std::vector<UNPLACED_CENTER_VERTEX> unplacedCenterVertices;
+
   const PPIF::PPIFContext& ppifContext() const
     { return *ppifContext_; }
 
@@ -1886,13 +2024,38 @@ typedef union object_with_key KEY_OBJECT;
         #define StaticControlWord(p,t)            (((UINT *)(p))[t ## OFFSET])
         #define StaticControlWordMask(s)          ((POW2(s ## LEN) - 1) << s ## SHIFT)
 
-        #define CW_READ_STATIC(p,s,t)                                                \
-  ((StaticControlWord(p,t) &  StaticControlWordMask(s)) >> s ## SHIFT)
+/** \brief Compile-time layout of a control entry
+
+   The entry has 'length' bits starting at bit 'shift' of the control word
+   at UINT index 'offset' of the object, so reading and writing it is a
+   fixed shift and mask. The predefined entries are checked against each
+   other at compile time in cw.cc.
+ */
+template<std::size_t offset, UINT shift, UINT length>
+struct ControlEntryLayout
+{
+  static_assert(length>0 && shift+length<=32, "control entry exceeds its control word");
+
+  /** \brief 1 where bits are used */
+  static constexpr UINT mask = (~UINT(0) >> (32-length)) << shift;
+
+  static UINT read (const void *p)
+  {
+    return (static_cast<const UINT *>(p)[offset] & mask) >> shift;
+  }
+
+  static void write (void *p, UINT n)
+  {
+    UINT& word = static_cast<UINT *>(p)[offset];
+    word = (word & ~mask) | ((n << shift) & mask);
+  }
+};
+
+        #define CW_LAYOUT(s,t)                    ControlEntryLayout<t ## OFFSET, s ## SHIFT, s ## LEN>
+
+        #define CW_READ_STATIC(p,s,t)             (CW_LAYOUT(s,t)::read(p))
 
-        #define CW_WRITE_STATIC(p,s,t,n)                                             \
-  StaticControlWord(p,t) =                                           \
-    (StaticControlWord(p,t) &  (~StaticControlWordMask(s))) |          \
-    (((n) << s ## SHIFT) & StaticControlWordMask(s))
+        #define CW_WRITE_STATIC(p,s,t,n)          (CW_LAYOUT(s,t)::write(p,n))
 
 /** \brief Enumeration list of all control words of gm.h */
 enum GM_CW {
@@ -2085,8 +2248,8 @@ enum LV_MODIFIERS {
 #ifdef ModelP
 #define XFERVECTOR_SHIFT                        20
 #define XFERVECTOR_LEN                          2
-#define XFERVECTOR(p)                           CW_READ(p,XFERVECTOR_CE)
-#define SETXFERVECTOR(p,n)                      CW_WRITE(p,XFERVECTOR_CE,n)
+#define XFERVECTOR(p)                           CW_READ_STATIC(p,XFERVECTOR_,VECTOR_)
+#define SETXFERVECTOR(p,n)                      CW_WRITE_STATIC(p,XFERVECTOR_,VECTOR_,n)
 #endif /* ModelP */
 
 #define VOBJECT(v)                                      ((v)->object)
@@ -2345,8 +2508,8 @@ enum GM_OBJECTS {
 
 #define LOFFSET_SHIFT                           0
 #define LOFFSET_LEN                             1
-#define LOFFSET(p)                                      CW_READ(p,LOFFSET_CE)
-#define SETLOFFSET(p,n)                         CW_WRITE(p,LOFFSET_CE,n)
+#define LOFFSET(p)                                      CW_READ_STATIC(p,LOFFSET_,LINK_)
+#define SETLOFFSET(p,n)                         CW_WRITE_STATIC(p,LOFFSET_,LINK_,n)
 
 /** \brief Get the neighboring node of a link */
 #define NBNODE(p)                                       ((p)->nbnode)
@@ -2380,26 +2543,26 @@ provides the LINK in the list of node `b` pointing to `a`.
 #define NO_OF_ELEM_SHIFT                        2
 #define NO_OF_ELEM_LEN                          7
 #define NO_OF_ELEM_MAX                          128
-#define NO_OF_ELEM(p)                           CW_READ(p,NO_OF_ELEM_CE)
-#define SET_NO_OF_ELEM(p,n)             CW_WRITE(p,NO_OF_ELEM_CE,n)
+#define NO_OF_ELEM(p)                           CW_READ_STATIC(p,NO_OF_ELEM_,EDGE_)
+#define SET_NO_OF_ELEM(p,n)             CW_WRITE_STATIC(p,NO_OF_ELEM_,EDGE_,n)
 #define INC_NO_OF_ELEM(p)                       SET_NO_OF_ELEM(p,NO_OF_ELEM(p)+1)
 #define DEC_NO_OF_ELEM(p)                       SET_NO_OF_ELEM(p,NO_OF_ELEM(p)-1)
 
 #define AUXEDGE_SHIFT                           9
 #define AUXEDGE_LEN                             1
-#define AUXEDGE(p)                                      CW_READ(p,AUXEDGE_CE)
-#define SETAUXEDGE(p,n)                         CW_WRITE(p,AUXEDGE_CE,n)
+#define AUXEDGE(p)                                      CW_READ_STATIC(p,AUXEDGE_,EDGE_)
+#define SETAUXEDGE(p,n)                         CW_WRITE_STATIC(p,AUXEDGE_,EDGE_,n)
 
 #define EDGENEW_SHIFT                           1
 #define EDGENEW_LEN                             1
-#define EDGENEW(p)                                      CW_READ(p,EDGENEW_CE)
-#define SETEDGENEW(p,n)                         CW_WRITE(p,EDGENEW_CE,n)
+#define EDGENEW(p)                                      CW_READ_STATIC(p,EDGENEW_,EDGE_)
+#define SETEDGENEW(p,n)                         CW_WRITE_STATIC(p,EDGENEW_,EDGE_,n)
 
 /* boundary edges will be indicated by a subdomain id of 0 */
 #define EDSUBDOM_SHIFT                          12
 #define EDSUBDOM_LEN                            6
-#define EDSUBDOM(p)                                     CW_READ(p,EDSUBDOM_CE)
-#define SETEDSUBDOM(p,n)                        CW_WRITE(p,EDSUBDOM_CE,n)
+#define EDSUBDOM(p)                                     CW_READ_STATIC(p,EDSUBDOM_,EDGE_)
+#define SETEDSUBDOM(p,n)                        CW_WRITE_STATIC(p,EDSUBDOM_,EDGE_,n)
 
 #define LINK0(p)        (&((p)->links[0]))
 #define LINK1(p)        (&((p)->links[1]))
@@ -2429,18 +2592,18 @@ enum {TETRAHEDRON = 4,
 /* macros for control word */
 #define ECLASS_SHIFT                                    8
 #define ECLASS_LEN                                              2
-#define ECLASS(p)                                               CW_READ(p,ECLASS_CE)
-#define SETECLASS(p,n)                                  CW_WRITE(p,ECLASS_CE,n)
+#define ECLASS(p)                                               CW_READ_STATIC(p,ECLASS_,ELEMENT_)
+#define SETECLASS(p,n)                                  CW_WRITE_STATIC(p,ECLASS_,ELEMENT_,n)
 
 #define NSONS_SHIFT                                     10
 #define NSONS_LEN                                               5
-#define NSONS(p)                                                CW_READ(p,NSONS_CE)
-#define SETNSONS(p,n)                                   CW_WRITE(p,NSONS_CE,n)
+#define NSONS(p)                                                CW_READ_STATIC(p,NSONS_,ELEMENT_)
+#define SETNSONS(p,n)                                   CW_WRITE_STATIC(p,NSONS_,ELEMENT_,n)
 
 #define NEWEL_SHIFT                                     17
 #define NEWEL_LEN                                               1
-#define NEWEL(p)                                                CW_READ(p,NEWEL_CE)
-#define SETNEWEL(p,n)                                   CW_WRITE(p,NEWEL_CE,n)
+#define NEWEL(p)                                                CW_READ_STATIC(p,NEWEL_,ELEMENT_)
+#define SETNEWEL(p,n)                                   CW_WRITE_STATIC(p,NEWEL_,ELEMENT_,n)
 
 /* macros for flag word                           */
 /* are obviously all for internal use */
@@ -2448,18 +2611,18 @@ enum {TETRAHEDRON = 4,
 /* the property field */
 #define SUBDOMAIN_SHIFT                 24
 #define SUBDOMAIN_LEN                   6
-#define SUBDOMAIN(p)                    CW_READ(p,SUBDOMAIN_CE)
-#define SETSUBDOMAIN(p,n)               CW_WRITE(p,SUBDOMAIN_CE,n)
+#define SUBDOMAIN(p)                    CW_READ_STATIC(p,SUBDOMAIN_,PROPERTY_)
+#define SETSUBDOMAIN(p,n)               CW_WRITE_STATIC(p,SUBDOMAIN_,PROPERTY_,n)
 
 #define NODEORD_SHIFT                   0
 #define NODEORD_LEN                     24
-#define NODEORD(p)                      CW_READ(p,NODEORD_CE)
-#define SETNODEORD(p,n)                 CW_WRITE(p,NODEORD_CE,n)
+#define NODEORD(p)                      CW_READ_STATIC(p,NODEORD_,PROPERTY_)
+#define SETNODEORD(p,n)                 CW_WRITE_STATIC(p,NODEORD_,PROPERTY_,n)
 
 #define PROP_SHIFT                      30
 #define PROP_LEN                        2
-#define PROP(p)                         CW_READ(p,PROP_CE)
-#define SETPROP(p,n)                    CW_WRITE(p,PROP_CE,n)
+#define PROP(p)                         CW_READ_STATIC(p,PROP_,PROPERTY_)
+#define SETPROP(p,n)                    CW_WRITE_STATIC(p,PROP_,PROPERTY_,n)
 
 /* parallel macros */
 #ifdef ModelP
@@ -2641,7 +2804,8 @@ START_UGDIM_NAMESPACE
 #define SVECTOR(p,i)    ((VECTOR *) (p)->ge.refs[svector_offset[TAG(p)]+(i)])
 #define SIDE_ON_BND(p,i) (ELEM_BNDS(p,i) != NULL)
 #define INNER_SIDE(p,i)  (ELEM_BNDS(p,i) == NULL)
-#define INNER_BOUNDARY(p,i) (InnerBoundary(p,i))
+/* INNER_BOUNDARY(mg,p,i), the deprecated form INNER_BOUNDARY(p,i) uses the current BVP */
+#define INNER_BOUNDARY(...) (InnerBoundary(__VA_ARGS__))
 /* TODO: replace by function call */
 
 #ifdef UG_DIM_2
@@ -2913,6 +3077,12 @@ grid::dddContext()
 #define MG_FILENAME(p)                  ((p)->filename)
 #define MG_COARSE_FIXED(p)              ((p)->CoarseGridFixed)
 #define MG_MARK_KEY(p)              ((p)->MarkKey)
+#define MG_COMPACT_STORAGE(p)       ((p)->compactStorage)
+#define MG_EDGE_INDEX(p)            ((p)->edgeIndex)
+#define MG_GEOMETRY_CACHE(p)        ((p)->geometryCache)
+#define MG_CLOSURE_WORKLIST(p)      ((p)->closureWorklist)
+#define MG_ADAPT_INCREMENTAL(p)     ((p)->adaptIncremental)
+#define MG_BOUNDARY_BATCH(p)        ((p)->boundaryBatch)
 /* macros for formats                                                       */
 /*                                                                          */
 /****************************************************************************/
@@ -2968,6 +3138,7 @@ MULTIGRID               *MakeMGItem                             (const char *nam
 MULTIGRID               *GetMultigrid                           (const char *name);
 MULTIGRID               *GetFirstMultigrid                      (void);
 MULTIGRID               *GetNextMultigrid                       (const MULTIGRID *theMG);
+MULTIGRID               *GetMarkRecordingMultigrid      (const ELEMENT *theElement);
 
 /* create, saving and disposing a multigrid structure */
 MULTIGRID *CreateMultiGrid (char *MultigridName, BVP theBVP,
@@ -2979,6 +3150,8 @@ MULTIGRID *OpenMGFromDataFile(MULTIGRID *theMG, INT number, char *type,
 INT         DisposeGrid             (GRID *theGrid);
 INT             DisposeMultiGrid                (MULTIGRID *theMG);
 INT         Collapse                (MULTIGRID *theMG);
+INT         CompactGrid             (GRID *theGrid);
+INT         CompactMultiGrid        (MULTIGRID *theMG);
 
 /* coarse grid manipulations */
 NODE        *InsertInnerNode            (GRID *theGrid, const DOUBLE *pos);
@@ -2987,6 +3160,7 @@ NODE        *InsertBoundaryNode     (GRID *theGrid, BNDP *bndp);
 INT             DeleteNode                              (GRID *theGrid, NODE *theNode);
 ELEMENT     *InsertElement                      (GRID *theGrid, INT n, NODE **NodeList, ELEMENT **ElemList, INT *NbgSdList, INT *bnds_flag);
 INT         InsertMesh              (MULTIGRID *theMG, MESH *theMesh);
+INT         SetElementNeighbors     (GRID *theGrid, INT nThreads);
 INT             DeleteElement                   (MULTIGRID *theMG, ELEMENT *theElement);
 
 /* refinement */
@@ -3008,6 +3182,8 @@ INT                     GetSideIDFromScratch    (ELEMENT *theElement, NODE *theN
 INT             DisposeConnectionsInGrid (GRID *theGrid);
 
 /* searching */
+INT          InnerBoundary          (MULTIGRID *theMG, ELEMENT *t, INT side);
+[[deprecated("Pass the multigrid as first argument")]]
 INT          InnerBoundary          (ELEMENT *t, INT side);
 
 /* list */
@@ -3028,6 +3204,8 @@ EDGE            *GetFatherEdge                  (const EDGE *theEdge);
 EDGE            *FatherEdge                             (NODE **SideNodes, INT ncorners, NODE **Nodes, EDGE *theEdge);
 #endif
 EDGE            *GetEdge                                (const NODE *from, const NODE *to);
+EDGE            *GetEdge                                (const GRID *theGrid, const NODE *from, const NODE *to);
+INT             SetEdgeIndex                    (MULTIGRID *theMG, INT enable);
 INT             GetSons                                 (const ELEMENT *theElement, ELEMENT *SonList[MAX_SONS]);
 #ifdef ModelP
 INT             GetAllSons                              (const ELEMENT *theElement, ELEMENT *SonList[MAX_SONS]);
@@ -3055,7 +3233,11 @@ INT         SetEdgeSubdomainFromElements        (GRID *theGrid);
 INT         SetSubdomainIDfromBndInfo           (MULTIGRID *theMG);
 INT         FixCoarseGrid                       (MULTIGRID *theMG);
 INT                     ClearMultiGridUsedFlags                         (MULTIGRID *theMG, INT FromLevel, INT ToLevel, INT mask);
-void            CalculateCenterOfMass                           (ELEMENT *theElement, DOUBLE_VECTOR center_of_mass);
+void            CalculateCenterOfMass                           (ELEMENT *theElement, DOUBLE_VECTOR& center_of_mass);
+void            CalculateCenterOfMass                           (const GRID *theGrid, ELEMENT *theElement, DOUBLE_VECTOR& center_of_mass);
+INT         SetGeometryCache                    (MULTIGRID *theMG, INT enable);
+INT         UpdateGeometryCache                 (MULTIGRID *theMG);
+INT         GeometryCacheSlot                   (const GRID *theGrid, const ELEMENT *theElement);
 INT             KeyForObject                                            (KEY_OBJECT *obj);
 
 /** \todo remove the following functions after the code will never need any debugging */
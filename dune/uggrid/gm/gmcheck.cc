@@ -763,7 +763,7 @@ static INT CheckElement (GRID *theGrid, ELEMENT *theElement, INT *SideError, INT
           {
             INT err,id,nbid,id_nb,nbid_nb;
 
-            err = BNDS_BndSDesc(ELEM_BNDS(theElement,i),&id,&nbid);
+            err = BNDS_BndSDesc(MG_BVP(MYMG(theGrid)),ELEM_BNDS(theElement,i),&id,&nbid);
             if (err)
             {
               bserror |= (1<<i);
@@ -796,7 +796,7 @@ static INT CheckElement (GRID *theGrid, ELEMENT *theElement, INT *SideError, INT
               }
               else
               {
-                if (BNDS_BndSDesc(ELEM_BNDS(NbElement,j),&id_nb,&nbid_nb))
+                if (BNDS_BndSDesc(MG_BVP(MYMG(theGrid)),ELEM_BNDS(NbElement,j),&id_nb,&nbid_nb))
                 {
                   UserWriteF("nb=" EID_FMTX " ERROR BNDS_BndSDesc(%d) returned id=%d nbid=%d\n",
                              EID_PRTX(NbElement),j,id,nbid);
@@ -1051,7 +1051,7 @@ static INT CheckElement (GRID *theGrid, ELEMENT *theElement, INT *SideError, INT
       UserWrite("cannot get sons\n");
       return (1);
     }
-    for (i=0; (SonList[i]!=NULL || i<nsons) && i<MAX_SONS; i++)
+    for (i=0; i<MAX_SONS && (SonList[i]!=NULL || i<nsons); i++)
     {
       IFDEBUG(gm,1)
       if (REFINE(theElement)==0)
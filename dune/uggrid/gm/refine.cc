@@ -68,6 +68,7 @@
 
 #include <algorithm>
 #include <array>
+#include <vector>
 
 /* low module */
 #include <dune/uggrid/low/debug.h>
@@ -509,8 +510,8 @@ static INT UpdateFIFOLists (GRID *theGrid, ELEMENT *theElement, INT thePattern,
           EDGE_IN_PAT(NewPattern,j))
       {
 
-        EDGE *theEdge = GetEdge(CORNER_OF_EDGE_PTR(theElement, j, 0),
-                                CORNER_OF_EDGE_PTR(theElement, j, 1));
+        EDGE *theEdge = GetEdge(theGrid,CORNER_OF_EDGE_PTR(theElement, j, 0),
+                                        CORNER_OF_EDGE_PTR(theElement, j, 1));
         ASSERT(theEdge != NULL);
 
         SETPATTERN(theEdge,1);
@@ -681,6 +682,72 @@ INT NS_DIM_PREFIX Refinement_Changes (ELEMENT *theElement)
   return(REFINEMENT_CHANGES(theElement));
 }
 
+/****************************************************************************/
+/** \brief Remember a marked element for the next AdaptMultiGrid
+
+   \param theElement - element whose mark or coarsen flag changes
+
+   MarkForRefinement calls this function for every element it changes.
+   The element is recorded in the markedElements of its multigrid if that
+   multigrid records its marks, see GetMarkRecordingMultigrid. This is
+   the case after an AdaptMultiGrid with MG_ADAPT_INCREMENTAL set.
+   AdaptMultiGrid starts from these elements when it adapts only the
+   region around the marked elements, see AdaptMultiGridRegion. Parallel
+   builds always adapt all elements and ignore the marked elements.
+ */
+/****************************************************************************/
+
+void NS_DIM_PREFIX NoteMarkedElement (ELEMENT *theElement)
+{
+#ifndef ModelP
+  MULTIGRID *theMG = GetMarkRecordingMultigrid(theElement);
+  if (theMG != NULL)
+    theMG->markedElements.push_back(theElement);
+#endif
+}
+
+/****************************************************************************/
+/** \brief Forget the marked elements of a multigrid
+
+   \param theMG - multigrid structure
+
+   The elements noted by NoteMarkedElement are no longer valid or
+   complete, e.g. if the element lists are reordered or the marks are
+   set with SETMARK or SETCOARSEN instead of MarkForRefinement. The next
+   AdaptMultiGrid of theMG adapts all elements.
+ */
+/****************************************************************************/
+
+void NS_DIM_PREFIX ForgetMarkedElements (MULTIGRID *theMG)
+{
+  theMG->markedElements.clear();
+  theMG->marksRecorded = false;
+  theMG->markedFlag = 0;
+}
+
+/****************************************************************************/
+/** \brief Reset the closure patterns of the edges of an element
+
+   \param theGrid - grid level of theElement
+   \param theElement - element whose edges are reset
+
+   GridClosure expects PATTERN=0 and ADDPATTERN=1 on all edges.
+ */
+/****************************************************************************/
+
+static void ResetElementEdgePatterns (const GRID *theGrid, const ELEMENT *theElement)
+{
+  for (INT j = 0; j < EDGES_OF_ELEM(theElement); j++)
+  {
+    EDGE *theEdge = GetEdge(theGrid,CORNER_OF_EDGE_PTR(theElement, j, 0),
+                                    CORNER_OF_EDGE_PTR(theElement, j, 1));
+    ASSERT(theEdge != NULL);
+
+    SETPATTERN(theEdge,0);
+    SETADDPATTERN(theEdge,1);
+  }
+}
+
 /****************************************************************************/
 /*
    GridClosure - compute closure for next level
@@ -708,11 +775,15 @@ INT NS_DIM_PREFIX Refinement_Changes (ELEMENT *theElement)
 
 static INT PrepareGridClosure (const GRID *theGrid)
 {
-  /* reset USED flag of elements and PATTERN and */
-  /* ADDPATTERN flag on the edges                */
+  /* reset USED flag of elements, the PATTERN and ADDPATTERN */
+  /* flags on the edges are reset by ResetClosurePatterns()  */
   for (ELEMENT *theElement = PFIRSTELEMENT(theGrid); theElement != nullptr;
        theElement=SUCCE(theElement))
   {
+                #ifdef ModelP
+    /* objects copied from other processors keep the patterns of their sender */
+    ResetElementEdgePatterns(theGrid,theElement);
+                #endif
     SETUSED(theElement,0);
     if (EGHOST(theElement))
     {
@@ -720,19 +791,93 @@ static INT PrepareGridClosure (const GRID *theGrid)
       SETMARK(theElement,NO_REFINEMENT);
       SETMARKCLASS(theElement,0);
     }
+  }
 
-    for (INT j = 0; j < EDGES_OF_ELEM(theElement); j++)
-    {
-      EDGE *theEdge = GetEdge(CORNER_OF_EDGE_PTR(theElement, j, 0),
-                              CORNER_OF_EDGE_PTR(theElement, j, 1));
-      ASSERT(theEdge != NULL);
+  return(GM_OK);
+}
 
-      SETPATTERN(theEdge,0);
-      SETADDPATTERN(theEdge,1);                   /* needed in RestrictMarks() */
-    }
+/****************************************************************************/
+/** \brief Reset the closure patterns of all edges of a multigrid
+
+   \param theMG - multigrid structure
+
+   New edges have PATTERN=0 and ADDPATTERN=0. This function is called
+   before the first adaption of theMG, then ResetClosurePatterns() and
+   ResetSonPatterns() keep the edges of all levels without patterns.
+ */
+/****************************************************************************/
+
+static void ResetAllClosurePatterns (MULTIGRID *theMG)
+{
+  for (INT level = 0; level <= TOPLEVEL(theMG); level++)
+  {
+    const GRID *theGrid = GRID_ON_LEVEL(theMG,level);
+    for (const ELEMENT *theElement = PFIRSTELEMENT(theGrid); theElement != nullptr;
+         theElement=SUCCE(theElement))
+      ResetElementEdgePatterns(theGrid,theElement);
   }
 
-  return(GM_OK);
+  theMG->closurePatternsReset = true;
+}
+
+/****************************************************************************/
+/** \brief Reset the edge patterns after the closure of a grid level
+
+   \param theGrid - grid level of the last GridClosure
+
+   The closure changes the patterns of the edges of the elements it
+   visits, they are read by RestrictMarks() and AdaptGrid() afterwards.
+   This function is called after the last of them and resets the edges
+   again, only those of the elements in the worklist if GridClosure did
+   not visit all elements.
+ */
+/****************************************************************************/
+
+static void ResetClosurePatterns (const GRID *theGrid)
+{
+  MULTIGRID *theMG = MYMG(theGrid);
+  if (theGrid != theMG->closureGrid)
+    return;
+
+  if (theMG->closureSweep)
+    for (const ELEMENT *theElement = PFIRSTELEMENT(theGrid); theElement != nullptr;
+         theElement=SUCCE(theElement))
+      ResetElementEdgePatterns(theGrid,theElement);
+  else
+    for (const ELEMENT *theElement : theMG->closureList)
+      ResetElementEdgePatterns(theGrid,theElement);
+
+  theMG->closureGrid = NULL;
+}
+
+/****************************************************************************/
+/** \brief Reset the patterns of the new edges after the refinement of a level
+
+   \param theGrid - grid level refined by AdaptGrid()
+   \param created - number of createdElements of the multigrid before
+                    AdaptGrid(theGrid)
+
+   The edges of the sons created by AdaptGrid() get PATTERN=0 and
+   ADDPATTERN=1 for the closure of the next finer level. In parallel all
+   edges of the next finer level are reset, the sons are not recorded.
+ */
+/****************************************************************************/
+
+static void ResetSonPatterns (GRID *theGrid, [[maybe_unused]] std::size_t created)
+{
+  GRID *FinerGrid = UPGRID(theGrid);
+  if (FinerGrid == NULL)
+    return;
+
+        #ifndef ModelP
+  const std::vector<ELEMENT*>& createdElements = MYMG(theGrid)->createdElements;
+  for (std::size_t k=created; k<createdElements.size(); k++)
+    ResetElementEdgePatterns(FinerGrid,createdElements[k]);
+        #else
+  for (const ELEMENT *theElement = PFIRSTELEMENT(FinerGrid); theElement != nullptr;
+       theElement=SUCCE(theElement))
+    ResetElementEdgePatterns(FinerGrid,theElement);
+        #endif
 }
 
 #ifdef ModelP
@@ -1003,6 +1148,82 @@ static INT ExchangeClosureInfo (GRID *theGrid)
 #endif
 
 
+/****************************************************************************/
+/*
+   ComputeElementPatterns -
+
+   SYNOPSIS:
+   static void ComputeElementPatterns (const GRID *theGrid, ELEMENT *theElement);
+
+   PARAMETERS:
+   .  theGrid - pointer to grid structure
+   .  theElement - element of theGrid
+
+   DESCRIPTION:
+   This function sets the patterns of one element for ComputePatterns().
+
+ */
+/****************************************************************************/
+
+static void ComputeElementPatterns (const GRID *theGrid, ELEMENT *theElement)
+{
+        #ifdef ModelP
+  if (EGHOST(theElement))
+  {
+                #ifdef UG_DIM_3
+    SETSIDEPATTERN(theElement,0);
+                #endif
+    return;
+  }
+        #endif
+
+  if (MARKCLASS(theElement)==RED_CLASS)
+  {
+    INT Mark = MARK(theElement);
+    SHORT *thePattern = MARK2PATTERN(theElement,Mark);
+
+    for (INT i = 0; i < EDGES_OF_ELEM(theElement); i++)
+      if (EDGE_IN_PATTERN(thePattern,i))
+      {
+        EDGE *theEdge = GetEdge(theGrid,CORNER_OF_EDGE_PTR(theElement, i, 0),
+                                        CORNER_OF_EDGE_PTR(theElement, i, 1));
+
+        ASSERT(theEdge != NULL);
+
+        SETPATTERN(theEdge,1);
+      }
+
+                #ifdef UG_DIM_3
+    /* SIDEPATTERN must be reset here for master elements, */
+    /* because it overlaps with MARK (980217 s.l.)         */
+    SETSIDEPATTERN(theElement,0);
+    for (INT i = 0; i < SIDES_OF_ELEM(theElement); i++)
+    {
+#ifdef DUNE_UGGRID_TET_RULESET
+      if (CORNERS_OF_SIDE(theElement,i)==4)
+      {
+#endif
+      /* set SIDEPATTERN if side has node */
+      if(SIDE_IN_PATTERN(theElement,thePattern,i))
+        SETSIDEPATTERN(theElement,
+                       SIDEPATTERN(theElement) | 1<<i);
+#ifdef DUNE_UGGRID_TET_RULESET
+    }
+#endif
+    }
+                #endif
+  }
+  else
+  {
+                #ifdef UG_DIM_3
+    /* SIDEPATTERN must be reset here for master elements, */
+    /* because it overlaps with MARK (980217 s.l.)         */
+    SETSIDEPATTERN(theElement,0);
+                #endif
+    SETMARKCLASS(theElement,NO_CLASS);
+  }
+}
+
 /****************************************************************************/
 /*
    ComputePatterns -
@@ -1032,63 +1253,7 @@ static INT ComputePatterns (const GRID *theGrid)
   /* set PATTERN on the edges                           */
   for (ELEMENT *theElement = PFIRSTELEMENT(theGrid); theElement != nullptr;
        theElement=SUCCE(theElement))
-  {
-                #ifdef ModelP
-    if (EGHOST(theElement))
-    {
-                        #ifdef UG_DIM_3
-      SETSIDEPATTERN(theElement,0);
-                        #endif
-      continue;
-    }
-                #endif
-
-    if (MARKCLASS(theElement)==RED_CLASS)
-    {
-      INT Mark = MARK(theElement);
-      SHORT *thePattern = MARK2PATTERN(theElement,Mark);
-
-      for (INT i = 0; i < EDGES_OF_ELEM(theElement); i++)
-        if (EDGE_IN_PATTERN(thePattern,i))
-        {
-          EDGE *theEdge = GetEdge(CORNER_OF_EDGE_PTR(theElement, i, 0),
-                                  CORNER_OF_EDGE_PTR(theElement, i, 1));
-
-          ASSERT(theEdge != NULL);
-
-          SETPATTERN(theEdge,1);
-        }
-
-                        #ifdef UG_DIM_3
-      /* SIDEPATTERN must be reset here for master elements, */
-      /* because it overlaps with MARK (980217 s.l.)         */
-      SETSIDEPATTERN(theElement,0);
-      for (INT i = 0; i < SIDES_OF_ELEM(theElement); i++)
-      {
-#ifdef DUNE_UGGRID_TET_RULESET
-        if (CORNERS_OF_SIDE(theElement,i)==4)
-        {
-#endif
-        /* set SIDEPATTERN if side has node */
-        if(SIDE_IN_PATTERN(theElement,thePattern,i))
-          SETSIDEPATTERN(theElement,
-                         SIDEPATTERN(theElement) | 1<<i);
-#ifdef DUNE_UGGRID_TET_RULESET
-      }
-#endif
-      }
-                        #endif
-    }
-    else
-    {
-                        #ifdef UG_DIM_3
-      /* SIDEPATTERN must be reset here for master elements, */
-      /* because it overlaps with MARK (980217 s.l.)         */
-      SETSIDEPATTERN(theElement,0);
-                        #endif
-      SETMARKCLASS(theElement,NO_CLASS);
-    }
-  }
+    ComputeElementPatterns(theGrid,theElement);
 
   return(GM_OK);
 }
@@ -1323,59 +1488,72 @@ static INT CorrectElementSidePattern (ELEMENT *theElement, ELEMENT *theNeighbor,
    SetElementSidePatterns -
 
    SYNOPSIS:
+   static INT SetElementSidePattern (ELEMENT *theElement, bool listOnly);
    static INT SetElementSidePatterns (GRID *theGrid, ELEMENT *firstElement);
 
    PARAMETERS:
+   .  theElement - element to correct
+   .  listOnly - correct only with neighbors flagged by THEFLAG
    .  theGrid - pointer to grid structure
    .  firstElement
 
    DESCRIPTION:
+   The side patterns of theElement or of the elements from firstElement on
+   are made consistent with their neighbors.
 
    \return <ul>
    INT
  */
 /****************************************************************************/
 
-static INT SetElementSidePatterns (GRID *theGrid, ELEMENT *firstElement)
+static INT SetElementSidePattern (ELEMENT *theElement, bool listOnly)
 {
   INT i;
-  ELEMENT *theElement,*theNeighbor;
+  ELEMENT *theNeighbor;
 
-  /* set pattern (edge and side) on the elements */
-  for (theElement=firstElement; theElement!=NULL;
-       theElement=SUCCE(theElement))
-  {
-    /* make edgepattern consistent with pattern of edges */
-    SETUSED(theElement,1);
+  /* make edgepattern consistent with pattern of edges */
+  SETUSED(theElement,1);
 
-                #ifndef __ANISOTROPIC__
-    /** \todo change this for red refinement of pyramids */
-    if (DIM==3 && TAG(theElement)==PYRAMID) continue;
-                #endif
+        #ifndef __ANISOTROPIC__
+  /** \todo change this for red refinement of pyramids */
+  if (DIM==3 && TAG(theElement)==PYRAMID) return(GM_OK);
+        #endif
 
-    /* make sidepattern consistent with neighbors	*/
-    for (i=0; i<SIDES_OF_ELEM(theElement); i++)
-    {
-      theNeighbor = NBELEM(theElement,i);
-      if (theNeighbor == NULL) continue;
+  /* make sidepattern consistent with neighbors	*/
+  for (i=0; i<SIDES_OF_ELEM(theElement); i++)
+  {
+    theNeighbor = NBELEM(theElement,i);
+    if (theNeighbor == NULL) continue;
+    if (listOnly && !THEFLAG(theNeighbor)) continue;
 
-      /* only one of the neighboring elements does corrections */
-      /* determine element for side correction by (g)id        */
-      if (_EID_(theElement) < _EID_(theNeighbor)) continue;
+    /* only one of the neighboring elements does corrections */
+    /* determine element for side correction by (g)id        */
+    if (_EID_(theElement) < _EID_(theNeighbor)) continue;
 
-      /* determine element for side correction by used flag    */
-      /** \todo delete this:
-         if (USED(theNeighbor)) continue;
-       */
+    /* determine element for side correction by used flag    */
+    /** \todo delete this:
+       if (USED(theNeighbor)) continue;
+     */
 
-      /* edgepatterns from theElement and theNeighbor are in final state */
+    /* edgepatterns from theElement and theNeighbor are in final state */
 
-      if (CorrectElementSidePattern(theElement,theNeighbor,i) != GM_OK) RETURN(GM_ERROR);
-    }
+    if (CorrectElementSidePattern(theElement,theNeighbor,i) != GM_OK) RETURN(GM_ERROR);
   }
 
   return(GM_OK);
 }
+
+static INT SetElementSidePatterns (GRID *theGrid, ELEMENT *firstElement)
+{
+  ELEMENT *theElement;
+
+  /* set pattern (edge and side) on the elements */
+  for (theElement=firstElement; theElement!=NULL;
+       theElement=SUCCE(theElement))
+    if (SetElementSidePattern(theElement,false) != GM_OK) RETURN(GM_ERROR);
+
+  return(GM_OK);
+}
 #endif
 
 
@@ -1385,143 +1563,154 @@ static INT SetElementSidePatterns (GRID *theGrid, ELEMENT *firstElement)
    SetElementRules -
 
    SYNOPSIS:
+   static INT SetElementRule (GRID *theGrid, ELEMENT *theElement, INT *cnt);
    static INT SetElementRules (GRID *theGrid, ELEMENT *firstElement, INT *cnt);
 
    PARAMETERS:
    .  theGrid - pointer to grid structure
+   .  theElement - element to set the rule for
    .  firstElement
-   .  cnt
+   .  cnt - counter of the marked elements
 
    DESCRIPTION:
+   The rule of theElement or of the elements from firstElement on is set
+   from the edge and side pattern. SetElementRules stops early if the
+   fifo cannot be updated.
 
    \return <ul>
    INT
  */
 /****************************************************************************/
 
-static INT SetElementRules (GRID *theGrid, ELEMENT *firstElement, INT *cnt)
+static INT SetElementRule (GRID *theGrid, ELEMENT *theElement, INT *cnt)
 {
   INT Mark,NewPattern;
   INT thePattern,theEdgePattern,theSidePattern=0;
-  ELEMENT *theElement;
 
   [[maybe_unused]] const int me = theGrid->ppifContext().me();
 
-  /* set refinement rules from edge- and sidepattern */
-  (*cnt) = 0;
-  for (theElement=firstElement; theElement!=NULL;
-       theElement=SUCCE(theElement))
-  {
-    theEdgePattern = 0;
+  theEdgePattern = 0;
 
-    /* compute element pattern */
-    GetEdgeInfo(theElement,&theEdgePattern,PATTERN);
+  /* compute element pattern */
+  GetEdgeInfo(theElement,&theEdgePattern,PATTERN);
 
-                #ifdef UG_DIM_2
-    thePattern = theEdgePattern;
-    PRINTDEBUG(gm,2,(PFMT "SetElementRules(): e=" EID_FMTX " edgepattern=%d\n",
-                     me,EID_PRTX(theElement),theEdgePattern));
-                #endif
-                #ifdef UG_DIM_3
-    theSidePattern = SIDEPATTERN(theElement);
-    thePattern = theSidePattern<<EDGES_OF_ELEM(theElement) | theEdgePattern;
-    PRINTDEBUG(gm,2,(PFMT "SetElementRules(): e=" EID_FMTX
-                     " edgepattern=%03x sidepattern=%02x\n",
-                     me,EID_PRTX(theElement),theEdgePattern,theSidePattern));
-                #endif
+        #ifdef UG_DIM_2
+  thePattern = theEdgePattern;
+  PRINTDEBUG(gm,2,(PFMT "SetElementRules(): e=" EID_FMTX " edgepattern=%d\n",
+                   me,EID_PRTX(theElement),theEdgePattern));
+        #endif
+        #ifdef UG_DIM_3
+  theSidePattern = SIDEPATTERN(theElement);
+  thePattern = theSidePattern<<EDGES_OF_ELEM(theElement) | theEdgePattern;
+  PRINTDEBUG(gm,2,(PFMT "SetElementRules(): e=" EID_FMTX
+                   " edgepattern=%03x sidepattern=%02x\n",
+                   me,EID_PRTX(theElement),theEdgePattern,theSidePattern));
+        #endif
 
-    /* get Mark from pattern */
-    Mark = PATTERN2MARK(theElement,thePattern);
+  /* get Mark from pattern */
+  Mark = PATTERN2MARK(theElement,thePattern);
 
-    /* treat Mark according to mode */
-    if (fifoFlag)
-    {
-      /* directed refinement */
-      if (Mark == -1 && MARKCLASS(theElement)==RED_CLASS)
-      {
-        /* there is no rule for this pattern, switch to red */
-        Mark = RED;
-      }
-      else
-        ASSERT(Mark != -1);
-    }
-    else if (hFlag==0 && MARKCLASS(theElement)!=RED_CLASS)
+  /* treat Mark according to mode */
+  if (fifoFlag)
+  {
+    /* directed refinement */
+    if (Mark == -1 && MARKCLASS(theElement)==RED_CLASS)
     {
-      /* refinement with hanging nodes */
-      Mark = NO_REFINEMENT;
+      /* there is no rule for this pattern, switch to red */
+      Mark = RED;
     }
     else
+      ASSERT(Mark != -1);
+  }
+  else if (hFlag==0 && MARKCLASS(theElement)!=RED_CLASS)
+  {
+    /* refinement with hanging nodes */
+    Mark = NO_REFINEMENT;
+  }
+  else
+  {
+    /* refinement with closure (default) */
+                #ifdef __ANISOTROPIC__
+    if (MARKCLASS(theElement)==RED_CLASS && TAG(theElement)==PRISM)
     {
-      /* refinement with closure (default) */
-                        #ifdef __ANISOTROPIC__
-      if (MARKCLASS(theElement)==RED_CLASS && TAG(theElement)==PRISM)
+      ASSERT(USED(theElement)==1);
+      if (Mark==-1)
       {
-        ASSERT(USED(theElement)==1);
-        if (Mark==-1)
-        {
-          ASSERT(TAG(theElement)==PRISM);
-          /* to implement the anisotropic case for other elements */
-          /* and anisotropic refinements the initial anisotropic  */
-          /* rule is needed here. (980316 s.l.)                   */
-          Mark = PRI_QUADSECT;
-        }
-        else
-          SETUSED(theElement,0);
+        ASSERT(TAG(theElement)==PRISM);
+        /* to implement the anisotropic case for other elements */
+        /* and anisotropic refinements the initial anisotropic  */
+        /* rule is needed here. (980316 s.l.)                   */
+        Mark = PRI_QUADSECT;
       }
-                        #endif
-      ASSERT(Mark != -1);
+      else
+        SETUSED(theElement,0);
+    }
+                #endif
+    ASSERT(Mark != -1);
 
-      /* switch green class to red class? */
-      if (MARKCLASS(theElement)!=RED_CLASS &&
-          SWITCHCLASS(CLASS_OF_RULE(MARK2RULEADR(theElement,Mark))))
-      {
-        IFDEBUG(gm,1)
-        UserWriteF("   Switching MARKCLASS=%d for MARK=%d of EID=%d "
-                   "to RED_CLASS\n",
-                   MARKCLASS(theElement),Mark,ID(theElement));
-        ENDDEBUG
-        SETMARKCLASS(theElement,RED_CLASS);
-      }
+    /* switch green class to red class? */
+    if (MARKCLASS(theElement)!=RED_CLASS &&
+        SWITCHCLASS(CLASS_OF_RULE(MARK2RULEADR(theElement,Mark))))
+    {
+      IFDEBUG(gm,1)
+      UserWriteF("   Switching MARKCLASS=%d for MARK=%d of EID=%d "
+                 "to RED_CLASS\n",
+                 MARKCLASS(theElement),Mark,ID(theElement));
+      ENDDEBUG
+      SETMARKCLASS(theElement,RED_CLASS);
     }
+  }
 
-    REFINE_ELEMENT_LIST(1,theElement,"");
+  REFINE_ELEMENT_LIST(1,theElement,"");
 
-                #ifdef UG_DIM_3
-    /* choose best tet_red rule according to (*theFullRefRule)() */
-    if (TAG(theElement)==TETRAHEDRON && MARKCLASS(theElement)==RED_CLASS)
-    {
+        #ifdef UG_DIM_3
+  /* choose best tet_red rule according to (*theFullRefRule)() */
+  if (TAG(theElement)==TETRAHEDRON && MARKCLASS(theElement)==RED_CLASS)
+  {
 #ifndef DUNE_UGGRID_TET_RULESET
-      if ((Mark==TET_RED || Mark==TET_RED_0_5 ||
-           Mark==TET_RED_1_3))
+    if ((Mark==TET_RED || Mark==TET_RED_0_5 ||
+         Mark==TET_RED_1_3))
 #endif
-      {
-        PRINTDEBUG(gm,5,("FullRefRule() call with mark=%d\n",Mark))
+    {
+      PRINTDEBUG(gm,5,("FullRefRule() call with mark=%d\n",Mark))
 
-        Mark = (*theFullRefRule)(theElement);
-        assert( Mark==FULL_REFRULE_0_5 ||
-                Mark==FULL_REFRULE_1_3 ||
-                Mark==FULL_REFRULE_2_4);
-      }
+      Mark = (*theFullRefRule)(theElement);
+      assert( Mark==FULL_REFRULE_0_5 ||
+              Mark==FULL_REFRULE_1_3 ||
+              Mark==FULL_REFRULE_2_4);
     }
-                #endif
+  }
+        #endif
 
-    /* get new pattern from mark */
-    NewPattern = MARK2PAT(theElement,Mark);
-    IFDEBUG(gm,2)
-    UserWriteF("   thePattern=%d EdgePattern=%d SidePattern=%d NewPattern=%d Mark=%d\n",
-               thePattern,theEdgePattern,theSidePattern,NewPattern,Mark);
-    ENDDEBUG
+  /* get new pattern from mark */
+  NewPattern = MARK2PAT(theElement,Mark);
+  IFDEBUG(gm,2)
+  UserWriteF("   thePattern=%d EdgePattern=%d SidePattern=%d NewPattern=%d Mark=%d\n",
+             thePattern,theEdgePattern,theSidePattern,NewPattern,Mark);
+  ENDDEBUG
 
 
-    if (fifoFlag)
-    {
-      if (UpdateFIFOLists(theGrid,theElement,thePattern,NewPattern) != GM_OK) return(GM_OK);
-    }
-
-    if (Mark) (*cnt)++;
-    SETMARK(theElement,Mark);
+  if (fifoFlag)
+  {
+    if (UpdateFIFOLists(theGrid,theElement,thePattern,NewPattern) != GM_OK) return(GM_ERROR);
   }
 
+  if (Mark) (*cnt)++;
+  SETMARK(theElement,Mark);
+
+  return(GM_OK);
+}
+
+static INT SetElementRules (GRID *theGrid, ELEMENT *firstElement, INT *cnt)
+{
+  ELEMENT *theElement;
+
+  /* set refinement rules from edge- and sidepattern */
+  (*cnt) = 0;
+  for (theElement=firstElement; theElement!=NULL;
+       theElement=SUCCE(theElement))
+    if (SetElementRule(theGrid,theElement,cnt) != GM_OK) return(GM_OK);
+
   return(GM_OK);
 }
 
@@ -1671,46 +1860,54 @@ static INT ExchangeAddPatterns (GRID *theGrid)
    SetAddPatterns -
 
    SYNOPSIS:
+   static void SetElementAddPattern (const GRID *theGrid, ELEMENT *theElement);
    static INT SetAddPatterns (GRID *theGrid);
 
    PARAMETERS:
    .  theGrid - pointer to grid structure
+   .  theElement - element of theGrid
 
    DESCRIPTION:
+   The edges with edge nodes of red elements get ADDPATTERN=0, on all
+   elements of the grid or for theElement only.
 
    \return <ul>
    INT
  */
 /****************************************************************************/
 
-static INT SetAddPatterns (GRID *theGrid)
+static void SetElementAddPattern (const GRID *theGrid, ELEMENT *theElement)
 {
   INT j;
-  ELEMENT *theElement;
   EDGE    *theEdge;
 
-  /* set additional pattern on the edges */
-  for (theElement=PFIRSTELEMENT(theGrid); theElement!=NULL;
-       theElement=SUCCE(theElement))
-  {
-    if (MARKCLASS(theElement)!=RED_CLASS) continue;
+  if (MARKCLASS(theElement)!=RED_CLASS) return;
 
-    REFINE_ELEMENT_LIST(1,theElement,"SetAddPatterns(): addpattern=0");
+  REFINE_ELEMENT_LIST(1,theElement,"SetAddPatterns(): addpattern=0");
 
-    for (j=0; j<EDGES_OF_ELEM(theElement); j++)
-    {
-      /* no green elements for this edge if there is no edge node */
-      if (!NODE_OF_RULE(theElement,MARK(theElement),j))
-        continue;
+  for (j=0; j<EDGES_OF_ELEM(theElement); j++)
+  {
+    /* no green elements for this edge if there is no edge node */
+    if (!NODE_OF_RULE(theElement,MARK(theElement),j))
+      continue;
 
-      theEdge=GetEdge(CORNER_OF_EDGE_PTR(theElement,j,0),
-                      CORNER_OF_EDGE_PTR(theElement,j,1));
-      ASSERT(theEdge != NULL);
+    theEdge=GetEdge(theGrid,CORNER_OF_EDGE_PTR(theElement,j,0),
+                            CORNER_OF_EDGE_PTR(theElement,j,1));
+    ASSERT(theEdge != NULL);
 
-      /* ADDPATTERN is now set to 0 for all edges of red elements */
-      SETADDPATTERN(theEdge,0);
-    }
+    /* ADDPATTERN is now set to 0 for all edges of red elements */
+    SETADDPATTERN(theEdge,0);
   }
+}
+
+static INT SetAddPatterns (GRID *theGrid)
+{
+  ELEMENT *theElement;
+
+  /* set additional pattern on the edges */
+  for (theElement=PFIRSTELEMENT(theGrid); theElement!=NULL;
+       theElement=SUCCE(theElement))
+    SetElementAddPattern(theGrid,theElement);
 
         #ifdef ModelP
   if (ExchangeAddPatterns(theGrid)) RETURN(GM_FATAL);
@@ -1725,176 +1922,184 @@ static INT SetAddPatterns (GRID *theGrid)
    BuildGreenClosure -
 
    SYNOPSIS:
+   static void BuildElementGreenClosure (const GRID *theGrid, ELEMENT *theElement);
    static INT BuildGreenClosure (GRID *theGrid);
 
    PARAMETERS:
    .  theGrid - pointer to grid structure
+   .  theElement - element of theGrid
 
    DESCRIPTION:
+   The elements which are not red become green if they have an edge or
+   side node, on all elements of the grid or for theElement only.
 
    \return <ul>
    INT
  */
 /****************************************************************************/
 
-static INT BuildGreenClosure (const GRID *theGrid)
+static void BuildElementGreenClosure (const GRID *theGrid, ELEMENT *theElement)
 {
   INT i;
-  ELEMENT *theElement;
   EDGE    *theEdge;
         #ifdef UG_DIM_3
   INT j;
         #endif
 
-  /* build a green covering around the red elements */
-  for (theElement=PFIRSTELEMENT(theGrid); theElement!=NULL;
-       theElement=SUCCE(theElement))
-  {
-                #ifdef __ANISOTROPIC__
-    if (MARKCLASS(theElement)==RED_CLASS &&
-        !(TAG(theElement)==PRISM && MARK(theElement)==PRI_QUADSECT)) continue;
+        #ifdef __ANISOTROPIC__
+  if (MARKCLASS(theElement)==RED_CLASS &&
+      !(TAG(theElement)==PRISM && MARK(theElement)==PRI_QUADSECT)) return;
 
-    ASSERT(MARKCLASS(theElement)!=RED_CLASS ||
-           (MARKCLASS(theElement)==RED_CLASS && TAG(theElement)==PRISM
-            && MARK(theElement)==PRI_QUADSECT));
-                #else
-    if (MARKCLASS(theElement)==RED_CLASS) continue;
-                #endif
+  ASSERT(MARKCLASS(theElement)!=RED_CLASS ||
+         (MARKCLASS(theElement)==RED_CLASS && TAG(theElement)==PRISM
+          && MARK(theElement)==PRI_QUADSECT));
+        #else
+  if (MARKCLASS(theElement)==RED_CLASS) return;
+        #endif
 
-    SETUPDATE_GREEN(theElement,0);
+  SETUPDATE_GREEN(theElement,0);
 
-    /* if edge node exists element needs to be green */
-    for (i=0; i<EDGES_OF_ELEM(theElement); i++)
-    {
-      theEdge=GetEdge(CORNER_OF_EDGE_PTR(theElement,i,0),
-                      CORNER_OF_EDGE_PTR(theElement,i,1));
-      ASSERT(theEdge != NULL);
+  /* if edge node exists element needs to be green */
+  for (i=0; i<EDGES_OF_ELEM(theElement); i++)
+  {
+    theEdge=GetEdge(theGrid,CORNER_OF_EDGE_PTR(theElement,i,0),
+                            CORNER_OF_EDGE_PTR(theElement,i,1));
+    ASSERT(theEdge != NULL);
 
-      /* if edge is refined this will be a green element */
-      if (ADDPATTERN(theEdge) == 0)
-      {
-        /* for pyramids, prisms and hexhedra Patterns2Rules returns 0  */
-        /* for non red elements, because there is no complete rule set */
-        /* switch to mark COPY, because COPY rule refines no edges     */
+    /* if edge is refined this will be a green element */
+    if (ADDPATTERN(theEdge) == 0)
+    {
+      /* for pyramids, prisms and hexhedra Patterns2Rules returns 0  */
+      /* for non red elements, because there is no complete rule set */
+      /* switch to mark COPY, because COPY rule refines no edges     */
 #ifdef DUNE_UGGRID_TET_RULESET
-        if (DIM==3 && TAG(theElement)!=TETRAHEDRON)
+      if (DIM==3 && TAG(theElement)!=TETRAHEDRON)
 #else
-        if (DIM==3)
+      if (DIM==3)
 #endif
-        {
-          /* set to no-empty rule, e.g. COPY rule */
-                                        #ifdef __ANISOTROPIC__
-          if (MARKCLASS(theElement) != RED_CLASS)
-                                        #endif
-          SETMARK(theElement,COPY);
-
-          /* no existing edge node renew green refinement */
-          if (MIDNODE(theEdge)==NULL)
-          {
-            SETUPDATE_GREEN(theElement,1);
-          }
-        }
-        /* tetrahedra in 3D and 2D elements have a complete rule set */
-        else if (MARK(theElement) == NO_REFINEMENT)
-        {
-          IFDEBUG(gm,2)
-          UserWriteF("   ERROR: green tetrahedron with no rule! "
-                     "EID=%d TAG=%d "
-                     "REFINECLASS=%d REFINE=%d MARKCLASS=%d  MARK=%d\n",
-                     ID(theElement),TAG(theElement),REFINECLASS(theElement),
-                     REFINE(theElement),MARKCLASS(theElement),
-                     MARK(theElement));
-          ENDDEBUG
-        }
-
+      {
+        /* set to no-empty rule, e.g. COPY rule */
                                 #ifdef __ANISOTROPIC__
         if (MARKCLASS(theElement) != RED_CLASS)
                                 #endif
-        SETMARKCLASS(theElement,GREEN_CLASS);
+        SETMARK(theElement,COPY);
+
+        /* no existing edge node renew green refinement */
+        if (MIDNODE(theEdge)==NULL)
+        {
+          SETUPDATE_GREEN(theElement,1);
+        }
       }
-      else
+      /* tetrahedra in 3D and 2D elements have a complete rule set */
+      else if (MARK(theElement) == NO_REFINEMENT)
       {
-        /* existing edge node is deleted                         */
-        /* renew green refinement if element will be a green one */
-        if (MIDNODE(theEdge)!=NULL)
-          SETUPDATE_GREEN(theElement,1);
+        IFDEBUG(gm,2)
+        UserWriteF("   ERROR: green tetrahedron with no rule! "
+                   "EID=%d TAG=%d "
+                   "REFINECLASS=%d REFINE=%d MARKCLASS=%d  MARK=%d\n",
+                   ID(theElement),TAG(theElement),REFINECLASS(theElement),
+                   REFINE(theElement),MARKCLASS(theElement),
+                   MARK(theElement));
+        ENDDEBUG
       }
-    }
 
-                #ifdef UG_DIM_3
-    /* if side node exists element needs to be green */
-    for (i=0; i<SIDES_OF_ELEM(theElement); i++)
+                        #ifdef __ANISOTROPIC__
+      if (MARKCLASS(theElement) != RED_CLASS)
+                        #endif
+      SETMARKCLASS(theElement,GREEN_CLASS);
+    }
+    else
     {
-      ELEMENT *theNeighbor;
+      /* existing edge node is deleted                         */
+      /* renew green refinement if element will be a green one */
+      if (MIDNODE(theEdge)!=NULL)
+        SETUPDATE_GREEN(theElement,1);
+    }
+  }
 
-      theNeighbor = NBELEM(theElement,i);
+        #ifdef UG_DIM_3
+  /* if side node exists element needs to be green */
+  for (i=0; i<SIDES_OF_ELEM(theElement); i++)
+  {
+    ELEMENT *theNeighbor;
 
-      if (theNeighbor==NULL) continue;
+    theNeighbor = NBELEM(theElement,i);
 
-      for (j=0; j<SIDES_OF_ELEM(theNeighbor); j++)
-        if (NBELEM(theNeighbor,j) == theElement)
-          break;
+    if (theNeighbor==NULL) continue;
 
-                        #ifdef ModelP
-      if (j >= SIDES_OF_ELEM(theNeighbor))
-      {
-        ASSERT(EGHOST(theElement) && EGHOST(theNeighbor));
-        continue;
-      }
-                        #else
-      ASSERT(j<SIDES_OF_ELEM(theNeighbor));
-                        #endif
+    for (j=0; j<SIDES_OF_ELEM(theNeighbor); j++)
+      if (NBELEM(theNeighbor,j) == theElement)
+        break;
 
-      if (NODE_OF_RULE(theNeighbor,MARK(theNeighbor),
-                       EDGES_OF_ELEM(theNeighbor)+j))
-      {
+                #ifdef ModelP
+    if (j >= SIDES_OF_ELEM(theNeighbor))
+    {
+      ASSERT(EGHOST(theElement) && EGHOST(theNeighbor));
+      continue;
+    }
+                #else
+    ASSERT(j<SIDES_OF_ELEM(theNeighbor));
+                #endif
+
+    if (NODE_OF_RULE(theNeighbor,MARK(theNeighbor),
+                     EDGES_OF_ELEM(theNeighbor)+j))
+    {
 #ifdef DUNE_UGGRID_TET_RULESET
-        if (TAG(theNeighbor)==TETRAHEDRON)
-          printf("ERROR: no side nodes for tetrahedra! side=%d\n",j);
+      if (TAG(theNeighbor)==TETRAHEDRON)
+        printf("ERROR: no side nodes for tetrahedra! side=%d\n",j);
 #endif
-                                #ifdef __ANISOTROPIC__
-        if (MARKCLASS(theElement) != RED_CLASS)
-                                #endif
-        SETMARKCLASS(theElement,GREEN_CLASS);
-      }
+                        #ifdef __ANISOTROPIC__
+      if (MARKCLASS(theElement) != RED_CLASS)
+                        #endif
+      SETMARKCLASS(theElement,GREEN_CLASS);
+    }
 
 
-      /* side node change? */
-      if ((!NODE_OF_RULE(theNeighbor,REFINE(theNeighbor),
-                         EDGES_OF_ELEM(theNeighbor)+j) &&
-           NODE_OF_RULE(theNeighbor,MARK(theNeighbor),
-                        EDGES_OF_ELEM(theNeighbor)+j)) ||
-          (NODE_OF_RULE(theNeighbor,REFINE(theNeighbor),
-                        EDGES_OF_ELEM(theNeighbor)+j) &&
-           !NODE_OF_RULE(theNeighbor,MARK(theNeighbor),
-                         EDGES_OF_ELEM(theNeighbor)+j)))
-      {
-        SETUPDATE_GREEN(theElement,1);
-      }
+    /* side node change? */
+    if ((!NODE_OF_RULE(theNeighbor,REFINE(theNeighbor),
+                       EDGES_OF_ELEM(theNeighbor)+j) &&
+         NODE_OF_RULE(theNeighbor,MARK(theNeighbor),
+                      EDGES_OF_ELEM(theNeighbor)+j)) ||
+        (NODE_OF_RULE(theNeighbor,REFINE(theNeighbor),
+                      EDGES_OF_ELEM(theNeighbor)+j) &&
+         !NODE_OF_RULE(theNeighbor,MARK(theNeighbor),
+                       EDGES_OF_ELEM(theNeighbor)+j)))
+    {
+      SETUPDATE_GREEN(theElement,1);
     }
-                #endif
+  }
+        #endif
 
 
 #ifndef ModelP
-    /* if element is green before refinement and will be green after */
-    /* refinement and nothing changes -> reset USED flag             */
-    /* in parallel case: one communication to determine the minimum  */
-    /* over all copies of an green element would be needed           */
-    if (REFINECLASS(theElement)==GREEN_CLASS &&
-        MARKCLASS(theElement)==GREEN_CLASS && UPDATE_GREEN(theElement)==0)
-    {
-      /* do not renew green refinement */
-      SETUSED(theElement,0);
-    }
-                #ifdef __ANISOTROPIC__
-    if (MARKCLASS(theElement)==RED_CLASS && UPDATE_GREEN(theElement)==0)
-    {
-      ASSERT(TAG(theElement)==PRISM && MARK(theElement)==PRI_QUADSECT);
-      SETUSED(theElement,0);
-    }
-                #endif
-#endif
+  /* if element is green before refinement and will be green after */
+  /* refinement and nothing changes -> reset USED flag             */
+  /* in parallel case: one communication to determine the minimum  */
+  /* over all copies of an green element would be needed           */
+  if (REFINECLASS(theElement)==GREEN_CLASS &&
+      MARKCLASS(theElement)==GREEN_CLASS && UPDATE_GREEN(theElement)==0)
+  {
+    /* do not renew green refinement */
+    SETUSED(theElement,0);
   }
+        #ifdef __ANISOTROPIC__
+  if (MARKCLASS(theElement)==RED_CLASS && UPDATE_GREEN(theElement)==0)
+  {
+    ASSERT(TAG(theElement)==PRISM && MARK(theElement)==PRI_QUADSECT);
+    SETUSED(theElement,0);
+  }
+        #endif
+#endif
+}
+
+static INT BuildGreenClosure (const GRID *theGrid)
+{
+  ELEMENT *theElement;
+
+  /* build a green covering around the red elements */
+  for (theElement=PFIRSTELEMENT(theGrid); theElement!=NULL;
+       theElement=SUCCE(theElement))
+    BuildElementGreenClosure(theGrid,theElement);
 
   return(GM_OK);
 }
@@ -2055,6 +2260,357 @@ static INT CheckElementInfo (GRID *theGrid)
 #endif
 
 
+/****************************************************************************/
+/** \brief Add the elements around the edges of an element to a worklist
+
+   \param theElement - element whose neighborhood is added
+   \param list - the worklist, e.g. closureList
+
+   The elements sharing an edge with theElement are found by a search
+   through the side neighbors which share at least two corners with
+   theElement. They are flagged with THEFLAG and appended to list
+   unless they are flagged already.
+ */
+/****************************************************************************/
+
+static void AddClosureNeighbors (ELEMENT *theElement, std::vector<ELEMENT*>& list)
+{
+  /* the elements of this search, some dozens at most */
+  std::vector<ELEMENT*> visited(1,theElement);
+
+  for (std::size_t k=0; k<visited.size(); k++)
+  {
+    ELEMENT *theVisited = visited[k];
+
+    if (!THEFLAG(theVisited))
+    {
+      SETTHEFLAG(theVisited,1);
+      list.push_back(theVisited);
+    }
+
+    for (INT i=0; i<SIDES_OF_ELEM(theVisited); i++)
+    {
+      ELEMENT *theNeighbor = NBELEM(theVisited,i);
+      if (theNeighbor == NULL) continue;
+      if (std::find(visited.begin(),visited.end(),theNeighbor) != visited.end()) continue;
+
+      INT shared = 0;
+      for (INT j=0; j<CORNERS_OF_ELEM(theNeighbor); j++)
+        for (INT l=0; l<CORNERS_OF_ELEM(theElement); l++)
+          if (CORNER(theNeighbor,j) == CORNER(theElement,l))
+            shared++;
+
+      if (shared >= 2)
+        visited.push_back(theNeighbor);
+    }
+  }
+}
+
+/****************************************************************************/
+/** \brief Compute the closure from a worklist of elements
+
+   \param theGrid - pointer to grid structure
+
+   This function computes the same closure as the sweeps over all
+   elements in GridClosure, but visits all elements only once to reset
+   their marks and find the red and refined elements. Only the elements
+   sharing an edge with them, and in parallel the elements at the
+   processor interface, are given to the closure functions. All other
+   elements have no edge or side pattern and get the rule NO_REFINEMENT,
+   rule 0 of every element type.
+
+   If many elements are red or refined, as on the coarser levels, the
+   worklist holds all elements of the grid.
+
+   \return <ul>
+   .n   >0 elements will be refined
+   .n   =0 no elements will be refined
+   .n   =-1 an error occurred
+ */
+/****************************************************************************/
+
+static int WorklistClosure (GRID *theGrid)
+{
+  INT cnt,nElements;
+
+        #ifdef ModelP
+  const auto& context = theGrid->dddContext();
+  const bool parallel = (theGrid->ppifContext().procs() > 1);
+
+  /* elements at the processor interface, their edges may get patterns */
+  /* from other processors in the exchanges of the closure            */
+  std::vector<ELEMENT*> interfaceElements;
+        #endif
+
+  std::vector<ELEMENT*>& closureList = MYMG(theGrid)->closureList;
+  std::vector<ELEMENT*>& closureSeeds = MYMG(theGrid)->closureSeeds;
+
+  /* reset the elements like PrepareGridClosure(), ComputePatterns() */
+  /* and SetElementSidePatterns(), the red elements come first        */
+  closureList.clear();
+  closureSeeds.clear();
+  nElements = 0;
+  for (ELEMENT *theElement = PFIRSTELEMENT(theGrid); theElement != nullptr;
+       theElement=SUCCE(theElement))
+  {
+    nElements++;
+    SETTHEFLAG(theElement,0);
+    SETUSED(theElement,DIM==3);
+    if (EGHOST(theElement))
+    {
+      SETCOARSEN(theElement,0);
+      SETMARK(theElement,NO_REFINEMENT);
+      SETMARKCLASS(theElement,0);
+    }
+
+    /* the edge patterns of the red elements are set below */
+    if (MARKCLASS(theElement)==RED_CLASS)
+    {
+      SETTHEFLAG(theElement,1);
+      closureList.push_back(theElement);
+      continue;
+    }
+
+    ComputeElementPatterns(theGrid,theElement);
+    SETMARK(theElement,NO_REFINEMENT);
+
+    /* edges with edge nodes and side nodes which may disappear */
+    if (REFINE(theElement)!=NO_REFINEMENT)
+      closureSeeds.push_back(theElement);
+
+                #ifdef ModelP
+    if (parallel)
+      for (INT i=0; i<CORNERS_OF_ELEM(theElement); i++)
+        if (!DDD_InfoIsLocal(context,PARHDR(CORNER(theElement,i))))
+        {
+          interfaceElements.push_back(theElement);
+          break;
+        }
+                #endif
+  }
+  const std::size_t nRed = closureList.size();
+
+        #ifdef ModelP
+  /* objects copied from other processors during an adaption keep the */
+  /* patterns of their sender, they are at the processor interface    */
+  if (parallel)
+  {
+    for (std::size_t k=0; k<nRed; k++)
+      ResetElementEdgePatterns(theGrid,closureList[k]);
+    for (ELEMENT *theElement : interfaceElements)
+      ResetElementEdgePatterns(theGrid,theElement);
+  }
+        #endif
+
+  for (std::size_t k=0; k<nRed; k++)
+    ComputeElementPatterns(theGrid,closureList[k]);
+
+  std::size_t nInvolved = nRed + closureSeeds.size();
+        #ifdef ModelP
+  nInvolved += interfaceElements.size();
+        #endif
+
+  const bool sweep = (8*nInvolved > std::size_t(nElements));
+  if (sweep)
+  {
+    /* take all elements in the order of the grid */
+    closureList.clear();
+    for (ELEMENT *theElement = PFIRSTELEMENT(theGrid); theElement != nullptr;
+         theElement=SUCCE(theElement))
+    {
+      SETTHEFLAG(theElement,1);
+      closureList.push_back(theElement);
+    }
+  }
+  else
+  {
+    for (std::size_t k=0; k<nRed; k++)
+      AddClosureNeighbors(closureList[k],closureList);
+    for (ELEMENT *theElement : closureSeeds)
+      AddClosureNeighbors(theElement,closureList);
+                #ifdef ModelP
+    for (ELEMENT *theElement : interfaceElements)
+      if (!THEFLAG(theElement))
+      {
+        SETTHEFLAG(theElement,1);
+        closureList.push_back(theElement);
+      }
+                #endif
+  }
+
+        #ifdef UG_DIM_3
+                #if defined(ModelP) && defined(DUNE_UGGRID_TET_RULESET)
+  /* edge pattern is needed consistently in CorrectTetrahedronSidePattern() */
+  if (!refine_seq)
+  {
+    if (ExchangeEdgeClosureInfo(theGrid) != GM_OK) return(GM_ERROR);
+  }
+                #endif
+
+  /* set side patterns on the elements */
+  for (ELEMENT *theElement : closureList)
+    if (SetElementSidePattern(theElement,false) != GM_OK) RETURN(GM_ERROR);
+        #endif
+
+        #ifdef ModelP
+  if (ExchangeClosureInfo(theGrid) != GM_OK) RETURN(GM_ERROR);
+        #endif
+
+  /* set rules on the elements */
+  cnt = 0;
+  for (ELEMENT *theElement : closureList)
+    if (SetElementRule(theGrid,theElement,&cnt) != GM_OK) RETURN(GM_ERROR);
+
+  /* elements which became red have green neighbors too */
+  if (!sweep)
+  {
+    const std::size_t n = closureList.size();
+    for (std::size_t k=nRed; k<n; k++)
+      if (MARKCLASS(closureList[k])==RED_CLASS)
+        AddClosureNeighbors(closureList[k],closureList);
+  }
+
+  /* set patterns on all edges of red elements */
+  for (ELEMENT *theElement : closureList)
+    SetElementAddPattern(theGrid,theElement);
+        #ifdef ModelP
+  if (ExchangeAddPatterns(theGrid)) RETURN(GM_FATAL);
+        #endif
+
+  /* build the closure around the red elements */
+  for (ELEMENT *theElement : closureList)
+  {
+    BuildElementGreenClosure(theGrid,theElement);
+    SETTHEFLAG(theElement,0);
+  }
+
+  return(cnt);
+}
+
+#ifndef ModelP
+
+/****************************************************************************/
+/** \brief Compute the closure for the region around some elements
+
+   \param theGrid - pointer to grid structure
+   \param dirty - elements whose marks may differ from their refinement
+   \param up - closure of the upward pass of AdaptMultiGrid
+   \param region - returns the elements whose closure is computed
+
+   The rules of the closure depend on the red elements sharing an edge,
+   the green closure on the rules of the elements sharing an edge. So
+   only the elements within two edges of the dirty elements may get
+   another refinement than in the last adaption. This function computes
+   the closure for these region elements like WorklistClosure, with the
+   elements sharing an edge with the region as input. These keep their
+   marks, they are the same as after the last adaption.
+
+   \return <ul>
+   .n   number of region elements which will be refined
+   .n   =-1 an error occurred
+ */
+/****************************************************************************/
+
+static int RegionClosure (GRID *theGrid, const std::vector<ELEMENT*>& dirty, bool up,
+                          std::vector<ELEMENT*>& region)
+{
+  INT cnt;
+
+  /* the dirty elements and two rings of edge neighbors */
+  region.clear();
+  for (ELEMENT *theElement : dirty)
+    if (!THEFLAG(theElement))
+    {
+      SETTHEFLAG(theElement,1);
+      region.push_back(theElement);
+    }
+  std::size_t ring = 0;
+  for (INT i=0; i<2; i++)
+  {
+    const std::size_t n = region.size();
+    for (std::size_t k=ring; k<n; k++)
+      AddClosureNeighbors(region[k],region);
+    ring = n;
+  }
+
+  /* and their neighbors, which keep their marks */
+  std::vector<ELEMENT*> halo;
+  for (std::size_t k=ring; k<region.size(); k++)
+    AddClosureNeighbors(region[k],halo);
+
+  struct ElementMarks { INT mark, markclass, used; };
+  std::vector<ElementMarks> haloMarks;
+  haloMarks.reserve(halo.size());
+  for (ELEMENT *theElement : halo)
+    haloMarks.push_back({(INT)MARK(theElement),(INT)MARKCLASS(theElement),(INT)USED(theElement)});
+
+  /* reset the elements like WorklistClosure() */
+  for (ELEMENT *theElement : region)
+  {
+    /* leave only regular marks */
+    if (up && !(ECLASS(theElement)==RED_CLASS && MARKCLASS(theElement)==RED_CLASS))
+      SETMARK(theElement,NO_REFINEMENT);
+
+    SETUSED(theElement,DIM==3);
+    ComputeElementPatterns(theGrid,theElement);
+    if (MARKCLASS(theElement)!=RED_CLASS)
+      SETMARK(theElement,NO_REFINEMENT);
+  }
+  for (ELEMENT *theElement : halo)
+  {
+    if (up && !(ECLASS(theElement)==RED_CLASS && MARKCLASS(theElement)==RED_CLASS))
+      SETMARK(theElement,NO_REFINEMENT);
+
+    ComputeElementPatterns(theGrid,theElement);
+  }
+
+        #ifdef UG_DIM_3
+  /* set side patterns on the elements, with the flagged neighbors only */
+  for (ELEMENT *theElement : region)
+    if (SetElementSidePattern(theElement,true) != GM_OK) RETURN(GM_ERROR);
+  for (ELEMENT *theElement : halo)
+    if (SetElementSidePattern(theElement,true) != GM_OK) RETURN(GM_ERROR);
+        #endif
+
+  for (std::size_t k=0; k<halo.size(); k++)
+  {
+    SETMARK(halo[k],haloMarks[k].mark);
+    SETMARKCLASS(halo[k],haloMarks[k].markclass);
+    SETUSED(halo[k],haloMarks[k].used);
+  }
+
+  /* set rules on the region elements */
+  cnt = 0;
+  for (ELEMENT *theElement : region)
+    if (SetElementRule(theGrid,theElement,&cnt) != GM_OK) RETURN(GM_ERROR);
+
+  /* set patterns on all edges of red elements */
+  for (ELEMENT *theElement : region)
+    SetElementAddPattern(theGrid,theElement);
+  for (ELEMENT *theElement : halo)
+    SetElementAddPattern(theGrid,theElement);
+
+  /* build the closure around the red elements */
+  for (ELEMENT *theElement : region)
+    BuildElementGreenClosure(theGrid,theElement);
+
+  for (ELEMENT *theElement : region)
+    SETTHEFLAG(theElement,0);
+  for (ELEMENT *theElement : halo)
+    SETTHEFLAG(theElement,0);
+
+  /* the edges of this grid get patterns, see ResetClosurePatterns() */
+  MULTIGRID *theMG = MYMG(theGrid);
+  theMG->closureGrid = theGrid;
+  theMG->closureSweep = false;
+  theMG->closureList = region;
+  theMG->closureList.insert(theMG->closureList.end(),halo.begin(),halo.end());
+
+  return(cnt);
+}
+#endif
+
+
 /****************************************************************************/
 /*																			*/
 /* Function:  GridClosure                                                                                                       */
@@ -2095,6 +2651,22 @@ static int GridClosure (GRID *theGrid)
 {
   INT cnt;
 
+  /* the edges of this grid get patterns, see ResetClosurePatterns() */
+  MULTIGRID *theMG = MYMG(theGrid);
+  theMG->closureGrid = theGrid;
+  theMG->closureSweep = fifoFlag || !MG_CLOSURE_WORKLIST(theMG);
+
+  if (!theMG->closureSweep)
+  {
+    cnt = WorklistClosure(theGrid);
+
+                #if defined(Debug) && defined(ModelP)
+    if (cnt >= 0 && CheckElementInfo(theGrid)) RETURN(GM_ERROR);
+                #endif
+
+    return(cnt);
+  }
+
   /* initialize used control word entries */
   if (PrepareGridClosure(theGrid) != GM_OK) RETURN(GM_ERROR);
 
@@ -2501,13 +3073,16 @@ static INT RestrictElementMark(ELEMENT *theElement)
    RestrictMarks - restrict refinement marks when going down
 
    SYNOPSIS:
+   static INT RestrictElementMarks (ELEMENT *theElement);
    static INT RestrictMarks (GRID *theGrid);
 
    PARAMETERS:
+   .  theElement - element whose sons are marked
    .  theGrid - pointer to grid structure
 
    DESCRIPTION:
-   This function restricts refinement marks when going down
+   This function restricts refinement marks when going down, from the
+   sons of theElement or of all elements of theGrid.
 
    \return <ul>
    INT
@@ -2516,99 +3091,107 @@ static INT RestrictElementMark(ELEMENT *theElement)
  */
 /****************************************************************************/
 
-static INT RestrictMarks (const GRID *theGrid)
+static INT RestrictElementMarks (ELEMENT *theElement)
 {
-  ELEMENT *theElement,*SonList[MAX_SONS];
+  ELEMENT *SonList[MAX_SONS];
   INT flag;
 
-  for (theElement=FIRSTELEMENT(theGrid); theElement!=NULL;
-       theElement=SUCCE(theElement))
+  if (GetSons(theElement,SonList)!=GM_OK) RETURN(GM_ERROR);
+
+  if (hFlag)
   {
-    if (GetSons(theElement,SonList)!=GM_OK) RETURN(GM_ERROR);
+    if (
+      /* if element is not refined anyway,                   */
+      /* then there are no restrictions to apply             */
+      REFINE(theElement) == NO_REFINEMENT ||
+
+      /* irregular elements are marked by estimator,         */
+      /* because they are leaf elements                      */
+      ECLASS(theElement) == YELLOW_CLASS ||
+      ECLASS(theElement) == GREEN_CLASS ||
+
+      /* regular elements with YELLOW_CLASS copies are       */
+      /* marked by estimator, because the marks are dropped  */
+      REFINECLASS(theElement) == YELLOW_CLASS
+      )
+    {
+      return(GM_OK);
+    }
 
-    if (hFlag)
+    /* regular elements with GREEN_CLASS refinement */
+    /* go to no refinement or red refinement        */
+    if (REFINECLASS(theElement)==GREEN_CLASS)
     {
-      if (
-        /* if element is not refined anyway,                   */
-        /* then there are no restrictions to apply             */
-        REFINE(theElement) == NO_REFINEMENT ||
-
-        /* irregular elements are marked by estimator,         */
-        /* because they are leaf elements                      */
-        ECLASS(theElement) == YELLOW_CLASS ||
-        ECLASS(theElement) == GREEN_CLASS ||
-
-        /* regular elements with YELLOW_CLASS copies are       */
-        /* marked by estimator, because the marks are dropped  */
-        REFINECLASS(theElement) == YELLOW_CLASS
-        )
+      for (UINT i=0; i<NSONS(theElement); i++)
       {
-        continue;
-      }
+                                #ifdef ModelP
+        if (SonList[i] == NULL) break;
+                                #endif
 
-      /* regular elements with GREEN_CLASS refinement */
-      /* go to no refinement or red refinement        */
-      if (REFINECLASS(theElement)==GREEN_CLASS)
-      {
-        for (UINT i=0; i<NSONS(theElement); i++)
+        /* Is the son marked for further refinement */
+        /* (copies keep their marks outside the region of */
+        /* an incremental AdaptMultiGrid)                 */
+        if (MARK(SonList[i])>NO_REFINEMENT &&
+            MARKCLASS(SonList[i])!=YELLOW_CLASS)
         {
-                                        #ifdef ModelP
-          if (SonList[i] == NULL) break;
-                                        #endif
+          if (RestrictElementMark(theElement)) RETURN(GM_ERROR);
 
-          /* Is the son marked for further refinement */
-          if (MARK(SonList[i])>NO_REFINEMENT)
-          {
-            if (RestrictElementMark(theElement)) RETURN(GM_ERROR);
-
-            /* this must be done only once for each element */
-            break;
-          }
+          /* this must be done only once for each element */
+          break;
         }
-        continue;
       }
+      return(GM_OK);
+    }
 
-      /* regular elements with regular refinement are */
-      /* the only ones to coarsen                     */
-      if (REFINECLASS(theElement) == RED_CLASS)
-      {
-                                #ifndef __ANISOTROPIC__
-        SETMARK(theElement,REFINE(theElement));
-        SETMARKCLASS(theElement,REFINECLASS(theElement));
-                                #else
-        ASSERT(MARK(theElement)>=1);
-                                #endif
-      }
+    /* regular elements with regular refinement are */
+    /* the only ones to coarsen                     */
+    if (REFINECLASS(theElement) == RED_CLASS)
+    {
+                        #ifndef __ANISOTROPIC__
+      SETMARK(theElement,REFINE(theElement));
+      SETMARKCLASS(theElement,REFINECLASS(theElement));
+                        #else
+      ASSERT(MARK(theElement)>=1);
+                        #endif
     }
+  }
 
-                #ifdef ModelP
-    /* if no (or not all) sons are found by GetSons() on */
-    /* this proc then coarsening is not allowed          */
-    if (REFINECLASS(theElement)==RED_CLASS &&
-        SonList[0]==NULL) continue;
-                #endif
+        #ifdef ModelP
+  /* if no (or not all) sons are found by GetSons() on */
+  /* this proc then coarsening is not allowed          */
+  if (REFINECLASS(theElement)==RED_CLASS &&
+      SonList[0]==NULL) return(GM_OK);
+        #endif
 
-    flag = 0;
-    for (UINT i=0; i < MAX_SONS && SonList[i]!=NULL; i++)
+  flag = 0;
+  for (UINT i=0; i < MAX_SONS && SonList[i]!=NULL; i++)
+  {
+    /* if not all sons are marked no unrefinement is possible */
+    if (!COARSEN(SonList[i]) || REFINECLASS(SonList[i])==RED_CLASS)
     {
-      /* if not all sons are marked no unrefinement is possible */
-      if (!COARSEN(SonList[i]) || REFINECLASS(SonList[i])==RED_CLASS)
-      {
-        flag = 1;
-        break;
-      }
+      flag = 1;
+      break;
     }
+  }
 
-    if (flag) continue;
+  if (flag) return(GM_OK);
 
-    /* preserve regular refinement marks */
-    if (hFlag==0 && SonList[0]==NULL) continue;
+  /* preserve regular refinement marks */
+  if (hFlag==0 && SonList[0]==NULL) return(GM_OK);
 
-    /* remove refinement */
-    SETMARK(theElement,NO_REFINEMENT);
-    SETMARKCLASS(theElement,NO_CLASS);
-    SETCOARSEN(theElement,1);
-  }
+  /* remove refinement */
+  SETMARK(theElement,NO_REFINEMENT);
+  SETMARKCLASS(theElement,NO_CLASS);
+  SETCOARSEN(theElement,1);
+
+  return(GM_OK);
+}
+
+static INT RestrictMarks (const GRID *theGrid)
+{
+  for (ELEMENT *theElement=FIRSTELEMENT(theGrid); theElement!=NULL;
+       theElement=SUCCE(theElement))
+    if (RestrictElementMarks(theElement)!=GM_OK) RETURN(GM_ERROR);
 
   return(GM_OK);
 }
@@ -2673,34 +3256,265 @@ static int ComputeCopies (GRID *theGrid)
   }
   else
   {
-    PropagateNextNodeClasses(theGrid);
+    PropagateNextNodeClasses(theGrid);
+  }
+
+  /* an element is copied if it has a dof of class 2 and higher */
+  for (theElement=PFIRSTELEMENT(theGrid); theElement!=NULL;
+       theElement=SUCCE(theElement))
+  {
+    INT maxclass = 0;
+
+    if ((MARK(theElement)==NO_REFINEMENT)&&
+        ((maxclass=MaxNextNodeClass(theElement))>=MINVNCLASS))
+    {
+      PRINTDEBUG(gm,1,(PFMT "ComputeCopies(): level=%d e=" EID_FMTX "yellow marked\n",
+                       me,LEVEL(theElement),EID_PRTX(theElement)));
+      SETMARK(theElement,COPY);
+      SETMARKCLASS(theElement,YELLOW_CLASS);
+      cnt++;
+    }
+    else
+    {
+      PRINTDEBUG(gm,1,(PFMT "ComputeCopies(): level=%d e=" EID_FMTX "not yellow marked"
+                       " mark=%d maxclass=%d\n",
+                       me,LEVEL(theElement),EID_PRTX(theElement),MARK(theElement),maxclass));
+    }
+  }
+
+  return(cnt);
+}
+
+#ifndef ModelP
+
+/****************************************************************************/
+/** \brief Append the elements containing some nodes to a list
+
+   \param start - element containing the nodes
+   \param theNodes - the nodes
+   \param n - number of nodes
+   \param list - elements are appended unless flagged with THEFLAG
+
+   The elements are found by a search through the side neighbors of start
+   containing all nodes, they are flagged with THEFLAG.
+ */
+/****************************************************************************/
+
+static void AddElementsOfNodes (ELEMENT *start, NODE *const *theNodes, INT n,
+                                std::vector<ELEMENT*>& list)
+{
+  /* the elements of this search, some dozens at most */
+  std::vector<ELEMENT*> visited(1,start);
+
+  for (std::size_t k=0; k<visited.size(); k++)
+  {
+    ELEMENT *theVisited = visited[k];
+
+    if (!THEFLAG(theVisited))
+    {
+      SETTHEFLAG(theVisited,1);
+      list.push_back(theVisited);
+    }
+
+    for (INT i=0; i<SIDES_OF_ELEM(theVisited); i++)
+    {
+      ELEMENT *theNeighbor = NBELEM(theVisited,i);
+      if (theNeighbor == NULL) continue;
+      if (std::find(visited.begin(),visited.end(),theNeighbor) != visited.end()) continue;
+
+      INT found = 0;
+      for (INT j=0; j<CORNERS_OF_ELEM(theNeighbor); j++)
+        for (INT l=0; l<n; l++)
+          if (CORNER(theNeighbor,j) == theNodes[l])
+            found++;
+
+      if (found == n)
+        visited.push_back(theNeighbor);
+    }
+  }
+}
+
+/* append the elements sharing a corner with the elements from list[begin]
+   on to list, their corners are flagged with THEFLAG and appended to nodes */
+static void AddCornerNeighbors (std::vector<ELEMENT*>& list, std::size_t begin,
+                                std::vector<NODE*>& nodes)
+{
+  const std::size_t end = list.size();
+  for (std::size_t k=begin; k<end; k++)
+  {
+    ELEMENT *theElement = list[k];
+    for (INT i=0; i<CORNERS_OF_ELEM(theElement); i++)
+    {
+      NODE *theNode = CORNER(theElement,i);
+      if (THEFLAG(theNode)) continue;
+      SETTHEFLAG(theNode,1);
+      nodes.push_back(theNode);
+      AddElementsOfNodes(theElement,&theNode,1,list);
+    }
+  }
+}
+
+/****************************************************************************/
+/** \brief Update the node classes around some elements
+
+   \param seeds - elements whose seed of class 3 may have changed, or which
+                  are new
+   \param next - update NNCLASS for the copies on the next level, else
+                 NCLASS with the green and red elements as seeds
+   \param region - returns the elements whose nodes may change their class
+
+   The class of a node is 3 if an element seeds it, else one less than
+   the highest class of a node of an element around it, but at least 0.
+   So only nodes within two elements of the seeds change their classes,
+   like PropagateNodeClasses() and PropagateNextNodeClasses() compute
+   them, from all elements around these nodes.
+ */
+/****************************************************************************/
+
+static void UpdateNodeClasses (const std::vector<ELEMENT*>& seeds, bool next,
+                               std::vector<ELEMENT*>& region)
+{
+  const auto nodeClass = [next](const NODE *theNode) -> INT {
+                           return next ? NNCLASS(theNode) : NCLASS(theNode);
+                         };
+  const auto setNodeClass = [next](NODE *theNode, INT nclass) {
+                              if (next)
+                                SETNNCLASS(theNode,nclass);
+                              else
+                                SETNCLASS(theNode,nclass);
+                            };
+  const auto seeded = [next](const ELEMENT *theElement) {
+                        if (next)
+                          return (MARK(theElement)!=NO_REFINEMENT &&
+                                  (MARKCLASS(theElement)==RED_CLASS ||
+                                   MARKCLASS(theElement)==GREEN_CLASS));
+                        return (ECLASS(theElement)>=GREEN_CLASS);
+                      };
+
+  region.clear();
+  for (ELEMENT *theElement : seeds)
+    if (!THEFLAG(theElement))
+    {
+      SETTHEFLAG(theElement,1);
+      region.push_back(theElement);
+    }
+
+  /* the nodes within two elements of the seeds and all elements around them */
+  std::vector<NODE*> nodes;
+  std::size_t ring = 0;
+  for (INT i=0; i<3; i++)
+  {
+    const std::size_t n = region.size();
+    AddCornerNeighbors(region,ring,nodes);
+    ring = n;
+  }
+
+  for (NODE *theNode : nodes)
+  {
+    SETTHEFLAG(theNode,0);
+    setNodeClass(theNode,0);
+  }
+  for (ELEMENT *theElement : region)
+  {
+    SETTHEFLAG(theElement,0);
+    if (seeded(theElement))
+      for (INT i=0; i<CORNERS_OF_ELEM(theElement); i++)
+        setNodeClass(CORNER(theElement,i),3);
+  }
+
+  /* propagate the classes 3 and 2 like PropagateNodeClass() */
+  for (INT nclass=3; nclass>=2; nclass--)
+    for (ELEMENT *theElement : region)
+    {
+      INT m = 0;
+      for (INT i=0; i<CORNERS_OF_ELEM(theElement); i++)
+        m = std::max(m,nodeClass(CORNER(theElement,i)));
+      if (m == nclass)
+        for (INT i=0; i<CORNERS_OF_ELEM(theElement); i++)
+          if (nodeClass(CORNER(theElement,i)) < nclass)
+            setNodeClass(CORNER(theElement,i),nclass-1);
+    }
+}
+
+/****************************************************************************/
+/** \brief Determine the copy elements around the region of RegionClosure
+
+   \param region - elements of the last RegionClosure
+   \param sons - elements created by the last AdaptGrid with their neighbors
+   \param adapt - elements outside the region whose copy mark changes are appended
+   \param classElements - the elements whose nodes change NNCLASS are appended
+
+   This function does the same as ComputeCopies for the elements whose
+   seeds changed in the closure, see UpdateNodeClasses. The copies outside
+   the region get their marks from the closure, i.e. no refinement, first.
+
+   \return number of copy elements around the region
+ */
+/****************************************************************************/
+
+static int RegionCopies (const std::vector<ELEMENT*>& region, const std::vector<ELEMENT*>& sons,
+                         std::vector<ELEMENT*>& adapt, std::vector<ELEMENT*>& classElements)
+{
+  int cnt = 0;
+
+  /* elements which seed dofs of class 3 now or after the last adaption */
+  std::vector<ELEMENT*> seeds(sons);
+  for (ELEMENT *theElement : region)
+  {
+    const bool refined = (REFINE(theElement)!=NO_REFINEMENT &&
+                          (REFINECLASS(theElement)==RED_CLASS ||
+                           REFINECLASS(theElement)==GREEN_CLASS));
+    const bool marked = (MARK(theElement)!=NO_REFINEMENT &&
+                         (MARKCLASS(theElement)==RED_CLASS ||
+                          MARKCLASS(theElement)==GREEN_CLASS));
+    if (refined != marked)
+      seeds.push_back(theElement);
   }
 
+  std::vector<ELEMENT*> around;
+  UpdateNodeClasses(seeds,true,around);
+
   /* an element is copied if it has a dof of class 2 and higher */
-  for (theElement=PFIRSTELEMENT(theGrid); theElement!=NULL;
-       theElement=SUCCE(theElement))
+  for (ELEMENT *theElement : region)
   {
-    INT maxclass = 0;
+    SETTHEFLAG(theElement,1);
+    if (MARK(theElement)==NO_REFINEMENT &&
+        MaxNextNodeClass(theElement)>=MINVNCLASS)
+    {
+      SETMARK(theElement,COPY);
+      SETMARKCLASS(theElement,YELLOW_CLASS);
+      cnt++;
+    }
+  }
+  for (ELEMENT *theElement : around)
+  {
+    if (THEFLAG(theElement)) continue;
 
-    if ((MARK(theElement)==NO_REFINEMENT)&&
-        ((maxclass=MaxNextNodeClass(theElement))>=MINVNCLASS))
+    const bool copy = (MARKCLASS(theElement)==YELLOW_CLASS);
+    if ((copy || MARK(theElement)==NO_REFINEMENT) &&
+        MaxNextNodeClass(theElement)>=MINVNCLASS)
     {
-      PRINTDEBUG(gm,1,(PFMT "ComputeCopies(): level=%d e=" EID_FMTX "yellow marked\n",
-                       me,LEVEL(theElement),EID_PRTX(theElement)));
       SETMARK(theElement,COPY);
       SETMARKCLASS(theElement,YELLOW_CLASS);
       cnt++;
     }
-    else
+    else if (copy)
     {
-      PRINTDEBUG(gm,1,(PFMT "ComputeCopies(): level=%d e=" EID_FMTX "not yellow marked"
-                       " mark=%d maxclass=%d\n",
-                       me,LEVEL(theElement),EID_PRTX(theElement),MARK(theElement),maxclass));
+      SETMARK(theElement,NO_REFINEMENT);
+      SETMARKCLASS(theElement,NO_CLASS);
     }
+
+    if (REF_TYPE_CHANGES(theElement))
+      adapt.push_back(theElement);
   }
+  for (ELEMENT *theElement : region)
+    SETTHEFLAG(theElement,0);
+
+  classElements.insert(classElements.end(),around.begin(),around.end());
 
   return(cnt);
 }
+#endif
 
 /****************************************************************************/
 /*
@@ -2856,8 +3670,8 @@ static int UpdateContext (GRID *theGrid, ELEMENT *theElement, NODE **theElementC
 
     if (MARKED_NEW_GREEN(theElement))
     {
-      const EDGE* theEdge = GetEdge(CORNER(theElement,Corner0),
-                                    CORNER(theElement,Corner1));
+      const EDGE* theEdge = GetEdge(DOWNGRID(theGrid),CORNER(theElement,Corner0),
+                                                      CORNER(theElement,Corner1));
       ASSERT(theEdge != NULL);
 
       if (ADDPATTERN(theEdge) == 0)
@@ -2893,7 +3707,7 @@ static int UpdateContext (GRID *theGrid, ELEMENT *theElement, NODE **theElementC
       if (MidNodes[i]!=NULL) continue;
       const NODE* Node0 = CORNER(theElement,Corner0);
       const NODE* Node1 = CORNER(theElement,Corner1);
-      const EDGE* theEdge = GetEdge(Node0,Node1);
+      const EDGE* theEdge = GetEdge(DOWNGRID(theGrid),Node0,Node1);
       if (theEdge == nullptr)
         RETURN(GM_FATAL);
       MidNodes[i] = MIDNODE(theEdge);
@@ -3031,8 +3845,8 @@ static int UpdateContext (GRID *theGrid, ELEMENT *theElement, NODE **theElementC
       ASSERT(SideNodes[i]!=NULL);
       for (INT j = 0; j < EDGES_OF_SIDE(theElement,i); j++)
       {
-        const EDGE *fatherEdge = GetEdge(CORNER_OF_EDGE_PTR(theElement,EDGE_OF_SIDE(theElement,i,j),0),
-                                         CORNER_OF_EDGE_PTR(theElement,EDGE_OF_SIDE(theElement,i,j),1));
+        const EDGE *fatherEdge = GetEdge(DOWNGRID(theGrid),CORNER_OF_EDGE_PTR(theElement,EDGE_OF_SIDE(theElement,i,j),0),
+                                                           CORNER_OF_EDGE_PTR(theElement,EDGE_OF_SIDE(theElement,i,j),1));
 
         [[maybe_unused]] const NODE* Node0 = MIDNODE(fatherEdge);
 
@@ -5374,14 +6188,22 @@ static INT RefineElement (GRID *UpGrid, ELEMENT *theElement,NODE** theNodeContex
    AdaptGrid - adapt one level of the multigrid
 
    SYNOPSIS:
-   static int AdaptGrid (GRID *theGrid, INT *nadapted)
+   static int AdaptGrid (GRID *theGrid, INT *nadapted,
+                         const std::vector<ELEMENT*> *elements,
+                         std::vector<ELEMENT*>& changed)
 
    PARAMETERS:
    \param theGrid - grid level to refine
    \param nadapted - number elements have been changed
+   \param elements - sequential only: elements to refine in the order of
+                     their ids, or NULL for all elements of theGrid
+   \param changed - sequential only: the elements which have been changed
 
    DESCRIPTION:
-   This function refines one level of the grid
+   This function refines one level of the grid. In sequential builds the
+   sons of the changed elements are added to the createdElements of the
+   multigrid, and the new boundary vertices are evaluated together at the
+   end, see 'ProjectBoundaryVertices'.
 
    \return <ul>
    INT
@@ -5393,7 +6215,9 @@ static INT RefineElement (GRID *UpGrid, ELEMENT *theElement,NODE** theNodeContex
 #ifdef ModelP
 static int AdaptLocalGrid (GRID *theGrid, INT *nadapted)
 #else
-static int AdaptGrid (GRID *theGrid, INT *nadapted)
+static int AdaptGrid (GRID *theGrid, INT *nadapted,
+                      const std::vector<ELEMENT*> *elements,
+                      std::vector<ELEMENT*>& changed)
 #endif
 {
   INT modified = 0;
@@ -5409,6 +6233,20 @@ static int AdaptGrid (GRID *theGrid, INT *nadapted)
 
   REFINE_GRID_LIST(1,MYMG(theGrid),GLEVEL(theGrid),("AdaptGrid(%d):\n",GLEVEL(theGrid)),"");
 
+#ifndef ModelP
+  changed.clear();
+  MYMG(theGrid)->unprojectedVertices.clear();
+  MYMG(theGrid)->unplacedCenterVertices.clear();
+
+  /* the next element of the list or of the grid */
+  std::size_t next = 0;
+  const auto nextElement = [&](ELEMENT *theElement) -> ELEMENT* {
+                             if (elements == nullptr)
+                               return (theElement == nullptr) ? FIRSTELEMENT(theGrid) : SUCCE(theElement);
+                             return (next < elements->size()) ? (*elements)[next++] : nullptr;
+                           };
+#endif
+
         #ifdef IDENT_ONLY_NEW
   /* reset ident flags for old objects */
   for (NODE *theNode = PFIRSTNODE(UpGrid); theNode != nullptr; theNode = SUCCN(theNode))
@@ -5418,8 +6256,8 @@ static int AdaptGrid (GRID *theGrid, INT *nadapted)
   {
     for (INT i = 0; i < EDGES_OF_ELEM(theElement); i++)
     {
-      EDGE *theEdge = GetEdge(CORNER_OF_EDGE_PTR(theElement, i, 0),
-                              CORNER_OF_EDGE_PTR(theElement, i, 1));
+      EDGE *theEdge = GetEdge(UpGrid,CORNER_OF_EDGE_PTR(theElement, i, 0),
+                                     CORNER_OF_EDGE_PTR(theElement, i, 1));
       SETNEW_EDIDENT(theEdge, 0);
     }
   }
@@ -5429,10 +6267,17 @@ static int AdaptGrid (GRID *theGrid, INT *nadapted)
   /* ModelP: first loop over master elems, then loop over ghost elems */
   /* this assures that no unnecessary disposures of objects are done  */
   /* which may cause trouble during identification (s.l. 9803020      */
+#ifdef ModelP
   for (ELEMENT *theElement = FIRSTELEMENT(theGrid); theElement != nullptr;
        theElement=NextElement)
   {
     NextElement = SUCCE(theElement);
+#else
+  for (ELEMENT *theElement = nextElement(nullptr); theElement != nullptr;
+       theElement=NextElement)
+  {
+    NextElement = nextElement(theElement);
+#endif
                 #ifdef ModelP
     /* loop over master elems first, then over ghost elems */
     if (NextElement == NULL) NextElement=PFIRSTELEMENT(theGrid);
@@ -5477,6 +6322,10 @@ static int AdaptGrid (GRID *theGrid, INT *nadapted)
 
       REFINE_ELEMENT_LIST(1,theElement,"REFINING element: ");
 
+#ifndef ModelP
+      changed.push_back(theElement);
+#endif
+
       if (UnrefineElement(UpGrid,theElement))
         RETURN(GM_FATAL);
 
@@ -5563,6 +6412,22 @@ static int AdaptGrid (GRID *theGrid, INT *nadapted)
     SETCOARSEN(theElement,0);
   }
 
+#ifndef ModelP
+  /* the new boundary vertices of the level, see MG_BOUNDARY_BATCH */
+  if (ProjectBoundaryVertices(UpGrid)!=GM_OK)
+    RETURN(GM_FATAL);
+
+  /* the sons of the changed elements are new */
+  for (ELEMENT *theElement : changed)
+  {
+    ELEMENT *SonList[MAX_SONS];
+    if (GetAllSons(theElement,SonList)!=GM_OK)
+      RETURN(GM_FATAL);
+    for (INT i=0; i<MAX_SONS && SonList[i]!=NULL; i++)
+      MYMG(theGrid)->createdElements.push_back(SonList[i]);
+  }
+#endif
+
   if (UG_GlobalMaxINT(theGrid->ppifContext(), modified))
   {
     /* reset (multi)grid status */
@@ -5828,10 +6693,17 @@ static INT      PreProcessAdaptMultiGrid(MULTIGRID *theMG)
   return(0);
 }
 
-static INT      PostProcessAdaptMultiGrid(MULTIGRID *theMG)
+/* classElements: the elements whose side vectors may change their classes,
+   or NULL to compute the classes of all vectors */
+static INT      PostProcessAdaptMultiGrid(MULTIGRID *theMG,
+                                          const std::vector<ELEMENT*> *classElements)
 {
   START_TIMER(algebra_timer)
-  if (CreateAlgebra(theMG)) REP_ERR_RETURN(1);
+  if (classElements == nullptr)
+  {
+    if (CreateAlgebra(theMG)) REP_ERR_RETURN(1);
+  }
+  else if (UpdateSurfaceClasses(theMG,*classElements)) REP_ERR_RETURN(1);
   SUM_TIMER(algebra_timer)
 
   REFINE_MULTIGRID_LIST(1,theMG,"END AdaptMultiGrid():\n","","");
@@ -5858,13 +6730,347 @@ static INT      PostProcessAdaptMultiGrid(MULTIGRID *theMG)
   return(0);
 }
 
+#ifndef ModelP
+
+/* flag the elements below theElement with THEFLAG */
+static void FlagDescendants (const ELEMENT *theElement)
+{
+  ELEMENT *SonList[MAX_SONS];
+
+  if (GetAllSons(theElement,SonList)!=GM_OK) return;
+  for (INT i=0; i<MAX_SONS && SonList[i]!=NULL; i++)
+  {
+    SETTHEFLAG(SonList[i],1);
+    FlagDescendants(SonList[i]);
+  }
+}
+
+/* remove the elements flagged with THEFLAG from list */
+static void RemoveFlagged (std::vector<ELEMENT*>& list)
+{
+  list.erase(std::remove_if(list.begin(),list.end(),
+                            [](const ELEMENT *theElement) { return THEFLAG(theElement); }),
+             list.end());
+}
+
+/****************************************************************************/
+/** \brief Adapt the multigrid in the region around the marked elements
+
+   \param theMG - multigrid to refine
+   \param flag - flag for switching between different yellow closures
+   \param marked - elements marked since the last adaption
+
+   This function does the same as AdaptMultiGrid, but only for the
+   region around the marked elements on each level: the closure (see
+   RegionClosure), the restriction of the marks to the fathers of the
+   region, the copies and node classes (see RegionCopies) and the vector
+   classes (see UpdateSurfaceClasses). Levels without marks in the region
+   are skipped. All other elements must be as after the last
+   AdaptMultiGrid, see there for the conditions.
+
+   \return <ul>
+   <li> 0 - ok
+   <li> 1 - out of memory, but data structure as before
+   <li> 2 - fatal memory error, data structure corrupted
+   </ul>
+ */
+/****************************************************************************/
+
+static INT AdaptMultiGridRegion (MULTIGRID *theMG, INT flag,
+                                 const std::vector<ELEMENT*>& marked)
+{
+  const INT toplevel = TOPLEVEL(theMG);
+
+  /* per level the marked elements, the elements whose marks or coarsen
+     flags change in the downward pass, the elements whose closure
+     changes there and the sons of adapted elements and their neighbors */
+  std::vector<std::vector<ELEMENT*> > seeds(toplevel+2), restricted(toplevel+2);
+  std::vector<std::vector<ELEMENT*> > dirty(toplevel+2), sons(toplevel+2);
+  std::vector<ELEMENT*> region, fathers, around, adapt, changed;
+  std::vector<NODE*> nodes;
+
+  /* elements whose side vectors may change their classes */
+  std::vector<ELEMENT*> classElements;
+
+  for (ELEMENT *theElement : marked)
+    if (!THEFLAG(theElement))
+    {
+      SETTHEFLAG(theElement,1);
+      seeds[LEVEL(theElement)].push_back(theElement);
+    }
+  for (ELEMENT *theElement : marked)
+    SETTHEFLAG(theElement,0);
+
+  /* compute modification of coarser levels from above */
+  START_TIMER(closure_timer)
+
+  for (INT level = toplevel; level >= 0; level--)
+  {
+    GRID *theGrid = GRID_ON_LEVEL(theMG,level);
+    std::vector<ELEMENT*>& changes = restricted[level];
+    changes.insert(changes.end(),seeds[level].begin(),seeds[level].end());
+
+    /* the closure of the coarsest level is computed upwards only */
+    if (level == 0)
+    {
+      dirty[0] = changes;
+      break;
+    }
+    if (changes.empty()) continue;
+
+    if (RegionClosure(theGrid,changes,false,region)<0)
+    {
+      PrintErrorMessage('E',"AdaptMultiGrid","error in RegionClosure");
+      RETURN(GM_ERROR);
+    }
+
+    /* restrict marks to the fathers of the region and the marked elements */
+    fathers.clear();
+    for (ELEMENT *theElement : region)
+      if (!THEFLAG(EFATHER(theElement)))
+      {
+        SETTHEFLAG(EFATHER(theElement),1);
+        fathers.push_back(EFATHER(theElement));
+      }
+    for (ELEMENT *theElement : seeds[level-1])
+      if (!THEFLAG(theElement))
+      {
+        SETTHEFLAG(theElement,1);
+        fathers.push_back(theElement);
+      }
+
+                #if defined(UG_DIM_3) && defined(DUNE_UGGRID_TET_RULESET)
+    /* RestrictElementMark() reads the patterns of son edges of green */
+    /* tetrahedra, which may be outside the region                    */
+    around.clear();
+    for (ELEMENT *theElement : fathers)
+    {
+      if (TAG(theElement)!=TETRAHEDRON || REFINECLASS(theElement)!=GREEN_CLASS)
+        continue;
+
+      ELEMENT *SonList[MAX_SONS];
+      if (GetAllSons(theElement,SonList)!=GM_OK) RETURN(GM_ERROR);
+      for (INT j=0; j<EDGES_OF_ELEM(theElement); j++)
+      {
+        EDGE *theEdge = GetEdge(CORNER_OF_EDGE_PTR(theElement,j,0),
+                                CORNER_OF_EDGE_PTR(theElement,j,1));
+        if (theEdge==NULL || MIDNODE(theEdge)!=NULL) continue;
+
+        NODE *theNodes[2] = {SONNODE(CORNER_OF_EDGE_PTR(theElement,j,0)),
+                             SONNODE(CORNER_OF_EDGE_PTR(theElement,j,1))};
+        for (INT i=0; i<MAX_SONS && SonList[i]!=NULL; i++)
+        {
+          INT found = 0;
+          for (INT k=0; k<CORNERS_OF_ELEM(SonList[i]); k++)
+            if (CORNER(SonList[i],k)==theNodes[0] || CORNER(SonList[i],k)==theNodes[1])
+              found++;
+          if (found == 2)
+          {
+            AddElementsOfNodes(SonList[i],theNodes,2,around);
+            break;
+          }
+        }
+      }
+    }
+    for (ELEMENT *theElement : around)
+    {
+      SETTHEFLAG(theElement,0);
+      SetElementAddPattern(theGrid,theElement);
+      theMG->closureList.push_back(theElement);
+    }
+                #endif
+
+    for (ELEMENT *theElement : fathers)
+    {
+      SETTHEFLAG(theElement,0);
+      if (RestrictElementMarks(theElement)!=GM_OK) RETURN(GM_ERROR);
+      if (REF_TYPE_CHANGES(theElement) || COARSEN(theElement))
+        restricted[level-1].push_back(theElement);
+    }
+
+    /* elements with the closure of the last adaption keep their refinement */
+    for (ELEMENT *theElement : region)
+    {
+      const bool copy = (REFINECLASS(theElement)==YELLOW_CLASS);
+      if (MARK(theElement)==(copy ? NO_REFINEMENT : REFINE(theElement)) &&
+          MARKCLASS(theElement)==(copy ? NO_CLASS : REFINECLASS(theElement)))
+      {
+        SETMARK(theElement,REFINE(theElement));
+        SETMARKCLASS(theElement,REFINECLASS(theElement));
+      }
+      else
+        dirty[level].push_back(theElement);
+    }
+
+    ResetClosurePatterns(theGrid);
+  }
+
+  SUM_TIMER(closure_timer)
+
+  INT newlevel = 0;
+  std::vector<ELEMENT*> carried;
+  for (INT level = 0; level <= toplevel; level++)
+  {
+    GRID *theGrid = GRID_ON_LEVEL(theMG,level);
+
+    START_TIMER(closure_timer)
+
+    SETMODIFIED(theGrid,0);
+
+    /* determine regular and irregular elements on next level */
+    std::vector<ELEMENT*>& changes = dirty[level];
+    changes.insert(changes.end(),sons[level].begin(),sons[level].end());
+    INT nrefined = 0;
+    region.clear();
+    adapt.clear();
+    if (!changes.empty())
+    {
+      if ((nrefined = RegionClosure(theGrid,changes,true,region))<0)
+      {
+        PrintErrorMessage('E',"AdaptMultiGrid","error in 2. RegionClosure");
+        RETURN(GM_ERROR);
+      }
+
+      nrefined += RegionCopies(region,sons[level],adapt,classElements);
+    }
+
+    /* create a new grid level, if at least one element is refined on finest level */
+    if (nrefined>0 && level==toplevel) newlevel = 1;
+    if (newlevel)
+      if (CreateNewLevel(theMG)==NULL)
+        RETURN(GM_FATAL);
+
+    SUM_TIMER(closure_timer)
+
+    /* now really manipulate the next finer level */
+    START_TIMER(gridadapt_timer)
+
+    INT nadapted = 0;
+    const std::size_t created = theMG->createdElements.size();
+
+    if (level<toplevel || newlevel)
+    {
+      /* in the order of the grid, which AdaptGrid() would follow */
+      adapt.insert(adapt.end(),region.begin(),region.end());
+      std::sort(adapt.begin(),adapt.end(),
+                [](const ELEMENT *a, const ELEMENT *b) { return ID(a) < ID(b); });
+      adapt.erase(std::unique(adapt.begin(),adapt.end()),adapt.end());
+
+      /* the elements below the changed ones are disposed */
+      bool disposed = false;
+      for (ELEMENT *theElement : adapt)
+        if (REFINEMENT_CHANGES(theElement) && REFINE(theElement)!=NO_REFINEMENT)
+        {
+          FlagDescendants(theElement);
+          disposed = true;
+        }
+      if (disposed)
+        for (INT l=level+1; l<=toplevel; l++)
+        {
+          RemoveFlagged(seeds[l]);
+          RemoveFlagged(restricted[l]);
+          RemoveFlagged(dirty[l]);
+        }
+
+      if (AdaptGrid(theGrid,&nadapted,&adapt,changed)!=GM_OK)
+        RETURN(GM_FATAL);
+
+      /* reset coarse flags */
+      for (ELEMENT *theElement : restricted[level])
+        SETCOARSEN(theElement,0);
+    }
+    else
+    {
+      /* the coarse flags stay set until the next adaption */
+      for (ELEMENT *theElement : seeds[level])
+        if (COARSEN(theElement))
+          carried.push_back(theElement);
+    }
+
+    SUM_TIMER(gridadapt_timer)
+
+    ResetClosurePatterns(theGrid);
+    ResetSonPatterns(theGrid,created);
+
+    /* if no grid adaption has occurred adapt next level */
+    if (nadapted == 0) continue;
+
+    total_adapted += nadapted;
+
+    START_TIMER(algebra_timer)
+
+    /* the sons of the changed elements and of the elements around them */
+    around.clear();
+    nodes.clear();
+    for (ELEMENT *theElement : changed)
+      if (!THEFLAG(theElement))
+      {
+        SETTHEFLAG(theElement,1);
+        around.push_back(theElement);
+      }
+    AddCornerNeighbors(around,0,nodes);
+    for (NODE *theNode : nodes)
+      SETTHEFLAG(theNode,0);
+    for (ELEMENT *theElement : around)
+    {
+      SETTHEFLAG(theElement,0);
+
+      ELEMENT *SonList[MAX_SONS];
+      if (GetAllSons(theElement,SonList)!=GM_OK) RETURN(GM_FATAL);
+      for (INT i=0; i<MAX_SONS && SonList[i]!=NULL; i++)
+        sons[level+1].push_back(SonList[i]);
+    }
+
+    /* and compute the node classes on the changed level */
+    UpdateNodeClasses(sons[level+1],false,around);
+    classElements.insert(classElements.end(),around.begin(),around.end());
+
+    SUM_TIMER(algebra_timer)
+  }
+
+  DisposeTopLevel(theMG);
+  if (TOPLEVEL(theMG) > 0) DisposeTopLevel(theMG);
+  CURRENTLEVEL(theMG) = TOPLEVEL(theMG);
+
+  /* the vector classes change in the region only, unless the levels change */
+  classElements.insert(classElements.end(),
+                       theMG->createdElements.begin(),theMG->createdElements.end());
+  if (PostProcessAdaptMultiGrid(theMG,(TOPLEVEL(theMG)==toplevel) ? &classElements : nullptr))
+    REP_ERR_RETURN(1);
+
+  if (MG_GEOMETRY_CACHE(theMG))
+    UpdateGeometryCache(theMG);
+
+  theMG->markedElements = carried;
+  theMG->marksRecorded = MG_ADAPT_INCREMENTAL(theMG);
+  theMG->markedFlag = flag;
+
+  return(GM_OK);
+}
+#endif
+
 /****************************************************************************/
 /** \brief Adapt whole multigrid structure
 
    \param theMG - multigrid to refine
    \param flag - flag for switching between different yellow closures
 
-   This function refines whole multigrid structure
+   This function refines whole multigrid structure.
+   If MG_COMPACT_STORAGE is set the grid levels are compacted afterwards,
+   see 'CompactMultiGrid'. If MG_GEOMETRY_CACHE is set the geometry caches
+   are updated, see 'UpdateGeometryCache'.
+   If MG_ADAPT_INCREMENTAL is set, sequential builds adapt only the region
+   around the elements marked since the last call, see
+   'AdaptMultiGridRegion'. This needs MG_CLOSURE_WORKLIST, the same flag
+   as in the last call, MG_ADAPT_INCREMENTAL set in the last call and few
+   marked elements; otherwise all elements are adapted. Only the marks set
+   by 'MarkForRefinement' are recorded, so the default is off. Code which
+   sets marks directly must call 'ForgetMarkedElements'.
+   The refinement prediction (REFINEINFO) is then only updated if mgtest
+   is set.
+   If MG_BOUNDARY_BATCH is set, sequential builds evaluate the boundary
+   vertices created on a level with one call of the batch function of
+   each boundary segment, see 'ProjectBoundaryVertices'.
 
    \return <ul>
    <li> 0 - ok
@@ -5921,8 +7127,32 @@ INT NS_DIM_PREFIX AdaptMultiGrid (MULTIGRID *theMG, INT flag, INT seq, INT mgtes
     SETREFINESTEP(REFINEINFO(theMG),0);
   }
 
-  /* set info for refinement prediction */
-  SetRefineInfo(theMG);
+  /* set flags for different modes */
+  rFlag=flag & 0x03;                    /* copy local or all */
+  hFlag=!((flag>>2)&0x1);       /* use hanging nodes */
+  fifoFlag=(flag>>3)&0x1;       /* use fifo              */
+
+  /* adapt only the region around the marked elements, if all other
+     elements are as after the last adaption of this multigrid */
+  bool region = false;
+#ifndef ModelP
+  std::vector<ELEMENT*> marked;
+  marked.swap(theMG->markedElements);
+  if (MG_ADAPT_INCREMENTAL(theMG) && MG_CLOSURE_WORKLIST(theMG) &&
+      theMG->marksRecorded && theMG->markedFlag==flag &&
+      hFlag && !fifoFlag && rFlag!=GM_COPY_ALL &&
+      !MG_COMPACT_STORAGE(theMG) && theMG->elementsInIdOrder)
+  {
+    INT nt = 0;
+    for (INT level = 0; level <= TOPLEVEL(theMG); level++)
+      nt += NT(GRID_ON_LEVEL(theMG,level));
+    region = (64*marked.size() <= (std::size_t)nt);
+  }
+#endif
+
+  /* set info for refinement prediction, which needs all elements */
+  if (!region || mgtest)
+    SetRefineInfo(theMG);
   /* evaluate prediction */
   if (mgtest)
   {
@@ -5930,13 +7160,12 @@ INT NS_DIM_PREFIX AdaptMultiGrid (MULTIGRID *theMG, INT flag, INT seq, INT mgtes
                PREDNEW0(REFINEINFO(theMG)), PREDNEW1(REFINEINFO(theMG)));
   }
 
-  /* set flags for different modes */
-  rFlag=flag & 0x03;                    /* copy local or all */
-  hFlag=!((flag>>2)&0x1);       /* use hanging nodes */
-  fifoFlag=(flag>>3)&0x1;       /* use fifo              */
-
   refine_seq = seq;
 
+  /* the edges of the coarse grid have no patterns yet */
+  theMG->closureGrid = NULL;
+  if (!theMG->closurePatternsReset)
+    ResetAllClosurePatterns(theMG);
   No_Green_Update=0;
   Green_Marks=0;
 
@@ -5947,10 +7176,26 @@ INT NS_DIM_PREFIX AdaptMultiGrid (MULTIGRID *theMG, INT flag, INT seq, INT mgtes
   /* prepare algebra (set internal flags correctly) */
   START_TIMER(algebra_timer)
 
-  PrepareAlgebraModification(theMG);
+  if (region)
+  {
+                #ifdef UG_DIM_3
+    /* the side vectors created by the last adaption are not new any more */
+    for (ELEMENT *theElement : theMG->createdElements)
+      for (INT i=0; i<SIDES_OF_ELEM(theElement); i++)
+        SETVNEW(SVECTOR(theElement,i),0);
+                #endif
+  }
+  else
+    PrepareAlgebraModification(theMG);
+  theMG->createdElements.clear();
 
   SUM_TIMER(algebra_timer)
 
+#ifndef ModelP
+  if (region)
+    return AdaptMultiGridRegion(theMG,flag,marked);
+#endif
+
   const INT toplevel = TOPLEVEL(theMG);
 
   REFINE_MULTIGRID_LIST(1,theMG,"AdaptMultiGrid()","","")
@@ -5985,6 +7230,8 @@ INT NS_DIM_PREFIX AdaptMultiGrid (MULTIGRID *theMG, INT flag, INT seq, INT mgtes
     if (RestrictMarks(GRID_ON_LEVEL(theMG,level-1))!=GM_OK) RETURN(GM_ERROR);
 
     REFINE_GRID_LIST(1,theMG,level-1,("End RestrictMarks(%d,down):\n",level),"");
+
+    ResetClosurePatterns(theGrid);
   }
 
   SUM_TIMER(closure_timer)
@@ -6068,11 +7315,15 @@ INT NS_DIM_PREFIX AdaptMultiGrid (MULTIGRID *theMG, INT flag, INT seq, INT mgtes
     START_TIMER(gridadapt_timer)
 
     nadapted = 0;
+    const std::size_t created = theMG->createdElements.size();
 
     if (level<toplevel || newlevel)
                         #ifndef ModelP
-      if (AdaptGrid(theGrid,&nadapted)!=GM_OK)
+    {
+      std::vector<ELEMENT*> changed;
+      if (AdaptGrid(theGrid,&nadapted,nullptr,changed)!=GM_OK)
         RETURN(GM_FATAL);
+    }
                         #else
       if (AdaptGrid(theGrid,toplevel,level,newlevel,&nadapted)!=GM_OK)
         RETURN(GM_FATAL);
@@ -6080,6 +7331,9 @@ INT NS_DIM_PREFIX AdaptMultiGrid (MULTIGRID *theMG, INT flag, INT seq, INT mgtes
 
     SUM_TIMER(gridadapt_timer)
 
+    ResetClosurePatterns(theGrid);
+    ResetSonPatterns(theGrid,created);
+
     /* if no grid adaption has occurred adapt next level */
     if (nadapted == 0) continue;
 
@@ -6115,11 +7369,41 @@ INT NS_DIM_PREFIX AdaptMultiGrid (MULTIGRID *theMG, INT flag, INT seq, INT mgtes
   SUM_TIMER(gridcons_timer)
         #endif
 
+#ifndef ModelP
+  /* the coarse flags of the finest level stay set until the next adaption */
+  if (!newlevel && MG_ADAPT_INCREMENTAL(theMG))
+    for (ELEMENT *theElement = FIRSTELEMENT(GRID_ON_LEVEL(theMG,toplevel));
+         theElement != nullptr; theElement = SUCCE(theElement))
+      if (COARSEN(theElement))
+        theMG->markedElements.push_back(theElement);
+#endif
+
   DisposeTopLevel(theMG);
   if (TOPLEVEL(theMG) > 0) DisposeTopLevel(theMG);
   CURRENTLEVEL(theMG) = TOPLEVEL(theMG);
 
-  if (PostProcessAdaptMultiGrid(theMG)) REP_ERR_RETURN(1);
+  if (PostProcessAdaptMultiGrid(theMG,nullptr)) REP_ERR_RETURN(1);
+
+  if (MG_COMPACT_STORAGE(theMG))
+  {
+    if (CompactMultiGrid(theMG)) REP_ERR_RETURN(1);
+  }
+  /* CompactGrid has rebuilt the geometry caches already */
+  else if (MG_GEOMETRY_CACHE(theMG))
+  {
+#ifdef ModelP
+    if (SetGeometryCache(theMG,true)) REP_ERR_RETURN(1);
+#else
+    /* only the sons of the changed elements need new entries */
+    if (UpdateGeometryCache(theMG)) REP_ERR_RETURN(1);
+#endif
+  }
+
+#ifndef ModelP
+  /* record the marks until the next adaption, see NoteMarkedElement */
+  theMG->marksRecorded = MG_ADAPT_INCREMENTAL(theMG);
+  theMG->markedFlag = flag;
+#endif
 
   return(GM_OK);
 }
@@ -90,55 +90,55 @@ enum REFINE_CE {
 /* edges */
 #define PATTERN_SHIFT                           10
 #define PATTERN_LEN                             1
-#define PATTERN(p)                                      CW_READ(p,PATTERN_CE)
-#define SETPATTERN(p,n)                         CW_WRITE(p,PATTERN_CE,n)
+#define PATTERN(p)                                      CW_READ_STATIC(p,PATTERN_,EDGE_)
+#define SETPATTERN(p,n)                         CW_WRITE_STATIC(p,PATTERN_,EDGE_,n)
 
 #define ADDPATTERN_SHIFT                        11
 #define ADDPATTERN_LEN                          1
-#define ADDPATTERN(p)                           CW_READ(p,ADDPATTERN_CE)
-#define SETADDPATTERN(p,n)                      CW_WRITE(p,ADDPATTERN_CE,n)
+#define ADDPATTERN(p)                           CW_READ_STATIC(p,ADDPATTERN_,EDGE_)
+#define SETADDPATTERN(p,n)                      CW_WRITE_STATIC(p,ADDPATTERN_,EDGE_,n)
 
 
 /* element */
 #define REFINE_SHIFT                                    0
 #define REFINE_LEN                                              8
-#define REFINE(p)                                               CW_READ(p,REFINE_CE)
-#define SETREFINE(p,n)                                  CW_WRITE(p,REFINE_CE,n)
+#define REFINE(p)                                               CW_READ_STATIC(p,REFINE_,ELEMENT_)
+#define SETREFINE(p,n)                                  CW_WRITE_STATIC(p,REFINE_,ELEMENT_,n)
 
 #define MARK_SHIFT                                              0
 #define MARK_LEN                                                8
-#define MARK(p)                                                 CW_READ(p,MARK_CE)
-#define SETMARK(p,n)                                    CW_WRITE(p,MARK_CE,n)
+#define MARK(p)                                                 CW_READ_STATIC(p,MARK_,FLAG_)
+#define SETMARK(p,n)                                    CW_WRITE_STATIC(p,MARK_,FLAG_,n)
 
 #define COARSEN_SHIFT                                   10
 #define COARSEN_LEN                                     1
-#define COARSEN(p)                                              CW_READ(p,COARSEN_CE)
-#define SETCOARSEN(p,n)                                 CW_WRITE(p,COARSEN_CE,n)
+#define COARSEN(p)                                              CW_READ_STATIC(p,COARSEN_,FLAG_)
+#define SETCOARSEN(p,n)                                 CW_WRITE_STATIC(p,COARSEN_,FLAG_,n)
 
 #define DECOUPLED_SHIFT                                 12
 #define DECOUPLED_LEN                                   1
-#define DECOUPLED(p)                                    CW_READ(p,DECOUPLED_CE)
-#define SETDECOUPLED(p,n)                               CW_WRITE(p,DECOUPLED_SHIFT,n)
+#define DECOUPLED(p)                                    CW_READ_STATIC(p,DECOUPLED_,FLAG_)
+#define SETDECOUPLED(p,n)                               CW_WRITE_STATIC(p,DECOUPLED_,FLAG_,n)
 
 #define REFINECLASS_SHIFT                               15
 #define REFINECLASS_LEN                                 2
-#define REFINECLASS(p)                                  CW_READ(p,REFINECLASS_CE)
-#define SETREFINECLASS(p,n)                     CW_WRITE(p,REFINECLASS_CE,n)
+#define REFINECLASS(p)                                  CW_READ_STATIC(p,REFINECLASS_,ELEMENT_)
+#define SETREFINECLASS(p,n)                     CW_WRITE_STATIC(p,REFINECLASS_,ELEMENT_,n)
 
 #define UPDATE_GREEN_SHIFT                              8
 #define UPDATE_GREEN_LEN                                1
-#define UPDATE_GREEN(p)                                 CW_READ(p,UPDATE_GREEN_CE)
-#define SETUPDATE_GREEN(p,n)                    CW_WRITE(p,UPDATE_GREEN_CE,n)
+#define UPDATE_GREEN(p)                                 CW_READ_STATIC(p,UPDATE_GREEN_,FLAG_)
+#define SETUPDATE_GREEN(p,n)                    CW_WRITE_STATIC(p,UPDATE_GREEN_,FLAG_,n)
 
 #define SIDEPATTERN_SHIFT                               0
 #define SIDEPATTERN_LEN                                 6
-#define SIDEPATTERN(p)                                  CW_READ(p,SIDEPATTERN_CE)
-#define SETSIDEPATTERN(p,n)                     CW_WRITE(p,SIDEPATTERN_CE,n)
+#define SIDEPATTERN(p)                                  CW_READ_STATIC(p,SIDEPATTERN_,FLAG_)
+#define SETSIDEPATTERN(p,n)                     CW_WRITE_STATIC(p,SIDEPATTERN_,FLAG_,n)
 
 #define MARKCLASS_SHIFT                                 13
 #define MARKCLASS_LEN                                   2
-#define MARKCLASS(p)                                    CW_READ(p,MARKCLASS_CE)
-#define SETMARKCLASS(p,n)                               CW_WRITE(p,MARKCLASS_CE,n)
+#define MARKCLASS(p)                                    CW_READ_STATIC(p,MARKCLASS_,FLAG_)
+#define SETMARKCLASS(p,n)                               CW_WRITE_STATIC(p,MARKCLASS_,FLAG_,n)
 
 #ifdef ModelP
 #define NEW_NIDENT_LEN                 2
@@ -264,6 +264,8 @@ INT Get_Sons_of_ElementSide(const ELEMENT *theElement,
                             INT useRefineClass=0);
 INT     Connect_Sons_of_ElementSide                     (GRID *theGrid, ELEMENT *theElement, INT side, INT Sons_of_Side, ELEMENT **Sons_of_Side_List, INT *SonSides, INT ioflag);
 INT             Refinement_Changes                                              (ELEMENT *theElement);
+void    NoteMarkedElement                               (ELEMENT *theElement);
+void    ForgetMarkedElements                    (MULTIGRID *theMG);
 
 END_UGDIM_NAMESPACE
 
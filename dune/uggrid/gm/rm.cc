@@ -36,6 +36,8 @@
 #include <cmath>
 #include <cstdlib>
 
+#include <array>
+
 /* low module */
 #include <dune/uggrid/low/architecture.h>
 #include <dune/uggrid/low/debug.h>
@@ -2074,11 +2076,14 @@ INT NS_DIM_PREFIX MarkForRefinement (ELEMENT *theElement, enum RefinementRule ru
   if (EGHOST(theElement)) return(0);
         #endif
 
+  /* the incremental AdaptMultiGrid starts from the marked elements */
+  NoteMarkedElement(theElement);
   SETCOARSEN(theElement,0);
 
   if (rule != COARSE)
     theElement = ELEMENT_TO_MARK(theElement);
   ASSERT(theElement!=NULL);
+  NoteMarkedElement(theElement);
 
   PRINTDEBUG(gm,4,("MarkForRefinement() e=" EID_FMTX "rule=%d\n",
                    EID_PRTX(theElement),rule))
@@ -2444,13 +2449,194 @@ INT NS_DIM_PREFIX EstimateHere (const ELEMENT *theElement)
 }
 
 
+#if defined(UG_DIM_3) && defined(DUNE_UGGRID_TET_RULESET)
+#  include "RefRules.cc"
+#endif
+
+/* dense table of N patterns, NOINDEX for patterns without rule */
+template<std::size_t N, std::size_t M>
+static constexpr std::array<SHORT,N> DensePatternRules (const PATTERN_RULE (&rules)[M])
+{
+  std::array<SHORT,N> table {};
+  for (SHORT& rule : table)
+    rule = NOINDEX;
+  for (const PATTERN_RULE& r : rules)
+    table[r.pattern] = r.rule;
+  return table;
+}
+
+/* hash table of the rules: the rule of a pattern is in the slot
+   pattern % modulus, which is the smallest modulus without collisions */
+struct HashedPatternRules
+{
+  std::array<PATTERN_RULE,64> slots;
+  INT modulus;
+};
+
+template<std::size_t M>
+static constexpr HashedPatternRules HashPatternRules (const PATTERN_RULE (&rules)[M])
+{
+  HashedPatternRules hashed {};
+  for (INT modulus=M; modulus<=INT(hashed.slots.size()); modulus++)
+  {
+    bool collision = false;
+    for (std::size_t i=0; i<M; i++)
+      for (std::size_t j=i+1; j<M; j++)
+        collision |= (rules[i].pattern%modulus == rules[j].pattern%modulus);
+    if (collision)
+      continue;
+
+    for (PATTERN_RULE& slot : hashed.slots)
+      slot = {-1,NOINDEX};
+    for (const PATTERN_RULE& r : rules)
+      hashed.slots[r.pattern%modulus] = r;
+    hashed.modulus = modulus;
+    break;
+  }
+  return hashed;
+}
+
+#ifdef UG_DIM_2
+/** \todo 0 can mean T_COPY OR T_NOREF */
+static constexpr PATTERN_RULE triangleRules[] = {
+  {0,T_NOREF},
+  {1,T_BISECT_1_0},
+  {2,T_BISECT_1_1},
+  {3,T_BISECT_2_T1_2},
+  {4,T_BISECT_1_2},
+  {5,T_BISECT_2_T1_1},
+  {6,T_BISECT_2_T1_0},
+  {7,T_RED}
+};
+static constexpr auto triangleRuleOfPattern = DensePatternRules<8>(triangleRules);
+
+/** \todo 0 can mean Q_COPY OR Q_NOREF */
+/* the patterns 1 to 15 without a midnode are mappings for the green closure */
+static constexpr PATTERN_RULE quadrilateralRules[] = {
+  {0,Q_NOREF},
+  {1,Q_CLOSE_2_0},
+  {2,Q_CLOSE_2_1},
+  {3,Q_CLOSE_1_0},
+  {4,Q_CLOSE_2_2},
+  {5,Q_BLUE_0},
+  {6,Q_CLOSE_1_1},
+  {7,Q_CLOSE_3_3},
+  {8,Q_CLOSE_2_3},
+  {9,Q_CLOSE_1_3},
+  {10,Q_BLUE_1},
+  {11,Q_CLOSE_3_2},
+  {12,Q_CLOSE_1_2},
+  {13,Q_CLOSE_3_1},
+  {14,Q_CLOSE_3_0},
+  {15,Q_RED},
+  {17,Q_CLOSE_2_0},
+  {18,Q_CLOSE_2_1},
+  {19,Q_CLOSE_1_0},
+  {20,Q_CLOSE_2_2},
+  {22,Q_CLOSE_1_1},
+  {24,Q_CLOSE_2_3},
+  {25,Q_CLOSE_1_3},
+  {28,Q_CLOSE_1_2},
+  {31,Q_RED}
+};
+static constexpr auto quadrilateralRuleOfPattern = DensePatternRules<32>(quadrilateralRules);
+#endif
+
+#ifdef UG_DIM_3
+#ifndef DUNE_UGGRID_TET_RULESET
+static constexpr PATTERN_RULE tetrahedronRules[] = {
+  {0,0},
+  {63,TET_RED},
+  {1023,TET_RED_HEX}
+};
+static constexpr auto tetrahedronRuleOfPattern = DensePatternRules<1024>(tetrahedronRules);
+#endif
+
+static constexpr PATTERN_RULE pyramidRules[] = {
+  {0,0},
+  {511,PYR_RED}
+};
+static constexpr auto pyramidRuleOfPattern = DensePatternRules<512>(pyramidRules);
+
+/* the prism and hexahedron patterns have up to 13 and 18 bits for a few
+   rules, so these are hashed */
+static constexpr PATTERN_RULE prismRules[] = {
+  {0,0},
+  {56,PRI_BISECT_1_2},
+  {65,PRI_BISECT_0_1},
+  {130,PRI_BISECT_0_2},
+  {195,PRI_BISECT_HEX1},
+  {260,PRI_BISECT_0_3},
+  {325,PRI_BISECT_HEX0},
+  {390,PRI_BISECT_HEX2},
+  {455,PRI_QUADSECT},
+  {7679,PRI_RED}
+};
+static constexpr auto prismRuleOfPattern = HashPatternRules(prismRules);
+static_assert(prismRuleOfPattern.modulus>0);
+
+static constexpr PATTERN_RULE hexahedronRules[] = {
+  {0,0},
+  {5,HEXA_TRISECT_0},
+  {240,HEXA_BISECT_0_3},
+  {257,HEXA_BISECT_HEXPRI1},
+  {1280,HEXA_TRISECT_5},
+  {1285,HEXA_BISECT_0_1},
+  {2056,HEXA_BISECT_HEXPRI0},
+  {2570,HEXA_BISECT_0_2},
+  {42485,HEXA_QUADSECT_1},
+  {84730,HEXA_QUADSECT_2},
+  {139023,HEXA_QUADSECT_0},
+  {262143,HEXA_RED}
+};
+static constexpr auto hexahedronRuleOfPattern = HashPatternRules(hexahedronRules);
+static_assert(hexahedronRuleOfPattern.modulus>0);
+#endif
+
+template<std::size_t N>
+static constexpr PATTERN_RULES DenseRuleTable (const std::array<SHORT,N>& table, bool redOnly)
+{
+  return {table.data(),N,nullptr,0,~0,redOnly};
+}
+
+static constexpr PATTERN_RULES HashedRuleTable (const HashedPatternRules& hashed, bool redOnly)
+{
+  return {nullptr,0,hashed.slots.data(),hashed.modulus,~0,redOnly};
+}
+
+static constexpr std::array<PATTERN_RULES,TAGS> MakePatternRuleTables ()
+{
+  std::array<PATTERN_RULES,TAGS> tables {};
+        #ifdef UG_DIM_2
+  tables[TRIANGLE] = DenseRuleTable(triangleRuleOfPattern,false);
+  tables[QUADRILATERAL] = DenseRuleTable(quadrilateralRuleOfPattern,false);
+        #endif
+        #ifdef UG_DIM_3
+#ifdef DUNE_UGGRID_TET_RULESET
+  /* the bit of the side 0 is not used in the rule set */
+  tables[TETRAHEDRON] = {pattern2RuleTetrahedron,1024,nullptr,0,~(1<<10),false};
+#else
+  tables[TETRAHEDRON] = DenseRuleTable(tetrahedronRuleOfPattern,true);
+#endif
+  tables[PYRAMID] = DenseRuleTable(pyramidRuleOfPattern,true);
+  tables[PRISM] = HashedRuleTable(prismRuleOfPattern,true);
+  tables[HEXAHEDRON] = HashedRuleTable(hexahedronRuleOfPattern,true);
+        #endif
+  return tables;
+}
+
+/* rules of the patterns of all element types */
+constexpr std::array<PATTERN_RULES,TAGS> NS_DIM_PREFIX PatternRules = MakePatternRuleTables();
+
 /****************************************************************************/
 /** \brief Return mark of rule for a specific pattern
 
    \param theElement - element rule is searched for
    \param pattern: pattern a rule is searched for
 
-   This function returns mark of rule for a specific pattern
+   This function returns mark of rule for a specific pattern. The rules
+   of the patterns of all element types are in constant tables, see
+   PatternRules.
 
    \return Mark rule; values of the unnamed enums in the file rm.h
    mark of rule
@@ -2459,201 +2645,59 @@ INT NS_DIM_PREFIX EstimateHere (const ELEMENT *theElement)
 
 INT NS_DIM_PREFIX Patterns2Rules(ELEMENT *theElement, INT pattern)
 {
-        #ifdef UG_DIM_2
-  switch (TAG(theElement)) {
-  case (TRIANGLE) :
-    switch (pattern) {
-    /** \todo 0 can mean T_COPY OR T_NOREF */
-    case (0) : return(T_NOREF);
-    case (1) : return(T_BISECT_1_0);
-    case (2) : return(T_BISECT_1_1);
-    case (3) : return(T_BISECT_2_T1_2);
-    case (4) : return(T_BISECT_1_2);
-    case (5) : return(T_BISECT_2_T1_1);
-    case (6) : return(T_BISECT_2_T1_0);
-    case (7) : return(T_RED);
-    default :
-      assert(0);
-      PrintErrorMessage('E',"Patterns2Rules","no mapping for TRIANGLE and this pattern!");
-      return(-1);
-    }
-    break;
-  case (QUADRILATERAL) :
-    switch (pattern) {
-    /** \todo 0 can mean Q_COPY OR Q_NOREF */
-    case (0) : return(Q_NOREF);
-    case (5) : return(Q_BLUE_0);
-    case (7) : return(Q_CLOSE_3_3);
-    case (10) : return(Q_BLUE_1);
-    case (11) : return(Q_CLOSE_3_2);
-    case (13) : return(Q_CLOSE_3_1);
-    case (14) : return(Q_CLOSE_3_0);
-
-    case (1) :                                    /* mapping for green closure */
-    case (17) : return(Q_CLOSE_2_0);
-
-    case (2) :                                    /* mapping for green closure */
-    case (18) : return(Q_CLOSE_2_1);
-
-    case (3) :                                    /* mapping for green closure */
-    case (19) : return(Q_CLOSE_1_0);
+  const PATTERN_RULES& table = PatternRules[TAG(theElement)];
 
-    case (4) :                                    /* mapping for green closure */
-    case (20) : return(Q_CLOSE_2_2);
-
-    case (6) :                                    /* mapping for green closure */
-    case (22) : return(Q_CLOSE_1_1);
-
-    case (8) :                                    /* mapping for green closure */
-    case (24) : return(Q_CLOSE_2_3);
+  if (table.dense==nullptr && table.hashed==nullptr)
+  {
+    PrintErrorMessage('E',"Patterns2Rules","Elementtype not found!");
+    assert(0); return(-1);
+  }
 
-    case (9) :                                    /* mapping for green closure */
-    case (25) : return(Q_CLOSE_1_3);
+  if (table.redOnly && MARKCLASS(theElement) != RED_CLASS) return(0);
 
-    case (12) :                                    /* mapping for green closure */
-    case (28) : return(Q_CLOSE_1_2);
+  pattern &= table.mask;
 
-    case (15) :                                    /* mapping for green closure */
-    case (31) : return(Q_RED);
-    default :
-      assert(0);
-      PrintErrorMessage('E',"Patterns2Rules","no mapping for QUADRILATERAL and this pattern!");
-      return(-1);
-    }
-    break;
-  default :
-    PrintErrorMessage('E',"Patterns2Rules","Elementtype not found!");
-    assert(0); return(-1);
+  INT rule = NOINDEX;
+  if (pattern>=0 && pattern<table.size)
+    rule = table.dense[pattern];
+  else if (pattern>=0 && table.hashed!=nullptr)
+  {
+    const PATTERN_RULE& r = table.hashed[pattern % table.modulus];
+    if (r.pattern==pattern)
+      rule = r.rule;
   }
-        #endif
-        #ifdef UG_DIM_3
-  switch (TAG(theElement)) {
-  case (TETRAHEDRON) :
-#ifdef DUNE_UGGRID_TET_RULESET
-    /* convert pattern to old style */
-    pattern &= (~(1<<10));
 
+#if defined(UG_DIM_3) && defined(DUNE_UGGRID_TET_RULESET)
+  /* the rule set has no rules for some patterns, see SetElementRule */
+  if (TAG(theElement)==TETRAHEDRON)
+  {
     IFDEBUG(gm,0)
-    int tetrarule;
     if (pattern<0 || pattern>1023)
       PRINTDEBUG(gm,0,("Pattern2Rule(): ERROR elem=" EID_FMTX
                        " pattern=%d\n",EID_PRTX(theElement),pattern))
       assert(pattern>=0 && pattern<=1023);
-    tetrarule = Pattern2Rule[TAG(theElement)][pattern];
-    if (tetrarule<0 || tetrarule>MaxRules[TETRAHEDRON])
+    if (rule<0 || rule>MaxRules[TETRAHEDRON])
       PRINTDEBUG(gm,0,("Pattern2Rule(): ERROR elem=" EID_FMTX
-                       " pattern=%d rule=%d\n",EID_PRTX(theElement),pattern,tetrarule))
-      assert(tetrarule>=0 && tetrarule<=MaxRules[TETRAHEDRON]);
+                       " pattern=%d rule=%d\n",EID_PRTX(theElement),pattern,rule))
+      assert(rule>=0 && rule<=MaxRules[TETRAHEDRON]);
     ENDDEBUG
 
-    return(Pattern2Rule[TAG(theElement)][pattern]);
-#else
-    if (MARKCLASS(theElement) != RED_CLASS) return(0);
-    switch (pattern) {
-    /* copy rule */
-    case (0) :
-      return(0);
-    case (63) :
-      return(TET_RED);
-    case (1023) :
-      return(TET_RED_HEX);
-    default :
-      PrintErrorMessage('E',"Patterns2Rules","no mapping for TETRAHEDRON and this pattern!");
-      assert(0); return(-1);
-    }
-    break;
+    return(rule);
+  }
 #endif
 
-  case (PYRAMID) :
-    if (MARKCLASS(theElement) != RED_CLASS) return(0);
-    switch (pattern) {
-    /* copy rule */
-    case (0) :
-      return(0);
-    case (511) :
-      return(PYR_RED);
-    default :
-      PrintErrorMessage('E',"Patterns2Rules","no mapping for PYRAMID and this pattern!");
-      assert(0); return(-1);
-    }
-    break;
-
-  case (PRISM) :
-    if (MARKCLASS(theElement) != RED_CLASS) return(0);
-    switch (pattern) {
-    /* copy rule */
-    case (0) :
-      return(0);
-    case (7679) :
-      return(PRI_RED);
-    case (455) :
-      return(PRI_QUADSECT);
-    case 56 :
-      return PRI_BISECT_1_2;
-    case 65 :
-      return PRI_BISECT_0_1;
-    case 130 :
-      return PRI_BISECT_0_2;
-    case 260 :
-      return PRI_BISECT_0_3;
-    case 325 :
-      return PRI_BISECT_HEX0;
-    case 195 :
-      return PRI_BISECT_HEX1;
-    case 390 :
-      return PRI_BISECT_HEX2;
-    default :
-      PrintErrorMessageF('E',"Patterns2Rules","no mapping for PRISM and pattern %d!", pattern);
-                                                #ifndef __ANISOTROPIC__
-      assert(0);
-                                                #endif
-      return(-1);
-    }
-    break;
-
-  case (HEXAHEDRON) :
-    if (MARKCLASS(theElement) != RED_CLASS) return(0);
-    switch (pattern) {
-    /* copy rule */
-    case (0) :
-      return(0);
-    /* full red rule */
-    case (262143) :
-      return(HEXA_RED);
-    case (1285) :
-      return HEXA_BISECT_0_1;
-    case (2570) :
-      return HEXA_BISECT_0_2;
-    case (240) :
-      return HEXA_BISECT_0_3;
-    case (139023) :
-      return HEXA_QUADSECT_0;
-    case (42485) :
-      return HEXA_QUADSECT_1;
-    case (84730) :
-      return HEXA_QUADSECT_2;
-    case (5) :
-      return HEXA_TRISECT_0;
-    case (1280) :
-      return HEXA_TRISECT_5;
-    case (2056) :
-      return HEXA_BISECT_HEXPRI0;
-    case (257) :
-      return HEXA_BISECT_HEXPRI1;
-    default :
-      PrintErrorMessage('E',"Patterns2Rules","no mapping for HEXAHEDRON and this pattern!");
-      UserWriteF("pattern=%d\n",pattern);
-      assert(0); return(-1);
-    }
-    break;
-
-  default :
-    PrintErrorMessage('E',"Patterns2Rules","Elementtype not found!");
-    assert(0); return(-1);
+  if (rule == NOINDEX)
+  {
+    PrintErrorMessageF('E',"Patterns2Rules","no mapping for element type %d and pattern %d!",
+                       (int)TAG(theElement),(int)pattern);
+                #if defined(UG_DIM_3) && defined(__ANISOTROPIC__)
+    if (TAG(theElement)!=PRISM)
+                #endif
+    assert(0);
+    return(-1);
   }
-        #endif
-  PrintErrorMessage('E',"Patterns2Rules","Elementtype not found!");
-  assert(0); return(-1);
+
+  return(rule);
 }
 
 /****************************************************************************/
@@ -2967,10 +3011,6 @@ INT NS_DIM_PREFIX ShowRefRule (INT tag, INT nb)
  */
 /****************************************************************************/
 
-#ifdef DUNE_UGGRID_TET_RULESET
-#  include "RefRules.cc"
-#endif
-
 static INT InitRuleManager3D (void)
 {
   FULLREFRULE *newFRR;
@@ -35,6 +35,7 @@
 #ifndef __RULEMANAGER__
 #define __RULEMANAGER__
 
+#include <array>
 #include <memory>
 
 #include "gm.h"
@@ -83,7 +84,7 @@ enum {INNER_EDGE        = 1,
 
 #define PATTERN2RULE(e,p)       (Patterns2Rules((e),(p)))
 #define RULE2MARK(e,r)          (RefRules[TAG(e)][(r)].mark)
-#define PATTERN2MARK(e,p)       (((PATTERN2RULE((e),(p)))>=0) ? (RefRules[TAG(e)][PATTERN2RULE((e),(p))].mark) : -1)
+#define PATTERN2MARK(e,p)       (Patterns2Marks((e),(p)))
 
 #ifdef __SR2201__
 #define NODE_OF_RULE(e,m,i) ((*MARK2RULEADR((e),(m))).sonandnode[(i)][0]!=-1)
@@ -311,8 +312,26 @@ struct refrule {
   struct sondata sons[MAX_SONS_DIM];
 };
 
+/** \brief rule of an edge (and side) pattern */
+struct pattern_rule {
+  INT pattern;
+  SHORT rule;
+};
+
+/** \brief rules of the patterns of an element type, see Patterns2Rules */
+struct pattern_rules {
+  const SHORT *dense;                           /* rules of the patterns below size, -1 if none */
+  INT size;
+  const struct pattern_rule *hashed;            /* or the rule of a pattern in the slot  */
+  INT modulus;                                  /* pattern % modulus of this table       */
+  INT mask;                                     /* bits of the pattern selecting the rule */
+  bool redOnly;                                 /* elements not marked red get rule 0    */
+};
+
 typedef struct sondata SONDATA;
 typedef struct refrule REFRULE;
+typedef struct pattern_rule PATTERN_RULE;
+typedef struct pattern_rules PATTERN_RULES;
 
 
 /****************************************************************************/
@@ -327,6 +346,7 @@ extern INT MaxNewEdges[TAGS];
 extern INT CenterNodeIndex[TAGS];
 extern REFRULE                  *RefRules[TAGS];
 extern const SHORT* Pattern2Rule[TAGS];
+extern const std::array<PATTERN_RULES,TAGS> PatternRules;
 extern FULLREFRULEPTR theFullRefRule;
 
 
@@ -347,6 +367,41 @@ ELEMENT         *ELEMENT_TO_MARK                (ELEMENT *theElement);
 INT             GetRule_AnisotropicRed  (ELEMENT *theElement, INT *Rule);
 #endif
 
+/****************************************************************************/
+/** \brief Return the mark of the rule for a pattern
+
+   \param theElement - element rule is searched for
+   \param pattern - pattern a rule is searched for
+
+   The closure looks up the rule of every element, so the tables of
+   PatternRules are read here. Patterns without rule are passed to
+   Patterns2Rules, which reports them.
+
+   \return mark of the rule, -1 if there is none
+ */
+/****************************************************************************/
+
+inline INT Patterns2Marks (ELEMENT *theElement, INT pattern)
+{
+  const PATTERN_RULES& rules = PatternRules[TAG(theElement)];
+  INT rule = 0;
+
+  if (!rules.redOnly || MARKCLASS(theElement)==RED_CLASS)
+  {
+    pattern &= rules.mask;
+    rule = -1;
+    if (pattern>=0 && pattern<rules.size)
+      rule = rules.dense[pattern];
+    else if (pattern>=0 && rules.hashed!=nullptr
+             && rules.hashed[pattern % rules.modulus].pattern==pattern)
+      rule = rules.hashed[pattern % rules.modulus].rule;
+    if (rule < 0)
+      rule = Patterns2Rules(theElement,pattern);
+  }
+
+  return((rule>=0) ? RefRules[TAG(theElement)][rule].mark : -1);
+}
+
 END_UGDIM_NAMESPACE
 
 #endif
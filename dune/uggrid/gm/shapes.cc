@@ -98,8 +98,11 @@ USING_UG_NAMESPACE
  */
 /****************************************************************************/
 
-INT NS_DIM_PREFIX UG_GlobalToLocal (INT n, const DOUBLE **Corners,
-                                    const FieldVector<DOUBLE,DIM>& EvalPoint, FieldVector<DOUBLE,DIM>& LocalCoord)
+/* Newton iteration of UG_GlobalToLocal, starting with the inverse IM0 of
+   the Jacobian at local coordinate 0 */
+static INT GlobalToLocalFrom (INT n, const DOUBLE **Corners,
+                              const DOUBLE_VECTOR& EvalPoint, DOUBLE_VECTOR& LocalCoord,
+                              const DOUBLE_VECTOR IM0[DIM], DOUBLE IMdet0)
 {
   DOUBLE_VECTOR tmp,diff,M[DIM],IM[DIM];
   DOUBLE s,IMdet;
@@ -108,17 +111,13 @@ INT NS_DIM_PREFIX UG_GlobalToLocal (INT n, const DOUBLE **Corners,
   V_DIM_SUBTRACT(EvalPoint,Corners[0],diff);
   if (n == DIM+1)
   {
-    TRANSFORMATION(DIM+1,Corners,LocalCoord,M);
-    M_DIM_INVERT(M,IM,IMdet);
-    if (IMdet==0) return (2);
-    MT_TIMES_V_DIM(IM,diff,LocalCoord);
+    if (IMdet0==0) return (2);
+    MT_TIMES_V_DIM(IM0,diff,LocalCoord);
     return(0);
   }
-  V_DIM_CLEAR(LocalCoord);
-  TRANSFORMATION(n,Corners,LocalCoord,M);
-  M_DIM_INVERT(M,IM,IMdet);
-  if (IMdet==0) return (3);
-  MT_TIMES_V_DIM(IM,diff,LocalCoord);
+  if (IMdet0==0) return (3);
+  MT_TIMES_V_DIM(IM0,diff,LocalCoord);
+  IMdet = IMdet0;
   for (i=0; i<MAX_ITER; i++)
   {
     LOCAL_TO_GLOBAL (n,Corners,LocalCoord,tmp);
@@ -137,6 +136,56 @@ INT NS_DIM_PREFIX UG_GlobalToLocal (INT n, const DOUBLE **Corners,
   return(1);
 }
 
+INT NS_DIM_PREFIX UG_GlobalToLocal (INT n, const DOUBLE **Corners,
+                                    const FieldVector<DOUBLE,DIM>& EvalPoint, FieldVector<DOUBLE,DIM>& LocalCoord)
+{
+  DOUBLE_VECTOR local(0.0),M[DIM],IM[DIM];
+  DOUBLE IMdet;
+
+  TRANSFORMATION(n,Corners,local,M);
+  M_DIM_INVERT(M,IM,IMdet);
+
+  return GlobalToLocalFrom(n,Corners,EvalPoint,LocalCoord,IM,IMdet);
+}
+
+/****************************************************************************/
+/** \brief Transform global coordinates to local in an element
+
+   \param theGrid - grid level of the element
+   \param theElement - the element
+   \param EvalPoint - global coordinates
+   \param LocalCoord - local coordinates
+
+   This function does the same as the other 'UG_GlobalToLocal', but takes
+   the inverse Jacobian from the geometry cache of 'theGrid' if the
+   element has an entry there (see 'SetGeometryCache'). For simplices this
+   saves the whole setup, the result is the same.
+
+   \return see the other 'UG_GlobalToLocal'
+ */
+/****************************************************************************/
+
+INT NS_DIM_PREFIX UG_GlobalToLocal (const GRID *theGrid, const ELEMENT *theElement,
+                                    const FieldVector<DOUBLE,DIM>& EvalPoint, FieldVector<DOUBLE,DIM>& LocalCoord)
+{
+  DOUBLE *x[MAX_CORNERS_OF_ELEM];
+  INT n;
+
+  CORNER_COORDINATES(theElement,n,x);
+
+  const INT k = GeometryCacheSlot(theGrid,theElement);
+  if (k<0 || theGrid->geometryCache->det[k]==0)
+    return UG_GlobalToLocal(n,(const DOUBLE **)x,EvalPoint,LocalCoord);
+
+  const GEOMETRY_CACHE& cache = *theGrid->geometryCache;
+  DOUBLE_VECTOR IM[DIM];
+  for (INT i=0; i<DIM; i++)
+    for (INT j=0; j<DIM; j++)
+      IM[i][j] = cache.inverseJacobian[i][j][k];
+
+  return GlobalToLocalFrom(n,(const DOUBLE **)x,EvalPoint,LocalCoord,IM,cache.det[k]);
+}
+
 /****************************************************************************/
 /** \brief Calculate inner normals of tetrahedra
 
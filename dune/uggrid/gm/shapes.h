@@ -479,6 +479,7 @@ START_UGDIM_NAMESPACE
 /****************************************************************************/
 
 INT      UG_GlobalToLocal     (INT n, const DOUBLE **Corners, const FieldVector<DOUBLE,DIM>& EvalPoint, FieldVector<DOUBLE,DIM>& LocalCoord);
+INT      UG_GlobalToLocal     (const GRID *theGrid, const ELEMENT *theElement, const FieldVector<DOUBLE,DIM>& EvalPoint, FieldVector<DOUBLE,DIM>& LocalCoord);
 
 #ifdef UG_DIM_3
 DOUBLE  N                   (const INT i, const DOUBLE *LocalCoord);
@@ -0,0 +1,249 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************/
+/*                                                                          */
+/* File:      boundarybatch-benchmark.cc                                    */
+/*                                                                          */
+/* Purpose:   time the global refinement of a grid with curved boundary     */
+/*            segments, once evaluating each new boundary vertex on its     */
+/*            own, once per level with the scalar segment functions and     */
+/*            once per level with the batch functions (MG_BOUNDARY_BATCH),  */
+/*            and check that all give the same vertex positions, also      */
+/*            after local refinement and coarsening                         */
+/*                                                                          */
+/*            usage: boundarybatch-benchmark [cells per direction]          */
+/*                                           [refinement levels]            */
+/*                                           [setup work per call]          */
+/*                                                                          */
+/****************************************************************************/
+
+#include "config.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/uggrid/initug.h>
+
+#include "structuredgrid.h"
+
+USING_UG_NAMESPACES
+
+/* a face of the unit square/cube bulged outwards */
+struct CurvedFace
+{
+  INT n;
+  std::array<Dune::FieldVector<DOUBLE,DIM>, CORNERS_OF_BND_SEG> x;
+  Dune::FieldVector<DOUBLE,DIM> bulge;
+};
+
+static int setupWork = 2000;
+static volatile DOUBLE setupSink;
+static long scalarCalls, batchCalls, batchPoints;
+
+/* the work a CAD evaluator does per call before it evaluates a point */
+static void Setup (const CurvedFace& face)
+{
+  DOUBLE s = face.bulge.two_norm2();
+  for (int k=0; k<setupWork; k++)
+    s = std::sqrt(s + k);
+  setupSink = setupSink + s;
+}
+
+static void Evaluate (const CurvedFace& face, const DOUBLE *lambda, Dune::FieldVector<DOUBLE,DIM>& global)
+{
+#ifdef UG_DIM_2
+  const DOUBLE l0 = lambda[0];
+  for (int d=0; d<DIM; d++)
+    global[d] = (1-l0)*face.x[0][d] + l0*face.x[1][d]
+                + 4*l0*(1-l0)*face.bulge[d];
+#else
+  const DOUBLE l0 = lambda[0], l1 = lambda[1];
+  for (int d=0; d<DIM; d++)
+    if (face.n==3)
+      global[d] = face.x[0][d] + l0*(face.x[1][d]-face.x[0][d]) + l1*(face.x[2][d]-face.x[1][d])
+                  + 27*(1-l0)*(l0-l1)*l1*face.bulge[d];
+    else
+      global[d] = (1-l0)*(1-l1)*face.x[0][d] + l0*(1-l1)*face.x[1][d]
+                  + l0*l1*face.x[2][d] + (1-l0)*l1*face.x[3][d]
+                  + 16*l0*(1-l0)*l1*(1-l1)*face.bulge[d];
+#endif
+}
+
+static INT CurvedSegment (void *data, DOUBLE *lambda, Dune::FieldVector<DOUBLE,DIM>& global)
+{
+  const CurvedFace& face = *static_cast<const CurvedFace*>(data);
+  scalarCalls++;
+  Setup(face);
+  Evaluate(face, lambda, global);
+  return 0;
+}
+
+static INT CurvedSegmentBatch (void *data, INT n, const DOUBLE *lambda, Dune::FieldVector<DOUBLE,DIM> *global)
+{
+  const CurvedFace& face = *static_cast<const CurvedFace*>(data);
+  batchCalls++;
+  batchPoints += n;
+  Setup(face);
+  for (INT i=0; i<n; i++)
+    Evaluate(face, lambda+i*DIM_OF_BND, global[i]);
+  return 0;
+}
+
+/* hash of the positions of the vertices of all levels */
+static std::uint64_t Fingerprint (MULTIGRID *theMG)
+{
+  std::uint64_t hash = 1469598103934665603ull;
+  const auto add = [&hash](DOUBLE value) {
+                     std::uint64_t bits;
+                     std::memcpy(&bits, &value, sizeof(bits));
+                     hash = (hash ^ bits) * 1099511628211ull;
+                   };
+
+  for (int l=0; l<=TOPLEVEL(theMG); l++)
+    for (VERTEX *theVertex=PFIRSTVERTEX(GRID_ON_LEVEL(theMG,l)); theVertex!=nullptr;
+         theVertex=SUCCV(theVertex))
+    {
+      for (int d=0; d<DIM; d++)
+      {
+        add(CVECT(theVertex)[d]);
+        add(LCVECT(theVertex)[d]);
+      }
+      add(MOVED(theVertex));
+    }
+
+  return hash;
+}
+
+/* refine the leaves with center in a ball around c and coarsen the leaves
+   of the top level outside of it. In 3D a center vertex may see mid nodes
+   on its edges which a neighbor disposes later on the same level */
+static INT Adapt (MULTIGRID *theMG, DOUBLE c)
+{
+  for (int l=0; l<=TOPLEVEL(theMG); l++)
+    for (ELEMENT *theElement=PFIRSTELEMENT(GRID_ON_LEVEL(theMG,l)); theElement!=nullptr;
+         theElement=SUCCE(theElement))
+    {
+      if (!EstimateHere(theElement))
+        continue;
+      DOUBLE_VECTOR center;
+      CalculateCenterOfMass(theElement,center);
+      DOUBLE r2 = 0.0;
+      for (int d=0; d<DIM; d++)
+        r2 += (center[d]-c)*(center[d]-c);
+      if (r2<0.04)
+        MarkForRefinement(theElement,RED,0);
+      else if (l==TOPLEVEL(theMG) && l>0)
+        MarkForRefinement(theElement,COARSE,0);
+    }
+  return AdaptMultiGrid(theMG,GM_REFINE_TRULY_LOCAL,GM_REFINE_PARALLEL,GM_REFINE_NOHEAPTEST);
+}
+
+static int Run (int n, int levels, bool simplex, bool batch, bool batchFunctions,
+                std::uint64_t& fingerprint)
+{
+  std::deque<CurvedFace> faces;
+  const auto parametric = [&](INT id, INT corners, const INT *points,
+                              const std::array<Dune::FieldVector<DOUBLE,DIM>, CORNERS_OF_BND_SEG>& x) {
+                            CurvedFace& face = faces.emplace_back();
+                            face.n = corners;
+                            face.x = x;
+                            /* outwards, the face lies in the plane x_d = 0 or 1 */
+                            face.bulge = 0;
+                            for (int d=0; d<DIM; d++)
+                            {
+                              bool onPlane = true;
+                              for (INT i=1; i<corners; i++)
+                                onPlane = onPlane && (x[i][d]==x[0][d]);
+                              if (onPlane)
+                                face.bulge[d] = (x[0][d]>0.5 ? 0.1 : -0.1)/n;
+                            }
+                            return boundary_segment(id, points, CurvedSegment, &face,
+                                                    batchFunctions ? CurvedSegmentBatch : nullptr);
+                          };
+
+  MULTIGRID *theMG = CreateStructuredMultiGrid("boundarybatch", n, simplex, false, 0, parametric);
+  if (theMG==nullptr)
+    return 1;
+  MG_BOUNDARY_BATCH(theMG) = batch;
+  if (FixCoarseGrid(theMG))
+    return 1;
+
+  scalarCalls = batchCalls = batchPoints = 0;
+  const auto start = Clock::now();
+  for (int l=0; l<levels; l++)
+    if (RefineGlobally(theMG))
+      return 1;
+  const double refineTime = SecondsSince(start);
+
+  long vertices = 0;
+  for (int l=0; l<=TOPLEVEL(theMG); l++)
+    vertices += NV(GRID_ON_LEVEL(theMG,l));
+
+  printf("%-8s %-14s %8ld vertices  %8ld scalar calls  %6ld batch calls (%8ld points)  refine %8.3f ms\n",
+         simplex ? "simplex" : "cube",
+         batch ? (batchFunctions ? "batch" : "batch-fallback") : "per-vertex",
+         vertices, scalarCalls, batchCalls, batchPoints, 1e3*refineTime);
+
+  /* local refinement and coarsening near the boundary */
+  for (DOUBLE c : {0.2, 0.4, 0.6, 0.8, 0.7, 0.3, 0.7})
+    if (Adapt(theMG, c))
+      return 1;
+
+  int errors = 0;
+  for (int l=0; l<=TOPLEVEL(theMG); l++)
+  {
+    GRID *theGrid = GRID_ON_LEVEL(theMG,l);
+#ifdef ModelP
+    errors += (CheckGrid(theGrid,1,0,1,0)!=GM_OK);
+#else
+    errors += (CheckGrid(theGrid,1,0,1)!=GM_OK);
+#endif
+  }
+  fingerprint = Fingerprint(theMG);
+
+  DisposeMultiGrid(theMG);
+  return errors;
+}
+
+int main (int argc, char **argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+
+#ifdef UG_DIM_2
+  int n = 8;
+  int levels = 4;
+#else
+  int n = 2;
+  int levels = 2;
+#endif
+  if (argc>1) n = std::atoi(argv[1]);
+  if (argc>2) levels = std::atoi(argv[2]);
+  if (argc>3) setupWork = std::atoi(argv[3]);
+
+  if (InitUg(&argc, &argv))
+    return 1;
+
+  int errors = 0;
+  for (bool simplex : {false, true})
+  {
+    std::uint64_t vertexFingerprint, fallbackFingerprint, batchFingerprint;
+    errors += Run(n, levels, simplex, false, true, vertexFingerprint);
+    errors += Run(n, levels, simplex, true, false, fallbackFingerprint);
+    errors += Run(n, levels, simplex, true, true, batchFingerprint);
+    if (vertexFingerprint!=fallbackFingerprint)
+      errors++;
+    if (vertexFingerprint!=batchFingerprint)
+      errors++;
+  }
+
+  ExitUg();
+
+  if (errors)
+    printf("boundarybatch-benchmark: %d errors\n", errors);
+  return errors ? 1 : 0;
+}
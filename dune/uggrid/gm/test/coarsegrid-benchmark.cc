@@ -0,0 +1,135 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************/
+/*                                                                          */
+/* File:      coarsegrid-benchmark.cc                                       */
+/*                                                                          */
+/* Purpose:   compare the neighbor search of InsertElement through the      */
+/*            face map with SetElementNeighbors on the whole coarse grid    */
+/*                                                                          */
+/*            usage: coarsegrid-benchmark [cells per direction]             */
+/*                                        [max. number of threads]          */
+/*                                                                          */
+/****************************************************************************/
+
+#include "config.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/uggrid/initug.h>
+
+#include "structuredgrid.h"
+
+USING_UG_NAMESPACES
+
+/* hash of the neighbor ids of all elements of the coarse grid */
+static std::uint64_t Fingerprint (MULTIGRID *theMG)
+{
+  std::uint64_t hash = 1469598103934665603ull;
+  const GRID *theGrid = GRID_ON_LEVEL(theMG,0);
+  for (ELEMENT *theElement=PFIRSTELEMENT(theGrid); theElement!=nullptr; theElement=SUCCE(theElement))
+    for (INT i=0; i<SIDES_OF_ELEM(theElement); i++)
+      hash = (hash ^ (NBELEM(theElement,i)!=nullptr ? ID(NBELEM(theElement,i)) : -1)) * 1099511628211ull;
+  return hash;
+}
+
+/* the face map holds exactly the sides without a neighbor, so that
+   InsertElement finds the neighbors of further elements */
+static int CheckFaceMap (MULTIGRID *theMG)
+{
+  int errors = 0;
+  std::size_t open = 0;
+  const GRID *theGrid = GRID_ON_LEVEL(theMG,0);
+  for (ELEMENT *theElement=PFIRSTELEMENT(theGrid); theElement!=nullptr; theElement=SUCCE(theElement))
+    for (INT i=0; i<SIDES_OF_ELEM(theElement); i++)
+    {
+      if (NBELEM(theElement,i)!=nullptr)
+        continue;
+      MULTIGRID::FaceNodes key;
+      key.fill(nullptr);
+      for (INT j=0; j<CORNERS_OF_SIDE(theElement,i); j++)
+        key[j] = CORNER(theElement,CORNER_OF_SIDE(theElement,i,j));
+      std::sort(key.begin(), key.begin()+CORNERS_OF_SIDE(theElement,i));
+      const auto it = theMG->facemap.find(key);
+      errors += (it==theMG->facemap.end() || it->second!=std::make_pair(theElement,int(i)));
+      open++;
+    }
+  errors += (open!=theMG->facemap.size());
+  return errors;
+}
+
+/* create and fix a coarse grid, threads==0 uses the face map */
+static int Run (int n, int threads, bool simplex, std::uint64_t& fingerprint)
+{
+  const auto start = Clock::now();
+  MULTIGRID *theMG = CreateStructuredMultiGrid("coarsegrid", n, simplex, threads>0, threads);
+  if (theMG==nullptr)
+    return 1;
+  const double insertTime = SecondsSince(start);
+  int errors = CheckFaceMap(theMG);
+  if (FixCoarseGrid(theMG))
+    return 1;
+
+  GRID *theGrid = GRID_ON_LEVEL(theMG,0);
+#ifdef ModelP
+  errors += (CheckGrid(theGrid,1,0,1,0)!=GM_OK);
+#else
+  errors += (CheckGrid(theGrid,1,0,1)!=GM_OK);
+#endif
+  /* the face map is released by FixCoarseGrid */
+  errors += (theMG->facemap.bucket_count()>1);
+  fingerprint = Fingerprint(theMG);
+
+  if (threads==0)
+    printf("%-8s face map      insert %8.3fs  %9d elements\n",
+           simplex ? "simplex" : "cube", insertTime, NT(theGrid));
+  else
+    printf("%-8s %2d threads   insert %8.3fs  %9d elements\n",
+           simplex ? "simplex" : "cube", threads, insertTime, NT(theGrid));
+
+  DisposeMultiGrid(theMG);
+  return errors;
+}
+
+int main (int argc, char **argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+
+#ifdef UG_DIM_2
+  int n = 32;
+#else
+  int n = 6;
+#endif
+  int maxThreads = 4;
+  if (argc>1) n = std::atoi(argv[1]);
+  if (argc>2) maxThreads = std::atoi(argv[2]);
+
+  if (InitUg(&argc, &argv))
+    return 1;
+
+  int errors = 0;
+  for (bool simplex : {false, true})
+  {
+    std::uint64_t faceMapFingerprint;
+    errors += Run(n, 0, simplex, faceMapFingerprint);
+    for (int threads=1; threads<=maxThreads; threads*=2)
+    {
+      /* both searches have to find the same neighbors */
+      std::uint64_t fingerprint;
+      errors += Run(n, threads, simplex, fingerprint);
+      if (fingerprint != faceMapFingerprint)
+        errors++;
+    }
+  }
+
+  ExitUg();
+
+  if (errors)
+    printf("coarsegrid-benchmark: %d errors\n", errors);
+  return errors ? 1 : 0;
+}
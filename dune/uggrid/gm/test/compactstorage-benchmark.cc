@@ -0,0 +1,280 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************/
+/*                                                                          */
+/* File:      compactstorage-benchmark.cc                                   */
+/*                                                                          */
+/* Purpose:   refine and coarsen two equal multigrids, compact one of them  */
+/*            (CompactMultiGrid) and check that both have the same          */
+/*            geometry and neighbor relations, also after refining and      */
+/*            coarsening them again, with and without MG_COMPACT_STORAGE.   */
+/*            Time level sweeps (SetSurfaceClasses, a loop over the corners */
+/*            of all elements) on both                                      */
+/*                                                                          */
+/*            usage: compactstorage-benchmark [cells per direction]         */
+/*                                            [refinement levels]           */
+/*                                            [repetitions]                 */
+/*                                                                          */
+/****************************************************************************/
+
+#include "config.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/uggrid/initug.h>
+#include <dune/uggrid/gm/algebra.h>
+
+#include "structuredgrid.h"
+
+USING_UG_NAMESPACES
+
+static std::uint64_t Mix (std::uint64_t x)
+{
+  x += 0x9e3779b97f4a7c15ull;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+
+/* key of a point on a level, independent of ids and list order */
+template<class Point>
+static std::uint64_t PointKey (INT level, const Point& x)
+{
+  std::uint64_t key = Mix(level);
+  for (int d=0; d<DIM; d++)
+    key = Mix(key ^ std::uint64_t(std::llround(x[d]*1048576.0)));
+  return key;
+}
+
+static std::uint64_t ElementKey (ELEMENT *theElement)
+{
+  if (theElement==nullptr)
+    return 0;
+  DOUBLE_VECTOR center;
+  CalculateCenterOfMass(theElement,center);
+  return PointKey(LEVEL(theElement),center);
+}
+
+static std::uint64_t NodeKey (NODE *theNode)
+{
+  if (theNode==nullptr)
+    return 0;
+  return PointKey(LEVEL(theNode),CVECT(MYVERTEX(theNode)));
+}
+
+/* sum of the hashes of all elements and nodes with their neighbors,
+   fathers, sons, links and mid nodes. The sum does not depend on the
+   order of the lists, which compaction changes, nor on the ids, which
+   depend on the order in which refinement visits the elements */
+static std::uint64_t Fingerprint (MULTIGRID *theMG)
+{
+  std::uint64_t hash = Mix(TOPLEVEL(theMG));
+  for (int l=0; l<=TOPLEVEL(theMG); l++)
+  {
+    GRID *theGrid = GRID_ON_LEVEL(theMG,l);
+    hash += Mix(NT(theGrid)) + Mix(NN(theGrid)+1000003) + Mix(NV(theGrid)+2000003);
+
+    for (ELEMENT *theElement=PFIRSTELEMENT(theGrid); theElement!=nullptr; theElement=SUCCE(theElement))
+    {
+      std::uint64_t h = Mix(ElementKey(theElement) ^ TAG(theElement));
+      h = Mix(h ^ ElementKey(EFATHER(theElement)));
+      h = Mix(h ^ (NSONS(theElement) + 16*REFINE(theElement) + 256*ECLASS(theElement)));
+      for (INT i=0; i<CORNERS_OF_ELEM(theElement); i++)
+        h = Mix(h ^ NodeKey(CORNER(theElement,i)));
+      for (INT i=0; i<SIDES_OF_ELEM(theElement); i++)
+        h = Mix(h ^ ElementKey(NBELEM(theElement,i)));
+      hash += h;
+    }
+
+    for (NODE *theNode=PFIRSTNODE(theGrid); theNode!=nullptr; theNode=SUCCN(theNode))
+    {
+      std::uint64_t h = Mix(NodeKey(theNode) ^ NTYPE(theNode));
+      h = Mix(h ^ NodeKey(SONNODE(theNode)));
+      h = Mix(h ^ OBJT(MYVERTEX(theNode)));
+      /* the order of the links is not part of the grid */
+      std::uint64_t links = 0;
+      for (LINK *theLink=START(theNode); theLink!=nullptr; theLink=NEXT(theLink))
+        links += Mix(NodeKey(NBNODE(theLink)) ^ NodeKey(MIDNODE(MYEDGE(theLink))));
+      hash += Mix(h ^ links);
+    }
+  }
+  return hash;
+}
+
+static int Check (MULTIGRID *theMG)
+{
+  int errors = 0;
+  for (int l=0; l<=TOPLEVEL(theMG); l++)
+#ifdef ModelP
+    errors += (CheckGrid(GRID_ON_LEVEL(theMG,l),1,0,1,0)!=GM_OK);
+#else
+    errors += (CheckGrid(GRID_ON_LEVEL(theMG,l),1,0,1)!=GM_OK);
+#endif
+  return errors;
+}
+
+/* refine the leaves with center in a ball around c and coarsen the leaves
+   of the top level outside of it, the marks depend on the geometry only */
+static INT Adapt (MULTIGRID *theMG, DOUBLE c)
+{
+  for (int l=0; l<=TOPLEVEL(theMG); l++)
+    for (ELEMENT *theElement=PFIRSTELEMENT(GRID_ON_LEVEL(theMG,l)); theElement!=nullptr;
+         theElement=SUCCE(theElement))
+    {
+      if (!EstimateHere(theElement))
+        continue;
+      DOUBLE_VECTOR center;
+      CalculateCenterOfMass(theElement,center);
+      DOUBLE r2 = 0.0;
+      for (int d=0; d<DIM; d++)
+        r2 += (center[d]-c)*(center[d]-c);
+      if (r2<0.04)
+        MarkForRefinement(theElement,RED,0);
+      else if (l==TOPLEVEL(theMG) && l>0)
+        MarkForRefinement(theElement,COARSE,0);
+    }
+  return AdaptMultiGrid(theMG,GM_REFINE_TRULY_LOCAL,GM_REFINE_PARALLEL,GM_REFINE_NOHEAPTEST);
+}
+
+/* a level sweep through the elements and their corners */
+static DOUBLE SweepCorners (MULTIGRID *theMG)
+{
+  DOUBLE sum = 0.0;
+  for (int l=0; l<=TOPLEVEL(theMG); l++)
+    for (ELEMENT *theElement=PFIRSTELEMENT(GRID_ON_LEVEL(theMG,l)); theElement!=nullptr;
+         theElement=SUCCE(theElement))
+      for (INT i=0; i<CORNERS_OF_ELEM(theElement); i++)
+        sum += CVECT(MYVERTEX(CORNER(theElement,i)))[0];
+  return sum;
+}
+
+static int Run (int n, int levels, int repetitions, bool simplex)
+{
+  int errors = 0;
+
+  /* grid 1 is compacted, grid 0 not */
+  MULTIGRID *theMG[2];
+  const char *names[2] = {"compactstorage0", "compactstorage1"};
+  for (int i=0; i<2; i++)
+  {
+    theMG[i] = CreateStructuredMultiGrid(names[i], n, simplex);
+    if (theMG[i]==nullptr || FixCoarseGrid(theMG[i]))
+      return 1;
+    for (int l=0; l<levels; l++)
+      if (RefineGlobally(theMG[i]))
+        return 1;
+    /* scatter the objects in memory by local refinement and coarsening */
+    for (int s=0; s<4; s++)
+      if (Adapt(theMG[i], 0.2+0.2*s))
+        return 1;
+  }
+
+  /* the closure of tetrahedra takes the diagonal of a side with two
+     refined edges from the neighbor that is visited first
+     (CorrectTetrahedronSidePattern). After compaction changed the order of
+     the lists, adapting may triangulate the green elements differently and
+     the grids part, then only CheckGrid applies */
+  bool sameGrids = true;
+  const auto compare = [&](const char *when) {
+                         const int e = Check(theMG[0]) + Check(theMG[1])
+                                       + (sameGrids && Fingerprint(theMG[0])!=Fingerprint(theMG[1]));
+                         if (e)
+                           printf("%-8s grids differ %s\n", simplex ? "simplex" : "cube", when);
+                         return e;
+                       };
+  errors += compare("before compaction");
+
+  auto start = Clock::now();
+  if (CompactMultiGrid(theMG[1]))
+    return 1;
+  const double compactTime = SecondsSince(start);
+  errors += compare("after compaction");
+
+  /* level sweeps */
+  double surfaceTime[2], sweepTime[2];
+  DOUBLE sum[2] = {0.0, 0.0};
+  for (int i=0; i<2; i++)
+  {
+    start = Clock::now();
+    for (int r=0; r<repetitions; r++)
+      SetSurfaceClasses(theMG[i]);
+    surfaceTime[i] = SecondsSince(start);
+
+    start = Clock::now();
+    for (int r=0; r<repetitions; r++)
+      sum[i] += SweepCorners(theMG[i]);
+    sweepTime[i] = SecondsSince(start);
+  }
+  errors += (sum[0]!=sum[1]);
+  errors += compare("after the sweeps");
+
+  long elements = 0;
+  for (int l=0; l<=TOPLEVEL(theMG[0]); l++)
+    elements += NT(GRID_ON_LEVEL(theMG[0],l));
+  printf("%-8s %8ld elements  compacted in %6.3f s\n"
+         "         SetSurfaceClasses  lists %8.3f ms  compacted %8.3f ms  speedup %5.2f\n"
+         "         corner sweep       lists %8.3f ms  compacted %8.3f ms  speedup %5.2f\n",
+         simplex ? "simplex" : "cube", elements, compactTime,
+         1e3*surfaceTime[0]/repetitions, 1e3*surfaceTime[1]/repetitions,
+         surfaceTime[1]>0.0 ? surfaceTime[0]/surfaceTime[1] : 0.0,
+         1e3*sweepTime[0]/repetitions, 1e3*sweepTime[1]/repetitions,
+         sweepTime[1]>0.0 ? sweepTime[0]/sweepTime[1] : 0.0);
+
+  /* refine and coarsen the compacted grid like the other one */
+#ifdef DUNE_UGGRID_TET_RULESET
+  sameGrids = (DIM==2 || !simplex);
+#endif
+  for (int i=0; i<2; i++)
+    if (Adapt(theMG[i], 0.7))
+      return 1;
+  errors += compare("after adapting the compacted grid");
+
+  /* and once more with compaction after every adaption */
+  MG_COMPACT_STORAGE(theMG[1]) = 1;
+  for (int s=0; s<2; s++)
+  {
+    for (int i=0; i<2; i++)
+      if (Adapt(theMG[i], 0.3+0.4*s))
+        return 1;
+    errors += compare("with MG_COMPACT_STORAGE");
+  }
+
+  for (int i=0; i<2; i++)
+    DisposeMultiGrid(theMG[i]);
+  return errors;
+}
+
+int main (int argc, char **argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+
+#ifdef UG_DIM_2
+  int n = 8;
+  int levels = 4;
+#else
+  int n = 2;
+  int levels = 2;
+#endif
+  int repetitions = 20;
+  if (argc>1) n = std::atoi(argv[1]);
+  if (argc>2) levels = std::atoi(argv[2]);
+  if (argc>3) repetitions = std::atoi(argv[3]);
+
+  if (InitUg(&argc, &argv))
+    return 1;
+
+  int errors = 0;
+  for (bool simplex : {false, true})
+    errors += Run(n, levels, repetitions, simplex);
+
+  ExitUg();
+
+  if (errors)
+    printf("compactstorage-benchmark: %d errors\n", errors);
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,175 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************/
+/*                                                                          */
+/* File:      concurrentbvp-benchmark.cc                                    */
+/*                                                                          */
+/* Purpose:   refine two multigrids with different domains alternately and  */
+/*            check that both give the same vertex positions as when they   */
+/*            are refined alone, then time the evaluation of their boundary */
+/*            vertices with BNDP_Global in one thread and in one thread per */
+/*            multigrid                                                     */
+/*                                                                          */
+/*            usage: concurrentbvp-benchmark [cells per direction]          */
+/*                                           [refinement levels]            */
+/*                                           [repetitions]                  */
+/*                                                                          */
+/****************************************************************************/
+
+#include "config.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/uggrid/initug.h>
+
+#include "structuredgrid.h"
+
+USING_UG_NAMESPACES
+
+/* hash of the positions of the vertices of all levels */
+static std::uint64_t Fingerprint (MULTIGRID *theMG)
+{
+  std::uint64_t hash = 1469598103934665603ull;
+  const auto add = [&hash](DOUBLE value) {
+                     std::uint64_t bits;
+                     std::memcpy(&bits, &value, sizeof(bits));
+                     hash = (hash ^ bits) * 1099511628211ull;
+                   };
+
+  for (int l=0; l<=TOPLEVEL(theMG); l++)
+    for (VERTEX *theVertex=PFIRSTVERTEX(GRID_ON_LEVEL(theMG,l)); theVertex!=nullptr;
+         theVertex=SUCCV(theVertex))
+      for (int d=0; d<DIM; d++)
+        add(CVECT(theVertex)[d]);
+
+  return hash;
+}
+
+static int Check (MULTIGRID *theMG)
+{
+  int errors = 0;
+  for (int l=0; l<=TOPLEVEL(theMG); l++)
+#ifdef ModelP
+    errors += (CheckGrid(GRID_ON_LEVEL(theMG,l),1,0,1,0)!=GM_OK);
+#else
+    errors += (CheckGrid(GRID_ON_LEVEL(theMG,l),1,0,1)!=GM_OK);
+#endif
+  return errors;
+}
+
+/* evaluate the boundary vertices of the finest level, count the ones that
+   are not at their vertex position */
+static long EvaluateBoundary (MULTIGRID *theMG, int repetitions)
+{
+  long errors = 0;
+  Dune::FieldVector<DOUBLE,DIM> global;
+  for (int r=0; r<repetitions; r++)
+    for (VERTEX *theVertex=PFIRSTVERTEX(GRID_ON_LEVEL(theMG,TOPLEVEL(theMG))); theVertex!=nullptr;
+         theVertex=SUCCV(theVertex))
+      if (OBJT(theVertex)==BVOBJ)
+        errors += (BNDP_Global(MG_BVP(theMG),V_BNDP(theVertex),global)!=0
+                   || global!=CVECT(theVertex));
+  return errors;
+}
+
+static int Run (int n, int levels, int repetitions, bool simplex)
+{
+  /* the second domain has other boundary segments than the first */
+  const int cells[2] = {n, n+1};
+  const char *names[2] = {"concurrentbvp0", "concurrentbvp1"};
+  std::uint64_t alone[2], together[2];
+
+  int errors = 0;
+  for (int i=0; i<2; i++)
+  {
+    MULTIGRID *theMG = CreateStructuredMultiGrid(names[i], cells[i], simplex);
+    if (theMG==nullptr || FixCoarseGrid(theMG))
+      return 1;
+    for (int l=0; l<levels; l++)
+      if (RefineGlobally(theMG))
+        return 1;
+    alone[i] = Fingerprint(theMG);
+    DisposeMultiGrid(theMG);
+  }
+
+  MULTIGRID *theMG[2];
+  for (int i=0; i<2; i++)
+  {
+    theMG[i] = CreateStructuredMultiGrid(names[i], cells[i], simplex);
+    if (theMG[i]==nullptr || FixCoarseGrid(theMG[i]))
+      return 1;
+  }
+  for (int l=0; l<levels; l++)
+    for (int i=0; i<2; i++)
+      if (RefineGlobally(theMG[i]))
+        return 1;
+  for (int i=0; i<2; i++)
+  {
+    errors += Check(theMG[i]);
+    together[i] = Fingerprint(theMG[i]);
+    errors += (together[i]!=alone[i]);
+  }
+
+  long wrong[2] = {0, 0};
+  auto start = Clock::now();
+  for (int i=0; i<2; i++)
+    wrong[i] += EvaluateBoundary(theMG[i], repetitions);
+  const double sequential = SecondsSince(start);
+
+  start = Clock::now();
+  std::vector<std::thread> threads;
+  for (int i=0; i<2; i++)
+    threads.emplace_back([&wrong, &theMG, repetitions, i]() {
+                           wrong[i] += EvaluateBoundary(theMG[i], repetitions);
+                         });
+  for (auto& thread : threads)
+    thread.join();
+  const double concurrent = SecondsSince(start);
+  errors += (wrong[0]+wrong[1]!=0);
+
+  printf("%-8s %8ld + %8ld vertices  one thread %8.3f ms  one per multigrid %8.3f ms  speedup %5.2f\n",
+         simplex ? "simplex" : "cube",
+         long(NV(GRID_ON_LEVEL(theMG[0],levels))), long(NV(GRID_ON_LEVEL(theMG[1],levels))),
+         1e3*sequential, 1e3*concurrent, concurrent>0.0 ? sequential/concurrent : 0.0);
+
+  for (int i=0; i<2; i++)
+    DisposeMultiGrid(theMG[i]);
+  return errors;
+}
+
+int main (int argc, char **argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+
+#ifdef UG_DIM_2
+  int n = 8;
+  int levels = 4;
+#else
+  int n = 2;
+  int levels = 2;
+#endif
+  int repetitions = 200;
+  if (argc>1) n = std::atoi(argv[1]);
+  if (argc>2) levels = std::atoi(argv[2]);
+  if (argc>3) repetitions = std::atoi(argv[3]);
+
+  if (InitUg(&argc, &argv))
+    return 1;
+
+  int errors = 0;
+  for (bool simplex : {false, true})
+    errors += Run(n, levels, repetitions, simplex);
+
+  ExitUg();
+
+  if (errors)
+    printf("concurrentbvp-benchmark: %d errors\n", errors);
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,215 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************/
+/*                                                                          */
+/* File:      controlword-benchmark.cc                                      */
+/*                                                                          */
+/* Purpose:   time flag-heavy loops with the compile-time control entry     */
+/*            layouts and with the runtime control entry table              */
+/*                                                                          */
+/*            usage: controlword-benchmark [cells per direction]            */
+/*                                         [refinement levels]              */
+/*                                         [repetitions]                    */
+/*                                                                          */
+/****************************************************************************/
+
+#include "config.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/uggrid/initug.h>
+#include <dune/uggrid/gm/cw.h>
+
+#include "structuredgrid.h"
+
+USING_UG_NAMESPACES
+
+static void Report (const char *what, long n, double fixed, double table)
+{
+  printf("%-16s %9ld objects  layout %6.2f ns  table %6.2f ns  speedup %5.2f\n",
+         what, n, 1e9*fixed/std::max(n,1L), 1e9*table/std::max(n,1L),
+         fixed>0.0 ? table/fixed : 0.0);
+}
+
+/* ClearMultiGridUsedFlags and the same loop through the control entry table */
+static int UsedFlags (MULTIGRID *theMG, int repetitions)
+{
+  const INT mask = MG_ELEMUSED | MG_NODEUSED | MG_VERTEXUSED;
+  long n = 0;
+  for (int l=0; l<=TOPLEVEL(theMG); l++)
+    n += NT(GRID_ON_LEVEL(theMG,l)) + 2*NN(GRID_ON_LEVEL(theMG,l));
+
+  auto start = Clock::now();
+  for (int r=0; r<repetitions; r++)
+    if (ClearMultiGridUsedFlags(theMG,0,TOPLEVEL(theMG),mask))
+      return 1;
+  const double fixed = SecondsSince(start);
+
+  start = Clock::now();
+  for (int r=0; r<repetitions; r++)
+    for (int l=0; l<=TOPLEVEL(theMG); l++)
+    {
+      GRID *theGrid = GRID_ON_LEVEL(theMG,l);
+      for (ELEMENT *theElement=PFIRSTELEMENT(theGrid); theElement!=nullptr; theElement=SUCCE(theElement))
+        CW_WRITE(theElement,USED_CE,0);
+      for (NODE *theNode=PFIRSTNODE(theGrid); theNode!=nullptr; theNode=SUCCN(theNode))
+      {
+        CW_WRITE(theNode,USED_CE,0);
+        CW_WRITE(MYVERTEX(theNode),USED_CE,0);
+      }
+    }
+  Report("clear used",n*repetitions,fixed,SecondsSince(start));
+
+  /* toggle the flags of the elements, read them back both ways */
+  int errors = 0;
+  start = Clock::now();
+  for (int r=0; r<repetitions; r++)
+    for (int l=0; l<=TOPLEVEL(theMG); l++)
+      for (ELEMENT *theElement=PFIRSTELEMENT(GRID_ON_LEVEL(theMG,l)); theElement!=nullptr; theElement=SUCCE(theElement))
+      {
+        SETUSED(theElement,!USED(theElement));
+        SETTHEFLAG(theElement,USED(theElement) ^ (REFINE(theElement)&1));
+      }
+  const double toggleFixed = SecondsSince(start);
+
+  start = Clock::now();
+  for (int r=0; r<repetitions; r++)
+    for (int l=0; l<=TOPLEVEL(theMG); l++)
+      for (ELEMENT *theElement=PFIRSTELEMENT(GRID_ON_LEVEL(theMG,l)); theElement!=nullptr; theElement=SUCCE(theElement))
+      {
+        CW_WRITE(theElement,USED_CE,!CW_READ(theElement,USED_CE));
+        CW_WRITE(theElement,THEFLAG_CE,CW_READ(theElement,USED_CE) ^ (CW_READ(theElement,REFINE_CE)&1));
+      }
+  long nElements = 0;
+  for (int l=0; l<=TOPLEVEL(theMG); l++)
+    nElements += NT(GRID_ON_LEVEL(theMG,l));
+  Report("toggle used",nElements*repetitions,toggleFixed,SecondsSince(start));
+
+  for (int l=0; l<=TOPLEVEL(theMG); l++)
+    for (ELEMENT *theElement=PFIRSTELEMENT(GRID_ON_LEVEL(theMG,l)); theElement!=nullptr; theElement=SUCCE(theElement))
+    {
+      errors += (USED(theElement)!=0);
+      errors += (USED(theElement)!=CW_READ(theElement,USED_CE));
+      errors += (THEFLAG(theElement)!=CW_READ(theElement,THEFLAG_CE));
+      errors += (MARK(theElement)!=CW_READ(theElement,MARK_CE));
+      errors += (TAG(theElement)!=CW_READ(theElement,TAG_CE));
+    }
+  return errors;
+}
+
+/* PropagateNodeClass of ugm.cc through the control entry table */
+static void PropagateNodeClassTable (GRID *theGrid, INT nclass)
+{
+  for (ELEMENT *theElement=PFIRSTELEMENT(theGrid); theElement!=nullptr; theElement=SUCCE(theElement))
+  {
+    INT m = 0;
+    for (INT i=0; i<CORNERS_OF_ELEM(theElement); i++)
+      m = std::max(m,(INT)CW_READ(CORNER(theElement,i),NCLASS_CE));
+    if (m==nclass)
+      for (INT i=0; i<CORNERS_OF_ELEM(theElement); i++)
+        if ((INT)CW_READ(CORNER(theElement,i),NCLASS_CE) < nclass)
+          CW_WRITE(CORNER(theElement,i),NCLASS_CE,nclass-1);
+  }
+}
+
+/* node classes seeded at every fourth element of the top level */
+static int NodeClasses (MULTIGRID *theMG, int repetitions)
+{
+  GRID *theGrid = GRID_ON_LEVEL(theMG,TOPLEVEL(theMG));
+  const auto seed = [theGrid] (bool table) {
+                      INT k = 0;
+                      for (NODE *theNode=PFIRSTNODE(theGrid); theNode!=nullptr; theNode=SUCCN(theNode))
+                        if (table)
+                          CW_WRITE(theNode,NCLASS_CE,0);
+                        else
+                          SETNCLASS(theNode,0);
+                      for (ELEMENT *theElement=PFIRSTELEMENT(theGrid); theElement!=nullptr; theElement=SUCCE(theElement))
+                      {
+                        if (k++ % 4 != 0)
+                          continue;
+                        for (INT i=0; i<CORNERS_OF_ELEM(theElement); i++)
+                          if (table)
+                            CW_WRITE(CORNER(theElement,i),NCLASS_CE,3);
+                          else
+                            SETNCLASS(CORNER(theElement,i),3);
+                      }
+                    };
+
+  auto start = Clock::now();
+  for (int r=0; r<repetitions; r++)
+  {
+    seed(false);
+    if (PropagateNodeClasses(theGrid))
+      return 1;
+  }
+  const double fixed = SecondsSince(start);
+  std::vector<UINT> classes;
+  for (NODE *theNode=PFIRSTNODE(theGrid); theNode!=nullptr; theNode=SUCCN(theNode))
+    classes.push_back(NCLASS(theNode));
+
+  start = Clock::now();
+  for (int r=0; r<repetitions; r++)
+  {
+    seed(true);
+    PropagateNodeClassTable(theGrid,3);
+    PropagateNodeClassTable(theGrid,2);
+  }
+  Report("node classes",long(NT(theGrid))*repetitions,fixed,SecondsSince(start));
+
+  int errors = 0;
+  std::size_t i = 0;
+  for (NODE *theNode=PFIRSTNODE(theGrid); theNode!=nullptr; theNode=SUCCN(theNode))
+    errors += (NCLASS(theNode)!=classes[i++]);
+  return errors;
+}
+
+static int Run (int n, int levels, int repetitions, bool simplex)
+{
+  MULTIGRID *theMG = CreateStructuredMultiGrid("controlword", n, simplex);
+  if (theMG==nullptr)
+    return 1;
+  if (FixCoarseGrid(theMG))
+    return 1;
+  for (int l=0; l<levels; l++)
+    if (RefineGlobally(theMG))
+      return 1;
+
+  printf("%s\n", simplex ? "simplex" : "cube");
+  int errors = UsedFlags(theMG,repetitions);
+  errors += NodeClasses(theMG,repetitions);
+
+  DisposeMultiGrid(theMG);
+  return errors;
+}
+
+int main (int argc, char **argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+
+#ifdef UG_DIM_2
+  int n = 8;
+#else
+  int n = 2;
+#endif
+  int levels = 2;
+  int repetitions = 3;
+  if (argc>1) n = std::atoi(argv[1]);
+  if (argc>2) levels = std::atoi(argv[2]);
+  if (argc>3) repetitions = std::atoi(argv[3]);
+
+  if (InitUg(&argc, &argv))
+    return 1;
+
+  int errors = 0;
+  for (bool simplex : {false, true})
+    errors += Run(n, levels, repetitions, simplex);
+
+  ExitUg();
+
+  if (errors)
+    printf("controlword-benchmark: %d errors\n", errors);
+  return errors ? 1 : 0;
+}
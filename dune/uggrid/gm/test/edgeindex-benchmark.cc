@@ -0,0 +1,155 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************/
+/*                                                                          */
+/* File:      edgeindex-benchmark.cc                                        */
+/*                                                                          */
+/* Purpose:   compare GetEdge through the per-level edge index with the     */
+/*            walk through the link list of a node, on structured grids     */
+/*            and on a fan of elements around one node of high valence      */
+/*                                                                          */
+/*            usage: edgeindex-benchmark [cells per direction]              */
+/*                                       [refinement levels] [repetitions]  */
+/*                                       [elements of the fan]              */
+/*                                                                          */
+/****************************************************************************/
+
+#include "config.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/uggrid/initug.h>
+
+#include "structuredgrid.h"
+
+USING_UG_NAMESPACES
+
+/* triangles around the center of a disk, in 3D tetrahedra around the
+   center of a double cone, so that the center has valence k and more */
+static MULTIGRID *CreateFanMultiGrid (int k)
+{
+  std::vector<std::array<DOUBLE,DIM> > pos;
+  std::vector<std::vector<int> > elements;
+
+  pos.push_back({});
+  for (int i=0; i<k; i++)
+  {
+    std::array<DOUBLE,DIM> p{};
+    p[0] = std::cos(2*M_PI*i/k);
+    p[1] = std::sin(2*M_PI*i/k);
+    pos.push_back(p);
+  }
+#ifdef UG_DIM_2
+  for (int i=0; i<k; i++)
+    elements.push_back({0, 1+i, 1+(i+1)%k});
+#else
+  pos.push_back({0,0,1});
+  pos.push_back({0,0,-1});
+  for (int i=0; i<k; i++)
+  {
+    /* both positively oriented */
+    elements.push_back({0, 1+i, 1+(i+1)%k, k+1});
+    elements.push_back({0, 1+(i+1)%k, 1+i, k+2});
+  }
+#endif
+
+  return CreateMultiGridFromElements("edgeindexfan", pos, elements);
+}
+
+/* run refinement and edge lookups on one grid, return number of errors */
+static int Run (int n, int levels, int repetitions, int fan, bool simplex, bool indexed)
+{
+  MULTIGRID *theMG = fan ? CreateFanMultiGrid(fan)
+                     : CreateStructuredMultiGrid("edgeindex", n, simplex);
+  if (theMG==nullptr)
+    return 1;
+  if (SetEdgeIndex(theMG,indexed) || FixCoarseGrid(theMG))
+    return 1;
+
+  auto start = Clock::now();
+  for (int l=0; l<levels; l++)
+    if (RefineGlobally(theMG))
+      return 1;
+  const double refineTime = SecondsSince(start);
+
+  int errors = 0;
+  long lookups = 0;
+  start = Clock::now();
+  for (int r=0; r<repetitions; r++)
+    for (int l=0; l<=TOPLEVEL(theMG); l++)
+    {
+      const GRID *theGrid = GRID_ON_LEVEL(theMG,l);
+      for (ELEMENT *theElement=PFIRSTELEMENT(theGrid); theElement!=nullptr; theElement=SUCCE(theElement))
+        for (INT i=0; i<EDGES_OF_ELEM(theElement); i++)
+        {
+          errors += (GetEdge(theGrid,CORNER_OF_EDGE_PTR(theElement,i,1),
+                             CORNER_OF_EDGE_PTR(theElement,i,0))==nullptr);
+          lookups++;
+        }
+    }
+  const double lookupTime = SecondsSince(start);
+
+  /* both lookups have to find the same edges */
+  for (int l=0; l<=TOPLEVEL(theMG); l++)
+  {
+    const GRID *theGrid = GRID_ON_LEVEL(theMG,l);
+    if (indexed && theGrid->edgeIndex->size()!=std::size_t(NE(theGrid)))
+      errors++;
+    for (ELEMENT *theElement=PFIRSTELEMENT(theGrid); theElement!=nullptr; theElement=SUCCE(theElement))
+      for (INT i=0; i<EDGES_OF_ELEM(theElement); i++)
+        if (GetEdge(theGrid,CORNER_OF_EDGE_PTR(theElement,i,0),CORNER_OF_EDGE_PTR(theElement,i,1))
+            != GetEdge(CORNER_OF_EDGE_PTR(theElement,i,0),CORNER_OF_EDGE_PTR(theElement,i,1)))
+          errors++;
+  }
+
+  printf("%-8s %-10s refine %8.3fs  %10ld lookups %8.3fs  %6.1f ns/lookup\n",
+         fan ? "fan" : (simplex ? "simplex" : "cube"), indexed ? "index" : "link walk",
+         refineTime, lookups, lookupTime, 1e9*lookupTime/std::max(lookups,1L));
+
+  DisposeMultiGrid(theMG);
+  return errors;
+}
+
+int main (int argc, char **argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+
+#ifdef UG_DIM_2
+  int n = 8;
+#else
+  int n = 2;
+#endif
+  int levels = 2;
+  int repetitions = 3;
+  /* in 3D, all elements of the fan share the edges to the tips of the
+     cones, which can have at most NO_OF_ELEM_MAX-1 elements */
+#ifdef UG_DIM_2
+  int fan = 1024;
+#else
+  int fan = 100;
+#endif
+  if (argc>1) n = std::atoi(argv[1]);
+  if (argc>2) levels = std::atoi(argv[2]);
+  if (argc>3) repetitions = std::atoi(argv[3]);
+  if (argc>4) fan = std::atoi(argv[4]);
+
+  if (InitUg(&argc, &argv))
+    return 1;
+
+  int errors = 0;
+  for (bool simplex : {false, true})
+    for (bool indexed : {false, true})
+      errors += Run(n, levels, repetitions, 0, simplex, indexed);
+  for (bool indexed : {false, true})
+    errors += Run(n, levels, repetitions, fan, true, indexed);
+
+  ExitUg();
+
+  if (errors)
+    printf("edgeindex-benchmark: %d errors\n", errors);
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,278 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************/
+/*                                                                          */
+/* File:      evm-benchmark.cc                                              */
+/*                                                                          */
+/* Purpose:   compare the batched element geometry routines of evm.cc with  */
+/*            the routines for a single element                             */
+/*                                                                          */
+/*            usage: evm-benchmark [cells per direction]                    */
+/*                                 [refinement levels] [repetitions]        */
+/*                                                                          */
+/****************************************************************************/
+
+#include "config.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/uggrid/initug.h>
+#include <dune/uggrid/gm/evm.h>
+#include <dune/uggrid/gm/shapes.h>
+
+#include "structuredgrid.h"
+
+USING_UG_NAMESPACES
+
+/* corner coordinates of the elements of one tag in structure of arrays layout */
+struct Batch
+{
+  std::vector<ELEMENT*> elements;
+  std::vector<std::vector<DOUBLE> > data;
+  std::vector<DOUBLE*> x;
+
+  Batch (GRID *theGrid, INT tag)
+  {
+    for (ELEMENT *theElement=PFIRSTELEMENT(theGrid); theElement!=nullptr; theElement=SUCCE(theElement))
+      if (INT(TAG(theElement))==tag)
+        elements.push_back(theElement);
+    data.assign(DIM*CORNERS_OF_TAG(tag), std::vector<DOUBLE>(elements.size()));
+    for (auto& d : data)
+      x.push_back(d.data());
+  }
+
+  INT size () const { return elements.size(); }
+};
+
+/* arrays of n values each */
+struct Columns
+{
+  std::vector<std::vector<DOUBLE> > data;
+  std::vector<DOUBLE*> p;
+
+  Columns (int columns, INT n) : data(columns, std::vector<DOUBLE>(n))
+  {
+    for (auto& d : data)
+      p.push_back(d.data());
+  }
+};
+
+static bool Differ (DOUBLE a, DOUBLE b)
+{
+  return std::abs(a-b) > 1e-12*std::max(1.0,std::abs(a));
+}
+
+static void Report (const char *what, INT tag, INT n, int repetitions, double single, double batched)
+{
+  printf("%-14s tag %d %9d elements  single %6.1f ns  batched %6.1f ns  speedup %5.2f\n",
+         what, tag, n, 1e9*single/std::max(n*repetitions,1), 1e9*batched/std::max(n*repetitions,1),
+         batched>0.0 ? single/batched : 0.0);
+}
+
+static int Volumes (const Batch& batch, INT tag, int repetitions)
+{
+  const INT n = batch.size();
+  std::vector<DOUBLE> single(n), batched(n);
+
+  auto start = Clock::now();
+  for (int r=0; r<repetitions; r++)
+    for (INT e=0; e<n; e++)
+      single[e] = ElementVolume(batch.elements[e]);
+  const double singleTime = SecondsSince(start);
+
+  start = Clock::now();
+  for (int r=0; r<repetitions; r++)
+    GeneralElementVolumes(tag,n,batch.x.data(),batched.data());
+  Report("volume",tag,n,repetitions,singleTime,SecondsSince(start));
+
+  int errors = 0;
+  for (INT e=0; e<n; e++)
+    errors += Differ(single[e],batched[e]);
+  return errors;
+}
+
+#ifdef UG_DIM_3
+/* inverses of the matrices spanned by the edges at corner 0 of the elements */
+static int Inverses (const Batch& batch, INT tag, int repetitions)
+{
+  const INT n = batch.size();
+  Columns M(9,n), single(9,n), batched(9,n);
+  for (INT i=0; i<3; i++)
+  {
+    const INT edge = EDGE_OF_CORNER_TAG(tag,0,i);
+    const INT c = CORNER_OF_EDGE_TAG(tag,edge,0) + CORNER_OF_EDGE_TAG(tag,edge,1);
+    for (INT e=0; e<n; e++)
+      for (INT d=0; d<3; d++)
+        M.p[3*i+d][e] = batch.x[3*c+d][e] - batch.x[d][e];
+  }
+
+  int singleSingular = 0;
+  auto start = Clock::now();
+  for (int r=0; r<repetitions; r++)
+    for (INT e=0; e<n; e++)
+    {
+      DOUBLE m[9],im[9];
+      for (INT k=0; k<9; k++)
+        m[k] = M.p[k][e];
+      singleSingular += M3_Invert(im,m);
+      for (INT k=0; k<9; k++)
+        single.p[k][e] = im[k];
+    }
+  const double singleTime = SecondsSince(start);
+
+  int batchedSingular = 0;
+  start = Clock::now();
+  for (int r=0; r<repetitions; r++)
+    batchedSingular += M3_InvertBatch(n,M.p.data(),batched.p.data());
+  Report("inverse",tag,n,repetitions,singleTime,SecondsSince(start));
+
+  int errors = (singleSingular!=batchedSingular);
+  for (INT k=0; k<9; k++)
+    for (INT e=0; e<n; e++)
+      errors += Differ(single.p[k][e],batched.p[k][e]);
+  return errors;
+}
+
+static int TetrahedronQuality (const Batch& batch, int repetitions)
+{
+  const INT n = batch.size();
+  Columns normals(3*MAX_SIDES_OF_ELEM,n), angle(MAX_EDGES_OF_ELEM,n), length(MAX_EDGES_OF_ELEM,n);
+  std::vector<INT> degenerate(n);
+  int errors = 0;
+
+  /* side normals */
+  auto start = Clock::now();
+  for (int r=0; r<repetitions; r++)
+    for (INT e=0; e<n; e++)
+    {
+      DOUBLE *x[MAX_CORNERS_OF_ELEM];
+      [[maybe_unused]] INT nCorners;
+      DOUBLE_VECTOR theNormals[MAX_SIDES_OF_ELEM];
+      CORNER_COORDINATES(batch.elements[e],nCorners,x);
+      if (TetraSideNormals(batch.elements[e],x,theNormals))
+        errors++;
+      if (r==0)
+        for (INT k=0; k<4; k++)
+          for (INT d=0; d<3; d++)
+            normals.p[3*k+d][e] = theNormals[k][d];
+    }
+  double singleTime = SecondsSince(start);
+
+  Columns batchedNormals(3*MAX_SIDES_OF_ELEM,n);
+  start = Clock::now();
+  for (int r=0; r<repetitions; r++)
+    errors += TetraSideNormalsBatch(n,batch.x.data(),batchedNormals.p.data(),degenerate.data());
+  Report("side normals",TETRAHEDRON,n,repetitions,singleTime,SecondsSince(start));
+  for (INT k=0; k<3*4; k++)
+    for (INT e=0; e<n; e++)
+      errors += Differ(normals.p[k][e],batchedNormals.p[k][e]);
+
+  /* side angles and edge lengths */
+  start = Clock::now();
+  for (int r=0; r<repetitions; r++)
+    for (INT e=0; e<n; e++)
+    {
+      DOUBLE *x[MAX_CORNERS_OF_ELEM];
+      [[maybe_unused]] INT nCorners;
+      DOUBLE Angle[MAX_EDGES_OF_ELEM],Length[MAX_EDGES_OF_ELEM];
+      CORNER_COORDINATES(batch.elements[e],nCorners,x);
+      if (TetAngleAndLength(batch.elements[e],(const DOUBLE **)x,Angle,Length))
+        errors++;
+      if (r==0)
+        for (INT j=0; j<6; j++)
+        {
+          angle.p[j][e] = Angle[j];
+          length.p[j][e] = Length[j];
+        }
+    }
+  singleTime = SecondsSince(start);
+
+  Columns batchedAngle(MAX_EDGES_OF_ELEM,n), batchedLength(MAX_EDGES_OF_ELEM,n);
+  start = Clock::now();
+  for (int r=0; r<repetitions; r++)
+    errors += TetAngleAndLengthBatch(n,batch.x.data(),batchedAngle.p.data(),batchedLength.p.data(),degenerate.data());
+  Report("angle, length",TETRAHEDRON,n,repetitions,singleTime,SecondsSince(start));
+  for (INT j=0; j<6; j++)
+    for (INT e=0; e<n; e++)
+    {
+      errors += Differ(angle.p[j][e],batchedAngle.p[j][e]);
+      errors += Differ(length.p[j][e],batchedLength.p[j][e]);
+    }
+
+  return errors;
+}
+#endif
+
+static int Run (int n, int levels, int repetitions, bool simplex)
+{
+  MULTIGRID *theMG = CreateStructuredMultiGrid("evm", n, simplex);
+  if (theMG==nullptr)
+    return 1;
+  if (FixCoarseGrid(theMG))
+    return 1;
+  for (int l=0; l<levels; l++)
+    if (RefineGlobally(theMG))
+      return 1;
+
+  int errors = 0;
+  GRID *theGrid = GRID_ON_LEVEL(theMG,TOPLEVEL(theMG));
+  for (INT tag=0; tag<TAGS; tag++)
+  {
+    if (element_descriptors[tag]==nullptr)
+      continue;
+    Batch batch(theGrid,tag);
+    if (batch.size()==0)
+      continue;
+
+    const auto start = Clock::now();
+    if (GatherCornerCoordinates(batch.size(),batch.elements.data(),batch.x.data()))
+      return errors+1;
+    printf("gather         tag %d %9d elements  %6.1f ns\n",
+           tag, batch.size(), 1e9*SecondsSince(start)/batch.size());
+
+    errors += Volumes(batch,tag,repetitions);
+#ifdef UG_DIM_3
+    errors += Inverses(batch,tag,repetitions);
+    if (tag==TETRAHEDRON)
+      errors += TetrahedronQuality(batch,repetitions);
+#endif
+  }
+
+  DisposeMultiGrid(theMG);
+  return errors;
+}
+
+int main (int argc, char **argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+
+#ifdef UG_DIM_2
+  int n = 8;
+#else
+  int n = 2;
+#endif
+  int levels = 2;
+  int repetitions = 3;
+  if (argc>1) n = std::atoi(argv[1]);
+  if (argc>2) levels = std::atoi(argv[2]);
+  if (argc>3) repetitions = std::atoi(argv[3]);
+
+  if (InitUg(&argc, &argv))
+    return 1;
+
+  int errors = 0;
+  for (bool simplex : {false, true})
+    errors += Run(n, levels, repetitions, simplex);
+
+  ExitUg();
+
+  if (errors)
+    printf("evm-benchmark: %d errors\n", errors);
+  return errors ? 1 : 0;
+}
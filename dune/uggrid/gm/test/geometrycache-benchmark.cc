@@ -0,0 +1,164 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************/
+/*                                                                          */
+/* File:      geometrycache-benchmark.cc                                    */
+/*                                                                          */
+/* Purpose:   compare ElementVolume, CalculateCenterOfMass and              */
+/*            UG_GlobalToLocal with and without the geometry cache          */
+/*                                                                          */
+/*            usage: geometrycache-benchmark [cells per direction]          */
+/*                                           [refinement levels]            */
+/*                                           [repetitions]                  */
+/*                                                                          */
+/****************************************************************************/
+
+#include "config.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/uggrid/initug.h>
+#include <dune/uggrid/gm/evm.h>
+#include <dune/uggrid/gm/shapes.h>
+
+#include "structuredgrid.h"
+
+USING_UG_NAMESPACES
+
+/* sum of all quantities, with or without the cache */
+static DOUBLE Evaluate (MULTIGRID *theMG, bool cached, long& evaluations)
+{
+  DOUBLE sum = 0.0;
+  for (int l=0; l<=TOPLEVEL(theMG); l++)
+  {
+    const GRID *theGrid = cached ? GRID_ON_LEVEL(theMG,l) : nullptr;
+    for (ELEMENT *theElement=PFIRSTELEMENT(GRID_ON_LEVEL(theMG,l)); theElement!=nullptr; theElement=SUCCE(theElement))
+    {
+      DOUBLE_VECTOR center, local;
+      if (cached)
+        CalculateCenterOfMass(theGrid,theElement,center);
+      else
+        CalculateCenterOfMass(theElement,center);
+      sum += cached ? ElementVolume(theGrid,theElement) : ElementVolume(theElement);
+      UG_GlobalToLocal(theGrid,theElement,center,local);
+      for (int i=0; i<DIM; i++)
+        sum += center[i] + local[i];
+      evaluations++;
+    }
+  }
+  return sum;
+}
+
+/* every element has an entry that agrees with the uncached functions */
+static int Check (MULTIGRID *theMG)
+{
+  int errors = 0;
+  for (int l=0; l<=TOPLEVEL(theMG); l++)
+  {
+    const GRID *theGrid = GRID_ON_LEVEL(theMG,l);
+    if (theGrid->geometryCache==nullptr
+        || theGrid->geometryCache->element.size()!=std::size_t(NT(theGrid)))
+      return errors+1;
+    for (ELEMENT *theElement=PFIRSTELEMENT(theGrid); theElement!=nullptr; theElement=SUCCE(theElement))
+    {
+      DOUBLE_VECTOR center, cachedCenter, local, cachedLocal;
+      DOUBLE *x[MAX_CORNERS_OF_ELEM];
+      INT n;
+      CORNER_COORDINATES(theElement,n,x);
+      CalculateCenterOfMass(theElement,center);
+      CalculateCenterOfMass(theGrid,theElement,cachedCenter);
+      UG_GlobalToLocal(n,(const DOUBLE **)x,center,local);
+      UG_GlobalToLocal(theGrid,theElement,center,cachedLocal);
+      errors += (GeometryCacheSlot(theGrid,theElement)<0);
+      errors += (ElementVolume(theElement)!=ElementVolume(theGrid,theElement));
+      DOUBLE_VECTOR mean(0.0);
+      for (INT i=0; i<n; i++)
+        for (int d=0; d<DIM; d++)
+          mean[d] += x[i][d]/n;
+      errors += ((center-mean).infinity_norm() > 1e-12);
+      errors += (center!=cachedCenter);
+      errors += (local!=cachedLocal);
+    }
+  }
+  return errors;
+}
+
+static int Run (int n, int levels, int repetitions, bool simplex)
+{
+  MULTIGRID *theMG = CreateStructuredMultiGrid("geometrycache", n, simplex);
+  if (theMG==nullptr)
+    return 1;
+  if (FixCoarseGrid(theMG))
+    return 1;
+  for (int l=0; l<levels; l++)
+    if (RefineGlobally(theMG))
+      return 1;
+
+  int errors = 0;
+  DOUBLE sum[2];
+  double seconds[2];
+  long evaluations = 0;
+  for (bool cached : {false, true})
+  {
+    if (cached)
+    {
+      const auto start = Clock::now();
+      if (SetGeometryCache(theMG,true))
+        return 1;
+      printf("%-8s cache built in %.3fs\n", simplex ? "simplex" : "cube", SecondsSince(start));
+    }
+    evaluations = 0;
+    sum[cached] = 0.0;
+    const auto start = Clock::now();
+    for (int r=0; r<repetitions; r++)
+      sum[cached] += Evaluate(theMG, cached, evaluations);
+    seconds[cached] = SecondsSince(start);
+    printf("%-8s %-9s %9ld elements  %8.3fs  %6.1f ns/element\n",
+           simplex ? "simplex" : "cube", cached ? "cached" : "computed",
+           evaluations, seconds[cached], 1e9*seconds[cached]/std::max(evaluations,1L));
+  }
+  errors += (sum[0]!=sum[1]);
+  errors += Check(theMG);
+
+  /* the caches follow adaptation, only the new elements are computed */
+  const auto start = Clock::now();
+  if (RefineGlobally(theMG))
+    return 1;
+  printf("%-8s adapted with cache in %.3fs\n", simplex ? "simplex" : "cube", SecondsSince(start));
+  errors += Check(theMG);
+
+  DisposeMultiGrid(theMG);
+  return errors;
+}
+
+int main (int argc, char **argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+
+#ifdef UG_DIM_2
+  int n = 8;
+#else
+  int n = 2;
+#endif
+  int levels = 2;
+  int repetitions = 3;
+  if (argc>1) n = std::atoi(argv[1]);
+  if (argc>2) levels = std::atoi(argv[2]);
+  if (argc>3) repetitions = std::atoi(argv[3]);
+
+  if (InitUg(&argc, &argv))
+    return 1;
+
+  int errors = 0;
+  for (bool simplex : {false, true})
+    errors += Run(n, levels, repetitions, simplex);
+
+  ExitUg();
+
+  if (errors)
+    printf("geometrycache-benchmark: %d errors\n", errors);
+  return errors ? 1 : 0;
+}
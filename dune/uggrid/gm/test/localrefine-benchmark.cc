@@ -0,0 +1,204 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************/
+/*                                                                          */
+/* File:      localrefine-benchmark.cc                                      */
+/*                                                                          */
+/* Purpose:   time AdaptMultiGrid for local refinement of a few elements of */
+/*            a large grid, once with the worklist closure and once with    */
+/*            the closure sweeping all elements (MG_CLOSURE_WORKLIST), and  */
+/*            once adapting only the region around the marked elements      */
+/*            (MG_ADAPT_INCREMENTAL), and check that all give the same grid */
+/*            with the same marks and classes, also after coarsening        */
+/*                                                                          */
+/*            usage: localrefine-benchmark [cells per direction]            */
+/*                                         [refinement levels] [steps]      */
+/*                                         [marked elements per step]       */
+/*                                                                          */
+/****************************************************************************/
+
+#include "config.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/uggrid/initug.h>
+
+#include "structuredgrid.h"
+
+USING_UG_NAMESPACES
+
+/* hash of the ids of the elements in list order, their corners, refinement
+   and marks, and of the classes of the nodes and vectors */
+static std::uint64_t Fingerprint (MULTIGRID *theMG)
+{
+  std::uint64_t hash = 1469598103934665603ull;
+  const auto add = [&hash](std::uint64_t value) {
+                     hash = (hash ^ value) * 1099511628211ull;
+                   };
+
+  for (int l=0; l<=TOPLEVEL(theMG); l++)
+  {
+    const GRID *theGrid = GRID_ON_LEVEL(theMG,l);
+    for (ELEMENT *theElement=PFIRSTELEMENT(theGrid); theElement!=nullptr; theElement=SUCCE(theElement))
+    {
+      add(ID(theElement));
+      add(REFINE(theElement));
+      add(REFINECLASS(theElement));
+      add(MARK(theElement));
+      add(MARKCLASS(theElement));
+      add(COARSEN(theElement));
+      for (INT i=0; i<CORNERS_OF_ELEM(theElement); i++)
+        add(ID(CORNER(theElement,i)));
+#ifdef UG_DIM_3
+      for (INT i=0; i<SIDES_OF_ELEM(theElement); i++)
+      {
+        const VECTOR *v = SVECTOR(theElement,i);
+        add(VCLASS(v));
+        add(VNCLASS(v));
+        add(VNEW(v));
+        add(FINE_GRID_DOF(v));
+      }
+#endif
+    }
+    for (NODE *theNode=PFIRSTNODE(theGrid); theNode!=nullptr; theNode=SUCCN(theNode))
+    {
+      add(ID(theNode));
+      add(NCLASS(theNode));
+      add(NNCLASS(theNode));
+    }
+  }
+  add(FULLREFINELEVEL(theMG));
+
+  return hash;
+}
+
+/* refine a grid globally, then refine a few elements at a time */
+static int Run (int n, int levels, int steps, int marks, bool simplex, bool worklist,
+                bool incremental, std::uint64_t& fingerprint)
+{
+  MULTIGRID *theMG = CreateStructuredMultiGrid("localrefine", n, simplex);
+  if (theMG==nullptr)
+    return 1;
+  MG_CLOSURE_WORKLIST(theMG) = worklist;
+  MG_ADAPT_INCREMENTAL(theMG) = incremental;
+  if (FixCoarseGrid(theMG))
+    return 1;
+
+  for (int l=0; l<levels; l++)
+    if (RefineGlobally(theMG))
+      return 1;
+  const long elements = NT(GRID_ON_LEVEL(theMG,levels));
+
+  /* the marked elements move through the leaf elements of the finest
+     global level, like a front */
+  double adaptTime = 0.0;
+  for (int s=0; s<steps; s++)
+  {
+    std::vector<ELEMENT*> leaves;
+    for (ELEMENT *theElement=PFIRSTELEMENT(GRID_ON_LEVEL(theMG,levels));
+         theElement!=nullptr; theElement=SUCCE(theElement))
+      if (EstimateHere(theElement))
+        leaves.push_back(theElement);
+    const std::size_t stride = std::max<std::size_t>(1, leaves.size()/marks);
+    for (std::size_t i=(s*7919)%stride; i<leaves.size(); i+=stride)
+      MarkForRefinement(leaves[i],RED,0);
+
+    /* and the front leaves some elements behind */
+    long finer = 0;
+    for (int l=levels+1; l<=TOPLEVEL(theMG); l++)
+      for (ELEMENT *theElement=PFIRSTELEMENT(GRID_ON_LEVEL(theMG,l));
+           theElement!=nullptr; theElement=SUCCE(theElement))
+        if (EstimateHere(theElement) && (finer++)%3==0)
+          MarkForRefinement(theElement,COARSE,0);
+
+    const auto start = Clock::now();
+    if (AdaptMultiGrid(theMG,GM_REFINE_TRULY_LOCAL,GM_REFINE_PARALLEL,GM_REFINE_NOHEAPTEST))
+      return 1;
+    adaptTime += SecondsSince(start);
+  }
+
+  int errors = 0;
+  long total = 0;
+  const auto check = [&]() {
+                       total = 0;
+                       for (int l=0; l<=TOPLEVEL(theMG); l++)
+                       {
+                         GRID *theGrid = GRID_ON_LEVEL(theMG,l);
+                         total += NT(theGrid);
+#ifdef ModelP
+                         errors += (CheckGrid(theGrid,1,0,1,0)!=GM_OK);
+#else
+                         errors += (CheckGrid(theGrid,1,0,1)!=GM_OK);
+#endif
+                       }
+                       return Fingerprint(theMG);
+                     };
+  fingerprint = check();
+  const long refinedTotal = total;
+
+  /* coarsen the locally refined elements again */
+  for (int s=0; s<2; s++)
+  {
+    for (int l=levels+1; l<=TOPLEVEL(theMG); l++)
+      for (ELEMENT *theElement=PFIRSTELEMENT(GRID_ON_LEVEL(theMG,l));
+           theElement!=nullptr; theElement=SUCCE(theElement))
+        if (EstimateHere(theElement))
+          MarkForRefinement(theElement,COARSE,0);
+    if (AdaptMultiGrid(theMG,GM_REFINE_TRULY_LOCAL,GM_REFINE_PARALLEL,GM_REFINE_NOHEAPTEST))
+      return 1;
+  }
+  fingerprint ^= check() << 1;
+
+  printf("%-8s %-11s %9ld elements on level %d, %9ld in total  adapt %8.3f ms/step\n",
+         simplex ? "simplex" : "cube",
+         incremental ? "incremental" : (worklist ? "worklist" : "sweep"),
+         elements, levels, refinedTotal, 1e3*adaptTime/steps);
+
+  DisposeMultiGrid(theMG);
+  return errors;
+}
+
+int main (int argc, char **argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+
+#ifdef UG_DIM_2
+  int n = 8;
+#else
+  int n = 2;
+#endif
+  int levels = 2;
+  int steps = 4;
+  int marks = 4;
+  if (argc>1) n = std::atoi(argv[1]);
+  if (argc>2) levels = std::atoi(argv[2]);
+  if (argc>3) steps = std::atoi(argv[3]);
+  if (argc>4) marks = std::atoi(argv[4]);
+
+  if (InitUg(&argc, &argv))
+    return 1;
+
+  int errors = 0;
+  for (bool simplex : {false, true})
+  {
+    std::uint64_t sweepFingerprint, worklistFingerprint, incrementalFingerprint;
+    errors += Run(n, levels, steps, marks, simplex, false, false, sweepFingerprint);
+    errors += Run(n, levels, steps, marks, simplex, true, false, worklistFingerprint);
+    errors += Run(n, levels, steps, marks, simplex, true, true, incrementalFingerprint);
+    if (sweepFingerprint!=worklistFingerprint)
+      errors++;
+    if (sweepFingerprint!=incrementalFingerprint)
+      errors++;
+  }
+
+  ExitUg();
+
+  if (errors)
+    printf("localrefine-benchmark: %d errors\n", errors);
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,238 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************/
+/*                                                                          */
+/* File:      patternrules-benchmark.cc                                     */
+/*                                                                          */
+/* Purpose:   time the rule lookup of the closure (PATTERN2MARK) with the   */
+/*            pattern tables of Patterns2Rules and with the switch ladders  */
+/*            they replaced, and check that both give the same rules for    */
+/*            all patterns                                                  */
+/*                                                                          */
+/*            usage: patternrules-benchmark [cells per direction]           */
+/*                                          [refinement levels]             */
+/*                                          [repetitions]                   */
+/*                                                                          */
+/****************************************************************************/
+
+#include "config.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/uggrid/initug.h>
+#include <dune/uggrid/gm/rm.h>
+
+#include "structuredgrid.h"
+
+USING_UG_NAMESPACES
+
+/* Patterns2Rules before the pattern tables, -2 for patterns without rule */
+static INT SwitchPatterns2Rules (const ELEMENT *theElement, INT pattern)
+{
+#ifdef UG_DIM_2
+  switch (TAG(theElement)) {
+  case (TRIANGLE) :
+    switch (pattern) {
+    case (0) : return(T_NOREF);
+    case (1) : return(T_BISECT_1_0);
+    case (2) : return(T_BISECT_1_1);
+    case (3) : return(T_BISECT_2_T1_2);
+    case (4) : return(T_BISECT_1_2);
+    case (5) : return(T_BISECT_2_T1_1);
+    case (6) : return(T_BISECT_2_T1_0);
+    case (7) : return(T_RED);
+    default : return(-2);
+    }
+  case (QUADRILATERAL) :
+    switch (pattern) {
+    case (0) : return(Q_NOREF);
+    case (5) : return(Q_BLUE_0);
+    case (7) : return(Q_CLOSE_3_3);
+    case (10) : return(Q_BLUE_1);
+    case (11) : return(Q_CLOSE_3_2);
+    case (13) : return(Q_CLOSE_3_1);
+    case (14) : return(Q_CLOSE_3_0);
+    case (1) :
+    case (17) : return(Q_CLOSE_2_0);
+    case (2) :
+    case (18) : return(Q_CLOSE_2_1);
+    case (3) :
+    case (19) : return(Q_CLOSE_1_0);
+    case (4) :
+    case (20) : return(Q_CLOSE_2_2);
+    case (6) :
+    case (22) : return(Q_CLOSE_1_1);
+    case (8) :
+    case (24) : return(Q_CLOSE_2_3);
+    case (9) :
+    case (25) : return(Q_CLOSE_1_3);
+    case (12) :
+    case (28) : return(Q_CLOSE_1_2);
+    case (15) :
+    case (31) : return(Q_RED);
+    default : return(-2);
+    }
+  default : return(-2);
+  }
+#else
+  switch (TAG(theElement)) {
+  case (TETRAHEDRON) :
+#ifdef DUNE_UGGRID_TET_RULESET
+    if (pattern >= (1<<11)) return(-2);
+    return(Pattern2Rule[TETRAHEDRON][pattern & (~(1<<10))]);
+#else
+    if (MARKCLASS(theElement) != RED_CLASS) return(0);
+    switch (pattern) {
+    case (0) : return(0);
+    case (63) : return(TET_RED);
+    case (1023) : return(TET_RED_HEX);
+    default : return(-2);
+    }
+#endif
+  case (PYRAMID) :
+    if (MARKCLASS(theElement) != RED_CLASS) return(0);
+    switch (pattern) {
+    case (0) : return(0);
+    case (511) : return(PYR_RED);
+    default : return(-2);
+    }
+  case (PRISM) :
+    if (MARKCLASS(theElement) != RED_CLASS) return(0);
+    switch (pattern) {
+    case (0) : return(0);
+    case (7679) : return(PRI_RED);
+    case (455) : return(PRI_QUADSECT);
+    case 56 : return PRI_BISECT_1_2;
+    case 65 : return PRI_BISECT_0_1;
+    case 130 : return PRI_BISECT_0_2;
+    case 260 : return PRI_BISECT_0_3;
+    case 325 : return PRI_BISECT_HEX0;
+    case 195 : return PRI_BISECT_HEX1;
+    case 390 : return PRI_BISECT_HEX2;
+    default : return(-2);
+    }
+  case (HEXAHEDRON) :
+    if (MARKCLASS(theElement) != RED_CLASS) return(0);
+    switch (pattern) {
+    case (0) : return(0);
+    case (262143) : return(HEXA_RED);
+    case (1285) : return HEXA_BISECT_0_1;
+    case (2570) : return HEXA_BISECT_0_2;
+    case (240) : return HEXA_BISECT_0_3;
+    case (139023) : return HEXA_QUADSECT_0;
+    case (42485) : return HEXA_QUADSECT_1;
+    case (84730) : return HEXA_QUADSECT_2;
+    case (5) : return HEXA_TRISECT_0;
+    case (1280) : return HEXA_TRISECT_5;
+    case (2056) : return HEXA_BISECT_HEXPRI0;
+    case (257) : return HEXA_BISECT_HEXPRI1;
+    default : return(-2);
+    }
+  default : return(-2);
+  }
+#endif
+}
+
+/* Patterns2Rules was in another translation unit, so do not let the
+   compiler inline it here */
+static INT (*volatile switchPatterns2Rules)(const ELEMENT *, INT) = SwitchPatterns2Rules;
+
+/* PATTERN2MARK before the pattern tables */
+static INT SwitchPattern2Mark (const ELEMENT *theElement, INT pattern)
+{
+  return((switchPatterns2Rules(theElement,pattern)>=0) ?
+         RefRules[TAG(theElement)][switchPatterns2Rules(theElement,pattern)].mark : -1);
+}
+
+static int Run (int n, int levels, int repetitions, bool simplex)
+{
+  MULTIGRID *theMG = CreateStructuredMultiGrid("patternrules", n, simplex);
+  if (theMG==nullptr)
+    return 1;
+  if (FixCoarseGrid(theMG))
+    return 1;
+  for (int l=0; l<levels; l++)
+    if (RefineGlobally(theMG))
+      return 1;
+
+  /* the patterns with a rule, for the element type of the grid */
+  GRID *theGrid = GRID_ON_LEVEL(theMG,TOPLEVEL(theMG));
+  ELEMENT *first = PFIRSTELEMENT(theGrid);
+  SETMARKCLASS(first,RED_CLASS);
+  std::vector<INT> patterns;
+  for (INT pattern=0; pattern<(1<<18); pattern++)
+    if (SwitchPatterns2Rules(first,pattern)>=0)
+      patterns.push_back(pattern);
+
+  int errors = 0;
+  for (INT pattern : patterns)
+    errors += (Patterns2Rules(first,pattern)!=SwitchPatterns2Rules(first,pattern));
+
+  /* the closure looks up the pattern of every element, here a random one */
+  std::vector<ELEMENT*> elements;
+  std::vector<INT> elementPatterns;
+  unsigned int random = 12345;
+  for (ELEMENT *theElement=first; theElement!=nullptr; theElement=SUCCE(theElement))
+  {
+    random = random*1103515245u + 12345u;
+    SETMARKCLASS(theElement,(random>>16)%3 ? RED_CLASS : GREEN_CLASS);
+    elements.push_back(theElement);
+    elementPatterns.push_back(patterns[(random>>8)%patterns.size()]);
+  }
+
+  long sumTable = 0, sumSwitch = 0;
+  auto start = Clock::now();
+  for (int r=0; r<repetitions; r++)
+    for (std::size_t i=0; i<elements.size(); i++)
+      sumTable += PATTERN2MARK(elements[i],elementPatterns[i]);
+  const double table = SecondsSince(start);
+
+  start = Clock::now();
+  for (int r=0; r<repetitions; r++)
+    for (std::size_t i=0; i<elements.size(); i++)
+      sumSwitch += SwitchPattern2Mark(elements[i],elementPatterns[i]);
+  const double ladder = SecondsSince(start);
+  errors += (sumTable!=sumSwitch);
+
+  const long lookups = long(elements.size())*repetitions;
+  printf("%-8s %4zu patterns %9ld lookups  switch %6.2f ns  table %6.2f ns  speedup %5.2f\n",
+         simplex ? "simplex" : "cube", patterns.size(), lookups,
+         1e9*ladder/std::max(lookups,1L), 1e9*table/std::max(lookups,1L),
+         table>0.0 ? ladder/table : 0.0);
+
+  DisposeMultiGrid(theMG);
+  return errors;
+}
+
+int main (int argc, char **argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+
+#ifdef UG_DIM_2
+  int n = 8;
+#else
+  int n = 2;
+#endif
+  int levels = 2;
+  int repetitions = 20;
+  if (argc>1) n = std::atoi(argv[1]);
+  if (argc>2) levels = std::atoi(argv[2]);
+  if (argc>3) repetitions = std::atoi(argv[3]);
+
+  if (InitUg(&argc, &argv))
+    return 1;
+
+  int errors = 0;
+  for (bool simplex : {false, true})
+    errors += Run(n, levels, repetitions, simplex);
+
+  ExitUg();
+
+  if (errors)
+    printf("patternrules-benchmark: %d errors\n", errors);
+  return errors ? 1 : 0;
+}
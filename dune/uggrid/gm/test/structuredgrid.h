@@ -0,0 +1,326 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************/
+/*                                                                          */
+/* File:      structuredgrid.h                                              */
+/*                                                                          */
+/* Purpose:   structured coarse grids of the unit square/cube for the       */
+/*            gm tests and benchmarks                                       */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef UG_GM_TEST_STRUCTUREDGRID_H
+#define UG_GM_TEST_STRUCTUREDGRID_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <dune/uggrid/gm/gm.h>
+#include <dune/uggrid/gm/refine.h>
+#include <dune/uggrid/gm/ugm.h>
+#include <dune/uggrid/domain/std_domain.h>
+
+START_UGDIM_NAMESPACE
+
+using Clock = std::chrono::steady_clock;
+
+inline double SecondsSince (Clock::time_point start)
+{
+  return std::chrono::duration<double>(Clock::now()-start).count();
+}
+
+/** \brief Create the parametric boundary segment of a boundary face
+
+   The arguments are the segment id, the number of corners of the face,
+   their boundary point ids (-1 for the fourth one of a triangle) and
+   their coordinates.
+ */
+using ParametricSegmentFactory
+  = std::function<boundary_segment(INT, INT, const INT *,
+                                   const std::array<Dune::FieldVector<DOUBLE,DIM>, CORNERS_OF_BND_SEG>&)>;
+
+/** \brief Create a multigrid from a coarse mesh
+
+   pos are the vertex positions, elements the corners of the elements in
+   UG reference element order, tetrahedra positively oriented. The
+   boundary is made of the faces with only one element. The other
+   arguments are as for CreateStructuredMultiGrid.
+
+   \return the multigrid, or nullptr on error
+ */
+inline MULTIGRID *CreateMultiGridFromElements (const char *name,
+                                               const std::vector<std::array<DOUBLE,DIM> >& pos,
+                                               const std::vector<std::vector<int> >& elements,
+                                               bool bulk = false, int nThreads = 0,
+                                               const ParametricSegmentFactory& parametric = nullptr)
+{
+  using Point = std::array<DOUBLE,DIM>;
+  const int nVertices = pos.size();
+
+  /* boundary faces are the faces with only one element, oriented outwards
+     in 2D and inwards in 3D */
+  std::map<std::vector<int>, std::pair<std::vector<int>,int> > faces;
+  for (const auto& element : elements)
+  {
+    std::vector<std::vector<int> > elementFaces;
+#ifdef UG_DIM_2
+    for (std::size_t i=0; i<element.size(); i++)
+      elementFaces.push_back({element[i],element[(i+1)%element.size()]});
+#else
+    if (element.size()==4)
+      elementFaces = {{element[0],element[1],element[2]},{element[0],element[1],element[3]},
+                      {element[1],element[2],element[3]},{element[0],element[2],element[3]}};
+    else
+    {
+      const int hexFaces[6][4] = {{0,1,2,3},{0,1,5,4},{1,2,6,5},{2,3,7,6},{3,0,4,7},{4,5,6,7}};
+      for (const auto& f : hexFaces)
+        elementFaces.push_back({element[f[0]],element[f[1]],element[f[2]],element[f[3]]});
+    }
+#endif
+    Point center{};
+    for (int v : element)
+      for (int d=0; d<DIM; d++)
+        center[d] += pos[v][d]/element.size();
+    for (auto& face : elementFaces)
+    {
+      Point faceCenter{};
+      for (int v : face)
+        for (int d=0; d<DIM; d++)
+          faceCenter[d] += pos[v][d]/face.size();
+      DOUBLE normal[3] = {0,0,0};
+#ifdef UG_DIM_2
+      normal[0] = pos[face[1]][1]-pos[face[0]][1];
+      normal[1] = pos[face[0]][0]-pos[face[1]][0];
+      const bool outwards = true;
+#else
+      DOUBLE a[3], b[3];
+      for (int d=0; d<3; d++)
+      {
+        a[d] = pos[face[1]][d]-pos[face[0]][d];
+        b[d] = pos[face[2]][d]-pos[face[0]][d];
+      }
+      normal[0] = a[1]*b[2]-a[2]*b[1];
+      normal[1] = a[2]*b[0]-a[0]*b[2];
+      normal[2] = a[0]*b[1]-a[1]*b[0];
+      const bool outwards = false;
+#endif
+      DOUBLE sp = 0;
+      for (int d=0; d<DIM; d++)
+        sp += normal[d]*(faceCenter[d]-center[d]);
+      if ((sp>0) != outwards)
+        std::reverse(face.begin(),face.end());
+      auto key = face;
+      std::sort(key.begin(),key.end());
+      auto& entry = faces[key];
+      entry.first = face;
+      entry.second++;
+    }
+  }
+
+  std::vector<int> boundaryIndex(nVertices,-1);
+  std::vector<std::vector<int> > boundaryFaces;
+  int nBoundaryVertices = 0;
+  for (const auto& [key,entry] : faces)
+    if (entry.second==1)
+    {
+      boundaryFaces.push_back(entry.first);
+      for (int v : entry.first)
+        if (boundaryIndex[v]<0)
+          boundaryIndex[v] = nBoundaryVertices++;
+    }
+
+  auto theDomain = std::make_unique<domain>();
+  theDomain->numOfSegments = boundaryFaces.size();
+  theDomain->numOfCorners = nBoundaryVertices;
+  for (std::size_t s=0; s<boundaryFaces.size(); s++)
+  {
+    std::array<Dune::FieldVector<DOUBLE,DIM>, CORNERS_OF_BND_SEG> x;
+    INT points[CORNERS_OF_BND_SEG];
+    std::fill(points, points+CORNERS_OF_BND_SEG, -1);
+    for (std::size_t i=0; i<boundaryFaces[s].size(); i++)
+    {
+      points[i] = boundaryIndex[boundaryFaces[s][i]];
+      for (int d=0; d<DIM; d++)
+        x[i][d] = pos[boundaryFaces[s][i]][d];
+    }
+    if (parametric)
+      theDomain->boundarySegments.push_back(parametric(s, boundaryFaces[s].size(), points, x));
+    else
+      theDomain->linearSegments.emplace_back(s, boundaryFaces[s].size(), points, x);
+  }
+  BVP theBVP = new STD_BVP;
+  theBVP->Domain = std::move(theDomain);
+
+  std::vector<char> mgName(name, name+std::strlen(name)+1);
+  MULTIGRID *theMG = CreateMultiGrid(mgName.data(), theBVP, "DuneFormat", 1, 1);
+  if (theMG==nullptr)
+    return nullptr;
+  for (int i=0; i<theBVP->nsides; i++)
+  {
+    PATCH *thePatch = theBVP->patches[theBVP->sideoffset+i];
+    if (PATCH_TYPE(thePatch) == PARAMETRIC_PATCH_TYPE)
+    {
+      PARAM_PATCH_LEFT(thePatch) = 1;
+      PARAM_PATCH_RIGHT(thePatch) = 0;
+    }
+    else
+    {
+      LINEAR_PATCH_LEFT(thePatch) = 1;
+      LINEAR_PATCH_RIGHT(thePatch) = 0;
+    }
+  }
+
+  /* boundary nodes have been created from the domain, match them by position */
+  GRID *theGrid = GRID_ON_LEVEL(theMG,0);
+  std::vector<NODE*> nodes(nVertices,nullptr);
+  std::map<std::array<long,DIM>, int> byPosition;
+  for (int v=0; v<nVertices; v++)
+  {
+    std::array<long,DIM> key;
+    for (int d=0; d<DIM; d++)
+      key[d] = std::lround(pos[v][d]*(1<<20));
+    byPosition[key] = v;
+  }
+  for (NODE *theNode=PFIRSTNODE(theGrid); theNode!=nullptr; theNode=SUCCN(theNode))
+  {
+    std::array<long,DIM> key;
+    for (int d=0; d<DIM; d++)
+      key[d] = std::lround(CVECT(MYVERTEX(theNode))[d]*(1<<20));
+    nodes[byPosition.at(key)] = theNode;
+  }
+  for (int v=0; v<nVertices; v++)
+    if (boundaryIndex[v]<0)
+      nodes[v] = InsertInnerNode(theGrid,pos[v].data());
+
+  ELEMENT *noNeighbors[MAX_SIDES_OF_ELEM] = {};
+  for (const auto& element : elements)
+  {
+    NODE *corners[MAX_CORNERS_OF_ELEM];
+    for (std::size_t i=0; i<element.size(); i++)
+      corners[i] = nodes[element[i]];
+    if (InsertElement(theGrid,element.size(),corners,bulk ? noNeighbors : nullptr,nullptr,nullptr)==nullptr)
+    {
+      DisposeMultiGrid(theMG);
+      return nullptr;
+    }
+  }
+  if (bulk && SetElementNeighbors(theGrid,nThreads)!=GM_OK)
+  {
+    DisposeMultiGrid(theMG);
+    return nullptr;
+  }
+
+  return theMG;
+}
+
+/** \brief Create a multigrid on the unit square/cube with n^DIM cells
+
+   The cells are quadrilaterals/hexahedra, or triangles/tetrahedra
+   (2 resp. 6 per cell) if simplex is set. The boundary is made of one
+   linear segment per boundary face, or of the segments created by
+   parametric if that is set. FixCoarseGrid is not called, so the caller
+   may still change multigrid options.
+
+   If bulk is set, the elements are inserted without neighbor search and
+   the neighbors are set afterwards by SetElementNeighbors with nThreads
+   threads.
+
+   \return the multigrid, or nullptr on error
+ */
+inline MULTIGRID *CreateStructuredMultiGrid (const char *name, int n, bool simplex,
+                                             bool bulk = false, int nThreads = 0,
+                                             const ParametricSegmentFactory& parametric = nullptr)
+{
+  using Point = std::array<DOUBLE,DIM>;
+
+  const auto vertexIndex = [n](std::array<int,DIM> c) {
+                             int r = 0;
+                             for (int d=DIM-1; d>=0; d--)
+                               r = r*(n+1) + c[d];
+                             return r;
+                           };
+
+  int nVertices = 1, nCells = 1;
+  for (int d=0; d<DIM; d++)
+  {
+    nVertices *= n+1;
+    nCells *= n;
+  }
+  std::vector<Point> pos(nVertices);
+  for (int v=0; v<nVertices; v++)
+    for (int d=0, r=v; d<DIM; d++, r/=n+1)
+      pos[v][d] = DOUBLE(r%(n+1))/n;
+
+  /* elements, corners in UG reference element order */
+  std::vector<std::vector<int> > elements;
+  for (int c=0; c<nCells; c++)
+  {
+    std::array<int,DIM> origin;
+    for (int d=0, r=c; d<DIM; d++, r/=n)
+      origin[d] = r%n;
+    const auto corner = [&](int bits) {
+                          auto p = origin;
+                          for (int d=0; d<DIM; d++)
+                            if (bits & (1<<d))
+                              p[d]++;
+                          return vertexIndex(p);
+                        };
+#ifdef UG_DIM_2
+    if (!simplex)
+      elements.push_back({corner(0),corner(1),corner(3),corner(2)});
+    else
+    {
+      elements.push_back({corner(0),corner(1),corner(3)});
+      elements.push_back({corner(0),corner(3),corner(2)});
+    }
+#else
+    if (!simplex)
+      elements.push_back({corner(0),corner(1),corner(3),corner(2),
+                          corner(4),corner(5),corner(7),corner(6)});
+    else
+    {
+      /* Kuhn subdivision, positively oriented */
+      int perm[3] = {0,1,2};
+      do
+      {
+        const int b1 = 1<<perm[0];
+        const int b2 = b1 | (1<<perm[1]);
+        std::vector<int> tet = {corner(0),corner(b1),corner(b2),corner(7)};
+        DOUBLE a[3][3];
+        for (int i=0; i<3; i++)
+          for (int d=0; d<3; d++)
+            a[i][d] = pos[tet[i+1]][d] - pos[tet[0]][d];
+        const DOUBLE det = a[0][0]*(a[1][1]*a[2][2]-a[1][2]*a[2][1])
+                           - a[0][1]*(a[1][0]*a[2][2]-a[1][2]*a[2][0])
+                           + a[0][2]*(a[1][0]*a[2][1]-a[1][1]*a[2][0]);
+        if (det < 0)
+          std::swap(tet[1],tet[2]);
+        elements.push_back(tet);
+      }
+      while (std::next_permutation(perm,perm+3));
+    }
+#endif
+  }
+
+  return CreateMultiGridFromElements(name, pos, elements, bulk, nThreads, parametric);
+}
+
+/** \brief Refine all leaf elements of the top level red */
+inline INT RefineGlobally (MULTIGRID *theMG)
+{
+  GRID *theGrid = GRID_ON_LEVEL(theMG,TOPLEVEL(theMG));
+  for (ELEMENT *theElement=PFIRSTELEMENT(theGrid); theElement!=nullptr; theElement=SUCCE(theElement))
+    MarkForRefinement(theElement,RED,0);
+  return AdaptMultiGrid(theMG,GM_REFINE_TRULY_LOCAL,GM_REFINE_PARALLEL,GM_REFINE_NOHEAPTEST);
+}
+
+END_UGDIM_NAMESPACE
+
+#endif
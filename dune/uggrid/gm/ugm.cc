@@ -44,6 +44,13 @@
 #include <cmath>
 #include <cassert>
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
 
 #include <errno.h>
 #include <vector>
@@ -117,6 +124,7 @@ static char buffer[4*256];
 
 static INT theMGDirID;                          /* env var ID for the multigrids		*/
 static INT theMGRootDirID;                      /* env dir ID for the multigrids		*/
+static ENVDIR *theMGRootDir;            /* env dir of the multigrids			*/
 
 static UINT UsedOBJT;           /* for the dynamic OBJECT management	*/
 
@@ -127,6 +135,8 @@ static UINT UsedOBJT;           /* for the dynamic OBJECT management	*/
 /****************************************************************************/
 
 static INT DisposeVertex (GRID *theGrid, VERTEX *theVertex);
+static void PlaceCenterVertex (GRID *theGrid, ELEMENT *theElement, VERTEX *theVertex, INT edges,
+                               const UNPLACED_CENTER_VERTEX *saved);
 static INT DisposeEdge (GRID *theGrid, EDGE *theEdge);
 
 
@@ -168,8 +178,11 @@ GM_OBJECTS NS_DIM_PREFIX GetFreeOBJT ()
  * @param  size - size of the object
  * @param  type - type of the requested object
 
-   This function gets an object of type `type` from free list if possible,
-   otherwise it allocates memory from the multigrid heap using 'GetMem'.
+   This function gets an object of type `type` from the object free lists
+   of the multigrid heap (see 'GetObjectMem'). Free lists are kept per
+   object type and size, so objects released by 'PutFreeObject' are
+   recycled by later refinement steps. If no multigrid is given the
+   memory is taken from the system heap.
 
    @return <ul>
    <li>   pointer to an object of the requested type </li>
@@ -197,7 +210,7 @@ static void ConstructDDDObject (DDD::DDDContext& context, void *obj, INT size, I
 
 void * NS_DIM_PREFIX GetMemoryForObject (MULTIGRID *theMG, INT size, INT type)
 {
-  void * obj = GetMem(MGHEAP(theMG),size);
+  void * obj = GetObjectMem(theMG!=NULL ? MGHEAP(theMG) : NULL,size,type);
   if (obj != NULL)
     memset(obj,0,size);
 
@@ -217,7 +230,8 @@ void * NS_DIM_PREFIX GetMemoryForObject (MULTIGRID *theMG, INT size, INT type)
  * @param  size - size of the object
  * @param  type - type of the requested object
 
-   This function puts an object in the free list.
+   This function puts an object in the free list. The memory of all
+   free lists is released by 'DisposeMultiGrid'.
 
    @return <ul>
    <li>   0 if ok </li>
@@ -247,7 +261,7 @@ INT NS_DIM_PREFIX PutFreeObject (MULTIGRID *theMG, void *object, INT size, GM_OB
   DestructDDDObject(theMG->dddContext(), object,type);
   #endif
 
-  DisposeMem(MGHEAP(theMG), object);
+  DisposeObjectMem(MGHEAP(theMG), object);
   return 0;
 }
 
@@ -416,6 +430,95 @@ static NODE *CreateNode (GRID *theGrid, VERTEX *vertex,
   return(pn);
 }
 
+/****************************************************************************/
+/** \brief Leave the position of a new boundary vertex for later
+
+ * @param   theGrid - grid of the vertex
+ * @param   theVertex - new boundary vertex
+
+   If the multigrid evaluates the boundary in batches (MG_BOUNDARY_BATCH),
+   sequential builds record the vertex for ProjectBoundaryVertices, and the
+   caller gives it the position it would have without a curved boundary.
+
+   @return true if the vertex has been recorded
+ */
+/****************************************************************************/
+
+static bool DeferBoundaryVertex (GRID *theGrid, VERTEX *theVertex)
+{
+#ifdef ModelP
+  return false;
+#else
+  MULTIGRID *theMG = MYMG(theGrid);
+  if (!MG_BOUNDARY_BATCH(theMG))
+    return false;
+  theMG->unprojectedVertices.push_back(theVertex);
+  return true;
+#endif
+}
+
+/****************************************************************************/
+/** \brief Move the recorded boundary vertices to the boundary
+
+ * @param   theGrid - grid the vertices have been created on
+
+   This function evaluates the positions of the vertices recorded by
+   DeferBoundaryVertex with BNDP_GlobalBatch, i.e. with one call per
+   boundary segment where the segment has a batch function. Vertices
+   which move away from their position get the local coordinates of
+   the new position in their father element, like in CreateMidNode and
+   CreateSideNode. Then the center vertices of the boundary elements
+   are placed again, since they move with the vertices on their edges.
+
+   @return <ul>
+   <li>   GM_OK if ok </li>
+   <li>   GM_ERROR if the boundary could not be evaluated </li>
+   </ul> */
+/****************************************************************************/
+
+INT NS_DIM_PREFIX ProjectBoundaryVertices (GRID *theGrid)
+{
+  MULTIGRID *theMG = MYMG(theGrid);
+  std::vector<VERTEX*>& vertices = theMG->unprojectedVertices;
+  if (vertices.empty())
+  {
+    theMG->unplacedCenterVertices.clear();
+    return(GM_OK);
+  }
+
+  std::vector<BNDP*> bndp(vertices.size());
+  std::vector<FieldVector<DOUBLE,DIM> > bnd_global(vertices.size());
+  for (std::size_t i=0; i<vertices.size(); i++)
+    bndp[i] = V_BNDP(vertices[i]);
+  if (BNDP_GlobalBatch(MG_BVP(MYMG(theGrid)),bndp.data(),bndp.size(),bnd_global.data()))
+  {
+    vertices.clear();
+    theMG->unplacedCenterVertices.clear();
+    RETURN(GM_ERROR);
+  }
+
+  for (std::size_t i=0; i<vertices.size(); i++)
+  {
+    VERTEX *theVertex = vertices[i];
+    DOUBLE diff;
+
+    V_DIM_EUKLIDNORM_OF_DIFF(bnd_global[i],CVECT(theVertex),diff);
+    V_DIM_COPY(bnd_global[i],CVECT(theVertex));
+    if (diff > MAX_PAR_DIST)
+    {
+      SETMOVED(theVertex,1);
+      UG_GlobalToLocal(DOWNGRID(theGrid),VFATHER(theVertex),bnd_global[i],LCVECT(theVertex));
+    }
+  }
+  vertices.clear();
+
+  for (const UNPLACED_CENTER_VERTEX& unplaced : theMG->unplacedCenterVertices)
+    PlaceCenterVertex(theGrid,VFATHER(unplaced.vertex),unplaced.vertex,unplaced.edges,&unplaced);
+  theMG->unplacedCenterVertices.clear();
+
+  return(GM_OK);
+}
+
 /****************************************************************************/
 /** \brief Return pointer to a new node structure on an edge
 
@@ -424,6 +527,8 @@ static NODE *CreateNode (GRID *theGrid, VERTEX *vertex,
 
    This function creates and initializes a new node structure
    at the midpoint of an element edge and returns a pointer to it.
+   A new boundary vertex may be left at the midpoint of the edge
+   until ProjectBoundaryVertices, see DeferBoundaryVertex.
 
    @return <ul>
    <li>   pointer to requested object </li>
@@ -460,6 +565,8 @@ NODE *NS_DIM_PREFIX CreateSonNode (GRID *theGrid, NODE *FatherNode)
 
    This function creates and initializes a new node structure
    at the midpoint of an element edge and returns a pointer to it.
+   A new boundary vertex may be left at the midpoint of the edge
+   until ProjectBoundaryVertices, see DeferBoundaryVertex.
 
    @return <ul>
    <li>   pointer to requested object </li>
@@ -470,10 +577,9 @@ NODE *NS_DIM_PREFIX CreateSonNode (GRID *theGrid, NODE *FatherNode)
 NODE *NS_DIM_PREFIX CreateMidNode (GRID *theGrid, ELEMENT *theElement, VERTEX *theVertex, INT edge)
 {
   BNDP *bndp;
-  DOUBLE *x[MAX_CORNERS_OF_ELEM];
   DOUBLE_VECTOR bnd_global,global;
   DOUBLE diff;
-  INT n,move;
+  INT move;
 
   const INT co0 = CORNER_OF_EDGE(theElement,edge,0);
   const INT co1 = CORNER_OF_EDGE(theElement,edge,1);
@@ -482,7 +588,7 @@ NODE *NS_DIM_PREFIX CreateMidNode (GRID *theGrid, ELEMENT *theElement, VERTEX *t
   V_DIM_LINCOMB(0.5, CVECT(v0), 0.5, CVECT(v1), global);
 
   /* set MIDNODE pointer */
-  EDGE* theEdge = GetEdge(CORNER(theElement,co0),CORNER(theElement,co1));
+  EDGE* theEdge = GetEdge(DOWNGRID(theGrid),CORNER(theElement,co0),CORNER(theElement,co1));
   ASSERT(theEdge!=NULL);
 
   /* allocate vertex */
@@ -498,15 +604,19 @@ NODE *NS_DIM_PREFIX CreateMidNode (GRID *theGrid, ELEMENT *theElement, VERTEX *t
       if (EDSUBDOM(theEdge) == 0)
 #endif
     {
-      bndp = BNDP_CreateBndP(MGHEAP(MYMG(theGrid)),V_BNDP(v0),V_BNDP(v1),0.5);
+      bndp = BNDP_CreateBndP(MG_BVP(MYMG(theGrid)),MGHEAP(MYMG(theGrid)),V_BNDP(v0),V_BNDP(v1),0.5);
       if (bndp != NULL)
       {
         theVertex = CreateBoundaryVertex(theGrid);
         if (theVertex == NULL)
           return(NULL);
-        if (BNDP_Global(bndp,bnd_global))
+        if (DeferBoundaryVertex(theGrid,theVertex))
+        {
+          V_DIM_COPY(global,bnd_global);
+        }
+        else if (BNDP_Global(MG_BVP(MYMG(theGrid)),bndp,bnd_global))
           return(NULL);
-        if (BNDP_BndPDesc(bndp,&move))
+        if (BNDP_BndPDesc(MG_BVP(MYMG(theGrid)),bndp,&move))
           return(NULL);
         SETMOVE(theVertex,move);
         V_BNDP(theVertex) = bndp;
@@ -516,8 +626,7 @@ NODE *NS_DIM_PREFIX CreateMidNode (GRID *theGrid, ELEMENT *theElement, VERTEX *t
         if (diff > MAX_PAR_DIST)
         {
           SETMOVED(theVertex,1);
-          CORNER_COORDINATES(theElement,n,x);
-          UG_GlobalToLocal(n,(const DOUBLE **)x,bnd_global,local);
+          UG_GlobalToLocal(DOWNGRID(theGrid),theElement,bnd_global,local);
         }
         else
           V_DIM_LINCOMB(0.5, LOCAL_COORD_OF_ELEM(theElement,co0),
@@ -642,6 +751,8 @@ static INT SideOfNbElement(const ELEMENT *theElement, INT side)
 
    This function creates and initializes a new node structure
    at the midpoint of an element side and returns a pointer to it.
+   A new boundary vertex may be left at the midpoint of the side
+   until ProjectBoundaryVertices, see DeferBoundaryVertex.
 
    @return <ul>
    <li>   pointer to requested object </li>
@@ -653,7 +764,6 @@ NODE *NS_DIM_PREFIX CreateSideNode (GRID *theGrid, ELEMENT *theElement, VERTEX *
 {
   DOUBLE_VECTOR bnd_global,global;
   FieldVector<DOUBLE,DIM> local;
-  DOUBLE *x[MAX_CORNERS_OF_ELEM];
   NODE *theNode;
   BNDP *bndp;
   BNDS *bnds;
@@ -687,23 +797,26 @@ NODE *NS_DIM_PREFIX CreateSideNode (GRID *theGrid, ELEMENT *theElement, VERTEX *
           bnd_local[0] = bnd_local[1] = 0.33333333333333;
         else if (n == 4)
           bnd_local[0] = bnd_local[1] = 0.5;
-        bndp = BNDS_CreateBndP(MGHEAP(MYMG(theGrid)),bnds,bnd_local);
+        bndp = BNDS_CreateBndP(MG_BVP(MYMG(theGrid)),MGHEAP(MYMG(theGrid)),bnds,bnd_local);
         if (bndp != NULL) {
           theVertex = CreateBoundaryVertex(theGrid);
           if (theVertex == NULL)
             return(NULL);
-          if (BNDP_BndPDesc(bndp,&move))
+          if (BNDP_BndPDesc(MG_BVP(MYMG(theGrid)),bndp,&move))
             return(NULL);
           SETMOVE(theVertex,move);
-          if (BNDP_Global(bndp,bnd_global))
+          if (DeferBoundaryVertex(theGrid,theVertex))
+          {
+            V_DIM_COPY(global,bnd_global);
+          }
+          else if (BNDP_Global(MG_BVP(MYMG(theGrid)),bndp,bnd_global))
             return(NULL);
           V_BNDP(theVertex) = bndp;
           V_DIM_COPY(bnd_global,CVECT(theVertex));
           V_DIM_EUKLIDNORM_OF_DIFF(bnd_global,global,diff);
           if (diff > MAX_PAR_DIST) {
             SETMOVED(theVertex,1);
-            CORNER_COORDINATES(theElement,k,x);
-            UG_GlobalToLocal(k,(const DOUBLE **)x,bnd_global,local);
+            UG_GlobalToLocal(DOWNGRID(theGrid),theElement,bnd_global,local);
             PRINTDEBUG(gm,1,("local = %f %f %f\n",local[0],local[1],local[2]));
           }
         }
@@ -1396,11 +1509,68 @@ NODE * NS_DIM_PREFIX GetCenterNode (const ELEMENT *theElement)
   return (NULL);
 }
 
+/* position of the new center vertex of an element: the center, moved like
+   the moved vertices of the mid nodes on the edges in the bit mask edges.
+   The mid nodes which have been disposed since the creation of the vertex
+   are taken from saved */
+static void PlaceCenterVertex (GRID *theGrid, ELEMENT *theElement, VERTEX *theVertex, INT edges,
+                               const UNPLACED_CENTER_VERTEX *saved)
+{
+  DOUBLE_VECTOR diff;
+  INT n,j,moved;
+  const DOUBLE_VECTOR *VertexOnEdge[MAX_EDGES_OF_ELEM];
+  DOUBLE fac;
+  DOUBLE *x[MAX_CORNERS_OF_ELEM] = {};
+
+  moved = 0;
+  for (j=0; j<EDGES_OF_ELEM(theElement); j++) {
+    VertexOnEdge[j] = NULL;
+    if (edges & (1<<j)) {
+      EDGE *theEdge=GetEdge(CORNER(theElement,CORNER_OF_EDGE(theElement,j,0)),
+                            CORNER(theElement,CORNER_OF_EDGE(theElement,j,1)));
+      ASSERT(theEdge != NULL);
+      if (MIDNODE(theEdge) != NULL) {
+        VertexOnEdge[j] = &CVECT(MYVERTEX(MIDNODE(theEdge)));
+        moved += MOVED(MYVERTEX(MIDNODE(theEdge)));
+      }
+      else {
+        ASSERT(saved != NULL);
+        VertexOnEdge[j] = &saved->midVertex[j];
+        moved += ((saved->moved>>j) & 1);
+      }
+    }
+  }
+
+  CORNER_COORDINATES(theElement,n,x);
+  Dune::FieldVector<DOUBLE,DIM>& global = CVECT(theVertex);
+  Dune::FieldVector<DOUBLE,DIM>& local = LCVECT(theVertex);
+  V_DIM_CLEAR(local);
+  fac = 1.0 / n;
+  for (j=0; j<n; j++)
+    V_DIM_LINCOMB(1.0,local,
+                  fac,LOCAL_COORD_OF_ELEM(theElement,j),local);
+  LOCAL_TO_GLOBAL(n,x,local,global);
+  if (moved) {
+    V_DIM_CLEAR(diff);
+    for (j=0; j<EDGES_OF_ELEM(theElement); j++)
+      if (VertexOnEdge[j] != NULL) {
+        V_DIM_COPY(*VertexOnEdge[j],diff);
+        V_DIM_LINCOMB(1.0,diff,-0.5,CVECT(MYVERTEX(CORNER(theElement,CORNER_OF_EDGE(theElement,j,0)))),diff);
+        V_DIM_LINCOMB(1.0,diff,-0.5,CVECT(MYVERTEX(CORNER(theElement,CORNER_OF_EDGE(theElement,j,1)))),diff);
+        V_DIM_LINCOMB(0.5,diff,1.0,global,global);
+      }
+    UG_GlobalToLocal(DOWNGRID(theGrid),theElement,global,local);
+    SETMOVED(theVertex,1);
+  }
+}
+
 /****************************************************************************/
 /** \brief Allocate a new node on a side of an element
  *
  * Includes vertex
  * best fit boundary coordinates and local coordinates.
+ * The vertex of a boundary element is placed again by
+ * ProjectBoundaryVertices if the vertices on its edges move later.
  *
  * @return <ul>
  *    <li> pointer to new node </li>
@@ -1410,22 +1580,23 @@ NODE * NS_DIM_PREFIX GetCenterNode (const ELEMENT *theElement)
 /* #define MOVE_MIDNODE */
 NODE * NS_DIM_PREFIX CreateCenterNode (GRID *theGrid, ELEMENT *theElement, VERTEX *theVertex)
 {
-  DOUBLE_VECTOR diff;
-  INT n,j,moved,vertex_null;
-  VERTEX *VertexOnEdge[MAX_EDGES_OF_ELEM];
+  INT j,edges,vertex_null;
   NODE *theNode;
   EDGE *theEdge;
-  DOUBLE fac;
-  DOUBLE *x[MAX_CORNERS_OF_ELEM];
+  UNPLACED_CENTER_VERTEX unplaced;
         #ifdef MOVE_MIDNODE
         #ifndef ModelP
+  VERTEX *VertexOnEdge[MAX_EDGES_OF_ELEM];
+  DOUBLE_VECTOR diff;
+  INT n,moved;
+  DOUBLE *x[MAX_CORNERS_OF_ELEM];
   DOUBLE len_opp,len_bnd;
     #endif
     #endif
 
   /* check if moved side nodes exist */
-  CORNER_COORDINATES(theElement,n,x);
-  moved = 0;
+  edges = 0;
+  unplaced.moved = 0;
   vertex_null = (theVertex==NULL);
   if (theVertex==NULL && OBJT(theElement) == BEOBJ) {
     for (j=0; j<EDGES_OF_ELEM(theElement); j++) {
@@ -1433,15 +1604,25 @@ NODE * NS_DIM_PREFIX CreateCenterNode (GRID *theGrid, ELEMENT *theElement, VERTE
                       CORNER(theElement,CORNER_OF_EDGE(theElement,j,1)));
       ASSERT(theEdge != NULL);
       theNode = MIDNODE(theEdge);
-      if (theNode == NULL)
-        VertexOnEdge[j] = NULL;
-      else {
-        VertexOnEdge[j] = MYVERTEX(theNode);
-        moved += MOVED(VertexOnEdge[j]);
+      if (theNode != NULL)
+      {
+        edges |= (1<<j);
+        unplaced.midVertex[j] = CVECT(MYVERTEX(theNode));
+        unplaced.moved |= (MOVED(MYVERTEX(theNode))<<j);
       }
+                #ifdef MOVE_MIDNODE
+                #ifndef ModelP
+      VertexOnEdge[j] = (theNode == NULL) ? NULL : MYVERTEX(theNode);
+            #endif
+            #endif
     }
                 #ifdef MOVE_MIDNODE
                 #ifndef ModelP
+    CORNER_COORDINATES(theElement,n,x);
+    moved = 0;
+    for (j=0; j<EDGES_OF_ELEM(theElement); j++)
+      if (VertexOnEdge[j] != NULL)
+        moved += MOVED(VertexOnEdge[j]);
     if (moved == 1) {
       for (j=0; j<EDGES_OF_ELEM(theElement); j++)
         if (VertexOnEdge[j] != NULL)
@@ -1502,27 +1683,15 @@ NODE * NS_DIM_PREFIX CreateCenterNode (GRID *theGrid, ELEMENT *theElement, VERTE
 
   if (!vertex_null) return(theNode);
 
-  FieldVector<DOUBLE,DIM>& global = CVECT(theVertex);
-  FieldVector<DOUBLE,DIM>& local = LCVECT(theVertex);
-  V_DIM_CLEAR(local);
-  fac = 1.0 / n;
-  for (j=0; j<n; j++)
-    V_DIM_LINCOMB(1.0,local,
-                  fac,LOCAL_COORD_OF_ELEM(theElement,j),local);
-  LOCAL_TO_GLOBAL(n,x,local,global);
-  if (moved) {
-    V_DIM_CLEAR(diff);
-    for (j=0; j<EDGES_OF_ELEM(theElement); j++)
-      if (VertexOnEdge[j] != NULL) {
-        V_DIM_COPY(CVECT(VertexOnEdge[j]),diff);
-        V_DIM_LINCOMB(1.0,diff,-0.5,CVECT(MYVERTEX(CORNER(theElement,CORNER_OF_EDGE(theElement,j,0)))),diff);
-        V_DIM_LINCOMB(1.0,diff,-0.5,CVECT(MYVERTEX(CORNER(theElement,CORNER_OF_EDGE(theElement,j,1)))),diff);
-        V_DIM_LINCOMB(0.5,diff,1.0,global,global);
-      }
-    UG_GlobalToLocal(n,(const DOUBLE **)x,global,local);
-    LOCAL_TO_GLOBAL(n,x,local,diff);
-    SETMOVED(theVertex,1);
+  PlaceCenterVertex(theGrid,theElement,theVertex,edges,NULL);
+        #ifndef ModelP
+  if (edges != 0 && MG_BOUNDARY_BATCH(MYMG(theGrid)))
+  {
+    unplaced.vertex = theVertex;
+    unplaced.edges = edges;
+    MYMG(theGrid)->unplacedCenterVertices.push_back(unplaced);
   }
+        #endif
   return(theNode);
 }
 
@@ -1936,39 +2105,420 @@ EDGE * NS_DIM_PREFIX FatherEdge (NODE **SideNodes, INT ncorners, NODE **Nodes, E
     UserWriteF("\n");
     ENDDEBUG
 
-    assert(edge0==theEdge || edge1==theEdge);
+    assert(edge0==theEdge || edge1==theEdge);
+  }
+  ENDDEBUG
+
+  return(fatherEdge);
+}
+#endif
+
+/****************************************************************************/
+/** \brief Return pointer to edge if it exists
+
+ * @param   from - starting node of edge
+ * @param   to - end node of edge
+
+   This function returns the pointer to the specified edge if it exists.
+
+   @return <ul>
+   <li>   pointer to specified object </li>
+   <li>   NULL if not found </li>
+   </ul> */
+/****************************************************************************/
+
+EDGE * NS_DIM_PREFIX GetEdge (const NODE *from, const NODE *to)
+{
+  LINK *pl;
+
+  /* run through neighbor list */
+  for (pl=START(from); pl!=NULL; pl = NEXT(pl))
+    if (NBNODE(pl)==to)
+      return(MYEDGE(pl));
+
+  /* return not found */
+  return(NULL);
+}
+
+static std::pair<const NODE*,const NODE*> EdgeIndexKey (const NODE *from, const NODE *to)
+{
+  return std::less<const NODE*>()(from,to) ? std::make_pair(from,to) : std::make_pair(to,from);
+}
+
+/****************************************************************************/
+/** \brief Return pointer to edge if it exists, using the edge index of a grid
+
+ * @param   theGrid - grid level of the nodes
+ * @param   from - starting node of edge
+ * @param   to - end node of edge
+
+   This function looks the edge up in the edge index of 'theGrid' if the
+   index is enabled (see 'SetEdgeIndex') and otherwise runs through the
+   link list of 'from' like 'GetEdge(from,to)'.
+
+   @return <ul>
+   <li>   pointer to specified object </li>
+   <li>   NULL if not found </li>
+   </ul> */
+/****************************************************************************/
+
+EDGE * NS_DIM_PREFIX GetEdge (const GRID *theGrid, const NODE *from, const NODE *to)
+{
+  if (theGrid==NULL || theGrid->edgeIndex==NULL)
+    return GetEdge(from,to);
+
+  ASSERT(LEVEL(from)==GLEVEL(theGrid) && LEVEL(to)==GLEVEL(theGrid));
+
+  auto it = theGrid->edgeIndex->find(EdgeIndexKey(from,to));
+  return (it!=theGrid->edgeIndex->end()) ? it->second : NULL;
+}
+
+/****************************************************************************/
+/** \brief Insert an edge into the edge index of a grid
+
+ * @param   theGrid - grid level of the edge
+ * @param   theEdge - edge with both links set
+
+   Nothing is done if 'theGrid' has no edge index.
+ */
+/****************************************************************************/
+
+void NS_DIM_PREFIX EdgeIndexInsert (GRID *theGrid, EDGE *theEdge)
+{
+  if (theGrid->edgeIndex!=NULL)
+    theGrid->edgeIndex->emplace(EdgeIndexKey(NBNODE(LINK1(theEdge)),NBNODE(LINK0(theEdge))),theEdge);
+}
+
+static void EdgeIndexErase (GRID *theGrid, EDGE *theEdge)
+{
+  if (theGrid->edgeIndex!=NULL)
+    theGrid->edgeIndex->erase(EdgeIndexKey(NBNODE(LINK1(theEdge)),NBNODE(LINK0(theEdge))));
+}
+
+/* fill the edge index of a grid from the link lists of its nodes */
+static void BuildEdgeIndex (GRID *theGrid)
+{
+  theGrid->edgeIndex->clear();
+  theGrid->edgeIndex->reserve(NE(theGrid));
+  for (NODE *theNode=PFIRSTNODE(theGrid); theNode!=NULL; theNode=SUCCN(theNode))
+    for (LINK *theLink=START(theNode); theLink!=NULL; theLink=NEXT(theLink))
+      if (LOFFSET(theLink)==0)
+        EdgeIndexInsert(theGrid,MYEDGE(theLink));
+}
+
+/****************************************************************************/
+/** \brief Switch the edge index of all grid levels on or off
+
+ * @param   theMG - multigrid structure
+ * @param   enable - true to keep an edge index on every level
+
+   With the edge index, 'GetEdge(theGrid,from,to)' is a hash lookup by
+   the two end nodes instead of a walk through the link list of 'from'.
+   The index is updated by 'CreateEdge' and 'DisposeEdge' and allocated
+   for new levels as long as it is enabled.
+
+   @return <ul>
+   <li>   GM_OK if ok </li>
+   </ul> */
+/****************************************************************************/
+
+INT NS_DIM_PREFIX SetEdgeIndex (MULTIGRID *theMG, INT enable)
+{
+  MG_EDGE_INDEX(theMG) = enable;
+
+  for (INT level=0; level<=TOPLEVEL(theMG); level++)
+  {
+    GRID *theGrid = GRID_ON_LEVEL(theMG,level);
+    if (enable)
+    {
+      if (theGrid->edgeIndex==NULL)
+        theGrid->edgeIndex = new EDGE_INDEX;
+      BuildEdgeIndex(theGrid);
+    }
+    else
+    {
+      delete theGrid->edgeIndex;
+      theGrid->edgeIndex = NULL;
+    }
+  }
+
+  return GM_OK;
+}
+
+/* the inverse of M and its determinant, false if M is singular with the
+   tolerance of M_DIM_INVERT */
+static bool InvertJacobian (const DOUBLE_VECTOR M[DIM], DOUBLE_VECTOR IM[DIM], DOUBLE& det)
+{
+#ifdef UG_DIM_2
+  det = M[0][0]*M[1][1] - M[1][0]*M[0][1];
+#else
+  det = M[0][0]*M[1][1]*M[2][2] + M[0][1]*M[1][2]*M[2][0] + M[0][2]*M[1][0]*M[2][1]
+        - M[0][2]*M[1][1]*M[2][0] - M[0][0]*M[1][2]*M[2][1] - M[0][1]*M[1][0]*M[2][2];
+#endif
+  if (std::abs(det) < SMALL_D*SMALL_D)
+  {
+    det = 0.0;
+    return false;
+  }
+
+  const DOUBLE invdet = 1.0/det;
+#ifdef UG_DIM_2
+  IM[0][0] =  M[1][1]*invdet;
+  IM[1][0] = -M[1][0]*invdet;
+  IM[0][1] = -M[0][1]*invdet;
+  IM[1][1] =  M[0][0]*invdet;
+#else
+  IM[0][0] = ( M[1][1]*M[2][2] - M[1][2]*M[2][1]) * invdet;
+  IM[0][1] = (-M[0][1]*M[2][2] + M[0][2]*M[2][1]) * invdet;
+  IM[0][2] = ( M[0][1]*M[1][2] - M[0][2]*M[1][1]) * invdet;
+  IM[1][0] = (-M[1][0]*M[2][2] + M[1][2]*M[2][0]) * invdet;
+  IM[1][1] = ( M[0][0]*M[2][2] - M[0][2]*M[2][0]) * invdet;
+  IM[1][2] = (-M[0][0]*M[1][2] + M[0][2]*M[1][0]) * invdet;
+  IM[2][0] = ( M[1][0]*M[2][1] - M[1][1]*M[2][0]) * invdet;
+  IM[2][1] = (-M[0][0]*M[2][1] + M[0][1]*M[2][0]) * invdet;
+  IM[2][2] = ( M[0][0]*M[1][1] - M[0][1]*M[1][0]) * invdet;
+#endif
+  return true;
+}
+
+/* fill entry k of the geometry cache of a grid from the corners of theElement,
+   except for the volume, see SetGeometryCacheVolumes */
+static void SetGeometryCacheEntry (GEOMETRY_CACHE& cache, std::size_t k, ELEMENT *theElement)
+{
+  DOUBLE *x[MAX_CORNERS_OF_ELEM] = {};
+  INT nCorners;
+  CORNER_COORDINATES(theElement,nCorners,x);
+
+  DOUBLE_VECTOR center;
+  CalculateCenterOfMass(theElement,center);
+  for (INT i=0; i<DIM; i++)
+    cache.center[i][k] = center[i];
+
+
+  DOUBLE_VECTOR local(0.0), M[DIM], IM[DIM];
+  DOUBLE det;
+  TRANSFORMATION(nCorners,x,local,M);
+  const bool regular = InvertJacobian(M,IM,det);
+  for (INT i=0; i<DIM; i++)
+    for (INT j=0; j<DIM; j++)
+      cache.inverseJacobian[i][j][k] = regular ? IM[i][j] : 0.0;
+  cache.det[k] = det;
+
+  cache.element[k] = theElement;
+  cache.slotOfId[ID(theElement)-cache.firstId] = k;
+}
+
+/* fill the volumes of the entries slots of a geometry cache, the elements of
+   one tag are computed together, see GeneralElementVolumes */
+static void SetGeometryCacheVolumes (GEOMETRY_CACHE& cache, const std::vector<std::size_t>& slots)
+{
+  std::vector<std::size_t> slotsOfTag[TAGS];
+  for (std::size_t k : slots)
+    slotsOfTag[TAG(cache.element[k])].push_back(k);
+
+  std::vector<const ELEMENT*> elements;
+  std::vector<DOUBLE> coordinates, volume;
+  DOUBLE *x[DIM*MAX_CORNERS_OF_ELEM];
+  for (INT tag=0; tag<TAGS; tag++)
+  {
+    const INT n = slotsOfTag[tag].size();
+    if (n==0)
+      continue;
+
+    elements.resize(n);
+    for (INT e=0; e<n; e++)
+      elements[e] = cache.element[slotsOfTag[tag][e]];
+    coordinates.resize(DIM*CORNERS_OF_TAG(tag)*n);
+    for (INT i=0; i<DIM*CORNERS_OF_TAG(tag); i++)
+      x[i] = coordinates.data() + i*n;
+    GatherCornerCoordinates(n,elements.data(),x);
+
+    volume.resize(n);
+    GeneralElementVolumes(tag,n,x,volume.data());
+    for (INT e=0; e<n; e++)
+      cache.volume[slotsOfTag[tag][e]] = volume[e];
+  }
+}
+
+/* resize the arrays of a geometry cache to n entries */
+static void ResizeGeometryCache (GEOMETRY_CACHE& cache, std::size_t n)
+{
+  cache.element.resize(n);
+  for (INT i=0; i<DIM; i++)
+  {
+    cache.center[i].resize(n);
+    for (INT j=0; j<DIM; j++)
+      cache.inverseJacobian[i][j].resize(n);
+  }
+  cache.volume.resize(n);
+  cache.det.resize(n);
+}
+
+/* fill the geometry cache of a grid from the corners of its elements */
+static void BuildGeometryCache (GRID *theGrid)
+{
+  GEOMETRY_CACHE& cache = *theGrid->geometryCache;
+
+  INT firstId = std::numeric_limits<INT>::max(), lastId = -1;
+  for (ELEMENT *theElement=PFIRSTELEMENT(theGrid); theElement!=NULL; theElement=SUCCE(theElement))
+  {
+    firstId = std::min(firstId,ID(theElement));
+    lastId = std::max(lastId,ID(theElement));
+  }
+  cache.firstId = firstId;
+  cache.slotOfId.assign(std::max(lastId-firstId+1,0),-1);
+  ResizeGeometryCache(cache,NT(theGrid));
+
+  std::vector<std::size_t> slots(NT(theGrid));
+  std::size_t k = 0;
+  for (ELEMENT *theElement=PFIRSTELEMENT(theGrid); theElement!=NULL; theElement=SUCCE(theElement), k++)
+  {
+    SetGeometryCacheEntry(cache,k,theElement);
+    slots[k] = k;
+  }
+  SetGeometryCacheVolumes(cache,slots);
+}
+
+/****************************************************************************/
+/** \brief Switch the geometry cache of all grid levels on or off
+
+ * @param   theMG - multigrid structure
+ * @param   enable - true to keep a geometry cache on every level
+
+   The geometry cache stores the center of mass, the volume and the
+   inverse Jacobian of every element of a level, see 'GEOMETRY_CACHE'.
+   The overloads of 'ElementVolume', 'CalculateCenterOfMass' and
+   'UG_GlobalToLocal' that take the grid of the element use it instead of
+   computing these from the corner coordinates.
+
+   The caches are built by 'FixCoarseGrid' and 'CompactGrid' and updated
+   by 'AdaptMultiGrid' as long as the cache is enabled, see
+   'UpdateGeometryCache'. Elements created in between are computed on
+   every call. Call this function again after moving vertices.
+
+   @return <ul>
+   <li>   GM_OK if ok </li>
+   </ul> */
+/****************************************************************************/
+
+INT NS_DIM_PREFIX SetGeometryCache (MULTIGRID *theMG, INT enable)
+{
+  MG_GEOMETRY_CACHE(theMG) = enable;
+
+  for (INT level=0; level<=TOPLEVEL(theMG); level++)
+  {
+    GRID *theGrid = GRID_ON_LEVEL(theMG,level);
+    if (enable)
+    {
+      if (theGrid->geometryCache==NULL)
+        theGrid->geometryCache = new GEOMETRY_CACHE;
+      BuildGeometryCache(theGrid);
+    }
+    else
+    {
+      delete theGrid->geometryCache;
+      theGrid->geometryCache = NULL;
+    }
+  }
+
+  return GM_OK;
+}
+
+/****************************************************************************/
+/** \brief Add the elements of the last adaption to the geometry caches
+
+ * @param   theMG - multigrid structure
+
+   This function appends entries for the elements created by the last
+   'AdaptMultiGrid' to the geometry caches of their levels. Entries of
+   disposed elements stay unused, a level with more of them than elements
+   is rebuilt, as are new levels. Sequential builds call this function at
+   the end of 'AdaptMultiGrid'; parallel builds do not record the created
+   elements and rebuild all levels with 'SetGeometryCache'.
+
+   @return <ul>
+   <li>   GM_OK if ok </li>
+   </ul> */
+/****************************************************************************/
+
+INT NS_DIM_PREFIX UpdateGeometryCache (MULTIGRID *theMG)
+{
+  std::vector<std::size_t> created(TOPLEVEL(theMG)+1,0);
+  std::vector<bool> rebuild(TOPLEVEL(theMG)+1,false);
+  for (ELEMENT *theElement : theMG->createdElements)
+  {
+    const INT level = LEVEL(theElement);
+    const GEOMETRY_CACHE *cache = GRID_ON_LEVEL(theMG,level)->geometryCache;
+    created[level]++;
+    if (cache==NULL || cache->element.empty() || ID(theElement)<cache->firstId)
+      rebuild[level] = true;
+  }
+
+  for (INT level=0; level<=TOPLEVEL(theMG); level++)
+  {
+    GRID *theGrid = GRID_ON_LEVEL(theMG,level);
+    if (theGrid->geometryCache==NULL)
+    {
+      theGrid->geometryCache = new GEOMETRY_CACHE;
+      rebuild[level] = true;
+    }
+
+    const std::size_t entries = theGrid->geometryCache->element.size() + created[level];
+    if (entries > 2*std::size_t(NT(theGrid)))
+      rebuild[level] = true;
+
+    if (rebuild[level])
+      BuildGeometryCache(theGrid);
+  }
+
+  std::vector<std::vector<std::size_t> > slots(TOPLEVEL(theMG)+1);
+  for (ELEMENT *theElement : theMG->createdElements)
+  {
+    const INT level = LEVEL(theElement);
+    if (rebuild[level])
+      continue;
+
+    GEOMETRY_CACHE& cache = *GRID_ON_LEVEL(theMG,level)->geometryCache;
+    const std::size_t k = cache.element.size();
+    ResizeGeometryCache(cache,k+1);
+    const std::size_t i = ID(theElement) - cache.firstId;
+    if (i >= cache.slotOfId.size())
+      cache.slotOfId.resize(i+1,-1);
+    SetGeometryCacheEntry(cache,k,theElement);
+    slots[level].push_back(k);
   }
-  ENDDEBUG
+  for (INT level=0; level<=TOPLEVEL(theMG); level++)
+    if (!slots[level].empty())
+      SetGeometryCacheVolumes(*GRID_ON_LEVEL(theMG,level)->geometryCache,slots[level]);
 
-  return(fatherEdge);
+  return GM_OK;
 }
-#endif
 
 /****************************************************************************/
-/** \brief Return pointer to edge if it exists
-
- * @param   from - starting node of edge
- * @param   to - end node of edge
+/** \brief Entry of an element in the geometry cache of its grid
 
-   This function returns the pointer to the specified edge if it exists.
+ * @param   theGrid - grid level of the element
+ * @param   theElement - the element
 
    @return <ul>
-   <li>   pointer to specified object </li>
-   <li>   NULL if not found </li>
+   <li>   index into the arrays of 'theGrid->geometryCache' </li>
+   <li>   -1 if the grid has no geometry cache or the element no entry </li>
    </ul> */
 /****************************************************************************/
 
-EDGE * NS_DIM_PREFIX GetEdge (const NODE *from, const NODE *to)
+INT NS_DIM_PREFIX GeometryCacheSlot (const GRID *theGrid, const ELEMENT *theElement)
 {
-  LINK *pl;
+  if (theGrid==NULL || theGrid->geometryCache==NULL)
+    return -1;
 
-  /* run through neighbor list */
-  for (pl=START(from); pl!=NULL; pl = NEXT(pl))
-    if (NBNODE(pl)==to)
-      return(MYEDGE(pl));
+  const GEOMETRY_CACHE& cache = *theGrid->geometryCache;
+  const INT i = ID(theElement) - cache.firstId;
+  if (i<0 || i>=INT(cache.slotOfId.size()))
+    return -1;
 
-  /* return not found */
-  return(NULL);
+  /* ids of copies received from other processes need not be unique */
+  const INT k = cache.slotOfId[i];
+  return (k>=0 && cache.element[k]==theElement) ? k : -1;
 }
 
 /****************************************************************************/
@@ -2010,7 +2560,7 @@ CreateEdge (GRID *theGrid, ELEMENT *theElement, INT edge, bool with_vector)
   to = CORNER(theElement,CORNER_OF_EDGE(theElement,edge,1));
 
   /* check if edge exists already */
-  if( (pe = GetEdge(from, to)) != NULL ) {
+  if( (pe = GetEdge(theGrid, from, to)) != NULL ) {
     if (NO_OF_ELEM(pe)<NO_OF_ELEM_MAX-1)
       INC_NO_OF_ELEM(pe);
     else
@@ -2076,7 +2626,7 @@ CreateEdge (GRID *theGrid, ELEMENT *theElement, INT edge, bool with_vector)
     {
 #ifdef UG_DIM_2
     case (CORNER_NODE | (CORNER_NODE<<4)) :
-      father_edge = GetEdge(NFATHER(n1),NFATHER(n2));
+      father_edge = GetEdge(DOWNGRID(theGrid),NFATHER(n1),NFATHER(n2));
       if (father_edge!=NULL) SETEDSUBDOM(pe,EDSUBDOM(father_edge));
       break;
     case (CORNER_NODE | (MID_NODE<<4)) :
@@ -2095,7 +2645,7 @@ CreateEdge (GRID *theGrid, ELEMENT *theElement, INT edge, bool with_vector)
 #endif
 #ifdef UG_DIM_3
     case (CORNER_NODE | (CORNER_NODE<<4)) :
-      father_edge = GetEdge(NFATHER(n1),NFATHER(n2));
+      father_edge = GetEdge(DOWNGRID(theGrid),NFATHER(n1),NFATHER(n2));
       if (father_edge!=NULL) SETEDSUBDOM(pe,EDSUBDOM(father_edge));
       else
       {
@@ -2222,6 +2772,7 @@ CreateEdge (GRID *theGrid, ELEMENT *theElement, INT edge, bool with_vector)
   START(from) = link0;
   NEXT(link1) = START(to);
   START(to) = link1;
+  EdgeIndexInsert(theGrid,pe);
 
   /* counters */
   NE(theGrid)++;
@@ -2456,13 +3007,13 @@ INT NS_DIM_PREFIX CreateSonElementSide (GRID *theGrid, ELEMENT *theElement, INT
     }
     bndp[i] = V_BNDP(MYVERTEX(CORNER(theSon,CORNER_OF_SIDE(theSon,son_side,i))));
   }
-  bnds = BNDP_CreateBndS(MGHEAP(MYMG(theGrid)),bndp,n);
+  bnds = BNDP_CreateBndS(MG_BVP(MYMG(theGrid)),MGHEAP(MYMG(theGrid)),bndp,n);
   if (bnds == NULL)
     RETURN(GM_ERROR);
   SET_BNDS(theSon,son_side,bnds);
 
     #ifdef UG_DIM_2
-  const EDGE* theEdge = GetEdge(CORNER(theSon,CORNER_OF_EDGE(theSon,son_side,0)),
+  EDGE* theEdge = GetEdge(CORNER(theSon,CORNER_OF_EDGE(theSon,son_side,0)),
                     CORNER(theSon,CORNER_OF_EDGE(theSon,son_side,1)));
   ASSERT(theEdge != NULL);
   SETEDSUBDOM(theEdge,0);
@@ -2519,6 +3070,7 @@ GRID * NS_DIM_PREFIX CreateNewLevel (MULTIGRID *theMG)
   GRID_INIT_NODE_LIST(theGrid);
   GRID_INIT_VERTEX_LIST(theGrid);
   GRID_INIT_VECTOR_LIST(theGrid);
+  theGrid->nFineGridDof = 0;
   if (l>0)
   {
     DOWNGRID(theGrid) = GRID_ON_LEVEL(theMG,l-1);
@@ -2537,6 +3089,8 @@ GRID * NS_DIM_PREFIX CreateNewLevel (MULTIGRID *theMG)
     DOWNGRID(GRID_ON_LEVEL(theMG,l+1)) = theGrid;
   }
   MYMG(theGrid) = theMG;
+  theGrid->edgeIndex = MG_EDGE_INDEX(theMG) ? new EDGE_INDEX : NULL;
+  theGrid->geometryCache = MG_GEOMETRY_CACHE(theMG) ? new GEOMETRY_CACHE : NULL;
   GRID_ON_LEVEL(theMG,l) = theGrid;
     TOPLEVEL(theMG) = l;
     CURRENTLEVEL(theMG) = l;
@@ -2738,6 +3292,38 @@ MULTIGRID * NS_DIM_PREFIX GetNextMultigrid (const MULTIGRID *theMG)
   return (MG);
 }
 
+/****************************************************************************/
+/** \brief Return the multigrid of an element if it records marks
+
+ * @param   theElement - element of any multigrid
+
+   This function searches the multigrids whose marks since the last
+   'AdaptMultiGrid' are recorded, see 'NoteMarkedElement', for the one
+   whose heap holds theElement. It does not change the current
+   environment directory.
+
+   @return <ul>
+   <li>   pointer to MULTIGRID </li>
+   <li>   NULL if no multigrid recording marks holds theElement </li>
+   </ul> */
+/****************************************************************************/
+
+MULTIGRID * NS_DIM_PREFIX GetMarkRecordingMultigrid (const ELEMENT *theElement)
+{
+  for (ENVITEM *item = ENVDIR_DOWN(theMGRootDir); item != NULL; item = NEXT_ENVITEM(item))
+  {
+    /* the other dimension has its own multigrids */
+    if (ENVITEM_TYPE(item) != theMGDirID)
+      continue;
+
+    MULTIGRID *theMG = (MULTIGRID *) item;
+    if (theMG->marksRecorded && ObjectInHeap(MGHEAP(theMG),theElement))
+      return (theMG);
+  }
+
+  return (NULL);
+}
+
 /****************************************************************************/
 /** \brief Return a pointer to new multigrid structure
 
@@ -2813,6 +3399,17 @@ MULTIGRID * NS_DIM_PREFIX CreateMultiGrid (char *MultigridName, BVP theBVP,
   /* fill multigrid structure */
   theMG->status = 0;
   MG_COARSE_FIXED(theMG) = 0;
+  MG_COMPACT_STORAGE(theMG) = 0;
+  MG_EDGE_INDEX(theMG) = 0;
+  MG_GEOMETRY_CACHE(theMG) = 0;
+  MG_CLOSURE_WORKLIST(theMG) = 1;
+  theMG->closureGrid = NULL;
+  theMG->closureSweep = false;
+  theMG->closurePatternsReset = false;
+  MG_ADAPT_INCREMENTAL(theMG) = 0;
+  MG_BOUNDARY_BATCH(theMG) = 1;
+  theMG->elementsInIdOrder = 1;
+  ForgetMarkedElements(theMG);
   theMG->vertIdCounter = 0;
   theMG->nodeIdCounter = 0;
   theMG->elemIdCounter = 0;
@@ -2929,6 +3526,8 @@ static INT DisposeEdge (GRID *theGrid, EDGE *theEdge)
     }
   }
 
+  EdgeIndexErase(theGrid,theEdge);
+
   /* reset pointer of midnode to edge */
   if (MIDNODE(theEdge) != NULL)
     SETNFATHER(MIDNODE(theEdge),NULL);
@@ -3122,6 +3721,11 @@ INT NS_DIM_PREFIX DisposeElement (GRID *theGrid, ELEMENT *theElement)
 
   GRID_UNLINK_ELEMENT(theGrid,theElement);
 
+  /* the memory of the element may be reused by a new one */
+  const INT slot = GeometryCacheSlot(theGrid,theElement);
+  if (slot>=0)
+    theGrid->geometryCache->element[slot] = NULL;
+
         #ifdef __CENTERNODE__
   {
     theNode = CENTERNODE(theElement);
@@ -3474,6 +4078,8 @@ INT NS_DIM_PREFIX Collapse (MULTIGRID *theMG)
       GRID_LINK_VERTEX(GRID_ON_LEVEL(theMG,tl),
                        theVertex,VXPRIO(theVertex));
     }
+    delete theGrid->edgeIndex;
+    delete theGrid->geometryCache;
     GRID_ON_LEVEL(theMG,l) = NULL;
   }
 
@@ -3594,6 +4200,8 @@ INT NS_DIM_PREFIX DisposeTopLevel (MULTIGRID *theMG)
   if (theMG->currentLevel>theMG->topLevel)
     theMG->currentLevel = theMG->topLevel;
 
+  delete theGrid->edgeIndex;
+  delete theGrid->geometryCache;
   PutFreeObject(theMG,theGrid,sizeof(GRID),GROBJ);
 
   return(0);
@@ -3652,6 +4260,8 @@ INT NS_DIM_PREFIX DisposeGrid (GRID *theGrid)
   theMG->vertIdCounter = 0;
   theMG->elemIdCounter = 0;
 
+  delete theGrid->edgeIndex;
+  delete theGrid->geometryCache;
   PutFreeObject(theMG,theGrid,sizeof(GRID),GROBJ);
 
   return(0);
@@ -3830,13 +4440,13 @@ NODE * NS_DIM_PREFIX InsertBoundaryNode (GRID *theGrid, BNDP *bndp)
     PrintErrorMessage('E',"InsertBoundaryNode","cannot create vertex");
     REP_ERR_RETURN(NULL);
   }
-  if (BNDP_Global(bndp,CVECT(theVertex)))
+  if (BNDP_Global(MG_BVP(MYMG(theGrid)),bndp,CVECT(theVertex)))
   {
     DisposeVertex(theGrid,theVertex);
     return(NULL);
   }
 
-  if (BNDP_BndPDesc(bndp,&move))
+  if (BNDP_BndPDesc(MG_BVP(MYMG(theGrid)),bndp,&move))
   {
     DisposeVertex(theGrid,theVertex);
     return(NULL);
@@ -4191,6 +4801,10 @@ static INT Neighbor_Direct_Insert(INT tag, ELEMENT **ElemList, const INT *NbgSdL
 
    This function inserts an element
 
+   If 'ElemList' is NULL, the neighbors are found through the face map of
+   the multigrid. Otherwise 'ElemList' holds the neighbors; NULL entries
+   may be set later, e.g. for all elements at once by 'SetElementNeighbors'.
+
    \return Pointer to the newly created element, NULL if an error occurred
 
  */
@@ -4210,10 +4824,10 @@ ELEMENT * NS_DIM_PREFIX InsertElement (GRID *theGrid, INT n, NODE **Node, ELEMEN
   theMG = MYMG(theGrid);
 
   // nodes are already inserted, so we know how many there are...
-  if (theMG->facemap.bucket_count() <= 1)
+  if (ElemList == NULL && theMG->facemap.bucket_count() <= 1)
   {
     // try to allocate the right size a-priori to avoid rehashing
-    theMG->facemap.rehash(theMG->nodeIdCounter);
+    theMG->facemap.reserve(theMG->nodeIdCounter);
     // theMG->facemap.max_load_factor(1000);
   }
 
@@ -4357,12 +4971,12 @@ ELEMENT * NS_DIM_PREFIX InsertElement (GRID *theGrid, INT n, NODE **Node, ELEMEN
 
     if (bnds_flag==NULL)
     {
-      bnds[i] = BNDP_CreateBndS(MGHEAP(theMG),bndp,m);
+      bnds[i] = BNDP_CreateBndS(MG_BVP(theMG),MGHEAP(theMG),bndp,m);
       if (bnds[i] != NULL) ElementType = BEOBJ;
     }
     else if (bnds_flag[i]!=0)
     {
-      bnds[i] = BNDP_CreateBndS(MGHEAP(theMG),bndp,m);
+      bnds[i] = BNDP_CreateBndS(MG_BVP(theMG),MGHEAP(theMG),bndp,m);
       assert(bnds[i]!=NULL);
       ElementType = BEOBJ;
     }
@@ -4425,6 +5039,186 @@ ELEMENT * NS_DIM_PREFIX InsertElement (GRID *theGrid, INT n, NODE **Node, ELEMEN
   return(theElement);
 }
 
+/* one side of an element with its sorted corner nodes */
+struct ElementSide
+{
+  MULTIGRID::FaceNodes nodes;
+  ELEMENT *theElement;
+  INT side;
+};
+
+/****************************************************************************/
+/** \brief Set the neighbor relations of all elements of a grid
+
+ * @param   theGrid - grid structure
+ * @param   nThreads - number of threads to use, all cores if <= 0
+
+   This function finds the neighbors of all elements of 'theGrid' from
+   their corners, i.e., what 'InsertElement' does element by element with
+   the face map of the multigrid, for all elements at once.
+
+   The sides of all elements are sorted by the id of their first corner
+   node (a counting sort, in the order of the element list), so the two
+   sides of a face end up in the same short bucket. Setting up the sides
+   and matching them within the buckets is split among 'nThreads' threads.
+   The result does not depend on the number of threads.
+
+   Use it to insert a large coarse grid: pass an 'ElemList' of NULL
+   pointers to 'InsertElement' to skip the neighbor search, then call
+   this function once. Sides that already have a neighbor are left alone.
+   Afterwards the face map of the multigrid holds the sides without a
+   neighbor, as if the elements had been inserted with the neighbor search,
+   so elements inserted later still find their neighbors.
+
+   @return <ul>
+   <li>   GM_OK if ok </li>
+   <li>   GM_ERROR if more than two elements share a side </li>
+   </ul> */
+/****************************************************************************/
+
+INT NS_DIM_PREFIX SetElementNeighbors (GRID *theGrid, INT nThreads)
+{
+  if (nThreads<=0)
+    nThreads = std::max(1u,std::thread::hardware_concurrency());
+
+  std::vector<ELEMENT*> elements;
+  elements.reserve(NT(theGrid));
+  std::vector<std::size_t> offset(1,0);
+  offset.reserve(NT(theGrid)+1);
+  for (ELEMENT *theElement=PFIRSTELEMENT(theGrid); theElement!=NULL; theElement=SUCCE(theElement))
+  {
+    elements.push_back(theElement);
+    offset.push_back(offset.back()+SIDES_OF_ELEM(theElement));
+  }
+  if (elements.empty())
+    return(GM_OK);
+
+  INT maxId = 0;
+  for (NODE *theNode=PFIRSTNODE(theGrid); theNode!=NULL; theNode=SUCCN(theNode))
+    maxId = std::max(maxId,ID(theNode));
+
+  /* run f(begin,end) on nThreads parts of [0,n) */
+  const auto inParallel = [nThreads](std::size_t n, const auto& f) {
+                            std::vector<std::thread> threads;
+                            for (INT t=1; t<nThreads; t++)
+                              threads.emplace_back(f,n*t/nThreads,n*(t+1)/nThreads);
+                            f(std::size_t(0),n/nThreads);
+                            for (std::thread& thread : threads)
+                              thread.join();
+                          };
+
+  /* the sides of all elements, with corners sorted by id */
+  std::vector<ElementSide> sides(offset.back());
+  inParallel(elements.size(), [&](std::size_t begin, std::size_t end) {
+               for (std::size_t e=begin; e<end; e++)
+               {
+                 ELEMENT *theElement = elements[e];
+                 for (INT i=0; i<SIDES_OF_ELEM(theElement); i++)
+                 {
+                   ElementSide& theSide = sides[offset[e]+i];
+                   const INT n = CORNERS_OF_SIDE(theElement,i);
+                   INT j;
+                   for (j=0; j<n; j++)
+                     theSide.nodes[j] = CORNER(theElement,CORNER_OF_SIDE(theElement,i,j));
+                   for (; j<MAX_CORNERS_OF_SIDE; j++)
+                     theSide.nodes[j] = NULL;
+                   std::sort(theSide.nodes.begin(),theSide.nodes.begin()+n,
+                             [](const NODE *a, const NODE *b) { return ID(a)<ID(b); });
+                   theSide.theElement = theElement;
+                   theSide.side = i;
+                 }
+               }
+             });
+
+  /* counting sort by the first corner */
+  std::vector<std::size_t> bucket(maxId+2,0);
+  for (const ElementSide& theSide : sides)
+    bucket[ID(theSide.nodes[0])+1]++;
+  for (INT id=0; id<=maxId; id++)
+    bucket[id+1] += bucket[id];
+  std::vector<std::size_t> order(sides.size());
+  {
+    std::vector<std::size_t> next(bucket.begin(),bucket.end()-1);
+    for (std::size_t k=0; k<sides.size(); k++)
+      order[next[ID(sides[k].nodes[0])]++] = k;
+  }
+
+  /* sides with equal corners are the two sides of a face. The sides are
+     disjoint, so the buckets can be matched concurrently. */
+  std::vector<std::size_t> partner(sides.size(),sides.size());
+  std::atomic<bool> shared(false);
+  inParallel(maxId+1, [&](std::size_t begin, std::size_t end) {
+               for (std::size_t id=begin; id<end; id++)
+                 for (std::size_t k=bucket[id]; k<bucket[id+1]; k++)
+                 {
+                   const std::size_t a = order[k];
+                   for (std::size_t l=k+1; l<bucket[id+1]; l++)
+                   {
+                     const std::size_t b = order[l];
+                     if (sides[a].nodes!=sides[b].nodes)
+                       continue;
+                     if (partner[a]!=sides.size() || partner[b]!=sides.size())
+                       shared = true;
+                     partner[a] = b;
+                     partner[b] = a;
+                   }
+                 }
+             });
+  if (shared)
+  {
+    PrintErrorMessage('E',"SetElementNeighbors",
+                      "more than two elements share a side");
+    REP_ERR_RETURN(GM_ERROR);
+  }
+
+  for (std::size_t a=0; a<sides.size(); a++)
+  {
+    const std::size_t b = partner[a];
+    if (b<a || b==sides.size())
+      continue;
+
+    const ElementSide& theSide = sides[a];
+    const ElementSide& theOther = sides[b];
+    if (NBELEM(theSide.theElement,theSide.side)!=NULL
+        || NBELEM(theOther.theElement,theOther.side)!=NULL)
+      continue;
+
+    SET_NBELEM(theSide.theElement,theSide.side,theOther.theElement);
+    SET_NBELEM(theOther.theElement,theOther.side,theSide.theElement);
+        #ifdef UG_DIM_3
+    if (VEC_DEF_IN_OBJ_OF_GRID(theGrid,SIDEVEC))
+      if (DisposeDoubledSideVector(theGrid,theSide.theElement,theSide.side,
+                                   theOther.theElement,theOther.side))
+        REP_ERR_RETURN(GM_ERROR);
+        #endif
+  }
+
+  /* the face map is keyed by the corners sorted by address, see
+     NeighborSearch_O_n. Sides entered by 'InsertElement' which have a
+     neighbor now are removed, the sides without one are added. */
+  MULTIGRID *theMG = MYMG(theGrid);
+  const auto faceMapKey = [](const ElementSide& theSide) {
+                            MULTIGRID::FaceNodes key = theSide.nodes;
+                            std::sort(key.begin(),std::find(key.begin(),key.end(),(NODE*)NULL));
+                            return key;
+                          };
+  if (!theMG->facemap.empty())
+    for (const ElementSide& theSide : sides)
+    {
+      if (NBELEM(theSide.theElement,theSide.side)==NULL)
+        continue;
+      const auto it = theMG->facemap.find(faceMapKey(theSide));
+      if (it!=theMG->facemap.end() && it->second.first==theSide.theElement)
+        theMG->facemap.erase(it);
+    }
+  for (const ElementSide& theSide : sides)
+    if (NBELEM(theSide.theElement,theSide.side)==NULL)
+      theMG->facemap.emplace(faceMapKey(theSide),
+                             std::make_pair(theSide.theElement,int(theSide.side)));
+
+  return(GM_OK);
+}
+
 /****************************************************************************/
 /** \brief Delete an element
 
@@ -4499,6 +5293,7 @@ INT NS_DIM_PREFIX InsertMesh (MULTIGRID *theMG, MESH *theMesh)
   VERTEX **VList;
   INT i,k,n,nv,j,maxlevel,l,move;
   INT ElemSideOnBnd[MAX_SIDES_OF_ELEM];
+  ELEMENT *NoNeighbors[MAX_SIDES_OF_ELEM];
   INT MarkKey = MG_MARK_KEY(theMG);
 
   if (theMesh == NULL) return(GM_OK);
@@ -4532,8 +5327,8 @@ INT NS_DIM_PREFIX InsertMesh (MULTIGRID *theMG, MESH *theMesh)
       theGrid = GRID_ON_LEVEL(theMG,theMesh->VertexLevel[i]);
       VList[i] = CreateBoundaryVertex(theGrid);
       assert(VList[i]!=NULL);
-      if (BNDP_Global(theMesh->theBndPs[i],CVECT(VList[i]))) assert(0);
-      if (BNDP_BndPDesc(theMesh->theBndPs[i],&move))
+      if (BNDP_Global(MG_BVP(theMG),theMesh->theBndPs[i],CVECT(VList[i]))) assert(0);
+      if (BNDP_BndPDesc(MG_BVP(theMG),theMesh->theBndPs[i],&move))
         return(GM_OK);
       SETMOVE(VList[i],move);
       V_BNDP(VList[i]) = theMesh->theBndPs[i];
@@ -4554,8 +5349,8 @@ INT NS_DIM_PREFIX InsertMesh (MULTIGRID *theMG, MESH *theMesh)
     {
       VList[i] = CreateBoundaryVertex(theGrid);
       assert(VList[i]!=NULL);
-      if (BNDP_Global(theMesh->theBndPs[i],CVECT(VList[i]))) assert(0);
-      if (BNDP_BndPDesc(theMesh->theBndPs[i],&move))
+      if (BNDP_Global(MG_BVP(theMG),theMesh->theBndPs[i],CVECT(VList[i]))) assert(0);
+      if (BNDP_BndPDesc(MG_BVP(theMG),theMesh->theBndPs[i],&move))
         return(GM_OK);
       SETMOVE(VList[i],move);
       V_BNDP(VList[i]) = theMesh->theBndPs[i];
@@ -4568,6 +5363,10 @@ INT NS_DIM_PREFIX InsertMesh (MULTIGRID *theMG, MESH *theMesh)
   }
   if (theMesh->nElements == NULL)
     return(GM_OK);
+
+  /* the neighbors are set for all elements at once below */
+  for (l=0; l<MAX_SIDES_OF_ELEM; l++)
+    NoNeighbors[l] = NULL;
   for (j=1; j<=1; j++)
     for (k=0; k<theMesh->nElements[j]; k++)
     {
@@ -4599,15 +5398,19 @@ INT NS_DIM_PREFIX InsertMesh (MULTIGRID *theMG, MESH *theMesh)
         }
       }
       if (theMesh->ElemSideOnBnd==NULL)
-        theElement = InsertElement (theGrid,n,Nodes,NULL,NULL,NULL);
+        theElement = InsertElement (theGrid,n,Nodes,NoNeighbors,NULL,NULL);
       else
       {
         for (l=0; l<SIDES_OF_TAG(REF2TAG(n)); l++) ElemSideOnBnd[l] = (theMesh->ElemSideOnBnd[j][k]&(1<<l));
-        theElement = InsertElement (theGrid,n,Nodes,NULL,NULL,ElemSideOnBnd);
+        theElement = InsertElement (theGrid,n,Nodes,NoNeighbors,NULL,ElemSideOnBnd);
       }
       SETSUBDOMAIN(theElement,j);
     }
 
+  for (l=0; l<=TOPLEVEL(theMG); l++)
+    if (SetElementNeighbors(GRID_ON_LEVEL(theMG,l),0))
+      REP_ERR_RETURN(GM_ERROR);
+
   return(GM_OK);
 }
 
@@ -4616,9 +5419,10 @@ INT NS_DIM_PREFIX InsertMesh (MULTIGRID *theMG, MESH *theMesh)
    InnerBoundary -
 
    SYNOPSIS:
-   INT InnerBoundary (ELEMENT *t, INT side);
+   INT InnerBoundary (MULTIGRID *theMG, ELEMENT *t, INT side);
 
 
+ * @param   theMG
  * @param   t
  * @param   side
 
@@ -4629,14 +5433,14 @@ INT NS_DIM_PREFIX InsertMesh (MULTIGRID *theMG, MESH *theMesh)
  */
 /****************************************************************************/
 
-INT NS_DIM_PREFIX InnerBoundary (ELEMENT *t, INT side)
+INT NS_DIM_PREFIX InnerBoundary (MULTIGRID *theMG, ELEMENT *t, INT side)
 {
   INT left,right;
 
   ASSERT(OBJT(t) == BEOBJ);
   ASSERT(SIDE_ON_BND(t,side));
 
-  BNDS_BndSDesc(ELEM_BNDS(t,side),&left,&right);
+  BNDS_BndSDesc(MG_BVP(theMG),ELEM_BNDS(t,side),&left,&right);
 
   return((left != 0) && (right != 0));
 }
@@ -4649,13 +5453,13 @@ INT NS_DIM_PREFIX InnerBoundary (ELEMENT *t, INT side)
  * @param center_of_mass center of mass as the result
  *
  * This function calculates the center of mass for an arbitrary element.
- * DOUBLE_VECTOR is an array for a 2D resp. 3D coordinate.
+ * DOUBLE_VECTOR is a FieldVector for a 2D resp. 3D coordinate.
  *
  * \sa DOUBLE_VECTOR, ELEMENT
  */
 /****************************************************************************/
 
-void NS_DIM_PREFIX CalculateCenterOfMass(ELEMENT *theElement, DOUBLE_VECTOR center_of_mass)
+void NS_DIM_PREFIX CalculateCenterOfMass(ELEMENT *theElement, DOUBLE_VECTOR& center_of_mass)
 {
   INT i, nr_corners;
 
@@ -4671,6 +5475,32 @@ void NS_DIM_PREFIX CalculateCenterOfMass(ELEMENT *theElement, DOUBLE_VECTOR cent
   V_DIM_SCALE(1.0/nr_corners,center_of_mass);
 }
 
+/****************************************************************************/
+/** \brief Center of mass of an element, from the geometry cache if possible
+ *
+ * @param theGrid grid level of the element
+ * @param theElement the element
+ * @param center_of_mass center of mass as the result
+ *
+ * This function returns the center of mass stored in the geometry cache
+ * of 'theGrid' if the element has an entry there (see 'SetGeometryCache'),
+ * and calculates it otherwise.
+ */
+/****************************************************************************/
+
+void NS_DIM_PREFIX CalculateCenterOfMass(const GRID *theGrid, ELEMENT *theElement, DOUBLE_VECTOR& center_of_mass)
+{
+  const INT k = GeometryCacheSlot(theGrid,theElement);
+  if (k<0)
+  {
+    CalculateCenterOfMass(theElement,center_of_mass);
+    return;
+  }
+
+  for (INT i=0; i<DIM; i++)
+    center_of_mass[i] = theGrid->geometryCache->center[i][k];
+}
+
 /****************************************************************************/
 /** \brief Calculate an (hopefully) unique key for the geometric object
 
@@ -5516,7 +6346,7 @@ void NS_DIM_PREFIX ListNode (const MULTIGRID *theMG, const NODE *theNode, INT da
   {
     if (OBJT(theVertex) == BVOBJ)
     {
-      if (BNDP_BndPDesc(V_BNDP(theVertex),&i))
+      if (BNDP_BndPDesc(MG_BVP(theMG),V_BNDP(theVertex),&i))
         UserWrite("Error in boundary point\n");
       else
         UserWriteF("boundary point: move %d moved %d\n",i,
@@ -6417,7 +7247,7 @@ static INT FinishGrid (MULTIGRID *mg)
           for (side=0; side<SIDES_OF_ELEM(elem); side++)
             if (SIDE_ON_BND(elem,side))
             {
-              if (BNDS_BndSDesc(ELEM_BNDS(elem,side),&id,&nbid))
+              if (BNDS_BndSDesc(MG_BVP(mg),ELEM_BNDS(elem,side),&id,&nbid))
                 REP_ERR_RETURN (GM_ERROR);
 
               if ((nb=NBELEM(elem,side))==NULL)
@@ -6522,7 +7352,7 @@ static INT FinishGrid (MULTIGRID *mg)
                 /* push unused neighbour across boundary to unused fifo */
                 fifo_in(&unused,nb);
 
-              if (BNDS_BndSDesc(ELEM_BNDS(elem,side),&id,&nbid))
+              if (BNDS_BndSDesc(MG_BVP(mg),ELEM_BNDS(elem,side),&id,&nbid))
                 REP_ERR_RETURN (GM_ERROR);
 
               if (id!=s_id || nbid==0)
@@ -6646,7 +7476,7 @@ INT NS_DIM_PREFIX SetSubdomainIDfromBndInfo (MULTIGRID *theMG)
       assert(i<SIDES_OF_ELEM(theElement));
 
       /* set id from BNDS */
-      if (BNDS_BndSDesc(ELEM_BNDS(theElement,i),&id,&nbid))
+      if (BNDS_BndSDesc(MG_BVP(theMG),ELEM_BNDS(theElement,i),&id,&nbid))
         REP_ERR_RETURN (GM_ERROR);
       assert(id>0);
       SETSUBDOMAIN(theElement,id);
@@ -6711,7 +7541,9 @@ INT NS_DIM_PREFIX SetSubdomainIDfromBndInfo (MULTIGRID *theMG)
  * @param   id - the id of the block to be allocated
 
    This function does all that is necessary to complete the coarse grid.
-   Finally the MG_COARSE_FIXED flag is set.
+   Finally the MG_COARSE_FIXED flag is set. If MG_COMPACT_STORAGE is set
+   the coarse grid is compacted, see 'CompactMultiGrid'. The geometry
+   cache is built if MG_GEOMETRY_CACHE is set, see 'SetGeometryCache'.
 
    @return <ul>
    <li>   GM_OK if ok </li>
@@ -6740,9 +7572,484 @@ INT NS_DIM_PREFIX FixCoarseGrid (MULTIGRID *theMG)
   ReleaseTmpMem(MGHEAP(theMG),MG_MARK_KEY(theMG));
   MG_MARK_KEY(theMG) = 0;
 
+  if (MG_COMPACT_STORAGE(theMG))
+  {
+    if (CompactMultiGrid(theMG))
+      REP_ERR_RETURN (GM_ERROR);
+  }
+  /* CompactGrid has rebuilt the geometry caches already */
+  else if (MG_GEOMETRY_CACHE(theMG))
+    SetGeometryCache(theMG,true);
+
   return (GM_OK);
 }
 
+/****************************************************************************/
+/*                                                                          */
+/* compaction of grid levels                                                */
+/*                                                                          */
+/****************************************************************************/
+
+/** \brief Number of bits per coordinate in a space-filling curve key */
+#define SFC_BITS        (64/DIM)
+
+/** \brief Quantization of positions on a grid level, see SFCKey */
+struct SFCBox {
+  DOUBLE_VECTOR lower;
+  DOUBLE_VECTOR scale;
+};
+
+static SFCBox SFCBoxOfGrid (GRID *theGrid)
+{
+  DOUBLE_VECTOR lower, upper;
+  lower = std::numeric_limits<DOUBLE>::max();
+  upper = std::numeric_limits<DOUBLE>::lowest();
+
+  for (NODE *theNode=PFIRSTNODE(theGrid); theNode!=NULL; theNode=SUCCN(theNode))
+    for (INT i=0; i<DIM; i++)
+    {
+      lower[i] = std::min(lower[i],CVECT(MYVERTEX(theNode))[i]);
+      upper[i] = std::max(upper[i],CVECT(MYVERTEX(theNode))[i]);
+    }
+
+  SFCBox box;
+  box.lower = lower;
+  for (INT i=0; i<DIM; i++)
+    box.scale[i] = (upper[i]>lower[i]) ?
+                   ((std::uint64_t(1)<<SFC_BITS)-1)/(upper[i]-lower[i]) : 0.0;
+
+  return box;
+}
+
+/****************************************************************************/
+/** \brief Position of a point on the Morton (Z-order) curve
+
+   \param box - quantization of the grid level
+   \param x - point inside the box
+
+   The coordinates are quantized to SFC_BITS bits each and interleaved.
+ */
+/****************************************************************************/
+
+static std::uint64_t SFCKey (const SFCBox& box, const DOUBLE_VECTOR& x)
+{
+  std::uint64_t key = 0;
+
+  for (INT i=0; i<DIM; i++)
+  {
+    const DOUBLE t = (x[i]-box.lower[i])*box.scale[i];
+    const std::uint64_t q = (t>0.0) ?
+                            std::min<std::uint64_t>(t,(std::uint64_t(1)<<SFC_BITS)-1) : 0;
+    for (INT b=0; b<SFC_BITS; b++)
+      key |= ((q>>b) & 1) << (DIM*b+i);
+  }
+
+  return key;
+}
+
+/* collect the objects of a list part in list order */
+template<class T, class Succ>
+static std::vector<T*> ListPartObjects (T *first, T *last, Succ succ)
+{
+  std::vector<T*> objects;
+  for (T *theObject=first; theObject!=NULL; theObject=succ(theObject))
+  {
+    objects.push_back(theObject);
+    if (theObject==last) break;
+  }
+  return objects;
+}
+
+/* link the objects of all list parts, following the conventions of dlmgr.t */
+template<class T, class Pred, class Succ>
+static void RelinkListParts (std::vector<T*> parts[], INT nParts, T *first[], T *last[],
+                             Pred pred, Succ succ)
+{
+  T *prevLast = NULL;
+
+  for (INT part=0; part<nParts; part++)
+  {
+    const std::vector<T*>& objects = parts[part];
+    if (objects.empty())
+    {
+      first[part] = last[part] = NULL;
+      continue;
+    }
+    for (std::size_t i=0; i<objects.size(); i++)
+    {
+      pred(objects[i]) = (i>0) ? objects[i-1] : NULL;
+      succ(objects[i]) = (i+1<objects.size()) ? objects[i+1] : NULL;
+    }
+    if (prevLast!=NULL)
+      succ(prevLast) = objects.front();
+    first[part] = objects.front();
+    last[part] = prevLast = objects.back();
+  }
+}
+
+/****************************************************************************/
+/** \brief Move objects into contiguous memory
+
+   \param theMG - multigrid the objects belong to
+   \param parts - objects per list part in their new order, replaced by the
+   moved objects on return
+   \param nParts - number of list parts
+   \param sizeAndType - size and object type of an object
+   \param moved - receives the old address of each object with its new one
+
+   Objects of equal size and type are copied into one block obtained by
+   'GetObjectArray', in the order given by 'parts'. The DDD headers are
+   moved along. The old memory is not released.
+ */
+/****************************************************************************/
+
+template<class T, class SizeAndType>
+static INT MoveObjects (MULTIGRID *theMG, std::vector<T*> parts[], INT nParts,
+                        SizeAndType sizeAndType, std::unordered_map<void*,void*>& moved)
+{
+  std::map<std::pair<INT,INT>,std::vector<T**> > blocks;
+  std::size_t nObjects = 0;
+  for (INT part=0; part<nParts; part++)
+    for (T*& theObject : parts[part])
+    {
+      const auto [size, type] = sizeAndType(theObject);
+      blocks[std::make_pair(type,size)].push_back(&theObject);
+      nObjects++;
+    }
+
+  moved.clear();
+  moved.reserve(nObjects);
+  std::vector<void*> memory;
+  for (const auto& [key, objects] : blocks)
+  {
+    const auto [type, size] = key;
+    memory.resize(objects.size());
+    if (GetObjectArray(MGHEAP(theMG),size,type,objects.size(),memory.data()))
+      REP_ERR_RETURN(GM_OUT_OF_MEM);
+
+    for (std::size_t i=0; i<objects.size(); i++)
+    {
+      T *theObject = *objects[i];
+      T *theCopy = (T*) memory[i];
+      memcpy(theCopy,theObject,size);
+      #ifdef ModelP
+      DDD::DDDContext& context = theMG->dddContext();
+      if (HAS_DDDHDR(context, type))
+      {
+        const auto offset = DDD_InfoHdrOffset(context, DDDTYPE(context, type));
+        DDD_HdrConstructorMove(context, (DDD_HDR) (((char*) theCopy)+offset),
+                               (DDD_HDR) (((char*) theObject)+offset));
+      }
+      #endif
+      moved.emplace(theObject,theCopy);
+      *objects[i] = theCopy;
+    }
+  }
+
+  return GM_OK;
+}
+
+/* replace a pointer to a moved object by its new address */
+template<class T>
+static void Relocate (T *&p, const std::unordered_map<void*,void*>& moved)
+{
+  if (p==NULL) return;
+  auto it = moved.find((void*) p);
+  if (it!=moved.end())
+    p = (T*) it->second;
+}
+
+static void ReleaseMovedObjects (MULTIGRID *theMG, const std::unordered_map<void*,void*>& moved)
+{
+  for (const auto& [theObject, theCopy] : moved)
+    DisposeObjectMem(MGHEAP(theMG),theObject);
+}
+
+static INT CompactElements (GRID *theGrid, const SFCBox& box)
+{
+  MULTIGRID *theMG = MYMG(theGrid);
+  GRID *coarser = DOWNGRID(theGrid);
+
+  /* rank of the fathers in the list of the coarser level */
+  std::unordered_map<ELEMENT*,std::size_t> fatherRank;
+  if (coarser!=NULL)
+  {
+    std::size_t rank = 0;
+    for (ELEMENT *theFather=PFIRSTELEMENT(coarser); theFather!=NULL; theFather=SUCCE(theFather))
+      fatherRank[theFather] = rank++;
+  }
+
+  /* sort sons by father to keep the sons of an element consecutive,
+     and along the space-filling curve within a family */
+  std::vector<ELEMENT*> parts[ELEMENT_LISTPARTS];
+  for (INT part=0; part<ELEMENT_LISTPARTS; part++)
+  {
+    parts[part] = ListPartObjects(theGrid->elements[part],theGrid->lastelement[part],
+                                  [](ELEMENT *e) { return SUCCE(e); });
+
+    using Key = std::tuple<std::size_t,std::uint64_t,std::size_t>;
+    std::vector<std::pair<Key,ELEMENT*> > keys;
+    keys.reserve(parts[part].size());
+    for (ELEMENT *theElement : parts[part])
+    {
+      DOUBLE_VECTOR center(0.0);
+      for (INT i=0; i<CORNERS_OF_ELEM(theElement); i++)
+        center += CVECT(MYVERTEX(CORNER(theElement,i)));
+      center /= DOUBLE(CORNERS_OF_ELEM(theElement));
+
+      std::size_t rank = 0;
+      if (coarser!=NULL)
+      {
+        auto it = fatherRank.find(EFATHER(theElement));
+        rank = (it!=fatherRank.end()) ? it->second : fatherRank.size();
+      }
+      keys.emplace_back(Key(rank,SFCKey(box,center),keys.size()),theElement);
+    }
+    std::sort(keys.begin(),keys.end());
+    for (std::size_t i=0; i<keys.size(); i++)
+      parts[part][i] = keys[i].second;
+  }
+
+  std::unordered_map<void*,void*> moved;
+  if (MoveObjects(theMG,parts,ELEMENT_LISTPARTS,
+                  [](ELEMENT *e) {
+                    const INT tag = TAG(e);
+                    return (OBJT(e)==BEOBJ) ?
+                           std::make_pair(BND_SIZE_TAG(tag),INT(MAPPED_BND_OBJT_TAG(tag))) :
+                           std::make_pair(INNER_SIZE_TAG(tag),INT(MAPPED_INNER_OBJT_TAG(tag)));
+                  },moved))
+    REP_ERR_RETURN(GM_OUT_OF_MEM);
+
+  RelinkListParts(parts,ELEMENT_LISTPARTS,theGrid->elements,theGrid->lastelement,
+                  [](ELEMENT *e) -> ELEMENT*& { return PREDE(e); },
+                  [](ELEMENT *e) -> ELEMENT*& { return SUCCE(e); });
+
+  /* neighbors and first sons */
+  ELEMENT *prev = NULL;
+  for (ELEMENT *theElement=PFIRSTELEMENT(theGrid); theElement!=NULL; theElement=SUCCE(theElement))
+  {
+    for (INT i=0; i<SIDES_OF_ELEM(theElement); i++)
+    {
+      ELEMENT *theNeighbor = NBELEM(theElement,i);
+      Relocate(theNeighbor,moved);
+      SET_NBELEM(theElement,i,theNeighbor);
+    }
+
+    ELEMENT *theFather = EFATHER(theElement);
+    if (theFather!=NULL && (prev==NULL || EFATHER(prev)!=theFather
+                            || PRIO2INDEX(EPRIO(prev))!=PRIO2INDEX(EPRIO(theElement))))
+      SET_SON(theFather,PRIO2INDEX(EPRIO(theElement)),theElement);
+    prev = theElement;
+  }
+
+  /* side vectors */
+  for (VECTOR *theVector=PFIRSTVECTOR(theGrid); theVector!=NULL; theVector=SUCCVC(theVector))
+    Relocate(VOBJECT(theVector),moved);
+
+  /* fathers of elements and vertices on finer levels */
+  GRID *finer = UPGRID(theGrid);
+  if (finer!=NULL)
+    for (ELEMENT *theElement=PFIRSTELEMENT(finer); theElement!=NULL; theElement=SUCCE(theElement))
+    {
+      ELEMENT *theFather = EFATHER(theElement);
+      Relocate(theFather,moved);
+      SET_EFATHER(theElement,theFather);
+    }
+  for (GRID *g=finer; g!=NULL; g=UPGRID(g))
+    for (VERTEX *theVertex=PFIRSTVERTEX(g); theVertex!=NULL; theVertex=SUCCV(theVertex))
+      Relocate(VFATHER(theVertex),moved);
+
+  ReleaseMovedObjects(theMG,moved);
+
+  return GM_OK;
+}
+
+static INT CompactNodes (GRID *theGrid, const SFCBox& box)
+{
+  MULTIGRID *theMG = MYMG(theGrid);
+
+  std::vector<NODE*> parts[NODE_LISTPARTS];
+  for (INT part=0; part<NODE_LISTPARTS; part++)
+  {
+    parts[part] = ListPartObjects(theGrid->firstNode[part],theGrid->lastNode[part],
+                                  [](NODE *n) { return SUCCN(n); });
+    std::stable_sort(parts[part].begin(),parts[part].end(),
+                     [&box](NODE *a, NODE *b) {
+                       return SFCKey(box,CVECT(MYVERTEX(a))) < SFCKey(box,CVECT(MYVERTEX(b)));
+                     });
+  }
+
+  std::unordered_map<void*,void*> moved;
+  if (MoveObjects(theMG,parts,NODE_LISTPARTS,
+                  [](NODE *) { return std::make_pair(INT(sizeof(NODE)),INT(NDOBJ)); },
+                  moved))
+    REP_ERR_RETURN(GM_OUT_OF_MEM);
+
+  RelinkListParts(parts,NODE_LISTPARTS,theGrid->firstNode,theGrid->lastNode,
+                  [](NODE *n) -> NODE*& { return PREDN(n); },
+                  [](NODE *n) -> NODE*& { return SUCCN(n); });
+
+  /* corners of the elements and neighbors in the links */
+  for (ELEMENT *theElement=PFIRSTELEMENT(theGrid); theElement!=NULL; theElement=SUCCE(theElement))
+    for (INT i=0; i<CORNERS_OF_ELEM(theElement); i++)
+    {
+      NODE *theNode = CORNER(theElement,i);
+      Relocate(theNode,moved);
+      SET_CORNER(theElement,i,theNode);
+    }
+  for (NODE *theNode=PFIRSTNODE(theGrid); theNode!=NULL; theNode=SUCCN(theNode))
+    for (LINK *theLink=START(theNode); theLink!=NULL; theLink=NEXT(theLink))
+      Relocate(NBNODE(theLink),moved);
+
+  /* sons of nodes and mid nodes of edges on the coarser level */
+  GRID *coarser = DOWNGRID(theGrid);
+  if (coarser!=NULL)
+    for (NODE *theNode=PFIRSTNODE(coarser); theNode!=NULL; theNode=SUCCN(theNode))
+    {
+      Relocate(SONNODE(theNode),moved);
+      for (LINK *theLink=START(theNode); theLink!=NULL; theLink=NEXT(theLink))
+        Relocate(MIDNODE(MYEDGE(theLink)),moved);
+    }
+
+  /* fathers of nodes on the finer level */
+  GRID *finer = UPGRID(theGrid);
+  if (finer!=NULL)
+    for (NODE *theNode=PFIRSTNODE(finer); theNode!=NULL; theNode=SUCCN(theNode))
+      Relocate(theNode->father,moved);
+
+  ReleaseMovedObjects(theMG,moved);
+
+  /* the edge index is keyed by the nodes */
+  if (theGrid->edgeIndex!=NULL)
+    BuildEdgeIndex(theGrid);
+
+  /* the face map of InsertElement refers to the old nodes and elements */
+  if (GLEVEL(theGrid)==0)
+    theMG->facemap.clear();
+
+  return GM_OK;
+}
+
+static INT CompactVertices (GRID *theGrid, const SFCBox& box)
+{
+  MULTIGRID *theMG = MYMG(theGrid);
+
+  std::vector<VERTEX*> parts[VERTEX_LISTPARTS];
+  for (INT part=0; part<VERTEX_LISTPARTS; part++)
+  {
+    parts[part] = ListPartObjects(theGrid->vertices[part],theGrid->lastvertex[part],
+                                  [](VERTEX *v) { return SUCCV(v); });
+    std::stable_sort(parts[part].begin(),parts[part].end(),
+                     [&box](VERTEX *a, VERTEX *b) {
+                       return SFCKey(box,CVECT(a)) < SFCKey(box,CVECT(b));
+                     });
+  }
+
+  std::unordered_map<void*,void*> moved;
+  if (MoveObjects(theMG,parts,VERTEX_LISTPARTS,
+                  [](VERTEX *v) {
+                    return (OBJT(v)==BVOBJ) ?
+                           std::make_pair(INT(sizeof(struct bvertex)),INT(BVOBJ)) :
+                           std::make_pair(INT(sizeof(struct ivertex)),INT(IVOBJ));
+                  },moved))
+    REP_ERR_RETURN(GM_OUT_OF_MEM);
+
+  RelinkListParts(parts,VERTEX_LISTPARTS,theGrid->vertices,theGrid->lastvertex,
+                  [](VERTEX *v) -> VERTEX*& { return PREDV(v); },
+                  [](VERTEX *v) -> VERTEX*& { return SUCCV(v); });
+
+  /* vertices are shared by the nodes of all finer levels */
+  for (GRID *g=theGrid; g!=NULL; g=UPGRID(g))
+    for (NODE *theNode=PFIRSTNODE(g); theNode!=NULL; theNode=SUCCN(theNode))
+      Relocate(MYVERTEX(theNode),moved);
+
+  ReleaseMovedObjects(theMG,moved);
+
+  return GM_OK;
+}
+
+/****************************************************************************/
+/** \brief Store the elements, nodes and vertices of a grid level contiguously
+
+ * @param   theGrid - grid level to compact
+
+   This function moves the elements, nodes and vertices of 'theGrid' into
+   contiguous blocks of memory, one block per object type and size. The
+   objects are ordered along a Morton curve through the bounding box of
+   the level, and the lists of the grid are relinked in that order, so
+   traversing a level streams through memory.
+
+   Elements are grouped by father first, in the order of the fathers on
+   the coarser level, because 'GetSons' relies on the sons of an element
+   being consecutive. Compacting the levels from coarse to fine therefore
+   gives a hierarchical ordering.
+
+   All pointers between grid objects are updated, the ids are kept.
+   Pointers to elements, nodes and vertices of this level held outside
+   of the multigrid become invalid, and the order of the lists changes.
+
+   @return <ul>
+   <li>   GM_OK if ok </li>
+   <li>   GM_OUT_OF_MEM if out of memory, the grid may be partially compacted </li>
+   </ul>
+ */
+/****************************************************************************/
+
+INT NS_DIM_PREFIX CompactGrid (GRID *theGrid)
+{
+  if (PFIRSTNODE(theGrid)==NULL)
+    return GM_OK;
+
+  const SFCBox box = SFCBoxOfGrid(theGrid);
+
+  if (CompactElements(theGrid,box))
+    REP_ERR_RETURN(GM_OUT_OF_MEM);
+  if (CompactNodes(theGrid,box))
+    REP_ERR_RETURN(GM_OUT_OF_MEM);
+  if (CompactVertices(theGrid,box))
+    REP_ERR_RETURN(GM_OUT_OF_MEM);
+
+  /* the geometry cache is keyed by the old elements */
+  if (theGrid->geometryCache!=NULL)
+    BuildGeometryCache(theGrid);
+
+  /* the next AdaptMultiGrid adapts all elements, see AdaptMultiGrid */
+  MULTIGRID *theMG = MYMG(theGrid);
+  theMG->elementsInIdOrder = 0;
+  theMG->createdElements.clear();
+  ForgetMarkedElements(theMG);
+
+  return GM_OK;
+}
+
+/****************************************************************************/
+/** \brief Compact all grid levels of a multigrid
+
+ * @param   theMG - multigrid to compact
+
+   This function calls 'CompactGrid' for all levels from coarse to fine
+   and releases the memory that became unused.
+   It is called by 'FixCoarseGrid' and 'AdaptMultiGrid' if
+   'MG_COMPACT_STORAGE' is set.
+
+   @return <ul>
+   <li>   GM_OK if ok </li>
+   <li>   GM_OUT_OF_MEM if out of memory </li>
+   </ul>
+ */
+/****************************************************************************/
+
+INT NS_DIM_PREFIX CompactMultiGrid (MULTIGRID *theMG)
+{
+  for (INT level=0; level<=TOPLEVEL(theMG); level++)
+    if (CompactGrid(GRID_ON_LEVEL(theMG,level)))
+      REP_ERR_RETURN(GM_OUT_OF_MEM);
+
+  TrimObjectMem(MGHEAP(theMG));
+
+  return GM_OK;
+}
+
 /****************************************************************************/
 /** \brief Init what is necessary
  *
@@ -6766,7 +8073,8 @@ INT NS_DIM_PREFIX InitUGManager ()
     return(__LINE__);
   }
   theMGRootDirID = GetNewEnvDirID();
-  if (MakeEnvItem("Multigrids",theMGRootDirID,sizeof(ENVDIR))==NULL)
+  theMGRootDir = (ENVDIR *) MakeEnvItem("Multigrids",theMGRootDirID,sizeof(ENVDIR));
+  if (theMGRootDir==NULL)
   {
     PrintErrorMessage('F',"InitUGManager","could not install /Multigrids dir");
     return(__LINE__);
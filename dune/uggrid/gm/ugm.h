@@ -116,6 +116,7 @@ INT             CheckOrientationInGrid  (GRID *theGrid);
 
 NODE        *CreateSonNode          (GRID *theGrid, NODE *FatherNode);
 NODE            *CreateMidNode                  (GRID *theGrid, ELEMENT *theElement, VERTEX *theVertex, INT edge);
+void             EdgeIndexInsert        (GRID *theGrid, EDGE *theEdge);
 NODE            *GetCenterNode                  (const ELEMENT *theElement);
 NODE        *CreateCenterNode       (GRID *theGrid, ELEMENT *theElement, VERTEX *theVertex);
 
@@ -132,6 +133,9 @@ void            GetNbSideByNodes                (ELEMENT *theNeighbor, INT *nbsi
 void *GetMemoryForObject (MULTIGRID *mg, INT size, INT type);
 INT PutFreeObject (MULTIGRID *mg, void *object, INT size, GM_OBJECTS type);
 
+/* boundary vertices evaluated per grid level */
+INT              ProjectBoundaryVertices (GRID *theGrid);
+
 /* determination of node classes */
 INT             ClearNodeClasses                        (GRID *theGrid);
 INT             SeedNodeClasses                     (ELEMENT *theElement);
@@ -37,6 +37,8 @@
 #include <cstring>
 #include <cassert>
 #include <cstdio>
+#include <algorithm>
+#include <new>
 
 #include "ugtypes.h"
 #include "architecture.h"
@@ -86,16 +88,14 @@ HEAP *NS_PREFIX NewHeap (enum HeapType type, MEM size, void *buffer)
   if (size<MIN_HEAP_SIZE) return(NULL);
 
   /* initialize heap structure */
-  theHeap = (HEAP *) buffer;
+  /* The buffer is raw memory, so we construct the heap (and with it the
+   * containers it holds) using placement new. Value-initialization sets
+   * the arena position and all mark records to zero. */
+  theHeap = new(buffer) HEAP();
   theHeap->type = type;
   theHeap->size = size;
   theHeap->markKey = 0;
 
-  /* No constructor is ever called for theHeap.  Consequently, no constructor
-   * has been called for its member markedMemory, either.  Here we force this
-   * constructor call using placement new. */
-  new(theHeap->markedMemory) std::vector<void*>[MARK_STACK_SIZE+1];
-
   /* return heap structure */
   return(theHeap);
 }
@@ -115,14 +115,19 @@ HEAP *NS_PREFIX NewHeap (enum HeapType type, MEM size, void *buffer)
 void NS_PREFIX DisposeHeap (HEAP *theHeap)
 {
   if (theHeap != NULL) {
-    /* When using the system heap, the HEAP data structure contains an array of
-     * std::vectors, which have all be created using placement new.  Therefore,
-     * before freeing the memory of a HEAP we have to call the destructors of
-     * these std::vectors explicitly.  Otherwise we get memory leaks.
+    /* release all slabs of the object free lists at once */
+    for (const auto& slab : theHeap->slabs)
+      free(slab.first);
+
+    /* release the chunks of the mark/release arena */
+    for (const TmpMemChunk& chunk : theHeap->tmpChunks)
+      free(chunk.begin);
+
+    /* The HEAP has been created using placement new.  Therefore, before
+     * freeing its memory we have to call the destructor explicitly.
+     * Otherwise we get memory leaks.
      */
-    using namespace std;
-    for (INT i=0; i<MARK_STACK_SIZE; i++)
-      theHeap->markedMemory[i].~vector<void*>();
+    theHeap->~HEAP();
 
     free(theHeap);
   }
@@ -148,17 +153,50 @@ void *NS_PREFIX GetMem (HEAP *theHeap, MEM n)
    \param n - number of bytes to allocate
    \param key - key with which we can identify the rollback record
 
-   this function allocates memory on the heap and tags it with the `key`.
+   For a 'SIMPLE_HEAP' the memory is taken from an arena by advancing a
+   bump pointer. Only the most recent key may be used. When the current
+   chunk of the arena is exhausted the next chunk is used, or a new one
+   is allocated. Chunks are never returned to the system before
+   'DisposeHeap', so after a few mark/release cycles no more system
+   allocations take place.
+
+   \return pointer to the memory, NULL if not enough memory is available
 */
 void *NS_PREFIX GetTmpMem (HEAP *theHeap, MEM n, INT key)
 {
   if (theHeap->type==SIMPLE_HEAP)
   {
     ASSERT(key == theHeap->markKey);
-    /* we have to keep track of allocated memory, in order to do a proper rollback */
-    void* ptr = GetMem(theHeap,n);
-    theHeap->markedMemory[key].push_back(ptr);
-    return theHeap->markedMemory[key].back();
+    const MEM size = (n+OBJECT_ALIGNMENT-1) / OBJECT_ALIGNMENT * OBJECT_ALIGNMENT;
+
+    /* skip to the first chunk with enough space left */
+    std::vector<TmpMemChunk>& chunks = theHeap->tmpChunks;
+    while (theHeap->tmpChunk<chunks.size()
+           && theHeap->tmpOffset+size > chunks[theHeap->tmpChunk].size)
+    {
+      theHeap->tmpChunk++;
+      theHeap->tmpOffset = 0;
+    }
+
+    /* arena exhausted: append a new chunk */
+    if (theHeap->tmpChunk==chunks.size())
+    {
+      MEM chunkSize = chunks.empty() ? MIN_TMP_CHUNK_SIZE : 2*chunks.back().size;
+      chunkSize = std::max(chunkSize, size);
+      char* begin = (char*) malloc(chunkSize);
+      if (begin==NULL)
+        return NULL;
+      chunks.push_back({begin, chunkSize});
+    }
+
+    void* ptr = chunks[theHeap->tmpChunk].begin + theHeap->tmpOffset;
+    theHeap->tmpOffset += size;
+
+    TmpMemMark& mark = theHeap->marks[key];
+    mark.used += size;
+    mark.highWater = std::max(mark.highWater, mark.used);
+
+    return ptr;
   }
   /* no key for GENERAL_HEAP */
   return (GetMem(theHeap,n));
@@ -179,6 +217,285 @@ void NS_PREFIX DisposeMem (HEAP *theHeap, void *buffer)
   free(buffer);
 }
 
+/****************************************************************************/
+/** \brief Find or create the object free list for a size and type
+
+   \param theHeap - heap structure which manages memory allocation
+   \param n - size of the object in bytes
+   \param type - type of the object
+
+   \return index of the free list in theHeap->freeLists
+ */
+/****************************************************************************/
+
+static std::size_t ObjectFreeListIndex (HEAP *theHeap, MEM n, INT type)
+{
+  const MEM size = (std::max<MEM>(n,sizeof(void*))+OBJECT_ALIGNMENT-1)
+                   / OBJECT_ALIGNMENT * OBJECT_ALIGNMENT;
+
+  auto [it, isNew] = theHeap->freeListIndex.emplace(std::make_pair(type,size),
+                                                     theHeap->freeLists.size());
+  if (isNew)
+    theHeap->freeLists.push_back({type, size, NULL, MIN_OBJECT_SLAB_SIZE, 0, 0});
+
+  return it->second;
+}
+
+/****************************************************************************/
+/** \brief Allocate a new slab for an object free list
+
+   \param theHeap - heap structure which manages memory allocation
+   \param index - index of the free list in theHeap->freeLists
+
+   This function allocates a new slab and threads all objects in it
+   into the free list. Consecutive slabs of a list double in size up to
+   'MAX_OBJECT_SLAB_SIZE'.
+
+   \return <ul>
+   <li>   0 if ok </li>
+   <li>   1 if the slab could not be allocated </li>
+   </ul>
+ */
+/****************************************************************************/
+
+static INT NewObjectSlab (HEAP *theHeap, std::size_t index)
+{
+  ObjectFreeList& list = theHeap->freeLists[index];
+
+  const MEM n = std::max<MEM>(list.slabSize/list.size, 1);
+  char* slab = (char*) malloc(n*list.size);
+  if (slab==NULL)
+    return 1;
+
+  theHeap->slabs.emplace(slab, std::make_pair(slab+n*list.size, index));
+
+  /* link objects in ascending order of their addresses */
+  for (MEM i=0; i<n; i++)
+  {
+    void** obj = (void**) (slab+i*list.size);
+    *obj = (i+1<n) ? slab+(i+1)*list.size : list.first;
+  }
+  list.first = slab;
+  list.nTotal += n;
+  list.slabSize = std::min<MEM>(2*list.slabSize, MAX_OBJECT_SLAB_SIZE);
+
+  return 0;
+}
+
+/****************************************************************************/
+/** \brief Allocate an object from the object free lists of a heap
+
+   \param theHeap - heap structure which manages memory allocation
+   \param n - size of the object in bytes
+   \param type - type of the object
+
+   This function takes an object from the free list of the pair
+   ('type','n'). If that list is empty a new slab is allocated for it.
+   The memory is not initialized.
+
+   Objects obtained this way must be returned with 'DisposeObjectMem'.
+   They are released in bulk by 'DisposeHeap'.
+   If 'theHeap' is NULL the memory is taken from 'malloc'.
+
+   \return <ul>
+   <li>   pointer to the object </li>
+   <li>   NULL if not enough memory available </li>
+   </ul>
+ */
+/****************************************************************************/
+
+void *NS_PREFIX GetObjectMem (HEAP *theHeap, MEM n, INT type)
+{
+  if (theHeap==NULL)
+    return malloc(n);
+
+  const std::size_t index = ObjectFreeListIndex(theHeap, n, type);
+  ObjectFreeList& list = theHeap->freeLists[index];
+  if (list.first==NULL)
+    if (NewObjectSlab(theHeap, index))
+      return NULL;
+
+  void* obj = list.first;
+  list.first = *((void**) obj);
+  list.nUsed++;
+
+  return obj;
+}
+
+/****************************************************************************/
+/** \brief Return an object to the object free lists of a heap
+
+   \param theHeap - heap structure which manages memory allocation
+   \param object - object to dispose
+
+   This function puts an object obtained from 'GetObjectMem' back into
+   the free list of the slab it was carved from. Memory which does not
+   belong to any slab of 'theHeap' (e.g. objects allocated by DDD while
+   unpacking a message) is handed back to 'free'.
+ */
+/****************************************************************************/
+
+void NS_PREFIX DisposeObjectMem (HEAP *theHeap, void *object)
+{
+  if (object==NULL)
+    return;
+
+  if (theHeap!=NULL)
+  {
+    auto slab = theHeap->slabs.upper_bound((char*) object);
+    if (slab!=theHeap->slabs.begin())
+    {
+      --slab;
+      if ((char*) object < slab->second.first)
+      {
+        ObjectFreeList& list = theHeap->freeLists[slab->second.second];
+        *((void**) object) = list.first;
+        list.first = object;
+        list.nUsed--;
+        return;
+      }
+    }
+  }
+
+  free(object);
+}
+
+/****************************************************************************/
+/** \brief Check whether an object belongs to a heap
+
+   \param theHeap - heap structure which manages memory allocation
+   \param object - object to look up
+
+   This function looks up the slab of 'theHeap' holding 'object', like
+   'DisposeObjectMem' does.
+
+   \return <ul>
+   <li>   true if 'object' is from a slab of 'theHeap' </li>
+   <li>   false otherwise </li>
+   </ul>
+ */
+/****************************************************************************/
+
+bool NS_PREFIX ObjectInHeap (const HEAP *theHeap, const void *object)
+{
+  if (theHeap==NULL || object==NULL)
+    return false;
+
+  auto slab = theHeap->slabs.upper_bound((char*) object);
+  if (slab==theHeap->slabs.begin())
+    return false;
+  --slab;
+
+  return (const char*) object < slab->second.first;
+}
+
+/****************************************************************************/
+/** \brief Allocate objects in one contiguous block
+
+   \param theHeap - heap structure which manages memory allocation
+   \param n - size of one object in bytes
+   \param type - type of the objects
+   \param count - number of objects
+   \param objects - array of length 'count' receiving the objects
+
+   This function allocates a slab for exactly 'count' objects of the
+   pair ('type','n') and returns them in ascending order of their
+   addresses. The objects belong to the free list of that pair and are
+   returned one by one with 'DisposeObjectMem', like objects obtained
+   from 'GetObjectMem'. The memory is not initialized.
+
+   \return <ul>
+   <li>   0 if ok </li>
+   <li>   1 if not enough memory available or no heap given </li>
+   </ul>
+ */
+/****************************************************************************/
+
+INT NS_PREFIX GetObjectArray (HEAP *theHeap, MEM n, INT type, MEM count, void **objects)
+{
+  if (theHeap==NULL)
+    return 1;
+  if (count==0)
+    return 0;
+
+  const std::size_t index = ObjectFreeListIndex(theHeap, n, type);
+  ObjectFreeList& list = theHeap->freeLists[index];
+
+  char* slab = (char*) malloc(count*list.size);
+  if (slab==NULL)
+    return 1;
+
+  theHeap->slabs.emplace(slab, std::make_pair(slab+count*list.size, index));
+  for (MEM i=0; i<count; i++)
+    objects[i] = slab+i*list.size;
+  list.nUsed += count;
+  list.nTotal += count;
+
+  return 0;
+}
+
+/****************************************************************************/
+/** \brief Release slabs without objects in use
+
+   \param theHeap - heap structure which manages memory allocation
+
+   This function hands all slabs whose objects are all on the free lists
+   back to the system. The order of the remaining free objects is kept.
+ */
+/****************************************************************************/
+
+void NS_PREFIX TrimObjectMem (HEAP *theHeap)
+{
+  if (theHeap==NULL)
+    return;
+
+  /* count the free objects per slab */
+  std::map<char*,MEM> nFree;
+  for (const ObjectFreeList& list : theHeap->freeLists)
+    for (void* obj=list.first; obj!=NULL; obj=*((void**) obj))
+    {
+      auto slab = --theHeap->slabs.upper_bound((char*) obj);
+      nFree[slab->first]++;
+    }
+
+  std::vector<char*> empty;
+  for (const auto& [begin, count] : nFree)
+  {
+    const auto& slab = theHeap->slabs.at(begin);
+    if (count*theHeap->freeLists[slab.second].size == MEM(slab.first-begin))
+      empty.push_back(begin);
+  }
+  if (empty.empty())
+    return;
+
+  /* unlink the objects of empty slabs from the free lists */
+  auto isEmpty = [&](void* obj) {
+                   auto slab = --theHeap->slabs.upper_bound((char*) obj);
+                   return std::binary_search(empty.begin(), empty.end(), slab->first);
+                 };
+  for (ObjectFreeList& list : theHeap->freeLists)
+  {
+    void** next = &list.first;
+    while (*next!=NULL)
+    {
+      void* obj = *next;
+      if (isEmpty(obj))
+      {
+        *next = *((void**) obj);
+        list.nTotal--;
+      }
+      else
+        next = (void**) obj;
+    }
+  }
+
+  for (char* begin : empty)
+  {
+    theHeap->slabs.erase(begin);
+    free(begin);
+  }
+}
+
 /****************************************************************************/
 /** \copydoc Allocate memory from heap
 
@@ -225,6 +542,14 @@ INT NS_PREFIX MarkTmpMem (HEAP *theHeap, INT *key)
     return 1;
   theHeap->markKey++;
   *key = theHeap->markKey;
+
+  /* remember the arena position for the rewind in ReleaseTmpMem */
+  TmpMemMark& mark = theHeap->marks[*key];
+  mark.chunk = theHeap->tmpChunk;
+  mark.offset = theHeap->tmpOffset;
+  mark.released = false;
+  mark.used = 0;
+
   return 0;
 }
 
@@ -234,11 +559,16 @@ INT NS_PREFIX MarkTmpMem (HEAP *theHeap, INT *key)
    \param theHeap - heap to release
 
    This function releases to the next stack position. Only valid in the
-   'SIMPLE_HEAP' type.
+   'SIMPLE_HEAP' type. The bump pointer of the arena is reset to the
+   position it had when 'key' was marked.
+
+   If 'key' is not the most recent key, the memory is kept until all keys
+   marked after 'key' have been released as well.
 
    \return <ul>
    <li>   0 if OK </li>
    <li>   1 if mark stack empty or wrong heap type. </li>
+   <li>   2 if 'key' is not the most recent key </li>
    </ul>
  */
 /****************************************************************************/
@@ -250,14 +580,41 @@ INT NS_PREFIX ReleaseTmpMem (HEAP *theHeap, INT key)
   if (theHeap->markKey == 0) return 0;
   if (key > theHeap->markKey) return 1;
 
-  /* Free all memory associated to 'key' */
-  for (void* ptr : theHeap->markedMemory[key])
-    free(ptr);
-  theHeap->markedMemory[key].resize(0);
+  theHeap->marks[key].released = true;
 
   if (key < theHeap->markKey) return 2;
-  while (theHeap->markKey > 0 && theHeap->markedMemory[theHeap->markKey].size() == 0)
+  while (theHeap->markKey > 0 && theHeap->marks[theHeap->markKey].released)
+  {
+    TmpMemMark& mark = theHeap->marks[theHeap->markKey];
+    theHeap->tmpChunk = mark.chunk;
+    theHeap->tmpOffset = mark.offset;
+    mark.released = false;
+    mark.used = 0;
     theHeap->markKey--;
+  }
 
   return 0;
 }
+
+/****************************************************************************/
+/** \brief Maximum amount of temporary memory used for a key
+
+   \param theHeap - heap to query
+   \param key - mark key
+
+   Mark keys are reused in stack order. This function returns the largest
+   number of bytes that have been allocated with 'key' between a call of
+   'MarkTmpMem' and the corresponding 'ReleaseTmpMem' so far. The value
+   can be used to choose 'MIN_TMP_CHUNK_SIZE'.
+
+   \return number of bytes, 0 for an invalid key or heap type
+ */
+/****************************************************************************/
+
+MEM NS_PREFIX TmpMemHighWater (const HEAP *theHeap, INT key)
+{
+  if (theHeap->type!=SIMPLE_HEAP) return 0;
+  if (key < 0 || key > MARK_STACK_SIZE) return 0;
+
+  return theHeap->marks[key].highWater;
+}
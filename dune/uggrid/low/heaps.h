@@ -40,6 +40,9 @@
 #ifndef __HEAPS__
 #define __HEAPS__
 
+#include <cstddef>
+#include <map>
+#include <utility>
 #include <vector>
 
 #include "ugtypes.h"
@@ -93,6 +96,21 @@ enum {HEAP_FULL =           1,           /**< Return code if storage exhausted
 /** \brief Return code if the block is not defined */
 #define BLOCK_NOT_DEFINED    1
 
+/* @} */
+
+/****************************************************************************/
+/** @name Defines for the object free lists                                 */
+
+/** \brief Alignment of objects handed out by the object free lists and
+    of temporary memory handed out by GetTmpMem */
+#define OBJECT_ALIGNMENT      alignof(std::max_align_t)
+/** \brief Size in bytes of the first slab of an object free list */
+#define MIN_OBJECT_SLAB_SIZE  (1<<14)
+/** \brief Slabs of an object free list grow by doubling up to this size */
+#define MAX_OBJECT_SLAB_SIZE  (1<<22)
+/** \brief Size in bytes of the first chunk of the mark/release arena */
+#define MIN_TMP_CHUNK_SIZE    (1<<16)
+
 /* @} */
 /****************************************************************************/
 /*                                                                          */
@@ -106,11 +124,58 @@ typedef unsigned long MEM;
 /* structs and typedefs for the simple and general heap management          */
 /****************************************************************************/
 
+/** \brief Free list for the objects of one type and size
+
+   The objects are carved out of slabs owned by the heap. A free object
+   stores the pointer to the next free object in its first bytes.
+ */
+struct ObjectFreeList {
+  INT type;                       /**< object type this list was created for */
+  MEM size;                       /**< object size rounded to OBJECT_ALIGNMENT */
+  void *first;                    /**< first free object or nullptr          */
+  MEM slabSize;                   /**< size in bytes of the next slab        */
+  MEM nUsed;                      /**< number of objects handed out          */
+  MEM nTotal;                     /**< number of objects in all slabs        */
+};
+
+/** \brief Chunk of the mark/release arena of a SIMPLE_HEAP */
+struct TmpMemChunk {
+  char *begin;                    /**< start of the chunk                    */
+  MEM size;                       /**< size of the chunk in bytes            */
+};
+
+/** \brief Arena position and statistics recorded for a mark key */
+struct TmpMemMark {
+  std::size_t chunk;              /**< current chunk at MarkTmpMem           */
+  MEM offset;                     /**< offset into that chunk at MarkTmpMem  */
+  bool released;                  /**< ReleaseTmpMem has been called         */
+  MEM used;                       /**< bytes allocated since MarkTmpMem      */
+  MEM highWater;                  /**< max. bytes ever allocated for the key */
+};
+
 typedef struct {
   enum HeapType type;
   MEM size;
   INT markKey;
-  std::vector<void*> markedMemory[MARK_STACK_SIZE+1];
+
+  /** @name Mark/release arena, see GetTmpMem */
+  /* @{ */
+  /** \brief Chunks of the arena. They are kept when memory is released. */
+  std::vector<TmpMemChunk> tmpChunks;
+  /** \brief Chunk the bump pointer currently points into */
+  std::size_t tmpChunk;
+  /** \brief Offset of the bump pointer into the current chunk */
+  MEM tmpOffset;
+  /** \brief Arena position and statistics per mark key */
+  TmpMemMark marks[MARK_STACK_SIZE+1];
+  /* @} */
+
+  /** \brief Object free lists, see GetObjectMem */
+  std::vector<ObjectFreeList> freeLists;
+  /** \brief Index into freeLists for each (type,size) pair */
+  std::map<std::pair<INT,MEM>,std::size_t> freeListIndex;
+  /** \brief All slabs: start address -> (end address, index into freeLists) */
+  std::map<char*,std::pair<char*,std::size_t> > slabs;
 } HEAP;
 
 /****************************************************************************/
@@ -128,9 +193,16 @@ void        *GetMem                 (HEAP *theHeap, MEM n);
 void        *GetFreelistMemory      (HEAP *theHeap, INT size);
 void         DisposeMem             (HEAP *theHeap, void *buffer);
 
+void        *GetObjectMem           (HEAP *theHeap, MEM n, INT type);
+void         DisposeObjectMem       (HEAP *theHeap, void *object);
+bool         ObjectInHeap           (const HEAP *theHeap, const void *object);
+INT          GetObjectArray         (HEAP *theHeap, MEM n, INT type, MEM count, void **objects);
+void         TrimObjectMem          (HEAP *theHeap);
+
 INT          MarkTmpMem             (HEAP *theHeap, INT *key);
 void        *GetTmpMem              (HEAP *theHeap, MEM n, INT key);
 INT          ReleaseTmpMem          (HEAP *theHeap, INT key);
+MEM          TmpMemHighWater        (const HEAP *theHeap, INT key);
 /* @} */
 
 END_UG_NAMESPACE
@@ -0,0 +1,162 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-2.1-or-later
+#include "config.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <set>
+#include <vector>
+
+#include <dune/common/test/testsuite.hh>
+
+#include "../heaps.h"
+
+using namespace Dune;
+
+TestSuite test_object_mem()
+{
+  TestSuite test;
+
+  using namespace UG;
+
+  HEAP* heap = NewHeap(SIMPLE_HEAP, sizeof(HEAP), std::malloc(sizeof(HEAP)));
+  test.require(heap != nullptr, "require that NewHeap() succeeds");
+
+  const INT typeA = 1;
+  const INT typeB = 2;
+  const MEM size = 72;
+  const INT n = 10000;
+
+  std::vector<void*> objects;
+  std::set<void*> unique;
+  for (INT i = 0; i < n; ++i) {
+    void* obj = GetObjectMem(heap, size, typeA);
+    test.check(obj != nullptr, "GetObjectMem() must return memory");
+    test.check(reinterpret_cast<std::uintptr_t>(obj) % OBJECT_ALIGNMENT == 0,
+               "Objects must be aligned to OBJECT_ALIGNMENT");
+    std::fill_n(static_cast<char*>(obj), size, char(i));
+    objects.push_back(obj);
+    unique.insert(obj);
+  }
+  test.check(unique.size() == objects.size(), "Objects must not overlap");
+  test.check(heap->freeLists.size() == 1, "One free list per (type,size) pair");
+  test.check(heap->freeLists[0].nUsed == MEM(n), "All objects must be counted as used");
+
+  /* a different type of the same size gets its own list */
+  void* other = GetObjectMem(heap, size, typeB);
+  test.check(heap->freeLists.size() == 2, "A new type must create a new free list");
+  test.check(unique.count(other) == 0, "Objects of different types must not overlap");
+
+  /* disposed objects are handed out again */
+  void* recycled = objects.back();
+  objects.pop_back();
+  DisposeObjectMem(heap, recycled);
+  test.check(heap->freeLists[0].nUsed == MEM(n-1), "Disposed objects must not be counted as used");
+  test.check(GetObjectMem(heap, size, typeA) == recycled, "Free list must recycle disposed objects");
+  objects.push_back(recycled);
+
+  /* memory not owned by the heap is passed to free */
+  DisposeObjectMem(heap, std::malloc(size));
+  DisposeObjectMem(heap, nullptr);
+
+  for (void* obj : objects)
+    DisposeObjectMem(heap, obj);
+  test.check(heap->freeLists[0].nUsed == 0, "All objects must have been returned");
+  test.check(heap->freeLists[0].nTotal >= MEM(n), "Slabs must hold all objects");
+
+  /* object arrays are contiguous and recycled through the free list */
+  std::vector<void*> array(100);
+  test.require(GetObjectArray(heap, size, typeA, array.size(), array.data()) == 0,
+               "require that GetObjectArray() succeeds");
+  const MEM stride = (size + OBJECT_ALIGNMENT - 1) / OBJECT_ALIGNMENT * OBJECT_ALIGNMENT;
+  for (std::size_t i = 1; i < array.size(); ++i)
+    test.check(static_cast<char*>(array[i]) == static_cast<char*>(array[i-1]) + stride,
+               "Object arrays must be contiguous with aligned stride");
+  test.check(heap->freeLists[0].nUsed == MEM(array.size()), "Array objects must be counted as used");
+
+  /* slabs without objects in use are released, all others are kept */
+  const auto nSlabs = heap->slabs.size();
+  TrimObjectMem(heap);
+  test.check(heap->slabs.size() < nSlabs, "TrimObjectMem() must release unused slabs");
+  test.check(heap->freeLists[0].nTotal == MEM(array.size()), "Only the slab of the array must be kept");
+  test.check(heap->freeLists[1].nTotal >= 1, "Slabs with objects in use must be kept");
+  DisposeObjectMem(heap, array.back());
+  test.check(GetObjectMem(heap, size, typeA) == array.back(),
+             "Disposed array objects must be recycled");
+
+  /* objects still in use are released together with the heap */
+  DisposeHeap(heap);
+
+  /* without a heap the system allocator is used */
+  void* sys = GetObjectMem(nullptr, size, typeA);
+  test.check(sys != nullptr, "GetObjectMem() without heap must return memory");
+  DisposeObjectMem(nullptr, sys);
+
+  return test;
+}
+
+TestSuite test_tmp_mem()
+{
+  TestSuite test;
+
+  using namespace UG;
+
+  HEAP* heap = NewHeap(SIMPLE_HEAP, sizeof(HEAP), std::malloc(sizeof(HEAP)));
+  test.require(heap != nullptr, "require that NewHeap() succeeds");
+
+  INT key1, key2;
+  test.require(MarkTmpMem(heap, &key1) == 0, "require that MarkTmpMem() succeeds");
+
+  char* a = static_cast<char*>(GetTmpMem(heap, 100, key1));
+  char* b = static_cast<char*>(GetTmpMem(heap, 100, key1));
+  test.check(a != nullptr && b != nullptr, "GetTmpMem() must return memory");
+  test.check(b >= a + 100, "Temporary allocations must not overlap");
+  test.check(reinterpret_cast<std::uintptr_t>(b) % OBJECT_ALIGNMENT == 0,
+             "Temporary memory must be aligned to OBJECT_ALIGNMENT");
+
+  test.require(MarkTmpMem(heap, &key2) == 0, "require that nested MarkTmpMem() succeeds");
+  test.check(key2 == key1 + 1, "Mark keys must be handed out in stack order");
+  char* c = static_cast<char*>(GetTmpMem(heap, 1000, key2));
+  test.check(ReleaseTmpMem(heap, key2) == 0, "Releasing the last key must succeed");
+  test.check(GetTmpMem(heap, 1000, key1) == c, "Released memory must be reused");
+
+  /* allocations larger than a chunk get a chunk of their own */
+  char* big = static_cast<char*>(GetTmpMem(heap, 4*MIN_TMP_CHUNK_SIZE, key1));
+  test.check(big != nullptr, "GetTmpMem() must serve allocations larger than a chunk");
+  std::fill_n(big, 4*MIN_TMP_CHUNK_SIZE, 'x');
+  const auto nChunks = heap->tmpChunks.size();
+
+  test.check(ReleaseTmpMem(heap, key1) == 0, "Releasing the first key must succeed");
+  test.check(heap->markKey == 0, "All keys must have been released");
+  test.check(TmpMemHighWater(heap, key1) >= 2*100 + 1000 + 4*MIN_TMP_CHUNK_SIZE,
+             "High-water mark must cover all allocations of the key");
+  test.check(TmpMemHighWater(heap, key2) >= 1000, "High-water mark must be kept per key");
+
+  /* the same amount of memory fits into the chunks allocated before */
+  test.require(MarkTmpMem(heap, &key1) == 0, "require that MarkTmpMem() succeeds again");
+  GetTmpMem(heap, 200, key1);
+  GetTmpMem(heap, 4*MIN_TMP_CHUNK_SIZE, key1);
+  test.check(heap->tmpChunks.size() == nChunks, "Chunks must be reused after a release");
+
+  /* releasing an older key first keeps its memory until the newer key is released */
+  test.require(MarkTmpMem(heap, &key2) == 0, "require that nested MarkTmpMem() succeeds");
+  test.check(ReleaseTmpMem(heap, key1) == 2, "Releasing an older key first must be reported");
+  test.check(heap->markKey == key2, "Newer keys must stay marked");
+  test.check(ReleaseTmpMem(heap, key2) == 0, "Releasing the top key must succeed");
+  test.check(heap->markKey == 0, "Released older keys must be unwound with the top key");
+
+  DisposeHeap(heap);
+
+  return test;
+}
+
+int main()
+{
+  TestSuite test;
+
+  test.subTest(test_object_mem());
+  test.subTest(test_tmp_mem());
+
+  return test.exit();
+}
@@ -0,0 +1,285 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-2.1-or-later
+#ifndef DUNE_UGGRID_PARALLEL_DDD_BASIC_ITEMSET_HH
+#define DUNE_UGGRID_PARALLEL_DDD_BASIC_ITEMSET_HH 1
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace DDD {
+
+class DDDContext;
+
+namespace Basic {
+
+/**
+ * items of one kind of command, as collected by DDD_XferBegin/End
+ * and DDD_JoinBegin/End.
+ *
+ * The items are allocated from an arena of segments, which grow
+ * geometrically and keep their addresses, and are recorded in a flat
+ * array in the order of their creation. clear() keeps the first
+ * segment for the next round.
+ */
+template<class T>
+class ItemList
+{
+public:
+  /** size of the first segment, later segments double up to MaxSegmSize */
+  static constexpr int SegmSize = 256;
+  static constexpr int MaxSegmSize = 65536;
+
+  /** get a new item, it stays valid until clear() */
+  T* newItem ()
+  {
+    if (segm_==segms_.size() || used_==segms_[segm_].size)
+    {
+      if (segm_<segms_.size())
+        segm_++;
+      if (segm_==segms_.size())
+      {
+        const int size = segms_.empty() ? SegmSize
+                         : std::min(2*segms_.back().size, MaxSegmSize);
+        segms_.push_back({std::make_unique<T[]>(size), size});
+      }
+      used_ = 0;
+    }
+
+    T* item = &segms_[segm_].data[used_++];
+    items_.push_back(item);
+    return item;
+  }
+
+  /** give back the item which was created last */
+  void discardLast ()
+  {
+    items_.pop_back();
+    used_--;
+    nDiscarded_++;
+  }
+
+  /** all items in the order of their creation */
+  std::vector<T*>& items ()
+  { return items_; }
+
+  const std::vector<T*>& items () const
+  { return items_; }
+
+  int size () const
+  { return items_.size(); }
+
+  int nDiscarded () const
+  { return nDiscarded_; }
+
+  /**
+   * array of all items, sorted by compar(a,b)<0.
+   *
+   * The sort is stable with the newest items first, like the linked
+   * lists this class replaces.
+   */
+  template<class Compare>
+  std::vector<T*> sortedArray (Compare compar) const
+  {
+    std::vector<T*> array(items_.rbegin(), items_.rend());
+    std::stable_sort(array.begin(), array.end(),
+                     [&](const T* a, const T* b) { return compar(a, b) < 0; });
+    return array;
+  }
+
+  /**
+   * compress a sorted array of items, the number of valid items is
+   * returned.
+   *
+   * compar(context,a,b) returns false if *a should be skipped and
+   * eventually *b could be chosen, and true if *a must be taken. The
+   * last item is always taken.
+   */
+  static int unify (const DDD::DDDContext& context, std::vector<T*>& array,
+                    int (*compar)(const DDD::DDDContext&, T**, T**))
+  {
+    const int n = array.size();
+    int cntValid = 0;
+
+    for (int i=0; i<n-1; i++)
+      if (compar(context, &array[i], &array[i+1]))
+        array[cntValid++] = array[i];
+
+    if (n>0)
+      array[cntValid++] = array[n-1];
+
+    return cntValid;
+  }
+
+  /** forget all items, keep the first segment */
+  void clear ()
+  {
+    items_.clear();
+    if (segms_.size()>1)
+      segms_.resize(1);
+    segm_ = 0;
+    used_ = 0;
+    nDiscarded_ = 0;
+  }
+
+  /** quantitative resource usage */
+  void getResources (int *nSegms, int *nItems, std::size_t *alloc_mem, std::size_t *used_mem) const
+  {
+    std::size_t allocated = 0;
+    for (const auto& segm : segms_)
+      allocated += segm.size * sizeof(T);
+
+    *nSegms    = segms_.size();
+    *nItems    = items_.size();
+    *alloc_mem = allocated + items_.capacity() * sizeof(T*);
+    *used_mem  = items_.size() * (sizeof(T) + sizeof(T*));
+  }
+
+private:
+  struct Segm
+  {
+    std::unique_ptr<T[]> data;
+    int size;
+  };
+
+  std::vector<Segm> segms_;
+  std::size_t segm_ = 0;
+  int used_ = 0;
+
+  std::vector<T*> items_;
+  int nDiscarded_ = 0;
+};
+
+
+/**
+ * items of one kind of command, where items with equal keys are
+ * merged at once.
+ *
+ * compare(a,b,context) returns 0 for equal keys, after merging the new
+ * item b into the existing item a. less(a,b) orders the items by the
+ * same keys without side effects, hash(a) must be equal for items
+ * with equal keys.
+ * Duplicates are found by an open-addressing hash table, which
+ * replaces the B-tree of ooppcc.h; the items are sorted only once
+ * by getArray().
+ */
+template<class T>
+class ItemSet : public ItemList<T>
+{
+public:
+  using Compare = int (*)(T*, T*, const DDD::DDDContext*);
+  using Less = bool (*)(const T*, const T*);
+  using Hash = std::size_t (*)(const T*);
+
+  ItemSet (Compare compare, Less less, Hash hash, const DDD::DDDContext* context)
+    : compare_(compare), less_(less), hash_(hash), context_(context)
+  {}
+
+  /**
+   * insert the item which was created last by newItem().
+   *
+   * If there is an item with the same key already, both are merged,
+   * the new item is discarded and false is returned.
+   */
+  bool itemOK ()
+  {
+    T* item = this->items().back();
+
+    if (2*this->size() > int(table_.size()))
+      rehash(std::max<std::size_t>(2*table_.size(), TableSize));
+
+    const std::size_t mask = table_.size()-1;
+    for (std::size_t i = slot(item); ; i = (i+1) & mask)
+    {
+      if (table_[i]==nullptr)
+      {
+        table_[i] = item;
+        return true;
+      }
+
+      /* NOTE: the order of arguments for compare is crucial!
+               first comes the existing item, 2nd the new one. */
+      if (compare_(table_[i], item, context_)==0)
+      {
+        this->discardLast();
+        return false;
+      }
+    }
+  }
+
+  /**
+   * array of all items, sorted by less.
+   *
+   * Commands are often issued in the order of the gids already, then
+   * the sort is skipped.
+   */
+  std::vector<T*> getArray () const
+  {
+    std::vector<T*> array(this->items());
+    if (!std::is_sorted(array.begin(), array.end(), less_))
+      std::sort(array.begin(), array.end(), less_);
+    return array;
+  }
+
+  /** forget all items, the table is kept unless it was much too large */
+  void clear ()
+  {
+    if (table_.size() > 8*std::size_t(this->size()) + TableSize)
+      table_.clear();
+    else
+      std::fill(table_.begin(), table_.end(), nullptr);
+    ItemList<T>::clear();
+  }
+
+  void getResources (int *nSegms, int *nItems, std::size_t *alloc_mem, std::size_t *used_mem) const
+  {
+    ItemList<T>::getResources(nSegms, nItems, alloc_mem, used_mem);
+    *alloc_mem += table_.capacity() * sizeof(T*);
+    *used_mem  += *nItems * sizeof(T*);
+  }
+
+private:
+  static constexpr std::size_t TableSize = 1024;
+
+  /* Fibonacci hashing, takes the high bits of the product. The low
+     bits of a gid hold the processor number, they are equal for most
+     items and must not select the slot alone. */
+  std::size_t slot (const T* item) const
+  {
+    const std::uint64_t h = std::uint64_t(hash_(item)) * UINT64_C(0x9e3779b97f4a7c15);
+    return std::size_t(h >> (64-bits_));
+  }
+
+  void rehash (std::size_t size)
+  {
+    table_.assign(size, nullptr);
+    bits_ = 0;
+    while ((std::size_t(1)<<bits_) < size)
+      bits_++;
+
+    const std::size_t mask = size-1;
+    auto& items = this->items();
+    for (std::size_t k=0; k+1<items.size(); k++)
+    {
+      std::size_t i = slot(items[k]);
+      while (table_[i]!=nullptr)
+        i = (i+1) & mask;
+      table_[i] = items[k];
+    }
+  }
+
+  Compare compare_;
+  Less less_;
+  Hash hash_;
+  const DDD::DDDContext* context_;
+
+  std::vector<T*> table_;
+  int bits_ = 0;
+};
+
+} /* namespace Basic */
+} /* namespace DDD */
+
+#endif
@@ -71,6 +71,7 @@
 #include <iomanip>
 #include <iostream>
 #include <new>
+#include <vector>
 
 #include <dune/common/exceptions.hh>
 #include <dune/common/stdstreams.hh>
@@ -1183,7 +1184,22 @@ int LC_Abort(DDD::DDDContext& context, int exception)
 /*                                                                          */
 /****************************************************************************/
 
-LC_MSGHANDLE *LC_Communicate(const DDD::DDDContext& context)
+/**
+        Completes all sends and receives of the current communication.
+        Instead of polling every message, the function waits until some
+        messages have completed (MPI_Waitsome), so its cost does not
+        grow with the number of outstanding messages.
+
+        If a handler {\em unpack} is given, it is called for every
+        received message as soon as this message and all messages before
+        it in the returned array have arrived. Thus unpacking overlaps
+        with the messages still in transit, while the order of unpacking
+        is the same as without handler.
+
+   @return array of received messages
+   @param unpack  handler for received messages (optional)
+ */
+LC_MSGHANDLE *LC_Communicate(const DDD::DDDContext& context, const LC_MSGHANDLER& unpack)
 {
   auto& lcContext = context.lowCommContext();
 
@@ -1192,13 +1208,71 @@ LC_MSGHANDLE *LC_Communicate(const DDD::DDDContext& context)
 #       endif
 
 
-  /* poll asynchronous send and receives */
-  int leftSend = lcContext.nSends;
-  int leftRecv = lcContext.nRecvs;
-  do {
-    if (leftRecv>0) leftRecv = LC_PollRecv(context);
-    if (leftSend>0) leftSend = LC_PollSend(context);
-  } while (leftRecv>0 || leftSend>0);
+  /* collect outstanding receives and sends, some of them may have
+     been completed by LC_MsgAlloc already */
+  std::vector<msgid> ids;
+  std::vector<MSG_DESC *> descs;
+  for(int i=0; i<lcContext.nRecvs; i++)
+  {
+    MSG_DESC *md = lcContext.theRecvArray[i];
+    if (md->msgState==MSTATE_COMM)
+    {
+      ids.push_back(md->msgId);
+      descs.push_back(md);
+    }
+  }
+  const int nRecvIds = ids.size();
+  for(MSG_DESC *md=lcContext.SendQueue; md != nullptr; md=md->next)
+  {
+    if (md->msgState==MSTATE_COMM)
+    {
+      ids.push_back(md->msgId);
+      descs.push_back(md);
+    }
+  }
+
+
+  /* hand over received messages in order */
+  int nUnpacked = 0;
+  const auto deliver = [&]() {
+                         while (nUnpacked<lcContext.nRecvs
+                                && lcContext.theRecvArray[nUnpacked]->msgState==MSTATE_READY)
+                         {
+                           if (unpack)
+                             unpack(lcContext.theRecvArray[nUnpacked]);
+                           nUnpacked++;
+                         }
+                       };
+  deliver();
+
+
+  /* wait for completion of sends and receives, the requests are
+     set up once and kept up to date by WaitSome */
+  std::vector<MPI_Request> requests(ids.size());
+  GetRequests(ids.size(), ids.data(), requests.data());
+  std::vector<int> completed(ids.size());
+  int left = ids.size();
+  while (left>0)
+  {
+    int n = WaitSome(context.ppifContext(), ids.size(), ids.data(), requests.data(), completed.data());
+    if (n<=0)
+      DUNE_THROW(Dune::Exception, "WaitSome() failed in LC_Communicate()");
+
+    for(int k=0; k<n; k++)
+    {
+      MSG_DESC *md = descs[completed[k]];
+      if (completed[k] < nRecvIds)
+        LC_MsgRecv(md);
+      else
+        LC_DeleteMsgBuffer(context, (LC_MSGHANDLE)md);
+
+      md->msgId = NO_MSGID;
+      md->msgState = MSTATE_READY;
+    }
+    left -= n;
+
+    deliver();
+  }
 
 
 #       if DebugLowComm<=9
@@ -32,6 +32,8 @@
 #ifndef __DDD_LOWCOMM_H__
 #define __DDD_LOWCOMM_H__
 
+#include <functional>
+
 #include <dune/uggrid/parallel/ddd/dddtypes.hh>
 
 namespace DDD {
@@ -71,6 +73,9 @@ using LC_MSGCOMP = DDD::Basic::LC_MSGCOMP;
 using AllocFunc = DDD::Basic::AllocFunc;
 using FreeFunc = DDD::Basic::FreeFunc;
 
+/* handler for received messages, see LC_Communicate */
+using LC_MSGHANDLER = std::function<void(LC_MSGHANDLE)>;
+
 
 /****************************************************************************/
 /*                                                                          */
@@ -96,7 +101,8 @@ void       LC_MsgSend (const DDD::DDDContext& context, LC_MSGHANDLE);
 
 int           LC_Connect(DDD::DDDContext& context, LC_MSGTYPE);
 int           LC_Abort(DDD::DDDContext& context, int);
-LC_MSGHANDLE *LC_Communicate(const DDD::DDDContext& context);
+LC_MSGHANDLE *LC_Communicate(const DDD::DDDContext& context,
+                             const LC_MSGHANDLER& unpack = nullptr);
 void          LC_Cleanup(DDD::DDDContext& context);
 
 
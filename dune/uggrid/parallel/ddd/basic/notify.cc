@@ -19,6 +19,7 @@
 /* History:   94/01/17 kb  begin                                            */
 /*            95/04/06 kb  added SpreadNotify                               */
 /*            96/07/12 kb  united xxxNotify functions to one DDD_Notify()   */
+/*                         non-blocking consensus (OPT_NOTIFY_NBX)          */
 /*                                                                          */
 /* Remarks:                                                                 */
 /*                                                                          */
@@ -40,6 +41,9 @@
 #include <algorithm>
 #include <new>
 #include <tuple>
+#include <vector>
+
+#include <mpi.h>
 
 #include <dune/common/stdstreams.hh>
 
@@ -357,6 +361,107 @@ int NotifyTwoWave(DDD::DDDContext& context, NOTIFY_INFO *allInfos, int lastInfo,
 
 
 
+/****************************************************************************/
+
+/*
+        Sparse alternative to NotifyTwoWave (option OPT_NOTIFY_NBX),
+        the non-blocking consensus of Hoefler et al. Every message is
+        announced to its receiver by a synchronous send, which completes
+        only after it has been received. Each processor receives
+        announcements until all its own ones have completed; then it
+        joins a non-blocking reduction, which completes when all
+        processors have done so and which delivers the maximal exception.
+        Only the processors involved exchange data, instead of
+        concentrating all Infos at the root of the processor tree.
+
+        Consecutive calls alternate between two tags, as a processor
+        may already announce the messages of the next call while others
+        still wait for the reduction of the current one.
+ */
+static int NotifyNBX(DDD::DDDContext& context, int exception)
+{
+  auto& ctx = context.notifyContext();
+  const auto procs = context.procs();
+  const MPI_Comm comm = context.ppifContext().comm();
+  const int tag = VC_NOTIFY + (ctx.nbxRound++ & 1);
+  const int nSends = (exception==0) ? ctx.nSendDescs : 0;
+
+  /* announce the messages, the sizes must live until completion */
+  ctx.nbxSizes.resize(nSends);
+  std::vector<MPI_Request> sends(nSends);
+  for(int i=0; i<nSends; i++)
+  {
+    ctx.nbxSizes[i] = ctx.theDescs[i].size;
+    MPI_Issend(&ctx.nbxSizes[i], sizeof(std::size_t), MPI_BYTE, ctx.theDescs[i].proc, tag, comm, &sends[i]);
+  }
+
+  /* reuse theDescs-array for registering messages to be received */
+  int nRecvs = 0;
+  bool overflow = false;
+  int local_exception = exception;
+  int global_exception = 0;
+  MPI_Request reduction = MPI_REQUEST_NULL;
+  bool done = false;
+  while (! done)
+  {
+    int arrived;
+    MPI_Status status;
+    MPI_Iprobe(MPI_ANY_SOURCE, tag, comm, &arrived, &status);
+    if (arrived)
+    {
+      std::size_t size;
+      MPI_Recv(&size, sizeof(std::size_t), MPI_BYTE, status.MPI_SOURCE, tag, comm, MPI_STATUS_IGNORE);
+      if (nRecvs < procs-1)
+      {
+        ctx.theDescs[nRecvs].proc = status.MPI_SOURCE;
+        ctx.theDescs[nRecvs].size = size;
+        nRecvs++;
+      }
+      else
+        overflow = true;
+    }
+
+    if (reduction==MPI_REQUEST_NULL)
+    {
+      int sent;
+      MPI_Testall(nSends, sends.data(), &sent, MPI_STATUSES_IGNORE);
+      if (sent)
+        MPI_Iallreduce(&local_exception, &global_exception, 1, MPI_INT, MPI_MAX,
+                       comm, &reduction);
+    }
+    else
+    {
+      int complete;
+      MPI_Test(&reduction, &complete, MPI_STATUS_IGNORE);
+      done = complete;
+    }
+  }
+
+  if (global_exception>0)
+    return(-global_exception);
+
+  if (overflow)
+  {
+    DDD_PrintError('E', 6322, "msg-info array overflow in NotifyNBX");
+    return(ERROR);
+  }
+
+  /* the order of arrival is random */
+  std::sort(ctx.theDescs.begin(), ctx.theDescs.begin() + nRecvs,
+            [](const NOTIFY_DESC& a, const NOTIFY_DESC& b) {
+              return a.proc < b.proc;
+            });
+
+#if     DebugNotify<=3
+  printf("%4d:    NotifyNBX ready, nRecv=%d\n", context.me(), nRecvs);
+  fflush(stdout);
+#endif
+
+  return(nRecvs);
+}
+
+
+
 /****************************************************************************/
 
 
@@ -392,6 +497,7 @@ int DDD_Notify(DDD::DDDContext& context)
 
   const auto me = context.me();
   const auto procs = context.procs();
+  const bool nbx = DDD_GetOption(context, OPT_NOTIFY_NBX) == OPT_ON;
 
   /* get storage for local info list */
   NOTIFY_INFO* allInfos = NotifyPrepare(context);
@@ -408,7 +514,10 @@ int DDD_Notify(DDD::DDDContext& context)
       << " is sending global exception #" << (-ctx.nSendDescs) << "\n";
 
     /* notify partners */
-    nRecvMsgs = NotifyTwoWave(context, allInfos, ctx.lastInfo, -ctx.nSendDescs);
+    if (nbx)
+      nRecvMsgs = NotifyNBX(context, -ctx.nSendDescs);
+    else
+      nRecvMsgs = NotifyTwoWave(context, allInfos, ctx.lastInfo, -ctx.nSendDescs);
   }
   else
   {
@@ -440,7 +549,10 @@ int DDD_Notify(DDD::DDDContext& context)
     }
 
     /* notify partners */
-    nRecvMsgs = NotifyTwoWave(context, allInfos, ctx.lastInfo, 0);
+    if (nbx)
+      nRecvMsgs = NotifyNBX(context, 0);
+    else
+      nRecvMsgs = NotifyTwoWave(context, allInfos, ctx.lastInfo, 0);
   }
 
 
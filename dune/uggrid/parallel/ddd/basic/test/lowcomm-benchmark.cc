@@ -0,0 +1,194 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************/
+/*                                                                          */
+/* File:      lowcomm-benchmark.cc                                          */
+/*                                                                          */
+/* Purpose:   time LC_Communicate with messages to all other processors,    */
+/*            unpacking after completion and on arrival, and check an       */
+/*            object transfer (which unpacks coupling messages on arrival)  */
+/*            with DDD_ConsCheck                                            */
+/*                                                                          */
+/*            usage: lowcomm-benchmark [ints per message] [repetitions]     */
+/*                                     [objects per processor]              */
+/*                                                                          */
+/****************************************************************************/
+
+#include <config.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/uggrid/parallel/ppif/ppifcontext.hh>
+#include <dune/uggrid/parallel/ddd/dddi.h>
+#include <dune/uggrid/parallel/ddd/basic/lowcomm.h>
+
+USING_UG_NAMESPACES
+
+using Clock = std::chrono::steady_clock;
+
+static double SecondsSince (Clock::time_point start)
+{
+  return std::chrono::duration<double>(Clock::now()-start).count();
+}
+
+/* the header comes first, so objects and headers have the same address */
+struct Object
+{
+  DDD_HEADER hdr;
+  int value;
+};
+
+/* message to p contains m ints 1000*me+p+k */
+static int Check (LC_MSGHANDLE xm, LC_MSGCOMP table, int me, int m)
+{
+  const DDD_PROC from = LC_MsgGetProc(xm);
+  const int *data = static_cast<int *>(LC_GetPtr(xm, table));
+  int errors = (int(LC_GetTableLen(xm, table)) != m);
+  for (int k=0; k<m; k++)
+    errors += (data[k] != 1000*int(from) + me + k);
+  return errors;
+}
+
+/* one message to every other processor */
+static int Communicate (DDD::DDDContext& context, LC_MSGTYPE msgType, LC_MSGCOMP table,
+                        int m, bool onArrival)
+{
+  const int me = context.me();
+  const int procs = context.procs();
+
+  std::vector<LC_MSGHANDLE> sendMsgs;
+  for (int p=0; p<procs; p++)
+    if (p!=me)
+    {
+      LC_MSGHANDLE xm = LC_NewSendMsg(context, msgType, p);
+      LC_SetTableSize(xm, table, m);
+      LC_MsgPrepareSend(context, xm);
+      sendMsgs.push_back(xm);
+    }
+
+  const int nRecvs = LC_Connect(context, msgType);
+
+  for (LC_MSGHANDLE xm : sendMsgs)
+  {
+    int *data = static_cast<int *>(LC_GetPtr(xm, table));
+    for (int k=0; k<m; k++)
+      data[k] = 1000*me + LC_MsgGetProc(xm) + k;
+    LC_SetTableLen(xm, table, m);
+    LC_MsgSend(context, xm);
+  }
+
+  int errors = 0;
+  int nUnpacked = 0;
+  LC_MSGHANDLE *recvMsgs;
+  if (onArrival)
+  {
+    /* the handler sees the messages in the order of the array */
+    recvMsgs = LC_Communicate(context, [&](LC_MSGHANDLE xm) {
+      errors += (xm != context.lowCommContext().theRecvArray[nUnpacked++]);
+      errors += Check(xm, table, me, m);
+    });
+  }
+  else
+  {
+    recvMsgs = LC_Communicate(context);
+    for (int i=0; i<nRecvs; i++, nUnpacked++)
+      errors += Check(recvMsgs[i], table, me, m);
+  }
+  errors += (nUnpacked != nRecvs) + (nRecvs != procs-1);
+
+  LC_Cleanup(context);
+  return errors;
+}
+
+int main (int argc, char **argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+
+  const int m = (argc>1) ? std::atoi(argv[1]) : 10000;
+  const int repetitions = (argc>2) ? std::atoi(argv[2]) : 100;
+  const int n = (argc>3) ? std::atoi(argv[3]) : 10000;
+
+  auto ppifContext = std::make_shared<PPIF::PPIFContext>();
+  DDD::DDDContext context(ppifContext, nullptr);
+  DDD_Init(context);
+  DDD_SetOption(context, OPT_WARNING_DESTRUCT_HDR, OPT_OFF);
+
+  const int me = context.me();
+  const int procs = context.procs();
+
+  LC_MSGTYPE msgType = LC_NewMsgType(context, "Test");
+  LC_MSGCOMP table = LC_NewMsgTable("Ints", msgType, sizeof(int));
+
+  int errors = 0;
+  double seconds[2];
+  for (int onArrival=0; onArrival<2; onArrival++)
+  {
+    const auto start = Clock::now();
+    for (int r=0; r<repetitions; r++)
+      errors += Communicate(context, msgType, table, m, onArrival);
+    seconds[onArrival] = SecondsSince(start);
+  }
+
+  /* copy all objects to the next processor */
+  DDD_TYPE type = DDD_TypeDeclare(context, "Object");
+  DDD_TypeDefine(context, type,
+                 EL_DDDHDR, offsetof(Object,hdr),
+                 EL_LDATA,  offsetof(Object,value), sizeof(int),
+                 EL_END,    sizeof(Object));
+
+  std::vector<Object> objects(n);
+  for (int i=0; i<n; i++)
+  {
+    DDD_HdrConstructor(context, &objects[i].hdr, type, 1, 0);
+    objects[i].value = i;
+  }
+
+  auto start = Clock::now();
+  DDD_XferBegin(context);
+  if (procs>1)
+    for (auto& object : objects)
+      DDD_XferCopyObj(context, &object.hdr, (me+1)%procs, 1);
+  DDD_XferEnd(context);
+  const double xferTime = SecondsSince(start);
+  /* only objects with copies are in the object table */
+  errors += (context.nObjs() != (procs>1 ? 2*n : 0));
+  errors += DDD_ConsCheck(context);
+
+  /* delete the received copies again */
+  std::vector<DDD_HDR> received;
+  for (int i=0; i<context.nObjs(); i++)
+  {
+    DDD_HDR hdr = context.objTable()[i];
+    if (hdr < &objects.front().hdr || hdr > &objects.back().hdr)
+      received.push_back(hdr);
+  }
+  DDD_XferBegin(context);
+  for (DDD_HDR hdr : received)
+    DDD_XferDeleteObj(context, hdr);
+  DDD_XferEnd(context);
+  errors += (context.nObjs() != 0);
+  errors += DDD_ConsCheck(context);
+
+  if (me==0)
+  {
+    printf("%d processors, %d ints per message, %d repetitions\n", procs, m, repetitions);
+    printf("unpack after completion  %8.3f ms\n", 1e3*seconds[0]/repetitions);
+    printf("unpack on arrival        %8.3f ms\n", 1e3*seconds[1]/repetitions);
+    printf("xfer of %d objects     %8.3f ms\n", n, 1e3*xferTime);
+  }
+
+  for (auto& object : objects)
+    DDD_HdrDestructor(context, &object.hdr);
+  DDD_Exit(context);
+
+  if (errors)
+    printf("%d: lowcomm-benchmark: %d errors\n", me, errors);
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************/
+/*                                                                          */
+/* File:      notify-benchmark.cc                                           */
+/*                                                                          */
+/* Purpose:   time DDD_Notify with the two-wave algorithm and with the      */
+/*            non-blocking consensus (OPT_NOTIFY_NBX) for a sparse          */
+/*            communication pattern, and check both give the same result   */
+/*                                                                          */
+/*            usage: notify-benchmark [neighbors] [repetitions]             */
+/*                                                                          */
+/****************************************************************************/
+
+#include <config.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/uggrid/parallel/ppif/ppifcontext.hh>
+#include <dune/uggrid/parallel/ddd/dddi.h>
+#include <dune/uggrid/parallel/ddd/basic/notify.h>
+
+USING_UG_NAMESPACES
+
+using Clock = std::chrono::steady_clock;
+
+static double SecondsSince (Clock::time_point start)
+{
+  return std::chrono::duration<double>(Clock::now()-start).count();
+}
+
+/* processor me sends to me+1, ..., me+neighbors (cyclic), the message to
+   p has size 100*me+p, which lets the receiver check the sender.
+   NotifyNBX returns the senders in ascending order. */
+static int Notify (DDD::DDDContext& context, int neighbors, bool nbx)
+{
+  const int me = context.me();
+  const int procs = context.procs();
+  const int n = std::min(neighbors, procs-1);
+
+  NOTIFY_DESC *descs = DDD_NotifyBegin(context, n);
+  for (int i=0; i<n; i++)
+  {
+    descs[i].proc = (me+1+i) % procs;
+    descs[i].size = 100*me + descs[i].proc;
+  }
+
+  const int nRecvs = DDD_Notify(context);
+  int errors = (nRecvs != n);
+  for (int i=0; i<nRecvs; i++)
+  {
+    const int from = descs[i].proc;
+    const int distance = (me-from+procs) % procs;
+    errors += (distance<1 || distance>n);
+    errors += (descs[i].size != std::size_t(100*from + me));
+    for (int j=0; j<i; j++)
+      errors += nbx ? (int(descs[j].proc) >= from) : (int(descs[j].proc) == from);
+  }
+  DDD_NotifyEnd(context);
+  return errors;
+}
+
+/* processor 0 raises an exception, all others return it */
+static int Exception (DDD::DDDContext& context, int neighbors, bool nbx)
+{
+  if (context.me()!=0)
+    return Notify(context, neighbors, nbx) == 0;
+
+  DDD_NotifyBegin(context, -7);
+  const int ret = DDD_Notify(context);
+  DDD_NotifyEnd(context);
+  return ret != -7;
+}
+
+int main (int argc, char **argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+
+  const int neighbors = (argc>1) ? std::atoi(argv[1]) : 4;
+  const int repetitions = (argc>2) ? std::atoi(argv[2]) : 1000;
+
+  auto ppifContext = std::make_shared<PPIF::PPIFContext>();
+  DDD::DDDContext context(ppifContext, nullptr);
+  DDD_Init(context);
+
+  int errors = 0;
+  double seconds[2];
+  for (int nbx=0; nbx<2; nbx++)
+  {
+    DDD_SetOption(context, OPT_NOTIFY_NBX, nbx ? OPT_ON : OPT_OFF);
+
+    const auto start = Clock::now();
+    for (int r=0; r<repetitions; r++)
+      errors += Notify(context, neighbors, nbx);
+    seconds[nbx] = SecondsSince(start);
+
+    errors += Exception(context, neighbors, nbx);
+  }
+
+  if (context.me()==0)
+  {
+    printf("%d processors, %d neighbors, %d repetitions\n",
+           context.procs(), neighbors, repetitions);
+    printf("two-wave  %8.2f us per notify\n", 1e6*seconds[0]/repetitions);
+    printf("nbx       %8.2f us per notify\n", 1e6*seconds[1]/repetitions);
+  }
+
+  DDD_Exit(context);
+
+  if (errors)
+    printf("%d: notify-benchmark: %d errors\n", context.me(), errors);
+  return errors ? 1 : 0;
+}
@@ -265,7 +265,6 @@ static int ConsCheckGlobalCpl(DDD::DDDContext& context)
   COUPLING     *cpl;
   int i, j, lenCplBuf, nRecvMsgs;
   CONSMSG      *sendMsgs=NULL, *cm=NULL;
-  LC_MSGHANDLE *recvMsgs;
   int error_cnt = 0;
 
   auto& ctx = context.consContext();
@@ -319,19 +318,16 @@ static int ConsCheckGlobalCpl(DDD::DDDContext& context)
   ConsSend(context, sendMsgs);
 
 
-  /* communicate set of messages (send AND receive) */
-  recvMsgs = LC_Communicate(context);
-
-
-  /* perform checking of received data */
-  if (nRecvMsgs>0)
+  /* communicate set of messages (send AND receive),
+     perform checking of received data as soon as it arrives */
   {
-    std::vector<DDD_HDR> locObjs = LocalObjectsList(context);
+    std::vector<DDD_HDR> locObjs;
+    if (nRecvMsgs>0)
+      locObjs = LocalObjectsList(context);
 
-    for(i=0; i<nRecvMsgs; i++)
-    {
-      error_cnt += ConsCheckSingleMsg(context, recvMsgs[i], locObjs.data());
-    }
+    LC_Communicate(context, [&](LC_MSGHANDLE xm) {
+      error_cnt += ConsCheckSingleMsg(context, xm, locObjs.data());
+    });
   }
 
 
@@ -505,7 +501,6 @@ static int Cons2CheckGlobalCpl(DDD::DDDContext& context)
   COUPLING     *cpl, *cpl2;
   int i, j, lenCplBuf, nRecvMsgs;
   CONSMSG      *sendMsgs, *cm=0;
-  LC_MSGHANDLE *recvMsgs;
   int error_cnt = 0;
 
   auto& ctx = context.consContext();
@@ -556,18 +551,16 @@ static int Cons2CheckGlobalCpl(DDD::DDDContext& context)
   /* build and send messages */
   ConsSend(context, sendMsgs);
 
-  /* communicate set of messages (send AND receive) */
-  recvMsgs = LC_Communicate(context);
-
-
-  /* perform checking of received data */
-  if (nRecvMsgs>0)
+  /* communicate set of messages (send AND receive),
+     perform checking of received data as soon as it arrives */
   {
-    std::vector<DDD_HDR> locObjs = LocalObjectsList(context);
+    std::vector<DDD_HDR> locObjs;
+    if (nRecvMsgs>0)
+      locObjs = LocalObjectsList(context);
 
-    for(i=0; i<nRecvMsgs; i++) {
-      error_cnt += Cons2CheckSingleMsg(context, recvMsgs[i], locObjs.data());
-    }
+    LC_Communicate(context, [&](LC_MSGHANDLE xm) {
+      error_cnt += Cons2CheckSingleMsg(context, xm, locObjs.data());
+    });
   }
 
 
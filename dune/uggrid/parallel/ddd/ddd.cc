@@ -171,7 +171,12 @@ void DDD_Init(DDD::DDDContext& context)
   DDD_SetOption(context, OPT_XFER_PRUNE_DELETE,     OPT_OFF);
   DDD_SetOption(context, OPT_IF_REUSE_BUFFERS,      OPT_OFF);
   DDD_SetOption(context, OPT_IF_CREATE_EXPLICIT,    OPT_OFF);
+  DDD_SetOption(context, OPT_IF_PERSISTENT,         OPT_OFF);
+  DDD_SetOption(context, OPT_IF_INCREMENTAL, OPT_OFF);
   DDD_SetOption(context, OPT_CPLMGR_USE_FREELIST,   OPT_ON);
+  DDD_SetOption(context, OPT_CPLMGR_INDEX,          OPT_OFF);
+  DDD_SetOption(context, OPT_OBJMGR_GID_INDEX,      OPT_OFF);
+  DDD_SetOption(context, OPT_NOTIFY_NBX,            OPT_OFF);
 }
 
 
@@ -335,6 +340,13 @@ void DDD_SetOption (DDD::DDDContext& context, DDD_OPTION option, int value)
   }
 
   context.options()[option] = value;
+
+  if (option==OPT_OBJMGR_GID_INDEX)
+    ddd_ObjMgrGidIndex(context, value==OPT_ON);
+  if (option==OPT_CPLMGR_INDEX)
+    ddd_CplMgrIndex(context, value==OPT_ON);
+  if (option==OPT_IF_INCREMENTAL)
+    ddd_CplMgrTrackDirty(context, value==OPT_ON);
 }
 
 
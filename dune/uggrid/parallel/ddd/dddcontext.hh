@@ -4,6 +4,7 @@
 #define DUNE_UGGRID_PARALLEL_DDD_DDDCONTEXT_HH 1
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 #include <array>
 
@@ -39,6 +40,10 @@ struct NotifyContext
   int maxInfos;
   int lastInfo;
   int nSendDescs;
+
+  /* send buffer and round counter of NotifyNBX */
+  std::vector<std::size_t> nbxSizes;
+  int nbxRound = 0;
 };
 
 struct TopoContext
@@ -81,7 +86,6 @@ struct IfCreateContext
 
 struct IfUseContext
 {
-  int send_mesgs;
 };
 
 } /* namespace If */
@@ -105,27 +109,57 @@ struct JoinContext
   Basic::LC_MSGTYPE phase3msg_t;
   Basic::LC_MSGCOMP cpltab_id;
 
-  /* entry points for global sets */
-  JIJoinSet   *setJIJoin;
-  JIAddCplSet *setJIAddCpl2;
-  JIAddCplSet *setJIAddCpl3;
+  /* entry points for global sets, see basic/itemset.hh */
+  Basic::ItemSet<JIJoin>   *setJIJoin;
+  Basic::ItemSet<JIAddCpl> *setJIAddCpl2;
+  Basic::ItemSet<JIAddCpl> *setJIAddCpl3;
 };
 
 } /* namespace Join */
 
 namespace Mgr {
 
+/** coupling of an object in its coupling index, see OPT_CPLMGR_INDEX */
+struct CplIndexEntry
+{
+  DDD_PROC proc;
+  COUPLING *cpl;
+};
+
 struct CplmgrContext
 {
   CplSegm *segmCpl = nullptr;
   COUPLING *memlistCpl = nullptr;
   int *localIBuffer;
   int nCplSegms;
+
+  /** couplings of each object sorted by proc, parallel to cplTable.
+      the coupling lists are kept in the same order, see OPT_CPLMGR_INDEX */
+  bool cplIndexActive = false;
+  std::vector<std::vector<CplIndexEntry>> cplIndex;
+
+  /** track couplings changed since the last interface rebuild, see OPT_IF_INCREMENTAL */
+  bool trackDirty = false;
+
+  /** whether all changes since the last interface rebuild have been tracked */
+  bool dirtyComplete = false;
+
+  /** new couplings and couplings with changed priorities,
+      mutable as DDD_PrioChange gets a const context */
+  mutable std::vector<COUPLING*> dirtyCpls;
+
+  /** deleted couplings, disposed after the next interface rebuild */
+  COUPLING *deadCpls = nullptr;
+  int nDeadCpls = 0;
 };
 
 struct ObjmgrContext
 {
   DDD_GID theIdCount;
+
+  /** GID index of all objects in objTable, see OPT_OBJMGR_GID_INDEX */
+  bool gidIndexActive = false;
+  std::unordered_map<DDD_GID, DDD_HDR> gidIndex;
 };
 
 struct TypemgrContext
@@ -175,24 +209,23 @@ struct XferContext
   Basic::LC_MSGCOMP objmem_id;
 
 
-  /* entry points for global sets */
-  XICopyObjSet *setXICopyObj;
-  XISetPrioSet *setXISetPrio;
+  /* entry points for global sets, see basic/itemset.hh */
+  Basic::ItemSet<XICopyObj> *setXICopyObj;
+  Basic::ItemSet<XISetPrio> *setXISetPrio;
 
   XICopyObj* theXIAddData;
 
   AddDataSegm* segmAddData = nullptr;
   SizesSegm* segmSizes = nullptr;
 
-#define SLL_MEMBERS(T) Segm##T* segms##T; T* list##T; int n##T;
-  SLL_MEMBERS(XIDelCmd)
-  SLL_MEMBERS(XIDelObj)
-  SLL_MEMBERS(XINewCpl)
-  SLL_MEMBERS(XIOldCpl)
-  SLL_MEMBERS(XIAddCpl)
-  SLL_MEMBERS(XIDelCpl)
-  SLL_MEMBERS(XIModCpl)
-#undef SLL_MEMBERS
+  /* entry points for global lists */
+  Basic::ItemList<XIDelCmd> *listXIDelCmd;
+  Basic::ItemList<XIDelObj> *listXIDelObj;
+  Basic::ItemList<XINewCpl> *listXINewCpl;
+  Basic::ItemList<XIOldCpl> *listXIOldCpl;
+  Basic::ItemList<XIAddCpl> *listXIAddCpl;
+  Basic::ItemList<XIDelCpl> *listXIDelCpl;
+  Basic::ItemList<XIModCpl> *listXIModCpl;
 };
 
 } /* namespace Xfer */
@@ -104,6 +104,7 @@ using namespace DDD;
 
 
 #define MAX_TRIES  50000000  /* max. number of tries until timeout in IF-comm */
+#define MAX_IF_PLANS  4      /* max. number of persistent plans per IF and proc */
 
 #ifdef DDD_MAX_PROCBITS_IN_GID
 #define MAX_PROCBITS_IN_GID DDD_MAX_PROCBITS_IN_GID
@@ -131,8 +132,10 @@ using namespace DDD;
 /* types of virtual channels (for ppif interface) */
 enum VChanType {
   VC_IDENT   = 15,               /* channels used for identification module     */
-  VC_IFCOMM  = 16,               /* channels used for interface module          */
-  VC_TOPO    = 17                /* channels used for xfer module (topology)    */
+  VC_TOPO    = 17,               /* channels used for xfer module (topology)    */
+  VC_NOTIFY  = 18,               /* tags 18 and 19 used by notify (OPT_NOTIFY_NBX) */
+  VC_IFCOMM  = 32                /* channels used for interface module, one tag
+                                    VC_IFCOMM+id per interface (up to MAX_IF)  */
 };
 
 
@@ -248,6 +251,15 @@ enum PrioMergeVals {
 #define CPLDIR(c) (((int)((c)->_flags))&MASKCPLDIR)
 #define SETCPLDIR(c,d) ((c)->_flags) = (((c)->_flags)&(~MASKCPLDIR))|((d)&MASKCPLDIR)
 
+/* usage of 0x04 and 0x08 for tracking changes between interface rebuilds */
+#define MASKCPLDIRTY 0x00000004
+#define CPLDIRTY(c) (((int)((c)->_flags))&MASKCPLDIRTY)
+#define SETCPLDIRTY(c,d) ((c)->_flags) = (((c)->_flags)&(~MASKCPLDIRTY))|((d) ? MASKCPLDIRTY : 0)
+
+#define MASKCPLDEAD 0x00000008
+#define CPLDEAD(c) (((int)((c)->_flags))&MASKCPLDEAD)
+#define SETCPLDEAD(c,d) ((c)->_flags) = (((c)->_flags)&(~MASKCPLDEAD))|((d) ? MASKCPLDEAD : 0)
+
 /* usage of 0x10 for remembering the memory origin for the COUPLING struct */
 #define MASKCPLMEM 0x00000010
 #define CPLMEM_EXTERNAL  0x00
@@ -494,11 +506,20 @@ int       ddd_TypeDefined (TYPE_DESC *);
 void      ddd_ObjMgrInit(DDD::DDDContext& context);
 void      ddd_ObjMgrExit(DDD::DDDContext& context);
 void      ddd_EnsureObjTabSize(DDD::DDDContext& context, int);
+void      ddd_ObjMgrGidIndex(DDD::DDDContext& context, bool);
+void      ddd_GidIndexInsert(DDD::DDDContext& context, DDD_HDR);
+void      ddd_GidIndexErase(DDD::DDDContext& context, DDD_HDR);
 
 
 /* cplmgr.c */
 void      ddd_CplMgrInit(DDD::DDDContext& context);
 void      ddd_CplMgrExit(DDD::DDDContext& context);
+void      ddd_CplMgrIndex(DDD::DDDContext& context, bool);
+void      ddd_CplIndexMoveSlot(DDD::DDDContext& context, int, int);
+void      ddd_CplMgrTrackDirty(DDD::DDDContext& context, bool);
+void      ddd_CplMgrCleanDirty(DDD::DDDContext& context);
+void      ddd_CplDirty(const DDD::DDDContext& context, COUPLING *);
+void      ddd_ObjCplDirty(const DDD::DDDContext& context, DDD_HDR);
 COUPLING *AddCoupling(DDD::DDDContext& context, DDD_HDR, DDD_PROC, DDD_PRIO);
 COUPLING *ModCoupling(DDD::DDDContext& context, DDD_HDR, DDD_PROC, DDD_PRIO);
 void      DelCoupling(DDD::DDDContext& context, DDD_HDR, DDD_PROC);
@@ -517,6 +538,7 @@ void      IFAllFromScratch(DDD::DDDContext&);
 void      DDD_InfoIFImpl(DDD::DDDContext& context, DDD_IF);
 void      IFInvalidateShortcuts(DDD::DDDContext& context, DDD_TYPE);
 int       DDD_CheckInterfaces(DDD::DDDContext& context);
+int       DDD_CheckInterfacesRebuild(DDD::DDDContext& context);
 
 /* if/ifcmds.c */
 void   ddd_StdIFExchange   (DDD::DDDContext& context, size_t, ComProcHdrPtr,ComProcHdrPtr);
@@ -38,6 +38,7 @@ using HandlerXFERSCATTER      = void (*)(DDDContext& context, DDD_OBJ, int, DDD_
 using HandlerXFERGATHERX      = void (*)(DDDContext& context, DDD_OBJ, int, DDD_TYPE, char **);
 using HandlerXFERSCATTERX     = void (*)(DDDContext& context, DDD_OBJ, int, DDD_TYPE, char **, int);
 using HandlerXFERCOPYMANIP    = void (*)(DDDContext& context, DDD_OBJ);
+using HandlerXFERALLOC        = void (*)(DDDContext& context, DDD_TYPE, std::size_t, int, DDD_OBJ *);
 
 /* handlers not related to DDD_TYPE (i.e., global functions) */
 using HandlerGetRefType = DDD_TYPE (*)(DDDContext& context, DDD_OBJ, DDD_OBJ);
@@ -46,6 +47,8 @@ using ExecProcPtr  = int (*)(DDDContext& context, DDD_OBJ);
 using ExecProcXPtr = int (*)(DDDContext& context, DDD_OBJ, DDD_PROC, DDD_PRIO);
 using ComProcPtr2  = int (*)(DDDContext& context, DDD_OBJ, void *);
 using ComProcXPtr  = int (*)(DDDContext& context, DDD_OBJ, void *, DDD_PROC, DDD_PRIO);
+using ComProcSizePtr = std::size_t (*)(DDDContext& context, DDD_OBJ);
+using ComProcVPtr  = int (*)(DDDContext& context, DDD_OBJ, void *, std::size_t);
 
 /* PRIVATE INTERFACE */
 
@@ -95,6 +98,12 @@ using FreeFunc = void (*)(void*);
 struct NOTIFY_DESC;
 struct NOTIFY_INFO;
 
+/*
+ * containers for xfer and join commands, see itemset.hh
+ */
+template<class T> class ItemList;
+template<class T> class ItemSet;
+
 } /* namespace Basic */
 
 namespace Ident {
@@ -109,8 +118,8 @@ namespace Join {
 
 enum class JoinMode : unsigned char;
 
-struct JIJoinSet;
-struct JIAddCplSet;
+struct JIJoin;
+struct JIAddCpl;
 
 } /* namespace Join */
 
@@ -128,19 +137,14 @@ struct AddDataSegm;
 struct SizesSegm;
 
 struct XICopyObj;
-struct XICopyObjSet;
-struct XISetPrioSet;
-
-// From sll.ht instances:
-#define SLL_TYPES(T) struct Segm##T; struct T;
-SLL_TYPES(XIDelCmd)
-SLL_TYPES(XIDelObj)
-SLL_TYPES(XINewCpl)
-SLL_TYPES(XIOldCpl)
-SLL_TYPES(XIAddCpl)
-SLL_TYPES(XIDelCpl)
-SLL_TYPES(XIModCpl)
-#undef SLL_TYPES
+struct XISetPrio;
+struct XIDelCmd;
+struct XIDelObj;
+struct XINewCpl;
+struct XIOldCpl;
+struct XIAddCpl;
+struct XIDelCpl;
+struct XIModCpl;
 
 } /* namespace Xfer */
 
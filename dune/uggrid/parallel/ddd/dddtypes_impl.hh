@@ -3,6 +3,7 @@
 #ifndef DUNE_UGGRID_PARALLEL_DDD_DDDTYPES_IMPL_HH
 #define DUNE_UGGRID_PARALLEL_DDD_DDDTYPES_IMPL_HH 1
 
+#include <cstddef>
 #include <memory>
 #include <vector>
 
@@ -34,8 +35,15 @@ enum DDD_OPTION {
 
   OPT_IF_REUSE_BUFFERS,            ///< reuse interface buffs as long as possible
   OPT_IF_CREATE_EXPLICIT,          ///< dont (re-)create interfaces automatically
+  OPT_IF_PERSISTENT,               ///< keep persistent requests for repeated IF-communication
+  OPT_IF_INCREMENTAL,              ///< patch interfaces after xfer/identify/prio/join instead of rebuilding
 
   OPT_CPLMGR_USE_FREELIST,         ///< use freelist for coupling-memory (default)
+  OPT_CPLMGR_INDEX,                ///< keep the couplings of each object sorted by proc
+
+  OPT_OBJMGR_GID_INDEX,            ///< keep a GID index for DDD_SearchHdr
+
+  OPT_NOTIFY_NBX,                  ///< notify by non-blocking consensus instead of two-wave
 
   OPT_END
 };
@@ -167,6 +175,7 @@ struct TYPE_DESC
   HandlerXFERGATHERX handlerXFERGATHERX;
   HandlerXFERSCATTERX handlerXFERSCATTERX;
   HandlerXFERCOPYMANIP handlerXFERCOPYMANIP;
+  HandlerXFERALLOC handlerXFERALLOC;
 
 
   /** 2D matrix for comparing priorities */
@@ -182,6 +191,15 @@ struct TYPE_DESC
 
   /** mask for fast type-dependent copy    */
   std::unique_ptr<unsigned char[]> cmask;
+
+  /** runs of equal kind in cmask, see CopyByMask */
+  struct CopyRun
+  {
+    std::size_t offset;
+    std::size_t size;
+    bool bitwise;            /* mask with EL_GBITS, otherwise copy all */
+  };
+  std::vector<CopyRun> copyRuns;
 };
 
 namespace Basic {
@@ -234,6 +252,23 @@ struct IF_ATTR
     { /* Nothing */ }
 };
 
+/**
+ * message buffers and persistent requests for one pair of message
+ * sizes, reused by repeated IF-communication (OPT_IF_PERSISTENT)
+ */
+struct IF_PLAN
+{
+  std::size_t sizeIn = 0;
+  std::size_t sizeOut = 0;
+
+  /* while the plan is in use, these are swapped with the IF_PROC buffers */
+  std::vector<char> bufIn;
+  std::vector<char> bufOut;
+
+  PPIF::msgid msgIn = nullptr;
+  PPIF::msgid msgOut = nullptr;
+};
+
 /**
  * descriptor of message and its contents/buffers for IF-communic.
  */
@@ -250,11 +285,15 @@ struct IF_PROC
   int nItems = 0, nAB = 0, nBA = 0, nABA = 0;
   DDD_PROC proc;
 
-  PPIF::VChannelPtr vc;
-  PPIF::msgid msgIn;
-  PPIF::msgid msgOut;
+  PPIF::VChannelPtr vc = nullptr;
+  PPIF::msgid msgIn = nullptr;
+  PPIF::msgid msgOut = nullptr;
   std::vector<char> bufIn;
   std::vector<char> bufOut;
+
+  /* cached plans, and the one used by the current communication */
+  std::vector<IF_PLAN> plans;
+  IF_PLAN *plan = nullptr;
 };
 
 /**
@@ -276,6 +315,9 @@ struct IF_DEF
   /* flag: is obj-table valid? */
   bool objValid = false;
 
+  /* flag: is a split-phase communication in progress? */
+  bool commPending = false;
+
   int nIfHeads = 0;
 
   int nObjStruct;
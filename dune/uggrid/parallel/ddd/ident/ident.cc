@@ -1136,8 +1136,11 @@ DDD_RET DDD_IdentifyEnd(DDD::DDDContext& context)
 #                                       endif
 
           /* compute new GID from minimum of both current GIDs */
+          ddd_GidIndexErase(context, msgout->infos[0]->hdr);
           OBJ_GID(msgout->infos[0]->hdr) =
             MIN(OBJ_GID(msgout->infos[0]->hdr), msgin->gid);
+          ddd_GidIndexInsert(context, msgout->infos[0]->hdr);
+          ddd_ObjCplDirty(context, msgout->infos[0]->hdr);
 
           /* add a coupling for new object copy */
           AddCoupling(context, msgout->infos[0]->hdr, plist->proc, msgin->prio);
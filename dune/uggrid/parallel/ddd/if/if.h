@@ -26,6 +26,7 @@
 #ifndef __DDD_IF_H__
 #define __DDD_IF_H__
 
+#include <functional>
 #include <vector>
 
 #include <dune/uggrid/parallel/ddd/dddtypes_impl.hh>
@@ -57,6 +58,11 @@ enum CplDir {
 };
 
 
+/* with OPT_IF_INCREMENTAL, interfaces are patched if at most
+   1/IF_PATCH_RATIO of all couplings have changed */
+#define IF_PATCH_RATIO  4
+
+
 
 
 
@@ -69,6 +75,27 @@ enum CplDir {
       (iter)=(iter)->next)
 
 
+/* resets the commPending flag of an interface at the end of the scope,
+   also if a handler throws or the communication times out */
+class IFCommPendingGuard
+{
+public:
+  explicit IFCommPendingGuard (IF_DEF& theIf) : theIf_(theIf) {}
+  ~IFCommPendingGuard () { if (active_) theIf_.commPending = false; }
+
+  IFCommPendingGuard (const IFCommPendingGuard&) = delete;
+  IFCommPendingGuard& operator= (const IFCommPendingGuard&) = delete;
+
+  /* keep the flag, e.g. at the end of the first half of a split-phase
+     communication */
+  void release () { active_ = false; }
+
+private:
+  IF_DEF& theIf_;
+  bool active_ = true;
+};
+
+
 /****************************************************************************/
 /*                                                                          */
 /* function declarations                                                    */
@@ -76,12 +103,20 @@ enum CplDir {
 /****************************************************************************/
 
 
+/* ifcreate.c */
+RETCODE IFCreateFromScratch(DDD::DDDContext& context, COUPLING **, DDD_IF);
+
+
 /* ifuse.c */
 void    IFGetMem (IF_PROC *, size_t, int, int);
+void    IFFreePlans (DDD::DDDContext& context, IF_PROC *);
 int     IFInitComm(DDD::DDDContext& context, DDD_IF);
 void    IFExitComm(DDD::DDDContext& context, DDD_IF);
 void    IFInitSend(DDD::DDDContext& context, IF_PROC *);
 int     IFPollSend(DDD::DDDContext& context, DDD_IF);
+void    IFBeginComm(DDD::DDDContext& context, DDD_IF, bool);
+void    IFCompleteComm(DDD::DDDContext& context, DDD_IF, int, const std::function<void(IF_PROC *)>&);
+IF_ATTR *IFFindAttr(IF_PROC *, DDD_ATTR);
 char *  IFCommLoopObj (DDD::DDDContext& context, ComProcPtr2, IFObjPtr *, char *, size_t, int);
 char *  IFCommLoopCpl (DDD::DDDContext& context, ComProcPtr2, COUPLING **, char *, size_t, int);
 char *  IFCommLoopCplX (DDD::DDDContext& context, ComProcXPtr, COUPLING **, char *, size_t , int);
@@ -35,7 +35,9 @@
 #include <cstdlib>
 #include <cstdio>
 
+#include <algorithm>
 #include <iomanip>
+#include <vector>
 
 #include <dune/common/stdstreams.hh>
 
@@ -131,6 +133,75 @@ static int DDD_CheckInterface(DDD::DDDContext& context, DDD_IF ifId)
 /****************************************************************************/
 
 
+/*
+        description of the structure of an interface, as positions
+        in its coupling array and item counts.
+ */
+static std::vector<long> IFStructure(const DDD::DDDContext& context, DDD_IF ifId)
+{
+  const auto& theIF = context.ifCreateContext().theIf;
+  COUPLING **base = theIF[ifId].cpl;
+
+  std::vector<long> s;
+  for (const IF_PROC *h=theIF[ifId].ifHead; h!=NULL; h=h->next)
+  {
+    s.insert(s.end(), {(long) h->proc, (long) (h->cpl-base), h->nItems, h->nAttrs,
+                       h->nAB, h->nAB ? (long) (h->cplAB-base) : -1,
+                       h->nBA, h->nBA ? (long) (h->cplBA-base) : -1,
+                       h->nABA, h->nABA ? (long) (h->cplABA-base) : -1});
+    for (const IF_ATTR *a=h->ifAttr; a!=NULL; a=a->next)
+      s.insert(s.end(), {(long) a->attr, a->nItems, a->nAB, a->nBA, a->nABA});
+  }
+  return s;
+}
+
+
+/*
+        compare interface ifId with the interface created from scratch,
+        which replaces it.
+ */
+static int DDD_CheckInterfaceRebuild(DDD::DDDContext& context, DDD_IF ifId)
+{
+  using std::setw;
+
+  auto& theIF = context.ifCreateContext().theIf;
+  const auto& me = context.me();
+
+  int errors=0;
+
+  const std::vector<COUPLING*> cpl(theIF[ifId].cpl, theIF[ifId].cpl + theIF[ifId].nItems);
+  const std::vector<long> structure = IFStructure(context, ifId);
+
+  std::vector<COUPLING*> tmpcpl(context.couplingContext().nCplItems);
+  if (! IS_OK(IFCreateFromScratch(context, tmpcpl.data(), ifId)))
+  {
+    Dune::dwarn << ERRSTR "IF " << setw(2) << ifId
+                << " cannot be created on proc " << me << "\n";
+    return 1;
+  }
+
+  if (cpl.size() != (std::size_t) theIF[ifId].nItems ||
+      !std::equal(cpl.begin(), cpl.end(), theIF[ifId].cpl))
+  {
+    Dune::dwarn << ERRSTR "IF " << setw(2) << ifId << " on proc " << me
+                << " has other couplings than created from scratch ("
+                << cpl.size() << " != " << theIF[ifId].nItems << ")\n";
+    errors++;
+  }
+  else if (structure != IFStructure(context, ifId))
+  {
+    Dune::dwarn << ERRSTR "IF " << setw(2) << ifId << " on proc " << me
+                << " has other structure than created from scratch\n";
+    errors++;
+  }
+
+  return(errors);
+}
+
+
+/****************************************************************************/
+
+
 int DDD_CheckInterfaces(DDD::DDDContext& context)
 {
   const auto& nIFs = context.ifCreateContext().nIfs;
@@ -146,4 +217,29 @@ int DDD_CheckInterfaces(DDD::DDDContext& context)
 
 /****************************************************************************/
 
+/**
+        Check that the interfaces, which may have been patched after the
+        last xfer, identify, prio or join (option OPT_IF_INCREMENTAL), are
+        identical to the interfaces created from scratch. The interfaces
+        are replaced by the ones created from scratch. This is a local
+        check without communication.
+
+   @return number of errors
+ */
+
+int DDD_CheckInterfacesRebuild(DDD::DDDContext& context)
+{
+  const auto& nIFs = context.ifCreateContext().nIfs;
+
+  int errors = 0;
+  for(int i = 0; i < nIFs; ++i)
+  {
+    errors += DDD_CheckInterfaceRebuild(context, i);
+  }
+
+  return(errors);
+}
+
+/****************************************************************************/
+
 END_UGDIM_NAMESPACE
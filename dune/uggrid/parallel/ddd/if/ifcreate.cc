@@ -107,12 +107,22 @@ static void IFDeleteAll(DDD::DDDContext& context, DDD_IF ifId)
   IF_PROC  *ifh, *ifhNext;
   IF_ATTR *ifr, *ifrNext;
 
+  /* the message buffers of a split-phase communication are still in use */
+  if (theIF[ifId].commPending)
+    DUNE_THROW(Dune::Exception,
+               "interface " << ifId << " changed during communication");
+
   /* free IF_PROC memory */
   ifh=theIF[ifId].ifHead;
   while (ifh!=NULL)
   {
     ifhNext = ifh->next;
 
+    /* free persistent requests, they belong to the old channels */
+    IFFreePlans(context, ifh);
+    if (ifh->vc!=NULL)
+      DiscASync(context.ppifContext(), ifh->vc);
+
     /* free IF_ATTR memory */
     ifr=ifh->ifAttr;
     while (ifr!=NULL)
@@ -161,38 +171,26 @@ static bool is_elem (DDD_PRIO el, int n, const DDD_PRIO *set)
 
 
 
+/*
+        every interface communicates on its own channels with tag
+        VC_IFCOMM+ifId, so that its messages cannot be matched by
+        the receives of other interfaces or of the xfer module.
+ */
 static RETCODE update_channels(DDD::DDDContext& context, DDD_IF ifId)
 {
   auto& theIF = context.ifCreateContext().theIf;
 
   IF_PROC *ifh;
-  int i;
-  DDD_PROC *partners = DDD_ProcArray(context);
-
-  if (theIF[ifId].nIfHeads==0)
-  {
-    RET_ON_OK;
-  }
-
-  /* MarkHeap(); */
 
-  for(i=0, ifh=theIF[ifId].ifHead; ifh!=NULL; i++, ifh=ifh->next)
+  for(ifh=theIF[ifId].ifHead; ifh!=NULL; ifh=ifh->next)
   {
-    partners[i] = ifh->proc;
-  }
-
-  if (! IS_OK(DDD_GetChannels(context, theIF[ifId].nIfHeads)))
-  {
-    RET_ON_ERROR;
-  }
-
-  for(ifh=theIF[ifId].ifHead; ifh!=NULL; ifh=ifh->next) {
-    ifh->vc = VCHAN_TO(context, ifh->proc);
+    ifh->vc = ConnASync(context.ppifContext(), ifh->proc, VC_IFCOMM+ifId);
+    if (ifh->vc==NULL)
+    {
+      RET_ON_ERROR;
+    }
   }
 
-  /* ReleaseHeap(); */
-
-
   RET_ON_OK;
 }
 
@@ -235,14 +233,13 @@ static COUPLING ** IFCollectStdCouplings(DDD::DDDContext& context)
 
 /****************************************************************************/
 
-static RETCODE IFCreateFromScratch(DDD::DDDContext& context, COUPLING **tmpcpl, DDD_IF ifId)
+static RETCODE IFCreateFromCouplings(DDD::DDDContext& context, DDD_IF ifId, int n);
+
+RETCODE IFCreateFromScratch(DDD::DDDContext& context, COUPLING **tmpcpl, DDD_IF ifId)
 {
   auto& theIF = context.ifCreateContext().theIf;
 
-  IF_PROC     *ifHead = nullptr, *lastIfHead;
-  IF_ATTR    *ifAttr = nullptr, *lastIfAttr = nullptr;
-  int n, i;
-  DDD_PROC lastproc;
+  int n;
   [[maybe_unused]] int STAT_MOD;
 
   const auto& objTable = context.objTable();
@@ -333,6 +330,28 @@ static RETCODE IFCreateFromScratch(DDD::DDDContext& context, COUPLING **tmpcpl,
     std::sort(theIF[ifId].cpl, theIF[ifId].cpl + n, sort_IFCouplings);
   STAT_TIMER1(T_CREATE_SORT);
 
+  const RETCODE ret = IFCreateFromCouplings(context, ifId, n);
+
+  STAT_SET_MODULE(STAT_MOD);
+
+  return ret;
+}
+
+
+/****************************************************************************/
+
+/*
+        create IF_PROCs and IF_ATTRs for the sorted array of n couplings
+        in theIF[ifId].cpl, with CPLDIR set for this interface.
+ */
+static RETCODE IFCreateFromCouplings(DDD::DDDContext& context, DDD_IF ifId, int n)
+{
+  auto& theIF = context.ifCreateContext().theIf;
+
+  IF_PROC     *ifHead = nullptr, *lastIfHead;
+  IF_ATTR    *ifAttr = nullptr, *lastIfAttr = nullptr;
+  int i;
+  DDD_PROC lastproc;
 
   /* create IF_PROCs */
   STAT_RESET1;
@@ -454,9 +473,129 @@ static RETCODE IFCreateFromScratch(DDD::DDDContext& context, COUPLING **tmpcpl,
   /* TODO das handling der VCs muss noch erheblich verbessert werden */
   /* TODO Still very inefficient because we have to search for is_elem */
 
+  RET_ON_OK;
+}
+
+
+/****************************************************************************/
+
+/*
+        direction of coupling cpl in interface ifId, or 0 if the
+        coupling does not belong to it.
+ */
+static int IFCouplingDir(const DDD::DDDContext& context, DDD_IF ifId, const COUPLING *cpl)
+{
+  const auto& theIF = context.ifCreateContext().theIf;
+
+  if (ifId==STD_INTERFACE)
+    return 0;
+
+  const DDD_HDR hdr = cpl->obj;
+  if (! ((1<<OBJ_TYPE(hdr)) & theIF[ifId].maskO))
+    return 0;
+
+  const bool objInA = is_elem(OBJ_PRIO(hdr), theIF[ifId].nPrioA, theIF[ifId].A);
+  const bool objInB = is_elem(OBJ_PRIO(hdr), theIF[ifId].nPrioB, theIF[ifId].B);
+  const bool cplInA = is_elem(cpl->prio, theIF[ifId].nPrioA, theIF[ifId].A);
+  const bool cplInB = is_elem(cpl->prio, theIF[ifId].nPrioB, theIF[ifId].B);
+
+  return ((objInA&&cplInB) ? DirAB : 0) | ((objInB&&cplInA) ? DirBA : 0);
+}
+
+
+/*
+        patch interface ifId after couplings have changed, instead of
+        creating it from scratch (option OPT_IF_INCREMENTAL). the dead and
+        dirty couplings (see cplmgr.cc) are removed from the sorted coupling
+        array, which keeps the remaining ones in order. the dirty couplings
+        which still belong to the interface are sorted on their own and
+        merged in again.
+ */
+static RETCODE IFPatch(DDD::DDDContext& context, DDD_IF ifId)
+{
+  auto& theIF = context.ifCreateContext().theIf;
+  const auto& dirtyCpls = context.cplmgrContext().dirtyCpls;
+
+  IF_PROC *ifHead;
+  [[maybe_unused]] int STAT_MOD;
+
+  STAT_GET_MODULE(STAT_MOD);
+  STAT_SET_MODULE(DDD_MODULE_IF);
+
+  /* the message buffers of a split-phase communication are still in use */
+  if (theIF[ifId].commPending)
+    DUNE_THROW(Dune::Exception,
+               "interface " << ifId << " changed during communication");
+
+  /* building other interfaces has overwritten the directions */
+  STAT_RESET1;
+  ForIF(context, ifId, ifHead)
+  {
+    if (ifId==STD_INTERFACE)
+    {
+      for (int i=0; i<ifHead->nItems; i++)
+        SETCPLDIR(ifHead->cpl[i], 0);
+      continue;
+    }
+    for (int i=0; i<ifHead->nAB; i++)
+      SETCPLDIR(ifHead->cplAB[i], DirAB);
+    for (int i=0; i<ifHead->nBA; i++)
+      SETCPLDIR(ifHead->cplBA[i], DirBA);
+    for (int i=0; i<ifHead->nABA; i++)
+      SETCPLDIR(ifHead->cplABA[i], DirABA);
+  }
+
+  /* unchanged couplings stay in order */
+  std::vector<COUPLING*> kept;
+  kept.reserve(theIF[ifId].nItems);
+  for (int i=0; i<theIF[ifId].nItems; i++)
+  {
+    COUPLING *cpl = theIF[ifId].cpl[i];
+    if (!CPLDEAD(cpl) && !CPLDIRTY(cpl))
+      kept.push_back(cpl);
+  }
+
+  /* changed couplings which belong to the interface */
+  std::vector<COUPLING*> changed;
+  for (COUPLING *cpl : dirtyCpls)
+  {
+    if (CPLDEAD(cpl))
+      continue;
+
+    const int dir = IFCouplingDir(context, ifId, cpl);
+    if (ifId==STD_INTERFACE || dir!=0)
+    {
+      SETCPLDIR(cpl, dir);
+      changed.push_back(cpl);
+    }
+  }
+  STAT_TIMER1(T_CREATE_COLLECT);
+
+  STAT_RESET1;
+  std::sort(changed.begin(), changed.end(), sort_IFCouplings);
+  STAT_TIMER1(T_CREATE_SORT);
+
+  IFDeleteAll(context, ifId);
+
+  const int n = kept.size() + changed.size();
+  if (n>0)
+  {
+    theIF[ifId].cpl = (COUPLING **) AllocIF(sizeof(COUPLING *)*n);
+    if (theIF[ifId].cpl==NULL)
+    {
+      Dune::dwarn << "IFPatch: " STR_NOMEM " for IF "
+                  << std::setw(2) << ifId << "\n";
+      RET_ON_ERROR;
+    }
+    std::merge(kept.begin(), kept.end(), changed.begin(), changed.end(),
+               theIF[ifId].cpl, sort_IFCouplings);
+  }
+
+  const RETCODE ret = IFCreateFromCouplings(context, ifId, n);
+
   STAT_SET_MODULE(STAT_MOD);
 
-  RET_ON_OK;
+  return ret;
 }
 
 
@@ -764,8 +903,38 @@ void DDD_IFDisplayAll(const DDD::DDDContext& context)
 
 
 
-static void IFRebuildAll(DDD::DDDContext& context)
+/*
+        whether the interfaces can be patched: all changes since they were
+        built must have been tracked, and patching must be cheaper than
+        creating them from scratch.
+ */
+static bool IFPatchable(const DDD::DDDContext& context)
 {
+  const auto& mctx = context.cplmgrContext();
+
+  if (!mctx.trackDirty || !mctx.dirtyComplete)
+    return false;
+
+  const std::size_t nChanges = mctx.dirtyCpls.size() + mctx.nDeadCpls;
+  return nChanges * IF_PATCH_RATIO <= (std::size_t) context.couplingContext().nCplItems;
+}
+
+
+static void IFRebuildAll(DDD::DDDContext& context, bool patch)
+{
+  if (patch && IFPatchable(context))
+  {
+    const auto& nIFs = context.ifCreateContext().nIfs;
+    for (int i=0; i<nIFs; i++)
+    {
+      if (! IS_OK(IFPatch(context, i)))
+        DUNE_THROW(Dune::Exception, "cannot patch interface " << i);
+    }
+
+    ddd_CplMgrCleanDirty(context);
+    return;
+  }
+
   /* create standard interface */
   if (! IS_OK(IFCreateFromScratch(context, NULL, STD_INTERFACE)))
     DUNE_THROW(Dune::Exception,
@@ -805,9 +974,16 @@ static void IFRebuildAll(DDD::DDDContext& context)
       }
     }
   }
+
+  ddd_CplMgrCleanDirty(context);
 }
 
 
+/*
+        called after xfer, identify, prio and join. with option
+        OPT_IF_INCREMENTAL, the interfaces are patched if only few
+        couplings have changed.
+ */
 void IFAllFromScratch(DDD::DDDContext& context)
 {
   if (DDD_GetOption(context, OPT_IF_CREATE_EXPLICIT)==OPT_ON)
@@ -818,7 +994,7 @@ void IFAllFromScratch(DDD::DDDContext& context)
     return;
   }
 
-  IFRebuildAll(context);
+  IFRebuildAll(context, true);
 }
 
 
@@ -834,7 +1010,8 @@ void DDD_IFRefreshAll(DDD::DDDContext& context)
                 once more. just to be sure. */
   }
 
-  IFRebuildAll(context);
+  /* always from scratch, e.g. after DDD_AttrSet for distributed objects */
+  IFRebuildAll(context, false);
 }
 
 
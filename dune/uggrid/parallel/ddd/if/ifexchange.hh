@@ -0,0 +1,246 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-2.1-or-later
+#ifndef DUNE_UGGRID_PARALLEL_DDD_IF_IFEXCHANGE_HH
+#define DUNE_UGGRID_PARALLEL_DDD_IF_IFEXCHANGE_HH 1
+
+#include <cstddef>
+#include <initializer_list>
+
+#include <dune/uggrid/parallel/ddd/dddcontext.hh>
+#include <dune/uggrid/parallel/ddd/include/ddd.h>
+
+#include "if.h"
+
+START_UGDIM_NAMESPACE
+
+/** \brief Variant of IFCommLoopObj which calls a functor */
+template<class F>
+char *IFCommLoopFunctor (DDD::DDDContext&, F& f, IFObjPtr *obj, char *buffer,
+                         std::size_t itemSize, int nItems)
+{
+  for (int i=0; i<nItems; i++, buffer+=itemSize)
+    f(obj[i], static_cast<void *>(buffer));
+  return buffer;
+}
+
+/** \brief Variant of IFCommLoopCplX which calls a functor */
+template<class F>
+char *IFCommLoopFunctor (DDD::DDDContext& context, F& f, COUPLING **cpl, char *buffer,
+                         std::size_t itemSize, int nItems)
+{
+  for (int i=0; i<nItems; i++, buffer+=itemSize)
+  {
+    const DDD_HDR hdr = cpl[i]->obj;
+    const DDD_OBJ obj = (DDD_OBJ)(((char *)hdr) - context.typeDefs()[hdr->typ].offsetHeader);
+    f(obj, static_cast<void *>(buffer), DDD_PROC(cpl[i]->_proc), DDD_PRIO(cpl[i]->prio));
+  }
+  return buffer;
+}
+
+/** \brief Gather or scatter the items of an IF_PROC or IF_ATTR in one direction */
+template<bool XArgs, class Part, class F>
+char *IFCommLoopPart (DDD::DDDContext& context, F& f, Part *part, CplDir dir,
+                      char *buffer, std::size_t itemSize)
+{
+  switch (dir)
+  {
+  case DirAB :
+    if constexpr (XArgs)
+      return IFCommLoopFunctor(context, f, part->cplAB, buffer, itemSize, part->nAB);
+    else
+      return IFCommLoopFunctor(context, f, part->objAB, buffer, itemSize, part->nAB);
+  case DirBA :
+    if constexpr (XArgs)
+      return IFCommLoopFunctor(context, f, part->cplBA, buffer, itemSize, part->nBA);
+    else
+      return IFCommLoopFunctor(context, f, part->objBA, buffer, itemSize, part->nBA);
+  default :
+    if constexpr (XArgs)
+      return IFCommLoopFunctor(context, f, part->cplABA, buffer, itemSize, part->nABA);
+    else
+      return IFCommLoopFunctor(context, f, part->objABA, buffer, itemSize, part->nABA);
+  }
+}
+
+/** \brief Number of items of an IF_PROC or IF_ATTR in one direction */
+template<class Part>
+int IFNItemsPart (const Part *part, CplDir dir)
+{
+  return (dir==DirAB) ? part->nAB : (dir==DirBA) ? part->nBA : part->nABA;
+}
+
+/**
+ * \brief Communication across a DDD interface with functors
+ *
+ * Common implementation of the functor variants below. part(ifHead)
+ * returns ifHead, or for the variants with attribute its IF_ATTR, or
+ * nullptr if there is none. The items of the directions out are gathered
+ * in this order and those of in are scattered, the ABA items follow in
+ * both cases. With XArgs, gather and scatter get the processor and
+ * priority of the copy as extended arguments.
+ */
+template<bool XArgs, class Part, class Gather, class Scatter>
+void IFCommFunctor (DDD::DDDContext& context, DDD_IF aIF, const Part& part,
+                    std::initializer_list<CplDir> out, std::initializer_list<CplDir> in,
+                    std::size_t aSize, Gather& gather, Scatter& scatter)
+{
+  IF_PROC *ifHead;
+
+  /* shortcuts can only be used without extended handler arguments */
+  IFBeginComm(context, aIF, !XArgs);
+  IFCommPendingGuard pendingGuard(context.ifCreateContext().theIf[aIF]);
+
+  ForIF(context, aIF, ifHead)
+  {
+    const auto p = part(ifHead);
+    int nOut = 0, nIn = 0;
+    if (p != nullptr)
+    {
+      for (CplDir dir : out)
+        nOut += IFNItemsPart(p, dir);
+      for (CplDir dir : in)
+        nIn += IFNItemsPart(p, dir);
+      nOut += p->nABA;
+      nIn += p->nABA;
+    }
+    IFGetMem(ifHead, aSize, nIn, nOut);
+  }
+
+  const int recv_mesgs = IFInitComm(context, aIF);
+
+  ForIF(context, aIF, ifHead)
+  {
+    const auto p = part(ifHead);
+    if (p == nullptr)
+      continue;
+
+    char *buffer = ifHead->bufOut.data();
+    for (CplDir dir : out)
+      buffer = IFCommLoopPart<XArgs>(context, gather, p, dir, buffer, aSize);
+    IFCommLoopPart<XArgs>(context, gather, p, DirABA, buffer, aSize);
+    IFInitSend(context, ifHead);
+  }
+
+  IFCompleteComm(context, aIF, recv_mesgs, [&](IF_PROC *ifh) {
+    const auto p = part(ifh);
+    if (p == nullptr)
+      return;
+
+    char *buffer = ifh->bufIn.data();
+    for (CplDir dir : in)
+      buffer = IFCommLoopPart<XArgs>(context, scatter, p, dir, buffer, aSize);
+    IFCommLoopPart<XArgs>(context, scatter, p, DirABA, buffer, aSize);
+  });
+}
+
+/**
+ * \brief Bidirectional communication across a DDD interface with functors
+ *
+ * Does the same as the DDD_IFExchange for function pointers, but gather
+ * and scatter are called as gather(DDD_OBJ obj, void *data) and
+ * scatter(DDD_OBJ obj, void *data). Lambdas are inlined into the loops
+ * over the interface, which pays off for small items.
+ */
+template<class Gather, class Scatter>
+void DDD_IFExchange (DDD::DDDContext& context, DDD_IF aIF, std::size_t aSize,
+                     Gather&& gather, Scatter&& scatter)
+{
+  /* exchange BA and AB during send */
+  IFCommFunctor<false>(context, aIF, [](IF_PROC *ifHead) { return ifHead; },
+                       {DirBA, DirAB}, {DirAB, DirBA}, aSize, gather, scatter);
+}
+
+/**
+ * \brief Oneway communication across a DDD interface with functors
+ *
+ * See DDD_IFExchange with functors and DDD_IFOneway for function pointers.
+ */
+template<class Gather, class Scatter>
+void DDD_IFOneway (DDD::DDDContext& context, DDD_IF aIF, DDD_IF_DIR aDir, std::size_t aSize,
+                   Gather&& gather, Scatter&& scatter)
+{
+  const CplDir out = (aDir==IF_FORWARD) ? DirAB : DirBA;
+  const CplDir in  = (aDir==IF_FORWARD) ? DirBA : DirAB;
+  IFCommFunctor<false>(context, aIF, [](IF_PROC *ifHead) { return ifHead; },
+                       {out}, {in}, aSize, gather, scatter);
+}
+
+/**
+ * \brief DDD_IFExchange with functors on the part of the interface with attribute aAttr
+ */
+template<class Gather, class Scatter>
+void DDD_IFAExchange (DDD::DDDContext& context, DDD_IF aIF, DDD_ATTR aAttr, std::size_t aSize,
+                      Gather&& gather, Scatter&& scatter)
+{
+  IFCommFunctor<false>(context, aIF, [aAttr](IF_PROC *ifHead) { return IFFindAttr(ifHead, aAttr); },
+                       {DirBA, DirAB}, {DirAB, DirBA}, aSize, gather, scatter);
+}
+
+/**
+ * \brief DDD_IFOneway with functors on the part of the interface with attribute aAttr
+ */
+template<class Gather, class Scatter>
+void DDD_IFAOneway (DDD::DDDContext& context, DDD_IF aIF, DDD_ATTR aAttr, DDD_IF_DIR aDir,
+                    std::size_t aSize, Gather&& gather, Scatter&& scatter)
+{
+  const CplDir out = (aDir==IF_FORWARD) ? DirAB : DirBA;
+  const CplDir in  = (aDir==IF_FORWARD) ? DirBA : DirAB;
+  IFCommFunctor<false>(context, aIF, [aAttr](IF_PROC *ifHead) { return IFFindAttr(ifHead, aAttr); },
+                       {out}, {in}, aSize, gather, scatter);
+}
+
+/**
+ * \brief DDD_IFExchange with functors and extended arguments
+ *
+ * gather and scatter are called as f(DDD_OBJ obj, void *data,
+ * DDD_PROC proc, DDD_PRIO prio) with the processor and priority of
+ * the copy on the other side, like the handlers of DDD_IFExchangeX.
+ */
+template<class Gather, class Scatter>
+void DDD_IFExchangeX (DDD::DDDContext& context, DDD_IF aIF, std::size_t aSize,
+                      Gather&& gather, Scatter&& scatter)
+{
+  IFCommFunctor<true>(context, aIF, [](IF_PROC *ifHead) { return ifHead; },
+                      {DirBA, DirAB}, {DirAB, DirBA}, aSize, gather, scatter);
+}
+
+/**
+ * \brief DDD_IFOneway with functors and extended arguments, see DDD_IFExchangeX
+ */
+template<class Gather, class Scatter>
+void DDD_IFOnewayX (DDD::DDDContext& context, DDD_IF aIF, DDD_IF_DIR aDir, std::size_t aSize,
+                    Gather&& gather, Scatter&& scatter)
+{
+  const CplDir out = (aDir==IF_FORWARD) ? DirAB : DirBA;
+  const CplDir in  = (aDir==IF_FORWARD) ? DirBA : DirAB;
+  IFCommFunctor<true>(context, aIF, [](IF_PROC *ifHead) { return ifHead; },
+                      {out}, {in}, aSize, gather, scatter);
+}
+
+/**
+ * \brief DDD_IFAExchange with functors and extended arguments, see DDD_IFExchangeX
+ */
+template<class Gather, class Scatter>
+void DDD_IFAExchangeX (DDD::DDDContext& context, DDD_IF aIF, DDD_ATTR aAttr, std::size_t aSize,
+                       Gather&& gather, Scatter&& scatter)
+{
+  IFCommFunctor<true>(context, aIF, [aAttr](IF_PROC *ifHead) { return IFFindAttr(ifHead, aAttr); },
+                      {DirBA, DirAB}, {DirAB, DirBA}, aSize, gather, scatter);
+}
+
+/**
+ * \brief DDD_IFAOneway with functors and extended arguments, see DDD_IFExchangeX
+ */
+template<class Gather, class Scatter>
+void DDD_IFAOnewayX (DDD::DDDContext& context, DDD_IF aIF, DDD_ATTR aAttr, DDD_IF_DIR aDir,
+                     std::size_t aSize, Gather&& gather, Scatter&& scatter)
+{
+  const CplDir out = (aDir==IF_FORWARD) ? DirAB : DirBA;
+  const CplDir in  = (aDir==IF_FORWARD) ? DirBA : DirAB;
+  IFCommFunctor<true>(context, aIF, [aAttr](IF_PROC *ifHead) { return IFFindAttr(ifHead, aAttr); },
+                      {out}, {in}, aSize, gather, scatter);
+}
+
+END_UGDIM_NAMESPACE
+
+#endif
@@ -41,7 +41,10 @@
 #include <cstdio>
 #include <cstring>
 
+#include <functional>
+
 #include <dune/common/exceptions.hh>
+#include <dune/common/stdstreams.hh>
 
 #include <dune/uggrid/parallel/ddd/dddcontext.hh>
 
@@ -65,20 +68,102 @@ START_UGDIM_NAMESPACE
 /*
         allocate memory for message buffers,
         one for send, one for receive
+
+        the buffers keep their capacity, so with OPT_IF_REUSE_BUFFERS
+        repeated communication on an interface does not allocate.
  */
 void IFGetMem (IF_PROC *ifHead, size_t itemSize, int lenIn, int lenOut)
 {
   size_t sizeIn  = itemSize * lenIn;
   size_t sizeOut = itemSize * lenOut;
 
-  /* set memory to initial value, in order to find any bugs lateron */
-  ifHead->bufIn.assign(sizeIn, 0);
-  ifHead->bufOut.assign(sizeOut, 0);
+  ifHead->bufIn.resize(sizeIn);
+  ifHead->bufOut.resize(sizeOut);
 }
 
 
 
 
+/*
+        free the persistent requests of all plans of an IF_PROC
+ */
+void IFFreePlans(DDD::DDDContext& context, IF_PROC *ifHead)
+{
+  for (IF_PLAN& plan : ifHead->plans)
+  {
+    if (plan.msgIn!=NO_MSGID)
+      FreePersistent(context.ppifContext(), plan.msgIn);
+    if (plan.msgOut!=NO_MSGID)
+      FreePersistent(context.ppifContext(), plan.msgOut);
+  }
+  ifHead->plans.clear();
+  ifHead->plan = nullptr;
+}
+
+
+
+/*
+        find or create the plan for the current buffer sizes of an
+        IF_PROC and swap its buffers in. the persistent requests of
+        the plan are bound to these buffers.
+ */
+static void IFUsePlan(DDD::DDDContext& context, IF_PROC *ifHead)
+{
+  const size_t sizeIn  = ifHead->bufIn.size();
+  const size_t sizeOut = ifHead->bufOut.size();
+  int error;
+
+  IF_PLAN *plan = nullptr;
+  for (IF_PLAN& p : ifHead->plans)
+    if (p.sizeIn==sizeIn && p.sizeOut==sizeOut)
+      plan = &p;
+
+  if (plan==nullptr)
+  {
+    /* forget the oldest plan */
+    if (ifHead->plans.size()==MAX_IF_PLANS)
+    {
+      IF_PLAN& oldest = ifHead->plans.front();
+      if (oldest.msgIn!=NO_MSGID)
+        FreePersistent(context.ppifContext(), oldest.msgIn);
+      if (oldest.msgOut!=NO_MSGID)
+        FreePersistent(context.ppifContext(), oldest.msgOut);
+      ifHead->plans.erase(ifHead->plans.begin());
+    }
+
+    plan = &ifHead->plans.emplace_back();
+    plan->sizeIn = sizeIn;
+    plan->sizeOut = sizeOut;
+    plan->bufIn.resize(sizeIn);
+    plan->bufOut.resize(sizeOut);
+
+    /* the channel of the interface has a tag of its own, so a started
+       plan only matches messages of this interface */
+    if (sizeIn>0)
+    {
+      plan->msgIn =
+        RecvPersistent(context.ppifContext(), ifHead->vc,
+                       plan->bufIn.data(), sizeIn, &error);
+      if (plan->msgIn==NO_MSGID)
+        DUNE_THROW(Dune::Exception, "RecvPersistent() failed");
+    }
+    if (sizeOut>0)
+    {
+      plan->msgOut =
+        SendPersistent(context.ppifContext(), ifHead->vc,
+                       plan->bufOut.data(), sizeOut, &error);
+      if (plan->msgOut==NO_MSGID)
+        DUNE_THROW(Dune::Exception, "SendPersistent() failed");
+    }
+  }
+
+  ifHead->bufIn.swap(plan->bufIn);
+  ifHead->bufOut.swap(plan->bufOut);
+  ifHead->plan = plan;
+}
+
+
+
 /*
         initiate asynchronous receive calls,
         return number of messages to be received
@@ -89,7 +174,7 @@ int IFInitComm(DDD::DDDContext& context, DDD_IF ifId)
   int error;
   int recv_mesgs;
 
-  auto& ctx = context.ifUseContext();
+  const bool persistent = DDD_GetOption(context, OPT_IF_PERSISTENT) == OPT_ON;
 
   /* MarkHeap(); */
 
@@ -98,21 +183,31 @@ int IFInitComm(DDD::DDDContext& context, DDD_IF ifId)
   /* get memory and initiate receive calls */
   ForIF(context, ifId, ifHead)
   {
+    if (persistent && not (ifHead->bufIn.empty() && ifHead->bufOut.empty()))
+      IFUsePlan(context, ifHead);
+
     if (not ifHead->bufIn.empty())
     {
-      ifHead->msgIn =
-        RecvASync(context.ppifContext(), ifHead->vc,
-                  ifHead->bufIn.data(), ifHead->bufIn.size(),
-                  &error);
-      if (ifHead->msgIn==0)
-        DUNE_THROW(Dune::Exception, "RecvASync() failed");
+      if (ifHead->plan!=nullptr)
+      {
+        ifHead->msgIn = ifHead->plan->msgIn;
+        if (StartPersistent(context.ppifContext(), ifHead->msgIn)!=PPIF_SUCCESS)
+          DUNE_THROW(Dune::Exception, "StartPersistent() failed");
+      }
+      else
+      {
+        ifHead->msgIn =
+          RecvASync(context.ppifContext(), ifHead->vc,
+                    ifHead->bufIn.data(), ifHead->bufIn.size(),
+                    &error);
+        if (ifHead->msgIn==0)
+          DUNE_THROW(Dune::Exception, "RecvASync() failed");
+      }
 
       recv_mesgs++;
     }
   }
 
-  ctx.send_mesgs = 0;
-
   return recv_mesgs;
 }
 
@@ -123,9 +218,21 @@ int IFInitComm(DDD::DDDContext& context, DDD_IF ifId)
  */
 void IFExitComm(DDD::DDDContext& context, DDD_IF ifId)
 {
+  IF_PROC *ifHead;
+
+  /* give the buffers back to their plans */
+  ForIF(context, ifId, ifHead)
+  {
+    if (ifHead->plan!=nullptr)
+    {
+      ifHead->bufIn.swap(ifHead->plan->bufIn);
+      ifHead->bufOut.swap(ifHead->plan->bufOut);
+      ifHead->plan = nullptr;
+    }
+  }
+
   if (DDD_GetOption(context, OPT_IF_REUSE_BUFFERS) == OPT_OFF)
   {
-    IF_PROC *ifHead;
     ForIF(context, ifId, ifHead)
     {
       ifHead->bufIn.clear();
@@ -148,18 +255,22 @@ void IFInitSend(DDD::DDDContext& context, IF_PROC *ifHead)
 {
   int error;
 
-  auto& ctx = context.ifUseContext();
-
   if (not ifHead->bufOut.empty())
   {
+    if (ifHead->plan!=nullptr)
+    {
+      ifHead->msgOut = ifHead->plan->msgOut;
+      if (StartPersistent(context.ppifContext(), ifHead->msgOut)!=PPIF_SUCCESS)
+        DUNE_THROW(Dune::Exception, "StartPersistent() failed");
+      return;
+    }
+
     ifHead->msgOut =
       SendASync(context.ppifContext(), ifHead->vc,
                 ifHead->bufOut.data(), ifHead->bufOut.size(),
                 &error);
     if (ifHead->msgOut==0)
       DUNE_THROW(Dune::Exception, "SendASync() failed");
-
-    ctx.send_mesgs++;
   }
 }
 
@@ -168,17 +279,25 @@ void IFInitSend(DDD::DDDContext& context, IF_PROC *ifHead)
 /*
         poll asynchronous send calls,
         return if ready
+
+        only the sends of interface ifId are counted. each interface
+        has its own message tag, so that split-phase communication
+        on other interfaces may be in progress at the same time.
  */
 int IFPollSend(DDD::DDDContext& context, DDD_IF ifId)
 {
   unsigned long tries;
+  IF_PROC   *ifHead;
+  int send_mesgs = 0;
 
-  auto& ctx = context.ifUseContext();
-
-  for(tries=0; tries<MAX_TRIES && ctx.send_mesgs>0; tries++)
+  ForIF(context, ifId, ifHead)
   {
-    IF_PROC   *ifHead;
+    if (not ifHead->bufOut.empty() && ifHead->msgOut!= NO_MSGID)
+      send_mesgs++;
+  }
 
+  for(tries=0; tries<MAX_TRIES && send_mesgs>0; tries++)
+  {
     /* poll send calls */
     ForIF(context, ifId, ifHead)
     {
@@ -191,7 +310,7 @@ int IFPollSend(DDD::DDDContext& context, DDD_IF ifId)
 
         if (error==1)
         {
-          ctx.send_mesgs--;
+          send_mesgs--;
           ifHead->msgOut=NO_MSGID;
 
                                         #ifdef CtrlTimeoutsDetailed
@@ -207,14 +326,130 @@ int IFPollSend(DDD::DDDContext& context, DDD_IF ifId)
   }
 
         #ifdef CtrlTimeouts
-  if (ctx.send_mesgs==0)
+  if (send_mesgs==0)
   {
     printf("%4d: IFCTRL %02d send-completed    all after %10ld tries\n",
            context.me(), ifId, (unsigned long)tries);
   }
         #endif
 
-  return(ctx.send_mesgs==0);
+  return(send_mesgs==0);
+}
+
+
+
+/*
+        prepare a communication across interface ifId and mark it as
+        pending. the object shortcut tables are only needed by
+        handlers without extended arguments.
+ */
+void IFBeginComm(DDD::DDDContext& context, DDD_IF ifId, bool shortcuts)
+{
+  /* prohibit using standard interface (IF0) */
+  if (ifId==STD_INTERFACE)
+    DUNE_THROW(Dune::Exception, "cannot use standard interface");
+
+  /* if shortcut tables are invalid -> recompute */
+  if (shortcuts)
+    IFCheckShortcuts(context, ifId);
+
+  auto& theIf = context.ifCreateContext().theIf[ifId];
+  if (theIf.commPending)
+    DUNE_THROW(Dune::Exception,
+               "communication on IF " << ifId << " is already in progress");
+  theIf.commPending = true;
+}
+
+
+
+/*
+        poll receive calls, call scatter for every message which has
+        arrived, poll send completion and cleanup.
+        counterpart of IFBeginComm.
+ */
+void IFCompleteComm(DDD::DDDContext& context, DDD_IF ifId, int recv_mesgs,
+                    const std::function<void(IF_PROC *)>& scatter)
+{
+  IF_PROC *ifHead;
+  unsigned long tries;
+  IFCommPendingGuard pendingGuard(context.ifCreateContext().theIf[ifId]);
+
+  for(tries=0; tries<MAX_TRIES && recv_mesgs>0; tries++)
+  {
+    ForIF(context, ifId, ifHead)
+    {
+      if (not ifHead->bufIn.empty() && ifHead->msgIn!=NO_MSGID)
+      {
+        int error = InfoARecv(context.ppifContext(), ifHead->vc, ifHead->msgIn);
+        if (error==-1)
+          DUNE_THROW(Dune::Exception,
+                     "InfoARecv failed for recv to proc=" << ifHead->proc);
+
+        if (error==1)
+        {
+                                        #ifdef CtrlTimeoutsDetailed
+          printf("%4d: IFCTRL %02d received msg    from "
+                 "%4d after %10ld, size %ld\n",
+                 context.me(), ifId, ifHead->proc,
+                 (unsigned long)tries,
+                 (unsigned long)ifHead->bufIn.size());
+                                        #endif
+
+          recv_mesgs--;
+          ifHead->msgIn=NO_MSGID;
+          scatter(ifHead);
+        }
+      }
+    }
+  }
+
+        #ifdef CtrlTimeouts
+  if (recv_mesgs==0)
+    printf("%4d: IFCTRL %02d received msg  all after %10ld tries\n",
+           context.me(), ifId, (unsigned long)tries);
+        #endif
+
+  if (recv_mesgs>0)
+  {
+    Dune::dwarn << "IFCompleteComm: receive-timeout for IF " << ifId << "\n";
+
+    ForIF(context, ifId, ifHead)
+    {
+      if (not ifHead->bufIn.empty() && ifHead->msgIn!=NO_MSGID)
+        Dune::dwarn
+          << "  waiting for message (from proc " << ifHead->proc
+          << ", size " << ifHead->bufIn.size() << ")\n";
+    }
+  }
+  else if (! IFPollSend(context, ifId))
+  {
+    Dune::dwarn << "IFCompleteComm: send-timeout for IF " << ifId << "\n";
+
+    ForIF(context, ifId, ifHead)
+    {
+      if (not ifHead->bufOut.empty() && ifHead->msgOut!=NO_MSGID)
+        Dune::dwarn
+          << "  waiting for send completion (to proc " << ifHead->proc
+          << ", size " << ifHead->bufOut.size() << ")\n";
+    }
+  }
+
+  IFExitComm(context, ifId);
+}
+
+
+
+/*
+        find the part of ifHead with attribute aAttr,
+        returns NULL if there is none.
+ */
+IF_ATTR *IFFindAttr(IF_PROC *ifHead, DDD_ATTR aAttr)
+{
+  IF_ATTR *ifAttr = ifHead->ifAttr;
+  while ((ifAttr!=NULL) && (ifAttr->attr!=aAttr))
+    ifAttr = ifAttr->next;
+
+  return ifAttr;
 }
 
 
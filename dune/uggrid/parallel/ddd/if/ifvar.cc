@@ -0,0 +1,250 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-2.1-or-later
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+/****************************************************************************/
+/*                                                                          */
+/* File:      ifvar.cc                                                      */
+/*                                                                          */
+/* Purpose:   routines concerning interfaces between processors             */
+/*            part 4: communication with variable size per item             */
+/*                                                                          */
+/* Remarks:   every item is packed as its size followed by its data, so     */
+/*            one message per neighbor suffices. the receiver learns the    */
+/*            message size by probing for the message.                      */
+/*                                                                          */
+/****************************************************************************/
+
+/****************************************************************************/
+/*                                                                          */
+/* include files                                                            */
+/*            system include files                                          */
+/*            application include files                                     */
+/*                                                                          */
+/****************************************************************************/
+
+#include <config.h>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/stdstreams.hh>
+
+#include <dune/uggrid/parallel/ddd/dddcontext.hh>
+
+#include <dune/uggrid/parallel/ddd/dddi.h>
+#include "if.h"
+
+USING_UG_NAMESPACE
+
+/* PPIF namespace: */
+using namespace PPIF;
+
+START_UGDIM_NAMESPACE
+
+/****************************************************************************/
+/*                                                                          */
+/* data structures used in this source file (exported data structures are  */
+/*            in the corresponding include file!)                           */
+/*                                                                          */
+/****************************************************************************/
+
+/* size of an item as stored in front of its data */
+using IF_VSIZE = std::uint32_t;
+
+
+/****************************************************************************/
+/*                                                                          */
+/* routines                                                                 */
+/*                                                                          */
+/****************************************************************************/
+
+
+/*
+        append size and data of nItems objects to buffer
+ */
+static void IFGatherV (DDD::DDDContext& context, std::vector<char>& buffer,
+                       ComProcSizePtr Size, ComProcPtr2 Gather,
+                       IFObjPtr *obj, int nItems)
+{
+  for (int i=0; i<nItems; i++)
+  {
+    const size_t size = Size(context, obj[i]);
+    if (size > UINT32_MAX)
+      DUNE_THROW(Dune::Exception, "item too large for variable size IF communication");
+
+    const IF_VSIZE vsize = size;
+    const size_t pos = buffer.size();
+    buffer.resize(pos + sizeof(IF_VSIZE) + size);
+    std::memcpy(buffer.data()+pos, &vsize, sizeof(IF_VSIZE));
+    if (size>0)
+      Gather(context, obj[i], buffer.data()+pos+sizeof(IF_VSIZE));
+  }
+}
+
+
+/*
+        scatter nItems objects from buffer, starting at pos.
+        returns the position after the last item.
+ */
+static size_t IFScatterV (DDD::DDDContext& context, const IF_PROC *ifHead,
+                          size_t pos, ComProcVPtr Scatter,
+                          IFObjPtr *obj, int nItems)
+{
+  const std::vector<char>& buffer = ifHead->bufIn;
+
+  for (int i=0; i<nItems; i++)
+  {
+    IF_VSIZE vsize;
+    if (pos + sizeof(IF_VSIZE) > buffer.size())
+      DUNE_THROW(Dune::Exception,
+                 "message from proc=" << ifHead->proc << " too short");
+    std::memcpy(&vsize, buffer.data()+pos, sizeof(IF_VSIZE));
+    pos += sizeof(IF_VSIZE);
+
+    if (pos + vsize > buffer.size())
+      DUNE_THROW(Dune::Exception,
+                 "message from proc=" << ifHead->proc << " too short");
+    Scatter(context, obj[i], const_cast<char *>(buffer.data()+pos), vsize);
+    pos += vsize;
+  }
+
+  return pos;
+}
+
+
+/*
+        common part of DDD_IFExchangeV and DDD_IFOnewayV.
+        exchange==true sends BA, AB and ABA and receives AB, BA and ABA
+        as DDD_IFExchange does.
+ */
+static void IFCommV (DDD::DDDContext& context, DDD_IF aIF,
+                     bool exchange, DDD_IF_DIR aDir,
+                     ComProcSizePtr Size, ComProcPtr2 Gather, ComProcVPtr Scatter)
+{
+  IF_PROC *ifHead;
+  const bool forward = (aDir==IF_FORWARD);
+
+  IFBeginComm(context, aIF, true);
+  /* the probe only sees messages of this interface, which has its own tag */
+  IFCommPendingGuard pendingGuard(context.ifCreateContext().theIf[aIF]);
+
+  /* gather and send one message per neighbor */
+  std::vector<IF_PROC *> pending;
+  ForIF(context, aIF, ifHead)
+  {
+    ifHead->bufOut.clear();
+    if (exchange)
+    {
+      IFGatherV(context, ifHead->bufOut, Size, Gather, ifHead->objBA, ifHead->nBA);
+      IFGatherV(context, ifHead->bufOut, Size, Gather, ifHead->objAB, ifHead->nAB);
+    }
+    else if (forward)
+      IFGatherV(context, ifHead->bufOut, Size, Gather, ifHead->objAB, ifHead->nAB);
+    else
+      IFGatherV(context, ifHead->bufOut, Size, Gather, ifHead->objBA, ifHead->nBA);
+    IFGatherV(context, ifHead->bufOut, Size, Gather, ifHead->objABA, ifHead->nABA);
+
+    IFInitSend(context, ifHead);
+
+    const int nIn = exchange ? ifHead->nItems
+                    : (forward ? ifHead->nBA : ifHead->nAB) + ifHead->nABA;
+    if (nIn>0)
+      pending.push_back(ifHead);
+  }
+
+  /* receive messages in the order of their arrival and scatter them */
+  unsigned long tries;
+  for(tries=0; tries<MAX_TRIES && not pending.empty(); tries++)
+  {
+    for (size_t k=0; k<pending.size(); )
+    {
+      ifHead = pending[k];
+
+      int size;
+      const int arrived = ProbeASync(context.ppifContext(), ifHead->vc, &size);
+      if (arrived==-1)
+        DUNE_THROW(Dune::Exception,
+                   "ProbeASync() failed for recv to proc=" << ifHead->proc);
+      if (arrived==0)
+      {
+        k++;
+        continue;
+      }
+
+      ifHead->bufIn.resize(size);
+      if (RecvSync(context.ppifContext(), ifHead->vc, ifHead->bufIn.data(), size)!=size)
+        DUNE_THROW(Dune::Exception,
+                   "RecvSync() failed for recv from proc=" << ifHead->proc);
+
+      size_t pos = 0;
+      if (exchange)
+      {
+        pos = IFScatterV(context, ifHead, pos, Scatter, ifHead->objAB, ifHead->nAB);
+        pos = IFScatterV(context, ifHead, pos, Scatter, ifHead->objBA, ifHead->nBA);
+      }
+      else if (forward)
+        pos = IFScatterV(context, ifHead, pos, Scatter, ifHead->objBA, ifHead->nBA);
+      else
+        pos = IFScatterV(context, ifHead, pos, Scatter, ifHead->objAB, ifHead->nAB);
+      pos = IFScatterV(context, ifHead, pos, Scatter, ifHead->objABA, ifHead->nABA);
+
+      if (pos!=ifHead->bufIn.size())
+        DUNE_THROW(Dune::Exception,
+                   "message from proc=" << ifHead->proc << " too long");
+
+      pending[k] = pending.back();
+      pending.pop_back();
+    }
+  }
+
+  if (not pending.empty())
+  {
+    Dune::dwarn << "IFCommV: receive-timeout for IF " << aIF << "\n";
+    for (IF_PROC *p : pending)
+      Dune::dwarn << "  waiting for message (from proc " << p->proc << ")\n";
+  }
+
+  /* poll send calls */
+  if (not IFPollSend(context, aIF))
+    DUNE_THROW(Dune::Exception, "send-timeout for IF " << aIF);
+
+  IFExitComm(context, aIF);
+}
+
+
+/****************************************************************************/
+/*                                                                          */
+/* Function:  DDD_IFExchangeV                                               */
+/*                                                                          */
+/* Purpose:   exchange data of variable size per item across an interface. */
+/*            Size returns the number of bytes Gather writes for an         */
+/*            object, Scatter is called with the data and its size. The     */
+/*            data passed to Gather and Scatter is not aligned.             */
+/*                                                                          */
+/****************************************************************************/
+
+void DDD_IFExchangeV (DDD::DDDContext& context, DDD_IF aIF,
+                      ComProcSizePtr Size, ComProcPtr2 Gather, ComProcVPtr Scatter)
+{
+  IFCommV(context, aIF, true, IF_FORWARD, Size, Gather, Scatter);
+}
+
+
+/****************************************************************************/
+/*                                                                          */
+/* Function:  DDD_IFOnewayV                                                 */
+/*                                                                          */
+/* Purpose:   oneway communication of variable size per item across an     */
+/*            interface, see DDD_IFExchangeV and DDD_IFOneway.              */
+/*                                                                          */
+/****************************************************************************/
+
+void DDD_IFOnewayV (DDD::DDDContext& context, DDD_IF aIF, DDD_IF_DIR aDir,
+                    ComProcSizePtr Size, ComProcPtr2 Gather, ComProcVPtr Scatter)
+{
+  IFCommV(context, aIF, false, aDir, Size, Gather, Scatter);
+}
+
+END_UGDIM_NAMESPACE
@@ -0,0 +1,290 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************/
+/*                                                                          */
+/* File:      ifexchange-benchmark.cc                                       */
+/*                                                                          */
+/* Purpose:   overlap of computation with split-phase interface             */
+/*            communication (DDD_IFExchangeBegin/End), and exchanges with   */
+/*            persistent requests (OPT_IF_PERSISTENT). checks that two      */
+/*            interfaces can be pending at the same time                    */
+/*                                                                          */
+/*            usage: ifexchange-benchmark [objects per processor]           */
+/*                                        [work per object] [repetitions]   */
+/*                                                                          */
+/****************************************************************************/
+
+#include <config.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/uggrid/parallel/ppif/ppifcontext.hh>
+#include <dune/uggrid/parallel/ddd/dddi.h>
+
+USING_UG_NAMESPACES
+
+using Clock = std::chrono::steady_clock;
+
+static double SecondsSince (Clock::time_point start)
+{
+  return std::chrono::duration<double>(Clock::now()-start).count();
+}
+
+struct Object
+{
+  DDD_HEADER hdr;
+  double value;
+  double sum;
+  double other;
+};
+
+static int Gather (DDD::DDDContext&, DDD_OBJ obj, void *data)
+{
+  *static_cast<double *>(data) = reinterpret_cast<Object *>(obj)->value;
+  return 0;
+}
+
+static int Scatter (DDD::DDDContext&, DDD_OBJ obj, void *data)
+{
+  reinterpret_cast<Object *>(obj)->sum += *static_cast<const double *>(data);
+  return 0;
+}
+
+/* items of two doubles, for a second interface */
+static int GatherPair (DDD::DDDContext&, DDD_OBJ obj, void *data)
+{
+  double *item = static_cast<double *>(data);
+  item[0] = 2.0 * reinterpret_cast<Object *>(obj)->value;
+  item[1] = 3.0 * reinterpret_cast<Object *>(obj)->value;
+  return 0;
+}
+
+static int ScatterPair (DDD::DDDContext&, DDD_OBJ obj, void *data)
+{
+  const double *item = static_cast<const double *>(data);
+  reinterpret_cast<Object *>(obj)->other += item[0] + item[1];
+  return 0;
+}
+
+/* local computation which does not touch the interface */
+static double Work (std::vector<double>& x, int work)
+{
+  double s = 0.0;
+  for (auto& xi : x)
+  {
+    for (int k=0; k<work; k++)
+      xi = std::sqrt(xi + 1.0);
+    s += xi;
+  }
+  return s;
+}
+
+/* every copy contributes its value once */
+static int Check (const DDD::DDDContext& context, std::vector<Object>& objects)
+{
+  int errors = 0;
+  for (auto& object : objects)
+    errors += (object.sum != DDD_InfoNCopies(context, &object.hdr) * object.value);
+  return errors;
+}
+
+static int CheckPairs (const DDD::DDDContext& context, std::vector<Object>& objects)
+{
+  int errors = 0;
+  for (auto& object : objects)
+    errors += (object.other != DDD_InfoNCopies(context, &object.hdr) * 5.0 * object.value);
+  return errors;
+}
+
+static void ClearSums (std::vector<Object>& objects)
+{
+  for (auto& object : objects)
+    object.sum = object.other = 0.0;
+}
+
+/* two interfaces with different item sizes are pending at the same
+   time, begun and ended in opposite order on neighboring processors */
+static int TwoInterfaces (DDD::DDDContext& context, std::vector<Object>& objects,
+                          DDD_IF theIF, DDD_IF otherIF)
+{
+  ClearSums(objects);
+  DDD_IF_REQUEST first, second;
+  if (context.me()%2==0)
+  {
+    first = DDD_IFExchangeBegin(context, theIF, sizeof(double), Gather, Scatter);
+    second = DDD_IFExchangeBegin(context, otherIF, 2*sizeof(double), GatherPair, ScatterPair);
+    DDD_IFExchangeEnd(context, first);
+    DDD_IFExchangeEnd(context, second);
+  }
+  else
+  {
+    second = DDD_IFExchangeBegin(context, otherIF, 2*sizeof(double), GatherPair, ScatterPair);
+    first = DDD_IFExchangeBegin(context, theIF, sizeof(double), Gather, Scatter);
+    DDD_IFExchangeEnd(context, second);
+    DDD_IFExchangeEnd(context, first);
+  }
+  return Check(context, objects) + CheckPairs(context, objects);
+}
+
+/* number of persistent plans of an interface */
+static int Plans (DDD::DDDContext& context, DDD_IF theIF)
+{
+  int n = 0;
+  for (DDD::If::IF_PROC *ifHead=context.ifCreateContext().theIf[theIF].ifHead; ifHead!=nullptr; ifHead=ifHead->next)
+    n += ifHead->plans.size();
+  return n;
+}
+
+int main (int argc, char **argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+
+  const int n = (argc>1) ? std::atoi(argv[1]) : 100000;
+  const int work = (argc>2) ? std::atoi(argv[2]) : 20;
+  const int repetitions = (argc>3) ? std::atoi(argv[3]) : 10;
+
+  auto ppifContext = std::make_shared<PPIF::PPIFContext>();
+  DDD::DDDContext context(ppifContext, nullptr);
+  DDD_Init(context);
+  DDD_SetOption(context, OPT_WARNING_DESTRUCT_HDR, OPT_OFF);
+  DDD_SetOption(context, OPT_IF_REUSE_BUFFERS, OPT_ON);
+
+  DDD_TYPE type = DDD_TypeDeclare(context, "Object");
+  DDD_TypeDefine(context, type,
+                 EL_DDDHDR, offsetof(Object,hdr),
+                 EL_LDATA,  offsetof(Object,value), sizeof(double),
+                 EL_LDATA,  offsetof(Object,sum), sizeof(double),
+                 EL_LDATA,  offsetof(Object,other), sizeof(double),
+                 EL_END,    sizeof(Object));
+
+  /* object i is shared with the neighbors in a chain of processors */
+  const int me = context.me();
+  const int procs = context.procs();
+  std::vector<Object> objects(n);
+  DDD_IdentifyBegin(context);
+  for (int i=0; i<n; i++)
+  {
+    Object& object = objects[i];
+    DDD_HdrConstructor(context, &object.hdr, type, 1, 0);
+    object.value = i+1;
+    if (me>0)
+      DDD_IdentifyNumber(context, &object.hdr, me-1, i);
+    if (me<procs-1)
+      DDD_IdentifyNumber(context, &object.hdr, me+1, i);
+  }
+  DDD_IdentifyEnd(context);
+
+  DDD_TYPE O[] = {type};
+  DDD_PRIO A[] = {1};
+  DDD_IF theIF = DDD_IFDefine(context, 1, O, 1, A, 1, A);
+
+  std::vector<double> x(n, 1.0);
+  int errors = 0;
+  double s = 0.0;
+
+  /* communication alone */
+  auto start = Clock::now();
+  for (int r=0; r<repetitions; r++)
+  {
+    ClearSums(objects);
+    DDD_IFExchange(context, theIF, sizeof(double), Gather, Scatter);
+  }
+  const double exchangeTime = SecondsSince(start);
+  errors += Check(context, objects);
+
+  /* computation alone */
+  start = Clock::now();
+  for (int r=0; r<repetitions; r++)
+    s += Work(x, work);
+  const double workTime = SecondsSince(start);
+
+  /* one after the other */
+  start = Clock::now();
+  for (int r=0; r<repetitions; r++)
+  {
+    ClearSums(objects);
+    DDD_IFExchange(context, theIF, sizeof(double), Gather, Scatter);
+    s += Work(x, work);
+  }
+  const double blockingTime = SecondsSince(start);
+  errors += Check(context, objects);
+
+  /* computation between Begin and End */
+  start = Clock::now();
+  for (int r=0; r<repetitions; r++)
+  {
+    ClearSums(objects);
+    DDD_IF_REQUEST request = DDD_IFExchangeBegin(context, theIF, sizeof(double), Gather, Scatter);
+    s += Work(x, work);
+    DDD_IFExchangeEnd(context, request);
+  }
+  const double splitTime = SecondsSince(start);
+  errors += Check(context, objects);
+
+  /* only one communication may be in progress per interface */
+  DDD_IF_REQUEST request = DDD_IFOnewayBegin(context, theIF, IF_FORWARD, sizeof(double), Gather, Scatter);
+  try {
+    DDD_IFExchangeBegin(context, theIF, sizeof(double), Gather, Scatter);
+    errors++;
+  }
+  catch (const Dune::Exception&) {}
+  ClearSums(objects);
+  DDD_IFOnewayEnd(context, request);
+  errors += Check(context, objects);
+
+  DDD_IF otherIF = DDD_IFDefine(context, 1, O, 1, A, 1, A);
+  errors += TwoInterfaces(context, objects, theIF, otherIF);
+
+  /* persistent requests, one plan per neighbor */
+  DDD_SetOption(context, OPT_IF_PERSISTENT, OPT_ON);
+  start = Clock::now();
+  for (int r=0; r<repetitions; r++)
+  {
+    ClearSums(objects);
+    DDD_IFExchange(context, theIF, sizeof(double), Gather, Scatter);
+  }
+  const double persistentTime = SecondsSince(start);
+  errors += Check(context, objects);
+  errors += TwoInterfaces(context, objects, theIF, otherIF);
+  const int nPlans = Plans(context, theIF);
+  errors += (nPlans != context.ifCreateContext().theIf[theIF].nIfHeads);
+
+  /* rebuilding the interface drops the plans */
+  DDD_IFRefreshAll(context);
+  errors += (Plans(context, theIF) != 0);
+  ClearSums(objects);
+  DDD_IFExchange(context, theIF, sizeof(double), Gather, Scatter);
+  errors += Check(context, objects);
+  DDD_SetOption(context, OPT_IF_PERSISTENT, OPT_OFF);
+
+  const double hidden = blockingTime - splitTime;
+  if (me==0)
+  {
+    printf("%d processors, %d objects per processor, %d repetitions (checksum %g)\n",
+           procs, n, repetitions, s);
+    printf("exchange     %8.3f ms\n", 1e3*exchangeTime/repetitions);
+    printf("work         %8.3f ms\n", 1e3*workTime/repetitions);
+    printf("blocking     %8.3f ms\n", 1e3*blockingTime/repetitions);
+    printf("split-phase  %8.3f ms  hides %5.1f%% of the exchange\n",
+           1e3*splitTime/repetitions, 100.0*hidden/std::max(exchangeTime,1e-12));
+    printf("persistent   %8.3f ms\n", 1e3*persistentTime/repetitions);
+  }
+
+  for (auto& object : objects)
+    DDD_HdrDestructor(context, &object.hdr);
+  DDD_Exit(context);
+
+  if (errors)
+    printf("%d: ifexchange-benchmark: %d errors\n", me, errors);
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,196 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************/
+/*                                                                          */
+/* File:      iffunctor-benchmark.cc                                        */
+/*                                                                          */
+/* Purpose:   compare DDD_IFExchange and DDD_IFOneway with gather/scatter   */
+/*            function pointers and with lambdas (ifexchange.hh) for one    */
+/*            INT per interface item, and check that the variants with      */
+/*            attribute and with extended arguments give the same result    */
+/*                                                                          */
+/*            usage: iffunctor-benchmark [objects per processor]            */
+/*                                       [repetitions]                      */
+/*                                                                          */
+/****************************************************************************/
+
+#include <config.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/uggrid/parallel/ppif/ppifcontext.hh>
+#include <dune/uggrid/parallel/ddd/dddi.h>
+#include <dune/uggrid/parallel/ddd/if/ifexchange.hh>
+
+USING_UG_NAMESPACES
+
+using Clock = std::chrono::steady_clock;
+
+static double SecondsSince (Clock::time_point start)
+{
+  return std::chrono::duration<double>(Clock::now()-start).count();
+}
+
+struct Object
+{
+  DDD_HEADER hdr;
+  INT flag;
+  INT max;
+};
+
+static int Gather (DDD::DDDContext&, DDD_OBJ obj, void *data)
+{
+  *static_cast<INT *>(data) = reinterpret_cast<Object *>(obj)->flag;
+  return 0;
+}
+
+static int Scatter (DDD::DDDContext&, DDD_OBJ obj, void *data)
+{
+  Object *object = reinterpret_cast<Object *>(obj);
+  object->max = std::max(object->max, *static_cast<const INT *>(data));
+  return 0;
+}
+
+int main (int argc, char **argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+
+  const int n = (argc>1) ? std::atoi(argv[1]) : 1000000;
+  const int repetitions = (argc>2) ? std::atoi(argv[2]) : 10;
+
+  auto ppifContext = std::make_shared<PPIF::PPIFContext>();
+  DDD::DDDContext context(ppifContext, nullptr);
+  DDD_Init(context);
+  DDD_SetOption(context, OPT_WARNING_DESTRUCT_HDR, OPT_OFF);
+  DDD_SetOption(context, OPT_IF_REUSE_BUFFERS, OPT_ON);
+
+  DDD_TYPE type = DDD_TypeDeclare(context, "Object");
+  DDD_TypeDefine(context, type,
+                 EL_DDDHDR, offsetof(Object,hdr),
+                 EL_LDATA,  offsetof(Object,flag), sizeof(INT),
+                 EL_LDATA,  offsetof(Object,max), sizeof(INT),
+                 EL_END,    sizeof(Object));
+
+  /* object i is shared with the neighbors in a chain of processors */
+  const int me = context.me();
+  const int procs = context.procs();
+  std::vector<Object> objects(n);
+  DDD_IdentifyBegin(context);
+  for (int i=0; i<n; i++)
+  {
+    Object& object = objects[i];
+    DDD_HdrConstructor(context, &object.hdr, type, 1, 0);
+    object.flag = (i*7 + me) % 5;
+    if (me>0)
+      DDD_IdentifyNumber(context, &object.hdr, me-1, i);
+    if (me<procs-1)
+      DDD_IdentifyNumber(context, &object.hdr, me+1, i);
+  }
+  DDD_IdentifyEnd(context);
+
+  DDD_TYPE O[] = {type};
+  DDD_PRIO A[] = {1};
+  DDD_IF theIF = DDD_IFDefine(context, 1, O, 1, A, 1, A);
+  const int items = context.ifCreateContext().theIf[theIF].nItems;
+
+  const auto gather = [](DDD_OBJ obj, void *data) {
+                        *static_cast<INT *>(data) = reinterpret_cast<Object *>(obj)->flag;
+                      };
+  const auto scatter = [](DDD_OBJ obj, void *data) {
+                         Object *object = reinterpret_cast<Object *>(obj);
+                         object->max = std::max(object->max, *static_cast<const INT *>(data));
+                       };
+  const auto gatherX = [&gather](DDD_OBJ obj, void *data, DDD_PROC, DDD_PRIO) {
+                         gather(obj, data);
+                       };
+  const auto scatterX = [&scatter](DDD_OBJ obj, void *data, DDD_PROC, DDD_PRIO) {
+                          scatter(obj, data);
+                        };
+
+  /* function pointers, functors, functors on attribute 0 and functors
+     with extended arguments */
+  enum { Pointer, Functor, AFunctor, XFunctor, Variants };
+  const char *names[Variants] = {"function pointer", "functor", "A functor", "X functor"};
+
+  int errors = 0;
+  double seconds[2][Variants];
+  for (int oneway=0; oneway<2; oneway++)
+  {
+    std::vector<INT> result(n);
+    for (int variant=0; variant<Variants; variant++)
+    {
+      const auto start = Clock::now();
+      for (int r=0; r<repetitions; r++)
+      {
+        for (auto& object : objects)
+          object.max = -1;
+        switch (variant)
+        {
+        case Pointer :
+          if (oneway)
+            DDD_IFOneway(context, theIF, IF_FORWARD, sizeof(INT), Gather, Scatter);
+          else
+            DDD_IFExchange(context, theIF, sizeof(INT), Gather, Scatter);
+          break;
+        case Functor :
+          if (oneway)
+            DDD_IFOneway(context, theIF, IF_FORWARD, sizeof(INT), gather, scatter);
+          else
+            DDD_IFExchange(context, theIF, sizeof(INT), gather, scatter);
+          break;
+        case AFunctor :
+          if (oneway)
+            DDD_IFAOneway(context, theIF, 0, IF_FORWARD, sizeof(INT), gather, scatter);
+          else
+            DDD_IFAExchange(context, theIF, 0, sizeof(INT), gather, scatter);
+          break;
+        default :
+          if (oneway)
+            DDD_IFOnewayX(context, theIF, IF_FORWARD, sizeof(INT), gatherX, scatterX);
+          else
+            DDD_IFExchangeX(context, theIF, sizeof(INT), gatherX, scatterX);
+          break;
+        }
+      }
+      seconds[oneway][variant] = SecondsSince(start);
+
+      /* all variants give the same result */
+      for (int i=0; i<n; i++)
+        if (variant==Pointer)
+          result[i] = objects[i].max;
+        else
+          errors += (objects[i].max != result[i]);
+    }
+  }
+
+  if (me==0)
+  {
+    printf("%d processors, %d interface items on processor 0, %d repetitions\n",
+           procs, items, repetitions);
+    for (int oneway=0; oneway<2; oneway++)
+    {
+      printf("%-9s", oneway ? "oneway" : "exchange");
+      for (int variant=0; variant<Variants; variant++)
+        printf("  %s %7.2f ns/item", names[variant],
+               1e9*seconds[oneway][variant]/std::max(items*repetitions,1));
+      printf("  speedup %5.2f\n",
+             seconds[oneway][Functor]>0.0 ? seconds[oneway][Pointer]/seconds[oneway][Functor] : 0.0);
+    }
+  }
+
+  for (auto& object : objects)
+    DDD_HdrDestructor(context, &object.hdr);
+  DDD_Exit(context);
+
+  if (errors)
+    printf("%d: iffunctor-benchmark: %d errors\n", me, errors);
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,195 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************/
+/*                                                                          */
+/* File:      ifrebuild-benchmark.cc                                        */
+/*                                                                          */
+/* Purpose:   patching interfaces after priority changes and transfers of   */
+/*            a few objects (option OPT_IF_INCREMENTAL) compared with       */
+/*            creating them from scratch                                    */
+/*                                                                          */
+/*            usage: ifrebuild-benchmark [objects per processor]            */
+/*                                       [repetitions]                      */
+/*                                                                          */
+/****************************************************************************/
+
+#include <config.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/uggrid/parallel/ppif/ppifcontext.hh>
+#include <dune/uggrid/parallel/ddd/dddi.h>
+
+USING_UG_NAMESPACES
+
+using Clock = std::chrono::steady_clock;
+
+static double SecondsSince (Clock::time_point start)
+{
+  return std::chrono::duration<double>(Clock::now()-start).count();
+}
+
+enum Prio { PrioMaster = 1, PrioGhost = 2 };
+
+/* the header comes first, so objects and headers have the same address */
+struct Object
+{
+  DDD_HEADER hdr;
+  double value;
+};
+
+struct Timing
+{
+  double patch = 0.0;
+  double scratch = 0.0;
+};
+
+/*
+        bring the interfaces up to date after the changes, once by
+        patching and once from scratch, and check that both agree.
+ */
+static int Rebuild (DDD::DDDContext& context, Timing& timing)
+{
+  DDD_SetOption(context, OPT_IF_CREATE_EXPLICIT, OPT_OFF);
+
+  auto start = Clock::now();
+  IFAllFromScratch(context);
+  timing.patch += SecondsSince(start);
+
+  int errors = DDD_CheckInterfacesRebuild(context);
+
+  start = Clock::now();
+  DDD_IFRefreshAll(context);
+  timing.scratch += SecondsSince(start);
+
+  return errors;
+}
+
+int main (int argc, char **argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+
+  const int n = (argc>1) ? std::atoi(argv[1]) : 100000;
+  const int repetitions = (argc>2) ? std::atoi(argv[2]) : 5;
+
+  auto ppifContext = std::make_shared<PPIF::PPIFContext>();
+  DDD::DDDContext context(ppifContext, nullptr);
+  DDD_Init(context);
+  DDD_SetOption(context, OPT_WARNING_DESTRUCT_HDR, OPT_OFF);
+  DDD_SetOption(context, OPT_IF_INCREMENTAL, OPT_ON);
+
+  DDD_TYPE type = DDD_TypeDeclare(context, "Object");
+  DDD_TypeDefine(context, type,
+                 EL_DDDHDR, offsetof(Object,hdr),
+                 EL_GDATA,  offsetof(Object,value), sizeof(double),
+                 EL_END,    sizeof(Object));
+
+  /* object i is shared with one neighbor in a chain of processors,
+     alternating between the left and the right one */
+  const int me = context.me();
+  const int procs = context.procs();
+  std::vector<Object> objects(n);
+  DDD_IdentifyBegin(context);
+  for (int i=0; i<n; i++)
+  {
+    Object& object = objects[i];
+    DDD_HdrConstructor(context, &object.hdr, type, PrioMaster, 0);
+    object.value = i;
+    const int neighbor = ((i+me)%2==0) ? me+1 : me-1;
+    if (neighbor>=0 && neighbor<procs)
+      DDD_IdentifyNumber(context, &object.hdr, neighbor, i);
+  }
+  DDD_IdentifyEnd(context);
+
+  DDD_TYPE O[] = {type};
+  DDD_PRIO master[] = {PrioMaster};
+  DDD_PRIO all[] = {PrioMaster, PrioGhost};
+  DDD_IFDefine(context, 1, O, 1, master, 2, all);
+  DDD_IFDefine(context, 1, O, 1, master, 1, master);
+
+  int errors = 0;
+  const double fractions[] = {0.001, 0.01, 0.1};
+  Timing timing[3];
+
+  for (int f=0; f<3; f++)
+  {
+    const int k = std::max(1, int(fractions[f]*n));
+    std::vector<Object> extra(k);
+
+    for (int r=0; r<repetitions; r++)
+    {
+      /* change the priorities of k objects */
+      DDD_SetOption(context, OPT_IF_CREATE_EXPLICIT, OPT_ON);
+      DDD_PrioBegin(context);
+      for (int j=0; j<k; j++)
+      {
+        Object& object = objects[(j*7919 + r*k) % n];
+        DDD_PrioChange(context, &object.hdr,
+                       OBJ_PRIO(&object.hdr)==PrioMaster ? PrioGhost : PrioMaster);
+      }
+      DDD_PrioEnd(context);
+      errors += Rebuild(context, timing[f]);
+
+      /* create k objects and copy them to the next processor */
+      DDD_SetOption(context, OPT_IF_CREATE_EXPLICIT, OPT_ON);
+      DDD_XferBegin(context);
+      for (auto& object : extra)
+      {
+        DDD_HdrConstructor(context, &object.hdr, type, PrioMaster, 0);
+        if (procs>1)
+          DDD_XferCopyObj(context, &object.hdr, (me+1)%procs, PrioGhost);
+      }
+      DDD_XferEnd(context);
+      errors += Rebuild(context, timing[f]);
+
+      /* delete the received copies again */
+      std::vector<DDD_HDR> received;
+      for (int i=0; i<context.nObjs(); i++)
+      {
+        DDD_HDR hdr = context.objTable()[i];
+        const bool local = (hdr >= &objects.front().hdr && hdr <= &objects.back().hdr)
+                           || (hdr >= &extra.front().hdr && hdr <= &extra.back().hdr);
+        if (!local)
+          received.push_back(hdr);
+      }
+      DDD_SetOption(context, OPT_IF_CREATE_EXPLICIT, OPT_ON);
+      DDD_XferBegin(context);
+      for (DDD_HDR hdr : received)
+        DDD_XferDeleteObj(context, hdr);
+      DDD_XferEnd(context);
+      errors += Rebuild(context, timing[f]);
+
+      for (auto& object : extra)
+        DDD_HdrDestructor(context, &object.hdr);
+    }
+  }
+
+  /* the interfaces are still symmetric */
+  errors += DDD_CheckInterfaces(context);
+  errors += DDD_ConsCheck(context);
+
+  if (me==0)
+  {
+    printf("%d processors, %d objects per processor, %d repetitions\n", procs, n, repetitions);
+    for (int f=0; f<3; f++)
+      printf("%5.1f%% changed  patch %8.3f ms  from scratch %8.3f ms\n",
+             100.0*fractions[f], 1e3*timing[f].patch/(3*repetitions),
+             1e3*timing[f].scratch/(3*repetitions));
+  }
+
+  for (auto& object : objects)
+    DDD_HdrDestructor(context, &object.hdr);
+  DDD_Exit(context);
+
+  if (errors)
+    printf("%d: ifrebuild-benchmark: %d errors\n", me, errors);
+  return errors ? 1 : 0;
+}
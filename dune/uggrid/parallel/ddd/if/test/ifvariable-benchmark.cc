@@ -0,0 +1,226 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************/
+/*                                                                          */
+/* File:      ifvariable-benchmark.cc                                       */
+/*                                                                          */
+/* Purpose:   interface exchange of a variable number of doubles per        */
+/*            object, with DDD_IFExchangeV and with DDD_IFExchange padded   */
+/*            to the largest size, and check that a throwing handler does   */
+/*            not block the interface                                       */
+/*                                                                          */
+/*            usage: ifvariable-benchmark [objects per processor]           */
+/*                                        [max. doubles per object]         */
+/*                                        [repetitions]                     */
+/*                                                                          */
+/****************************************************************************/
+
+#include <config.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/uggrid/parallel/ppif/ppifcontext.hh>
+#include <dune/uggrid/parallel/ddd/dddi.h>
+
+USING_UG_NAMESPACES
+
+using Clock = std::chrono::steady_clock;
+
+static double SecondsSince (Clock::time_point start)
+{
+  return std::chrono::duration<double>(Clock::now()-start).count();
+}
+
+struct Object
+{
+  DDD_HEADER hdr;
+  std::vector<double> values;
+  double sum;
+};
+
+/* size of the padded items */
+static int maxValues;
+
+static std::size_t Size (DDD::DDDContext&, DDD_OBJ obj)
+{
+  return sizeof(double) * reinterpret_cast<Object *>(obj)->values.size();
+}
+
+static int Gather (DDD::DDDContext&, DDD_OBJ obj, void *data)
+{
+  const Object *object = reinterpret_cast<Object *>(obj);
+  std::memcpy(data, object->values.data(), sizeof(double)*object->values.size());
+  return 0;
+}
+
+/* data is not aligned */
+static int ScatterV (DDD::DDDContext&, DDD_OBJ obj, void *data, std::size_t size)
+{
+  Object *object = reinterpret_cast<Object *>(obj);
+  for (std::size_t i=0; i<size/sizeof(double); i++)
+  {
+    double value;
+    std::memcpy(&value, static_cast<char *>(data)+i*sizeof(double), sizeof(double));
+    object->sum += value;
+  }
+  return 0;
+}
+
+/* padded item: number of values, followed by maxValues doubles */
+static int GatherPadded (DDD::DDDContext& context, DDD_OBJ obj, void *data)
+{
+  const Object *object = reinterpret_cast<Object *>(obj);
+  double *item = static_cast<double *>(data);
+  item[0] = object->values.size();
+  Gather(context, obj, item+1);
+  return 0;
+}
+
+static int ScatterPadded (DDD::DDDContext& context, DDD_OBJ obj, void *data)
+{
+  double *item = static_cast<double *>(data);
+  return ScatterV(context, obj, item+1, sizeof(double)*std::size_t(item[0]));
+}
+
+/* fails before anything is sent */
+static std::size_t FailingSize (DDD::DDDContext&, DDD_OBJ)
+{
+  throw std::runtime_error("FailingSize");
+}
+
+/* every copy contributes its values once */
+static int Check (const DDD::DDDContext& context, std::vector<Object>& objects)
+{
+  int errors = 0;
+  for (auto& object : objects)
+  {
+    double own = 0.0;
+    for (double value : object.values)
+      own += value;
+    errors += (object.sum != (DDD_InfoNCopies(context, &object.hdr)) * own);
+  }
+  return errors;
+}
+
+static void ClearSums (std::vector<Object>& objects)
+{
+  for (auto& object : objects)
+    object.sum = 0.0;
+}
+
+int main (int argc, char **argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+
+  const int n = (argc>1) ? std::atoi(argv[1]) : 100000;
+  maxValues = (argc>2) ? std::atoi(argv[2]) : 16;
+  const int repetitions = (argc>3) ? std::atoi(argv[3]) : 10;
+
+  auto ppifContext = std::make_shared<PPIF::PPIFContext>();
+  DDD::DDDContext context(ppifContext, nullptr);
+  DDD_Init(context);
+  DDD_SetOption(context, OPT_WARNING_DESTRUCT_HDR, OPT_OFF);
+  DDD_SetOption(context, OPT_IF_REUSE_BUFFERS, OPT_ON);
+
+  DDD_TYPE type = DDD_TypeDeclare(context, "Object");
+  DDD_TypeDefine(context, type,
+                 EL_DDDHDR, offsetof(Object,hdr),
+                 EL_END,    sizeof(Object));
+
+  /* object i is shared with the neighbors in a chain of processors,
+     most objects carry few values and some carry many */
+  const int me = context.me();
+  const int procs = context.procs();
+  std::vector<Object> objects(n);
+  long payload = 0;
+  DDD_IdentifyBegin(context);
+  for (int i=0; i<n; i++)
+  {
+    Object& object = objects[i];
+    DDD_HdrConstructor(context, &object.hdr, type, 1, 0);
+    const int len = (i%8==0) ? maxValues : i%3;
+    for (int k=0; k<len; k++)
+      object.values.push_back(i%100 + k);
+    payload += len;
+    if (me>0)
+      DDD_IdentifyNumber(context, &object.hdr, me-1, i);
+    if (me<procs-1)
+      DDD_IdentifyNumber(context, &object.hdr, me+1, i);
+  }
+  DDD_IdentifyEnd(context);
+
+  DDD_TYPE O[] = {type};
+  DDD_PRIO A[] = {1};
+  DDD_IF theIF = DDD_IFDefine(context, 1, O, 1, A, 1, A);
+
+  int errors = 0;
+
+  /* padded to the largest item */
+  auto start = Clock::now();
+  for (int r=0; r<repetitions; r++)
+  {
+    ClearSums(objects);
+    DDD_IFExchange(context, theIF, sizeof(double)*(maxValues+1), GatherPadded, ScatterPadded);
+  }
+  const double paddedTime = SecondsSince(start);
+  errors += Check(context, objects);
+
+  /* size and data packed per item */
+  start = Clock::now();
+  for (int r=0; r<repetitions; r++)
+  {
+    ClearSums(objects);
+    DDD_IFExchangeV(context, theIF, Size, Gather, ScatterV);
+  }
+  const double variableTime = SecondsSince(start);
+  errors += Check(context, objects);
+
+  /* all couplings are ABA, so oneway communicates in both directions */
+  ClearSums(objects);
+  DDD_IFOnewayV(context, theIF, IF_FORWARD, Size, Gather, ScatterV);
+  errors += Check(context, objects);
+
+  /* a handler that throws does not leave the interface blocked,
+     on one processor the interface is empty */
+  bool thrown = false;
+  try {
+    DDD_IFOnewayV(context, theIF, IF_FORWARD, FailingSize, Gather, ScatterV);
+  }
+  catch (const std::runtime_error&) {
+    thrown = true;
+  }
+  errors += (thrown != (procs>1));
+  ClearSums(objects);
+  DDD_IFOnewayV(context, theIF, IF_FORWARD, Size, Gather, ScatterV);
+  errors += Check(context, objects);
+
+  if (me==0)
+  {
+    const double paddedBytes = double(n) * sizeof(double)*(maxValues+1);
+    const double variableBytes = double(n) * sizeof(std::uint32_t) + sizeof(double)*payload;
+    printf("%d processors, %d objects per processor, %d repetitions\n",
+           procs, n, repetitions);
+    printf("padded    %8.3f ms  %10.0f bytes per neighbor\n",
+           1e3*paddedTime/repetitions, paddedBytes);
+    printf("variable  %8.3f ms  %10.0f bytes per neighbor\n",
+           1e3*variableTime/repetitions, variableBytes);
+  }
+
+  for (auto& object : objects)
+    DDD_HdrDestructor(context, &object.hdr);
+  DDD_Exit(context);
+
+  if (errors)
+    printf("%d: ifvariable-benchmark: %d errors\n", me, errors);
+  return errors ? 1 : 0;
+}
@@ -115,7 +115,8 @@ enum OptConstXfer {
   XFER_SHOW_NONE     = 0x0000,        /* show no statistical infos              */
   XFER_SHOW_OBSOLETE = 0x0001,        /* show #obsolete xfer-commands           */
   XFER_SHOW_MEMUSAGE = 0x0002,        /* show sizes of message buffers          */
-  XFER_SHOW_MSGSALL  = 0x0004         /* show message contents by LowComm stats */
+  XFER_SHOW_MSGSALL  = 0x0004,        /* show message contents by LowComm stats */
+  XFER_SHOW_THROUGHPUT = 0x0008       /* show pack/unpack throughput in MB/s    */
 };
 
 enum OptConstJoin {
@@ -243,6 +244,24 @@ using DDD_HDR = DDD::DDD_HDR;
 #define DDD_TYPE_BY_HANDLER   127   /* must be > MAX_TYPEDESC */
 
 
+/*
+        state of a split-phase interface communication, returned by
+        DDD_IFExchangeBegin and its variants and completed by the
+        matching End function. the members are private to the
+        interface module.
+ */
+struct DDD_IF_REQUEST
+{
+  DDD_IF ifId;
+  DDD_ATTR attr;
+  DDD_IF_DIR dir;
+  size_t size;
+  ComProcPtr2 scatter;
+  ComProcXPtr scatterX;
+  int recvMesgs;
+};
+
+
 /****************************************************************************/
 /*                                                                          */
 /* macros                                                                   */
@@ -305,6 +324,7 @@ void     DDD_SetHandlerXFERSCATTER     (DDD::DDDContext& context, DDD_TYPE, Hand
 void     DDD_SetHandlerXFERGATHERX     (DDD::DDDContext& context, DDD_TYPE, HandlerXFERGATHERX);
 void     DDD_SetHandlerXFERSCATTERX    (DDD::DDDContext& context, DDD_TYPE, HandlerXFERSCATTERX);
 void     DDD_SetHandlerXFERCOPYMANIP   (DDD::DDDContext& context, DDD_TYPE, HandlerXFERCOPYMANIP);
+void     DDD_SetHandlerXFERALLOC       (DDD::DDDContext& context, DDD_TYPE, HandlerXFERALLOC);
 
 
 void     DDD_PrioMergeDefault (DDD::DDDContext& context, DDD_TYPE, int);
@@ -449,6 +469,28 @@ void     DDD_IFAExchangeX (DDD::DDDContext& context, DDD_IF,DDD_ATTR,
 void     DDD_IFAOnewayX   (DDD::DDDContext& context, DDD_IF,DDD_ATTR,DDD_IF_DIR,size_t, ComProcXPtr,ComProcXPtr);
 void     DDD_IFAExecLocalX(DDD::DDDContext& context, DDD_IF,DDD_ATTR,                   ExecProcXPtr);
 
+/* split-phase variants, the scatter handler is called by the End function */
+DDD_IF_REQUEST DDD_IFExchangeBegin   (DDD::DDDContext& context, DDD_IF,                    size_t, ComProcPtr2,ComProcPtr2);
+DDD_IF_REQUEST DDD_IFOnewayBegin     (DDD::DDDContext& context, DDD_IF,         DDD_IF_DIR,size_t, ComProcPtr2,ComProcPtr2);
+DDD_IF_REQUEST DDD_IFAExchangeBegin  (DDD::DDDContext& context, DDD_IF,DDD_ATTR,           size_t, ComProcPtr2,ComProcPtr2);
+DDD_IF_REQUEST DDD_IFAOnewayBegin    (DDD::DDDContext& context, DDD_IF,DDD_ATTR,DDD_IF_DIR,size_t, ComProcPtr2,ComProcPtr2);
+DDD_IF_REQUEST DDD_IFExchangeXBegin  (DDD::DDDContext& context, DDD_IF,                    size_t, ComProcXPtr,ComProcXPtr);
+DDD_IF_REQUEST DDD_IFOnewayXBegin    (DDD::DDDContext& context, DDD_IF,         DDD_IF_DIR,size_t, ComProcXPtr,ComProcXPtr);
+DDD_IF_REQUEST DDD_IFAExchangeXBegin (DDD::DDDContext& context, DDD_IF,DDD_ATTR,           size_t, ComProcXPtr,ComProcXPtr);
+DDD_IF_REQUEST DDD_IFAOnewayXBegin   (DDD::DDDContext& context, DDD_IF,DDD_ATTR,DDD_IF_DIR,size_t, ComProcXPtr,ComProcXPtr);
+void     DDD_IFExchangeEnd    (DDD::DDDContext& context, DDD_IF_REQUEST&);
+void     DDD_IFOnewayEnd      (DDD::DDDContext& context, DDD_IF_REQUEST&);
+void     DDD_IFAExchangeEnd   (DDD::DDDContext& context, DDD_IF_REQUEST&);
+void     DDD_IFAOnewayEnd     (DDD::DDDContext& context, DDD_IF_REQUEST&);
+void     DDD_IFExchangeXEnd   (DDD::DDDContext& context, DDD_IF_REQUEST&);
+void     DDD_IFOnewayXEnd     (DDD::DDDContext& context, DDD_IF_REQUEST&);
+void     DDD_IFAExchangeXEnd  (DDD::DDDContext& context, DDD_IF_REQUEST&);
+void     DDD_IFAOnewayXEnd    (DDD::DDDContext& context, DDD_IF_REQUEST&);
+
+/* variable size per item, the size of each item is sent along with its data */
+void     DDD_IFExchangeV  (DDD::DDDContext& context, DDD_IF,           ComProcSizePtr,ComProcPtr2,ComProcVPtr);
+void     DDD_IFOnewayV    (DDD::DDDContext& context, DDD_IF,DDD_IF_DIR,ComProcSizePtr,ComProcPtr2,ComProcVPtr);
+
 /*
         Transfer Environment Module
  */
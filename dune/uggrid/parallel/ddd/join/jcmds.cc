@@ -129,6 +129,7 @@ static int PreparePhase1Msgs (DDD::DDDContext& context, std::vector<JIJoin*>& ar
                  "cannot join " << OBJ_GID(itemsJ[i]->hdr)
                  << ", object already distributed");
 
+    ddd_GidIndexErase(context, itemsJ[i]->hdr);
     OBJ_GID(itemsJ[i]->hdr) = GID_INVALID;
   }
 
@@ -145,6 +146,7 @@ static int PreparePhase1Msgs (DDD::DDDContext& context, std::vector<JIJoin*>& ar
                  "for local object " << local_gid);
 
     OBJ_GID(itemsJ[i]->hdr) = itemsJ[i]->new_gid;
+    ddd_GidIndexInsert(context, itemsJ[i]->hdr);
   }
 
 
@@ -280,13 +282,13 @@ static void UnpackPhase1Msgs (DDD::DDDContext& context,
         /* generate phase2-JIAddCpl for this object */
         for(cpl=ObjCplList(context, localCplObjs[j]); cpl!=NULL; cpl=CPL_NEXT(cpl))
         {
-          JIAddCpl *ji = JIAddCplSet_NewItem(reinterpret_cast<JIAddCplSet*>(ctx.setJIAddCpl2));
+          JIAddCpl *ji = ctx.setJIAddCpl2->newItem();
           ji->dest    = CPL_PROC(cpl);
           ji->te.gid  = theJoin[i].gid;
           ji->te.proc = LC_MsgGetProc(jm);
           ji->te.prio = theJoin[i].prio;
 
-          if (! JIAddCplSet_ItemOK(reinterpret_cast<JIAddCplSet*>(ctx.setJIAddCpl2)))
+          if (! ctx.setJIAddCpl2->itemOK())
             continue;
 
 #                                       if DebugJoin<=1
@@ -300,13 +302,13 @@ static void UnpackPhase1Msgs (DDD::DDDContext& context,
         /* send phase3-JIAddCpl back to Join-proc */
         for(cpl=ObjCplList(context, localCplObjs[j]); cpl!=NULL; cpl=CPL_NEXT(cpl))
         {
-          JIAddCpl *ji = JIAddCplSet_NewItem(reinterpret_cast<JIAddCplSet*>(ctx.setJIAddCpl3));
+          JIAddCpl *ji = ctx.setJIAddCpl3->newItem();
           ji->dest    = LC_MsgGetProc(jm);
           ji->te.gid  = OBJ_GID(localCplObjs[j]);
           ji->te.proc = CPL_PROC(cpl);
           ji->te.prio = cpl->prio;
 
-          if (! JIAddCplSet_ItemOK(reinterpret_cast<JIAddCplSet*>(ctx.setJIAddCpl3)))
+          if (! ctx.setJIAddCpl3->itemOK())
             continue;
         }
       }
@@ -347,13 +349,13 @@ static void UnpackPhase1Msgs (DDD::DDDContext& context,
 
       /* send one phase3-JIAddCpl for symmetric connection */
       {
-        JIAddCpl *ji = JIAddCplSet_NewItem(reinterpret_cast<JIAddCplSet*>(ctx.setJIAddCpl3));
+        JIAddCpl *ji = ctx.setJIAddCpl3->newItem();
         ji->dest    = LC_MsgGetProc(jm);
         ji->te.gid  = OBJ_GID(theJoin[i].hdr);
         ji->te.proc = me;
         ji->te.prio = OBJ_PRIO(theJoin[i].hdr);
 
-        JIAddCplSet_ItemOK(reinterpret_cast<JIAddCplSet*>(ctx.setJIAddCpl3));
+        ctx.setJIAddCpl3->itemOK();
       }
 
       joinObjs[jo].hdr  = theJoin[i].hdr;
@@ -538,12 +540,12 @@ static void UnpackPhase2Msgs (DDD::DDDContext& context,
 
         while ((jo<nJoinObjs) && (OBJ_GID(joinObjs[jo].hdr) == theAC[i].gid))
         {
-          JIAddCpl *ji = JIAddCplSet_NewItem(reinterpret_cast<JIAddCplSet*>(ctx.setJIAddCpl3));
+          JIAddCpl *ji = ctx.setJIAddCpl3->newItem();
           ji->dest    = joinObjs[jo].proc;
           ji->te.gid  = theAC[i].gid;
           ji->te.proc = theAC[i].proc;
           ji->te.prio = theAC[i].prio;
-          JIAddCplSet_ItemOK(reinterpret_cast<JIAddCplSet*>(ctx.setJIAddCpl3));
+          ctx.setJIAddCpl3->itemOK();
 
 
 #                                       if DebugJoin<=1
@@ -786,8 +788,8 @@ DDD_RET DDD_JoinEnd(DDD::DDDContext& context)
           PREPARATION PHASE
    */
   /* get sorted array of JIJoin-items */
-  std::vector<JIJoin*> arrayJIJoin = JIJoinSet_GetArray(reinterpret_cast<JIJoinSet*>(ctx.setJIJoin));
-  obsolete = JIJoinSet_GetNDiscarded(reinterpret_cast<JIJoinSet*>(ctx.setJIJoin));
+  std::vector<JIJoin*> arrayJIJoin = ctx.setJIJoin->getArray();
+  obsolete = ctx.setJIJoin->nDiscarded();
 
 
   /*
@@ -823,7 +825,7 @@ DDD_RET DDD_JoinEnd(DDD::DDDContext& context)
   {
     if (DDD_GetOption(context, OPT_INFO_JOIN) & JOIN_SHOW_OBSOLETE)
     {
-      int all = JIJoinSet_GetNItems(reinterpret_cast<JIJoinSet*>(ctx.setJIJoin));
+      int all = ctx.setJIJoin->size();
 
       using std::setw;
       Dune::dwarn
@@ -900,7 +902,7 @@ DDD_RET DDD_JoinEnd(DDD::DDDContext& context)
           for which Joins had been issued remotely.
    */
   /* get sorted array of JIAddCpl-items */
-  std::vector<JIAddCpl*> arrayJIAddCpl2 = JIAddCplSet_GetArray(reinterpret_cast<JIAddCplSet*>(ctx.setJIAddCpl2));
+  std::vector<JIAddCpl*> arrayJIAddCpl2 = ctx.setJIAddCpl2->getArray();
 
   STAT_RESET;
   /* prepare msgs for JIAddCpl-items */
@@ -1010,7 +1012,7 @@ DDD_RET DDD_JoinEnd(DDD::DDDContext& context)
           on which the JoinObj-commands have been issued.
    */
   /* get sorted array of JIAddCpl-items */
-  std::vector<JIAddCpl*> arrayJIAddCpl3 = JIAddCplSet_GetArray(reinterpret_cast<JIAddCplSet*>(ctx.setJIAddCpl3));
+  std::vector<JIAddCpl*> arrayJIAddCpl3 = ctx.setJIAddCpl3->getArray();
 
   STAT_RESET;
   /* prepare msgs for JIAddCpl-items */
@@ -1099,11 +1101,11 @@ DDD_RET DDD_JoinEnd(DDD::DDDContext& context)
   /*
           free temporary storage
    */
-  JIJoinSet_Reset(reinterpret_cast<JIJoinSet*>(ctx.setJIJoin));
+  ctx.setJIJoin->clear();
 
-  JIAddCplSet_Reset(reinterpret_cast<JIAddCplSet*>(ctx.setJIAddCpl2));
+  ctx.setJIAddCpl2->clear();
 
-  JIAddCplSet_Reset(reinterpret_cast<JIAddCplSet*>(ctx.setJIAddCpl3));
+  ctx.setJIAddCpl3->clear();
 
   if (joinObjs!=NULL)
     delete[] joinObjs;
@@ -1175,12 +1177,12 @@ void DDD_JoinObj(DDD::DDDContext& context, DDD_HDR hdr, DDD_PROC dest, DDD_GID n
 
 
 
-  JIJoin* ji = JIJoinSet_NewItem(reinterpret_cast<JIJoinSet*>(ctx.setJIJoin));
+  JIJoin* ji = ctx.setJIJoin->newItem();
   ji->hdr     = hdr;
   ji->dest    = dest;
   ji->new_gid = new_gid;
 
-  if (! JIJoinSet_ItemOK(reinterpret_cast<JIJoinSet*>(ctx.setJIJoin)))
+  if (! ctx.setJIJoin->itemOK())
     return;
 
 #       if DebugJoin<=2
@@ -43,18 +43,6 @@
 
 USING_UG_NAMESPACE
 
-  START_UGDIM_NAMESPACE
-
-/*
-        NOTE: all container-classes from ooppcc.h are implemented in this
-              source file by setting the following define.
- */
-#define ContainerImplementation
-#define _CHECKALLOC(ptr)   assert(ptr!=NULL)
-
-
-END_UGDIM_NAMESPACE
-
 #include "join.h"
 
 START_UGDIM_NAMESPACE
@@ -88,6 +76,26 @@ int Method(Compare) (ClassPtr item1, ClassPtr item2, const DDD::DDDContext*)
 }
 
 
+/*
+        key order of the compare-method without merging,
+        for sorting the JIJoin-items.
+ */
+bool Method(Less) (const Class *item1, const Class *item2)
+{
+  if (item1->dest != item2->dest) return(item1->dest < item2->dest);
+  return(item1->new_gid < item2->new_gid);
+}
+
+
+/*
+        hash-method for finding double JIJoin-items.
+ */
+std::size_t Method(Hash) (const Class *item)
+{
+  return std::size_t(item->new_gid) ^ (std::size_t(item->dest) * 2654435761u);
+}
+
+
 void Method(Print) (ParamThis _PRINTPARAMS)
 {
   fprintf(fp, "JIJoin local_gid=" OBJ_GID_FMT " dest=%d new_gid=" DDD_GID_FMT "\n",
@@ -124,6 +132,29 @@ int Method(Compare) (ClassPtr item1, ClassPtr item2, const DDD::DDDContext*)
 }
 
 
+/*
+        key order of the compare-method without merging,
+        for sorting the JIAddCpl-items.
+ */
+bool Method(Less) (const Class *item1, const Class *item2)
+{
+  if (item1->dest != item2->dest) return(item1->dest < item2->dest);
+  if (item1->te.gid != item2->te.gid) return(item1->te.gid < item2->te.gid);
+  return(item1->te.proc < item2->te.proc);
+}
+
+
+/*
+        hash-method for finding double JIAddCpl-items.
+ */
+std::size_t Method(Hash) (const Class *item)
+{
+  return std::size_t(item->te.gid)
+         ^ (std::size_t(item->dest) * 2654435761u)
+         ^ (std::size_t(item->te.proc) * 40503u);
+}
+
+
 void Method(Print) (ParamThis _PRINTPARAMS)
 {
   fprintf(fp, "JIAddCpl gid=" DDD_GID_FMT " dest=%d proc=%d prio=%d\n",
@@ -217,9 +248,9 @@ void ddd_JoinInit(DDD::DDDContext& context)
   auto& ctx = context.joinContext();
 
   /* init control structures for JoinInfo-items in messages */
-  ctx.setJIJoin    = reinterpret_cast<DDD::Join::JIJoinSet*>(New_JIJoinSet());
-  ctx.setJIAddCpl2 = reinterpret_cast<DDD::Join::JIAddCplSet*>(New_JIAddCplSet());
-  ctx.setJIAddCpl3 = reinterpret_cast<DDD::Join::JIAddCplSet*>(New_JIAddCplSet());
+  ctx.setJIJoin    = new JIJoinSet(JIJoin_Compare, JIJoin_Less, JIJoin_Hash, &context);
+  ctx.setJIAddCpl2 = new JIAddCplSet(JIAddCpl_Compare, JIAddCpl_Less, JIAddCpl_Hash, &context);
+  ctx.setJIAddCpl3 = new JIAddCplSet(JIAddCpl_Compare, JIAddCpl_Less, JIAddCpl_Hash, &context);
 
   JoinSetMode(context, JoinMode::JMODE_IDLE);
 
@@ -241,9 +272,9 @@ void ddd_JoinExit(DDD::DDDContext& context)
 {
   auto& ctx = context.joinContext();
 
-  JIJoinSet_Free(reinterpret_cast<JIJoinSet*>(ctx.setJIJoin));
-  JIAddCplSet_Free(reinterpret_cast<JIAddCplSet*>(ctx.setJIAddCpl2));
-  JIAddCplSet_Free(reinterpret_cast<JIAddCplSet*>(ctx.setJIAddCpl3));
+  delete ctx.setJIJoin;
+  delete ctx.setJIAddCpl2;
+  delete ctx.setJIAddCpl3;
 }
 
 
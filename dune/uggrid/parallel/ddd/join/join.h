@@ -41,6 +41,7 @@
 
 #include <dune/uggrid/parallel/ddd/basic/lowcomm.h>
 #include <dune/uggrid/parallel/ddd/basic/oopp.h>    /* for object-orientated style via preprocessor */
+#include <dune/uggrid/parallel/ddd/basic/itemset.hh>
 
 /****************************************************************************/
 /*                                                                          */
@@ -92,33 +93,38 @@ enum class JoinMode : unsigned char {
 /*                                                                          */
 /****************************************************************************/
 
-START_UGDIM_NAMESPACE
-
-using JoinMode = DDD::Join::JoinMode;
+namespace DDD {
+namespace Join {
 
 /****************************************************************************/
 /* JIJoin: represents JoinObj command from application                      */
 /****************************************************************************/
 
+struct JIJoin
+{
+  DDD_HDR hdr;                  /* local obj for which the join is requested    */
+  DDD_PROC dest;                /* proc for joining                             */
+  DDD_GID new_gid;              /* gid of object on dest which should be joined */
+};
+
+} /* namespace Join */
+} /* namespace DDD */
+
+START_UGDIM_NAMESPACE
+
+using JoinMode = DDD::Join::JoinMode;
+using DDD::Join::JIJoin;
+
 #define ClassName JIJoin
-Class_Data_Begin
-DDD_HDR hdr;                    /* local obj for which the join is requested    */
-DDD_PROC dest;                  /* proc for joining                             */
-DDD_GID new_gid;                /* gid of object on dest which should be joined */
-Class_Data_End
 void Method(Print)   (DefThis _PRINTPARAMS);
 int  Method(Compare) (ClassPtr, ClassPtr, const DDD::DDDContext*);
-
+bool Method(Less) (const Class *, const Class *);
+std::size_t Method(Hash) (const Class *);
 #undef ClassName
 
-
-/* define container class */
-#ifndef SetOf  /* necessary for inline documentation only */
-#define SetOf          JIJoin
-#define Set_SegmSize   256
-#define Set_BTreeOrder 32
-#endif
-#include <dune/uggrid/parallel/ddd/basic/ooppcc.h>
+/* container class */
+using JIJoinSet = DDD::Basic::ItemSet<JIJoin>;
+typedef JIJoin *JIJoinPtr;
 
 
 
@@ -138,6 +144,10 @@ struct JIPartner
 /* JIAddCpl: remote command to add cpl for join-obj during phase 2          */
 /****************************************************************************/
 
+END_UGDIM_NAMESPACE
+namespace DDD {
+namespace Join {
+
 struct TEAddCpl
 {
   DDD_GID gid;                  /* gid of object to add coupling                */
@@ -147,24 +157,29 @@ struct TEAddCpl
 };
 
 
+struct JIAddCpl
+{
+  DDD_PROC dest;                /* receiver of this item                        */
+  TEAddCpl te;                  /* table entry (for message)                    */
+};
+
+} /* namespace Join */
+} /* namespace DDD */
+START_UGDIM_NAMESPACE
+
+using DDD::Join::TEAddCpl;
+using DDD::Join::JIAddCpl;
+
 #define ClassName JIAddCpl
-Class_Data_Begin
-DDD_PROC dest;                  /* receiver of this item                        */
-TEAddCpl te;                    /* table entry (for message)                    */
-Class_Data_End
 void Method(Print)   (DefThis _PRINTPARAMS);
 int  Method(Compare) (ClassPtr, ClassPtr, const DDD::DDDContext*);
-
+bool Method(Less) (const Class *, const Class *);
+std::size_t Method(Hash) (const Class *);
 #undef ClassName
 
-
-/* define container class */
-#ifndef SetOf  /* necessary for inline documentation only */
-#define SetOf          JIAddCpl
-#define Set_SegmSize   256
-#define Set_BTreeOrder 32
-#endif
-#include <dune/uggrid/parallel/ddd/basic/ooppcc.h>
+/* container class */
+using JIAddCplSet = DDD::Basic::ItemSet<JIAddCpl>;
+typedef JIAddCpl *JIAddCplPtr;
 
 
 
@@ -80,6 +80,9 @@ START_UGDIM_NAMESPACE
 
    960603 kb  enabled DDD_AttrSet, due to ug has to use it.
               (TODO remove this dangerous exception!)
+
+   the interfaces are not patched for attr changes of distributed
+   objects (see OPT_IF_INCREMENTAL), call DDD_IFRefreshAll afterwards.
  */
 
 void DDD_AttrSet (DDD_HDR hdr, DDD_ATTR attr)
@@ -36,6 +36,8 @@
 #include <cstdio>
 #include <cstring>
 #include <cassert>
+#include <algorithm>
+#include <iterator>
 
 #include <new>
 
@@ -56,6 +58,7 @@ using namespace PPIF;
 START_UGDIM_NAMESPACE
 
 using CplSegm = DDD::Mgr::CplSegm;
+using CplIndexEntry = DDD::Mgr::CplIndexEntry;
 
 /*
         the storage of COUPLING items is done with the following scheme:
@@ -178,9 +181,8 @@ static COUPLING *NewCoupling (DDD::DDDContext& context)
 }
 
 
-static void DisposeCoupling (DDD::DDDContext& context, COUPLING *cpl)
+static void FreeCoupling (DDD::DDDContext& context, COUPLING *cpl)
 {
-  auto& ctx = context.couplingContext();
   auto& mctx = context.cplmgrContext();
 
   if (CPLMEM(cpl)==CPLMEM_FREELIST)
@@ -192,8 +194,28 @@ static void DisposeCoupling (DDD::DDDContext& context, COUPLING *cpl)
   {
     FreeTmpReq(cpl, sizeof(COUPLING), TMEM_CPL);
   }
+}
+
+
+static void DisposeCoupling (DDD::DDDContext& context, COUPLING *cpl)
+{
+  auto& ctx = context.couplingContext();
+  auto& mctx = context.cplmgrContext();
 
   ctx.nCplItems -= 1;
+
+  if (mctx.trackDirty)
+  {
+    /* the interfaces still reference the coupling, keep it until
+       they have been patched. */
+    SETCPLDEAD(cpl, 1);
+    CPL_NEXT(cpl) = mctx.deadCpls;
+    mctx.deadCpls = cpl;
+    mctx.nDeadCpls++;
+    return;
+  }
+
+  FreeCoupling(context, cpl);
 }
 
 
@@ -220,6 +242,8 @@ static void IncreaseCplTabSize(DDD::DDDContext& context)
   /* allocate new coupling table */
   ctx.cplTable.resize(n);
   ctx.nCplTable.resize(n);
+  if (context.cplmgrContext().cplIndexActive)
+    context.cplmgrContext().cplIndex.resize(n);
 
   /* issue a warning in order to inform user */
   Dune::dwarn << "increased coupling table, now " << n << " entries\n";
@@ -228,6 +252,213 @@ static void IncreaseCplTabSize(DDD::DDDContext& context)
 }
 
 
+/****************************************************************************/
+/*                                                                          */
+/* coupling index                                                           */
+/*                                                                          */
+/* with option OPT_CPLMGR_INDEX, the CplManager keeps the couplings of each */
+/* object in an array sorted by proc, parallel to cplTable, and keeps the   */
+/* coupling list in the same order. AddCoupling, ModCoupling and            */
+/* DelCoupling then find a coupling and its predecessor in the list by      */
+/* binary search instead of walking the list.                               */
+/*                                                                          */
+/****************************************************************************/
+
+
+/* position of proc in the sorted index entries of an object */
+static std::vector<CplIndexEntry>::iterator
+CplIndexFind (std::vector<CplIndexEntry>& entries, DDD_PROC proc)
+{
+  return std::lower_bound(entries.begin(), entries.end(), proc,
+                          [](const CplIndexEntry& e, DDD_PROC p) { return e.proc < p; });
+}
+
+
+/*
+        find coupling of hdr with proc and its predecessor in the
+        coupling list. hdr must have couplings.
+ */
+static COUPLING *FindCoupling (DDD::DDDContext& context, DDD_HDR hdr,
+                               DDD_PROC proc, COUPLING **prev)
+{
+  auto& mctx = context.cplmgrContext();
+
+  if (mctx.cplIndexActive)
+  {
+    auto& entries = mctx.cplIndex[OBJ_INDEX(hdr)];
+    const auto it = CplIndexFind(entries, proc);
+    if (it == entries.end() || it->proc != proc)
+      return NULL;
+
+    *prev = (it != entries.begin()) ? std::prev(it)->cpl : NULL;
+    return it->cpl;
+  }
+
+  *prev = NULL;
+  for (COUPLING *cpl=IdxCplList(context, OBJ_INDEX(hdr)); cpl!=NULL; cpl=CPL_NEXT(cpl))
+  {
+    if (CPL_PROC(cpl)==proc)
+      return cpl;
+    *prev = cpl;
+  }
+  return NULL;
+}
+
+
+/*
+        link new coupling cpl into the coupling list of objIndex,
+        in front of the list or at its position in the index.
+ */
+static void LinkCoupling (DDD::DDDContext& context, int objIndex, COUPLING *cpl)
+{
+  auto& mctx = context.cplmgrContext();
+  COUPLING **link = &IdxCplList(context, objIndex);
+
+  if (mctx.cplIndexActive)
+  {
+    auto& entries = mctx.cplIndex[objIndex];
+    const auto it = CplIndexFind(entries, CPL_PROC(cpl));
+    if (it != entries.begin())
+      link = &CPL_NEXT(std::prev(it)->cpl);
+    entries.insert(it, {CPL_PROC(cpl), cpl});
+  }
+
+  CPL_NEXT(cpl) = *link;
+  *link = cpl;
+}
+
+
+/* remove cpl from the index of objIndex */
+static void CplIndexErase (DDD::DDDContext& context, int objIndex, COUPLING *cpl)
+{
+  auto& mctx = context.cplmgrContext();
+
+  if (!mctx.cplIndexActive)
+    return;
+
+  auto& entries = mctx.cplIndex[objIndex];
+  const auto it = CplIndexFind(entries, CPL_PROC(cpl));
+  if (it != entries.end() && it->cpl == cpl)
+    entries.erase(it);
+}
+
+
+/* the couplings of slot from have moved to slot to, the index of slot to is dropped */
+void ddd_CplIndexMoveSlot (DDD::DDDContext& context, int to, int from)
+{
+  auto& mctx = context.cplmgrContext();
+
+  if (!mctx.cplIndexActive)
+    return;
+
+  /* swap instead of move, so that slot from keeps the storage */
+  std::swap(mctx.cplIndex[to], mctx.cplIndex[from]);
+  mctx.cplIndex[from].clear();
+}
+
+
+void ddd_CplMgrIndex (DDD::DDDContext& context, bool active)
+{
+  auto& mctx = context.cplmgrContext();
+
+  mctx.cplIndex.clear();
+  mctx.cplIndexActive = active;
+  if (!active)
+    return;
+
+  const auto& ctx = context.couplingContext();
+  mctx.cplIndex.resize(ctx.cplTable.size());
+  for (int i=0; i < ctx.nCpls; i++)
+  {
+    auto& entries = mctx.cplIndex[i];
+    entries.reserve(IdxNCpl(context, i));
+    for (COUPLING *cpl=IdxCplList(context, i); cpl!=NULL; cpl=CPL_NEXT(cpl))
+      entries.push_back({CPL_PROC(cpl), cpl});
+    std::sort(entries.begin(), entries.end(),
+              [](const CplIndexEntry& a, const CplIndexEntry& b) { return a.proc < b.proc; });
+
+    /* relink the coupling list in the order of the index */
+    COUPLING **link = &IdxCplList(context, i);
+    for (const auto& e : entries)
+    {
+      *link = e.cpl;
+      link = &CPL_NEXT(e.cpl);
+    }
+    *link = NULL;
+  }
+}
+
+
+
+
+/****************************************************************************/
+/*                                                                          */
+/* tracking of changed couplings                                            */
+/*                                                                          */
+/* with option OPT_IF_INCREMENTAL, the CplManager remembers the couplings   */
+/* which changed since the interfaces were built. new couplings and those   */
+/* whose own priority or whose object's priority or attr changed are        */
+/* marked dirty. deleted couplings are marked dead and kept until the       */
+/* interfaces have been patched, see IFAllFromScratch.                      */
+/*                                                                          */
+/****************************************************************************/
+
+void ddd_CplDirty (const DDD::DDDContext& context, COUPLING *cpl)
+{
+  const auto& mctx = context.cplmgrContext();
+
+  if (mctx.trackDirty && !CPLDIRTY(cpl))
+  {
+    SETCPLDIRTY(cpl, 1);
+    mctx.dirtyCpls.push_back(cpl);
+  }
+}
+
+
+/* mark all couplings of an object, its priority or attr has changed */
+void ddd_ObjCplDirty (const DDD::DDDContext& context, DDD_HDR hdr)
+{
+  if (!context.cplmgrContext().trackDirty)
+    return;
+
+  for (COUPLING *cpl=ObjCplList(context, hdr); cpl!=NULL; cpl=CPL_NEXT(cpl))
+    ddd_CplDirty(context, cpl);
+}
+
+
+/* forget all changes, the interfaces are up to date now */
+void ddd_CplMgrCleanDirty (DDD::DDDContext& context)
+{
+  auto& mctx = context.cplmgrContext();
+
+  for (COUPLING *cpl : mctx.dirtyCpls)
+    SETCPLDIRTY(cpl, 0);
+  mctx.dirtyCpls.clear();
+
+  COUPLING *cpl = mctx.deadCpls;
+  while (cpl!=NULL)
+  {
+    COUPLING *next = CPL_NEXT(cpl);
+    FreeCoupling(context, cpl);
+    cpl = next;
+  }
+  mctx.deadCpls = nullptr;
+  mctx.nDeadCpls = 0;
+
+  mctx.dirtyComplete = mctx.trackDirty;
+}
+
+
+void ddd_CplMgrTrackDirty (DDD::DDDContext& context, bool active)
+{
+  auto& mctx = context.cplmgrContext();
+
+  ddd_CplMgrCleanDirty(context);
+
+  /* changes before now are unknown, the next rebuild starts from scratch */
+  mctx.trackDirty = active;
+  mctx.dirtyComplete = false;
+}
 
 
 /****************************************************************************/
@@ -293,6 +524,7 @@ COUPLING *AddCoupling(DDD::DDDContext& context, DDD_HDR hdr, DDD_PROC proc, DDD_
     assert(freeCplIdx < context.objTable().size());
     objTable[freeCplIdx] = hdr;
     OBJ_INDEX(hdr)           = freeCplIdx;
+    ddd_GidIndexInsert(context, hdr);
 
     objIndex = freeCplIdx;
     IdxCplList(context, objIndex) = nullptr;
@@ -302,13 +534,13 @@ COUPLING *AddCoupling(DDD::DDDContext& context, DDD_HDR hdr, DDD_PROC proc, DDD_
   }
   else
   {
-    for(cp2=IdxCplList(context, objIndex); cp2!=NULL; cp2=CPL_NEXT(cp2))
+    COUPLING *prev;
+    cp2 = FindCoupling(context, hdr, proc, &prev);
+    if (cp2!=NULL)
     {
-      if (CPL_PROC(cp2)==proc)
-      {
-        cp2->prio = prio;
-        return(cp2);
-      }
+      cp2->prio = prio;
+      ddd_CplDirty(context, cp2);
+      return(cp2);
     }
   }
 
@@ -325,9 +557,9 @@ COUPLING *AddCoupling(DDD::DDDContext& context, DDD_HDR hdr, DDD_PROC proc, DDD_
   cp->prio = prio;
 
   /* insert into theCpl array */
-  CPL_NEXT(cp) = IdxCplList(context, objIndex);
-  IdxCplList(context, objIndex) = cp;
+  LinkCoupling(context, objIndex, cp);
   IdxNCpl(context, objIndex)++;
+  ddd_CplDirty(context, cp);
 
   return(cp);
 }
@@ -355,8 +587,6 @@ COUPLING *AddCoupling(DDD::DDDContext& context, DDD_HDR hdr, DDD_PROC proc, DDD_
 
 COUPLING *ModCoupling(DDD::DDDContext& context, DDD_HDR hdr, DDD_PROC proc, DDD_PRIO prio)
 {
-  int objIndex;
-
   assert(proc!=context.me());
 
 #       if DebugCoupling<=1
@@ -365,7 +595,6 @@ COUPLING *ModCoupling(DDD::DDDContext& context, DDD_HDR hdr, DDD_PROC proc, DDD_
 #       endif
 
   /* find or free position in coupling array */
-  objIndex = OBJ_INDEX(hdr);
   if (! ObjHasCpl(context, hdr))
   {
     /* there are no couplings for this object! */
@@ -375,13 +604,13 @@ COUPLING *ModCoupling(DDD::DDDContext& context, DDD_HDR hdr, DDD_PROC proc, DDD_
   else
   {
     /* look if coupling exists and change it */
-    for (COUPLING *cp2 = IdxCplList(context, objIndex); cp2 != NULL; cp2 = CPL_NEXT(cp2))
+    COUPLING *prev;
+    COUPLING *cp2 = FindCoupling(context, hdr, proc, &prev);
+    if (cp2!=NULL)
     {
-      if (CPL_PROC(cp2)==proc)
-      {
-        cp2->prio = prio;
-        return(cp2);
-      }
+      cp2->prio = prio;
+      ddd_CplDirty(context, cp2);
+      return(cp2);
     }
   }
 
@@ -415,53 +644,52 @@ void DelCoupling (DDD::DDDContext& context, DDD_HDR hdr, DDD_PROC proc)
 
   if (objIndex < ctx.nCpls)
   {
-    for(cpl=IdxCplList(context, objIndex), cplLast=NULL; cpl!=NULL; cpl=CPL_NEXT(cpl))
+    cpl = FindCoupling(context, hdr, proc, &cplLast);
+    if (cpl==NULL)
+      return;
+
+    CplIndexErase(context, objIndex, cpl);
+    if (cplLast==NULL)
     {
-      if(CPL_PROC(cpl)==proc)
-      {
-        if (cplLast==NULL)
-        {
-          IdxCplList(context, objIndex) = CPL_NEXT(cpl);
-        }
-        else {
-          CPL_NEXT(cplLast) = CPL_NEXT(cpl);
-        }
-#                               if DebugCoupling<=1
-        Dune::dvverb << "DelCoupling " << OBJ_GID(hdr) << " on proc=" << proc
-                     << ", now " << (IdxNCpl(context, objIndex)-1) << " cpls\n";
-#                               endif
-
-        DisposeCoupling(context, cpl);
-
-        IdxNCpl(context, objIndex)--;
-
-        if (IdxNCpl(context, objIndex)==0)
-        {
-          ctx.nCpls -= 1;
-
-                                        #ifdef WithFullObjectTable
-          OBJ_INDEX(hdr) = ctx.nCpls;
-          OBJ_INDEX(objTable[ctx.nCpls]) = objIndex;
-          objTable[objIndex] = objTable[ctx.nCpls];
-          objTable[ctx.nCpls] = hdr;
-                                        #else
-          /* we will not register objects without coupling,
-             so we have to forget about hdr and mark it as local. */
-          context.nObjs(context.nObjs() - 1);
-          assert(context.nObjs() == ctx.nCpls);
-
-          objTable[objIndex] = objTable[ctx.nCpls];
-          OBJ_INDEX(objTable[ctx.nCpls]) = objIndex;
-
-          MarkHdrLocal(hdr);
-                                        #endif
-
-          IdxCplList(context, objIndex) = IdxCplList(context, ctx.nCpls);
-          IdxNCpl(context, objIndex) = IdxNCpl(context, ctx.nCpls);
-        }
-        break;
-      }
-      cplLast = cpl;
+      IdxCplList(context, objIndex) = CPL_NEXT(cpl);
+    }
+    else {
+      CPL_NEXT(cplLast) = CPL_NEXT(cpl);
+    }
+#               if DebugCoupling<=1
+    Dune::dvverb << "DelCoupling " << OBJ_GID(hdr) << " on proc=" << proc
+                 << ", now " << (IdxNCpl(context, objIndex)-1) << " cpls\n";
+#               endif
+
+    DisposeCoupling(context, cpl);
+
+    IdxNCpl(context, objIndex)--;
+
+    if (IdxNCpl(context, objIndex)==0)
+    {
+      ctx.nCpls -= 1;
+
+                        #ifdef WithFullObjectTable
+      OBJ_INDEX(hdr) = ctx.nCpls;
+      OBJ_INDEX(objTable[ctx.nCpls]) = objIndex;
+      objTable[objIndex] = objTable[ctx.nCpls];
+      objTable[ctx.nCpls] = hdr;
+                        #else
+      /* we will not register objects without coupling,
+         so we have to forget about hdr and mark it as local. */
+      context.nObjs(context.nObjs() - 1);
+      assert(context.nObjs() == ctx.nCpls);
+
+      objTable[objIndex] = objTable[ctx.nCpls];
+      OBJ_INDEX(objTable[ctx.nCpls]) = objIndex;
+
+      ddd_GidIndexErase(context, hdr);
+      MarkHdrLocal(hdr);
+                        #endif
+
+      IdxCplList(context, objIndex) = IdxCplList(context, ctx.nCpls);
+      IdxNCpl(context, objIndex) = IdxNCpl(context, ctx.nCpls);
+      ddd_CplIndexMoveSlot(context, objIndex, ctx.nCpls);
     }
   }
 }
@@ -660,7 +888,9 @@ void ddd_CplMgrExit(DDD::DDDContext& context)
   auto& mctx = context.cplmgrContext();
 
   FreeFix(mctx.localIBuffer);
+  ddd_CplMgrCleanDirty(context);
   FreeCplSegms(context);
+  mctx.cplIndex.clear();
 
   ctx.cplTable.clear();
   ctx.nCplTable.clear();
@@ -328,6 +328,8 @@ if (MakeUnique(context, ctx.theIdCount) <= MakeUnique(context, ctx.theIdCount-1)
   DUNE_THROW(Dune::Exception, "global ID overflow DDD_HdrConstructor");
 }
 
+ddd_GidIndexInsert(context, aHdr);
+
 #       ifdef DebugCreation
   Dune::dinfo
     << "DDD_HdrConstructor(adr=" << aHdr << ", type=" << aType
@@ -400,6 +402,7 @@ void DDD_HdrDestructor(DDD::DDDContext& context, DDD_HDR hdr)
 
   /* formally, the object's GID should be returned here */
 
+  ddd_GidIndexErase(context, hdr);
 
   /* if currently in xfer, register deletion for other processors */
   if (xfer_active)
@@ -430,6 +433,7 @@ void DDD_HdrDestructor(DDD::DDDContext& context, DDD_HDR hdr)
     objTable[objIndex] = objTable[nCpls];
     IdxCplList(context, objIndex) = IdxCplList(context, nCpls);
     IdxNCpl(context, objIndex) = IdxNCpl(context, nCpls);
+    ddd_CplIndexMoveSlot(context, objIndex, nCpls);
     OBJ_INDEX(objTable[objIndex]) = objIndex;
 
                 #ifdef WithFullObjectTable
@@ -593,6 +597,8 @@ void DDD_HdrConstructorCopy (DDD::DDDContext& context, DDD_HDR newhdr, DDD_PRIO
   /* init LDATA components. GDATA components will be copied elsewhere */
   OBJ_PRIO(newhdr)  = prio;
 
+  ddd_GidIndexInsert(context, newhdr);
+
 
 #       ifdef DebugCreation
   Dune::dinfo
@@ -643,6 +649,7 @@ void DDD_HdrConstructorMove (DDD::DDDContext& context, DDD_HDR newhdr, DDD_HDR o
   if (objIndex < nCpls)
     objTable[objIndex] = newhdr;
         #endif
+  ddd_GidIndexInsert(context, newhdr);
 
   /* change pointers from couplings to object */
   if (objIndex < nCpls)
@@ -673,8 +680,8 @@ void DDD_HdrConstructorMove (DDD::DDDContext& context, DDD_HDR newhdr, DDD_HDR o
 /*            has been set up during StructRegister()).                     */
 /*                                                                          */
 /*            CopyByMask() is a support function doing the actual work.     */
-/*            This function could be more efficient by copying more than    */
-/*            one byte at a time.                                           */
+/*            It copies the runs of the mask with memcpy, only EL_GBITS     */
+/*            regions are copied bit by bit.                                */
 /*                                                                          */
 /* Input:     target: DDD_OBJ address of target memory                      */
 /*            source: DDD_OBJ address of source object                      */
@@ -687,23 +694,29 @@ void DDD_HdrConstructorMove (DDD::DDDContext& context, DDD_HDR newhdr, DDD_HDR o
 
 static void CopyByMask (TYPE_DESC *desc, DDD_OBJ target, DDD_OBJ source)
 {
-  unsigned char *s=(unsigned char *)source, *t=(unsigned char *)target;
-  int i;
-
 #       ifdef DebugCreation
   Dune::dinfo << "CopyByMask(" << desc->name << ", size=" << desc->size
               << ", to=" << target << ", from=" << source << ")\n";
 #       endif
 
-  unsigned char* maskp = desc->cmask.get();
-
   /* copy all bits set in cmask from source to target */
-  for(i=0; i<desc->size; i++)
+  for (const auto& run : desc->copyRuns)
   {
-    unsigned char negmask = *maskp^0xff;
-    *t = (*s & *maskp) | (*t & negmask);
+    unsigned char *s = (unsigned char *)source + run.offset;
+    unsigned char *t = (unsigned char *)target + run.offset;
+
+    if (!run.bitwise)
+    {
+      memcpy(t, s, run.size);
+      continue;
+    }
 
-    t++; s++; maskp++;              /* Paragon didn't manage postfix increment */
+    const unsigned char *maskp = desc->cmask.get() + run.offset;
+    for (std::size_t i=0; i<run.size; i++)
+    {
+      unsigned char negmask = maskp[i]^0xff;
+      t[i] = (s[i] & maskp[i]) | (t[i] & negmask);
+    }
   }
 }
 
@@ -737,14 +750,88 @@ void ObjCopyGlobalData (TYPE_DESC *desc,
 
 
 
+/****************************************************************************/
+/*                                                                          */
+/* GID index                                                                */
+/*                                                                          */
+/* with option OPT_OBJMGR_GID_INDEX, the ObjManager maps the GIDs of all    */
+/* objects registered in objTable to their DDD_HDRs. the index is updated   */
+/* whenever an object enters or leaves objTable (constructors, destructor,  */
+/* AddCoupling/DelCoupling) or changes its GID (Identify, Join).            */
+/*                                                                          */
 /****************************************************************************/
 
+static bool IsHdrRegistered (const DDD::DDDContext& context, DDD_HDR hdr)
+{
+  const auto objIndex = OBJ_INDEX(hdr);
+  return objIndex < (unsigned int) context.nObjs() && context.objTable()[objIndex] == hdr;
+}
+
+
+/* (re-)insert hdr with its current GID, if it is registered in objTable */
+void ddd_GidIndexInsert (DDD::DDDContext& context, DDD_HDR hdr)
+{
+  auto& ctx = context.objmgrContext();
+
+  if (ctx.gidIndexActive && IsHdrRegistered(context, hdr))
+    ctx.gidIndex[OBJ_GID(hdr)] = hdr;
+}
+
+
+/* remove hdr, must be called before its GID is changed */
+void ddd_GidIndexErase (DDD::DDDContext& context, DDD_HDR hdr)
+{
+  auto& ctx = context.objmgrContext();
+
+  if (!ctx.gidIndexActive)
+    return;
+
+  const auto it = ctx.gidIndex.find(OBJ_GID(hdr));
+  if (it != ctx.gidIndex.end() && it->second == hdr)
+    ctx.gidIndex.erase(it);
+}
+
+
+void ddd_ObjMgrGidIndex (DDD::DDDContext& context, bool active)
+{
+  auto& ctx = context.objmgrContext();
+  const auto& objTable = context.objTable();
+
+  ctx.gidIndex.clear();
+  ctx.gidIndexActive = active;
+  if (!active)
+    return;
+
+  ctx.gidIndex.reserve(context.nObjs());
+  for (int i=0; i < context.nObjs(); i++)
+    ctx.gidIndex[OBJ_GID(objTable[i])] = objTable[i];
+}
+
+
+/****************************************************************************/
+
+/**
+        Find the local copy of a distributed object.
+        Without option OPT_OBJMGR_GID_INDEX, this is a linear search
+        through all objects registered by DDD.
+
+   @param  gid  global ID of the object
+   @return its DDD_HDR, or NULL if there is no local copy
+ */
+
 DDD_HDR DDD_SearchHdr(DDD::DDDContext& context, DDD_GID gid)
 {
   auto& objTable = context.objTable();
   const int nObjs = context.nObjs();
+  const auto& ctx = context.objmgrContext();
 int i;
 
+if (ctx.gidIndexActive)
+{
+  const auto it = ctx.gidIndex.find(gid);
+  return (it != ctx.gidIndex.end()) ? it->second : NULL;
+}
+
 i=0;
 while (i < nObjs && OBJ_GID(objTable[i])!=gid)
   i++;
@@ -779,6 +866,7 @@ void ddd_ObjMgrInit(DDD::DDDContext& context)
 void ddd_ObjMgrExit(DDD::DDDContext& context)
 {
   context.objTable().clear();
+  ddd_ObjMgrGidIndex(context, false);
 }
 
 
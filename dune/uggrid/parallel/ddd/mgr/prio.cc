@@ -143,6 +143,7 @@ else
 
     /* change priority, nevertheless */
     OBJ_PRIO(hdr) = prio;
+    ddd_ObjCplDirty(context, hdr);
   }
 }
 }
@@ -0,0 +1,196 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************/
+/*                                                                          */
+/* File:      cplmgr-benchmark.cc                                           */
+/*                                                                          */
+/* Purpose:   AddCoupling, ModCoupling and DelCoupling for objects with     */
+/*            many copies, like vertices shared by many processors, with    */
+/*            and without the coupling index (option OPT_CPLMGR_INDEX)      */
+/*                                                                          */
+/*            usage: cplmgr-benchmark [number of objects] [copies]          */
+/*                                                                          */
+/****************************************************************************/
+
+#include <config.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/uggrid/parallel/ppif/ppifcontext.hh>
+#include <dune/uggrid/parallel/ddd/dddi.h>
+
+USING_UG_NAMESPACES
+
+using Clock = std::chrono::steady_clock;
+
+struct Object
+{
+  DDD_HEADER hdr;
+  int data;
+};
+
+/* the copies of every object live on procs me+1 ... me+copies */
+static int Check (DDD::DDDContext& context, std::vector<Object>& objects,
+                  int copies, int removed, DDD_PRIO prio)
+{
+  int errors = 0;
+  for (auto& object : objects)
+  {
+    std::vector<int> found(copies+1, 0);
+    for (auto&& [proc, p] : DDD_InfoProcListRange(context, &object.hdr, false))
+    {
+      const int k = proc - context.me();
+      if (k < 1 || k > copies || p != prio)
+        errors++;
+      else
+        found[k]++;
+    }
+    for (int k=1; k<=copies; k++)
+      errors += (found[k] != (k <= removed ? 0 : 1));
+  }
+  return errors;
+}
+
+/* check that the index holds size couplings and that the coupling list
+   of every object is in the order of its index */
+static int CheckIndex (DDD::DDDContext& context, std::size_t size)
+{
+  const auto& index = context.cplmgrContext().cplIndex;
+  const int nCpls = context.couplingContext().nCpls;
+
+  int errors = 0;
+  std::size_t count = 0;
+  for (std::size_t i=0; i<index.size(); i++)
+  {
+    const auto& entries = index[i];
+    count += entries.size();
+    if ((int) i >= nCpls)
+    {
+      errors += !entries.empty();
+      continue;
+    }
+
+    errors += (entries.size() != (std::size_t) IdxNCpl(context, i));
+    std::size_t k = 0;
+    for (const COUPLING *cpl=IdxCplList(context, i); cpl!=nullptr; cpl=CPL_NEXT(cpl), k++)
+      errors += (k >= entries.size() || cpl != entries[k].cpl || CPL_PROC(cpl) != entries[k].proc
+                 || (k>0 && entries[k-1].proc >= entries[k].proc));
+    errors += (k != entries.size());
+  }
+  return errors + (count != size);
+}
+
+/* one run of add, modify, delete and re-add for all objects */
+static double Run (DDD::DDDContext& context, std::vector<Object>& objects,
+                   const std::vector<int>& order, int& errors)
+{
+  const int copies = order.size();
+  const int me = context.me();
+
+  const auto start = Clock::now();
+  for (auto& object : objects)
+    for (int k : order)
+      AddCoupling(context, &object.hdr, me+k, 1);
+  for (auto& object : objects)
+    for (int k : order)
+      ModCoupling(context, &object.hdr, me+k, 2);
+  for (auto& object : objects)
+    for (int k=1; k<=copies/2; k++)
+      DelCoupling(context, &object.hdr, me+k);
+  const double time = std::chrono::duration<double>(Clock::now()-start).count();
+
+  errors += Check(context, objects, copies, copies/2, 2);
+
+  for (auto& object : objects)
+    for (int k=1; k<=copies/2; k++)
+      AddCoupling(context, &object.hdr, me+k, 2);
+  errors += Check(context, objects, copies, 0, 2);
+
+  /* remove all couplings again, objects become local */
+  for (auto& object : objects)
+    for (int k : order)
+      DelCoupling(context, &object.hdr, me+k);
+  errors += (context.couplingContext().nCplItems != 0);
+
+  return time;
+}
+
+int main (int argc, char **argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+
+  const int n = (argc>1) ? std::atoi(argv[1]) : 10000;
+  const int copies = (argc>2) ? std::atoi(argv[2]) : 64;
+
+  auto ppifContext = std::make_shared<PPIF::PPIFContext>();
+  DDD::DDDContext context(ppifContext, nullptr);
+  DDD_Init(context);
+  DDD_SetOption(context, OPT_WARNING_DESTRUCT_HDR, OPT_OFF);
+
+  DDD_TYPE type = DDD_TypeDeclare(context, "Object");
+  DDD_TypeDefine(context, type,
+                 EL_DDDHDR, offsetof(Object,hdr),
+                 EL_GDATA,  offsetof(Object,data), sizeof(int),
+                 EL_END,    sizeof(Object));
+
+  /* couplings are added in random processor order, as after a transfer.
+     no communication takes place. */
+  std::vector<Object> objects(n);
+  for (auto& object : objects)
+    DDD_HdrConstructor(context, &object.hdr, type, 0, 0);
+
+  std::mt19937 random(42);
+  std::vector<int> order(copies);
+  for (int k=0; k<copies; k++)
+    order[k] = k+1;
+  std::shuffle(order.begin(), order.end(), random);
+
+  int errors = 0;
+  const double listTime = Run(context, objects, order, errors);
+
+  DDD_SetOption(context, OPT_CPLMGR_INDEX, OPT_ON);
+  const double indexTime = Run(context, objects, order, errors);
+  errors += CheckIndex(context, 0);
+
+  const double ops = 2.5 * n * copies;
+  printf("%d objects with %d copies each\n", n, copies);
+  printf("coupling lists  %8.3f s  %12.0f ops/s\n", listTime, ops/std::max(listTime, 1e-9));
+  printf("coupling index  %8.3f s  %12.0f ops/s\n", indexTime, ops/std::max(indexTime, 1e-9));
+
+  /* the index follows moved and destructed headers, and can be
+     built for existing couplings */
+  for (auto& object : objects)
+    for (int k : order)
+      AddCoupling(context, &object.hdr, context.me()+k, 1);
+  DDD_SetOption(context, OPT_CPLMGR_INDEX, OPT_OFF);
+  DDD_SetOption(context, OPT_CPLMGR_INDEX, OPT_ON);
+  errors += CheckIndex(context, (std::size_t) n*copies);
+
+  Object moved;
+  DDD_HdrConstructorMove(context, &moved.hdr, &objects[0].hdr);
+  if (ModCoupling(context, &moved.hdr, context.me()+1, 3)->obj != &moved.hdr)
+    errors++;
+  DelCoupling(context, &moved.hdr, context.me()+copies);
+  errors += (DDD_InfoNCopies(context, &moved.hdr) != copies-1);
+  DDD_HdrDestructor(context, &moved.hdr);
+  errors += CheckIndex(context, (std::size_t) (n-1)*copies);
+
+  for (int i=1; i<n; i++)
+    DDD_HdrDestructor(context, &objects[i].hdr);
+  errors += CheckIndex(context, 0);
+
+  DDD_Exit(context);
+
+  if (errors)
+    printf("cplmgr-benchmark: %d errors\n", errors);
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************/
+/*                                                                          */
+/* File:      searchhdr-benchmark.cc                                        */
+/*                                                                          */
+/* Purpose:   lookup throughput of DDD_SearchHdr with and without the       */
+/*            GID index (option OPT_OBJMGR_GID_INDEX)                       */
+/*                                                                          */
+/*            usage: searchhdr-benchmark [number of objects]                */
+/*                                                                          */
+/****************************************************************************/
+
+#include <config.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/uggrid/parallel/ppif/ppifcontext.hh>
+#include <dune/uggrid/parallel/ddd/dddi.h>
+
+USING_UG_NAMESPACES
+
+using Clock = std::chrono::steady_clock;
+
+struct Object
+{
+  DDD_HEADER hdr;
+  int data;
+};
+
+int main (int argc, char **argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+
+  const int n = (argc>1) ? std::atoi(argv[1]) : 1000000;
+  /* the linear search is O(n) per lookup, so it gets fewer lookups */
+  const int nLinear = std::max(1, 100000000 / n);
+
+  auto ppifContext = std::make_shared<PPIF::PPIFContext>();
+  DDD::DDDContext context(ppifContext, nullptr);
+  DDD_Init(context);
+  DDD_SetOption(context, OPT_WARNING_DESTRUCT_HDR, OPT_OFF);
+
+  DDD_TYPE type = DDD_TypeDeclare(context, "Object");
+  DDD_TypeDefine(context, type,
+                 EL_DDDHDR, offsetof(Object,hdr),
+                 EL_GDATA,  offsetof(Object,data), sizeof(int),
+                 EL_END,    sizeof(Object));
+
+  /* DDD only registers distributed objects, so give every object a
+     coupling to some other processor. no communication takes place. */
+  std::vector<Object> objects(n);
+  for (auto& object : objects)
+  {
+    DDD_HdrConstructor(context, &object.hdr, type, 0, 0);
+    AddCoupling(context, &object.hdr, context.me()+1, 0);
+  }
+
+  /* gids in random order, the i-th gid belongs to object i % n */
+  std::mt19937 random(42);
+  std::vector<int> order(n);
+  for (int i=0; i<n; i++)
+    order[i] = i;
+  std::shuffle(order.begin(), order.end(), random);
+  std::vector<DDD_GID> gids(n);
+  for (int i=0; i<n; i++)
+    gids[i] = OBJ_GID(&objects[order[i]].hdr);
+
+  int errors = 0;
+
+  /* linear search, on a subset of the gids */
+  auto start = Clock::now();
+  for (int i=0; i<nLinear; i++)
+    if (DDD_SearchHdr(context, gids[i % n]) != &objects[order[i % n]].hdr)
+      errors++;
+  const double linearRate = nLinear / std::max(std::chrono::duration<double>(Clock::now()-start).count(), 1e-9);
+
+  /* indexed search */
+  start = Clock::now();
+  DDD_SetOption(context, OPT_OBJMGR_GID_INDEX, OPT_ON);
+  const double buildTime = std::chrono::duration<double>(Clock::now()-start).count();
+  start = Clock::now();
+  for (int i=0; i<n; i++)
+    if (DDD_SearchHdr(context, gids[i]) != &objects[order[i]].hdr)
+      errors++;
+  const double indexRate = n / std::max(std::chrono::duration<double>(Clock::now()-start).count(), 1e-9);
+
+  printf("%d objects\n", n);
+  printf("linear search %12.0f lookups/s (%d lookups)\n", linearRate, nLinear);
+  printf("GID index     %12.0f lookups/s (%d lookups, built in %.3fs)\n", indexRate, n, buildTime);
+
+  /* the index follows moved and destructed headers */
+  Object moved;
+  DDD_HdrConstructorMove(context, &moved.hdr, &objects[0].hdr);
+  if (DDD_SearchHdr(context, OBJ_GID(&moved.hdr)) != &moved.hdr)
+    errors++;
+  const DDD_GID gid = OBJ_GID(&moved.hdr);
+  DDD_HdrDestructor(context, &moved.hdr);
+  if (DDD_SearchHdr(context, gid) != nullptr)
+    errors++;
+
+  /* and objects losing their last coupling */
+  DelCoupling(context, &objects[1].hdr, context.me()+1);
+  if (DDD_SearchHdr(context, OBJ_GID(&objects[1].hdr)) != nullptr)
+    errors++;
+
+  for (int i=2; i<n; i++)
+    DDD_HdrDestructor(context, &objects[i].hdr);
+  if (context.objmgrContext().gidIndex.size() != 0)
+    errors++;
+
+  DDD_Exit(context);
+
+  if (errors)
+    printf("searchhdr-benchmark: %d errors\n", errors);
+  return errors ? 1 : 0;
+}
@@ -436,6 +436,22 @@ static void AttachMask(const DDD::DDDContext& context, TYPE_DESC *desc)
     }
   }
 
+  /* compress mask into runs, CopyByMask copies 0xff-runs with memcpy
+     and skips 0x00-runs; only EL_GBITS need bitwise copying */
+  const auto kind = [](unsigned char b) { return (b==0x00) ? 0 : (b==0xff) ? 1 : 2; };
+  desc->copyRuns.clear();
+  for (std::size_t i=0; i<desc->size; )
+  {
+    const unsigned char m = desc->cmask[i];
+    std::size_t k = i+1;
+    while (k<desc->size && kind(desc->cmask[k])==kind(m))
+      k++;
+
+    if (m!=0x00)
+      desc->copyRuns.push_back({i, k-i, kind(m)==2});
+    i = k;
+  }
+
 #       ifdef DebugCopyMask
   if (context.isMaster())
   {
@@ -906,6 +922,7 @@ static void InitHandlers (TYPE_DESC *desc)
   desc->handlerXFERGATHERX = NULL;
   desc->handlerXFERSCATTERX = NULL;
   desc->handlerXFERCOPYMANIP = NULL;
+  desc->handlerXFERALLOC = NULL;
 }
 
 #define DEFINE_DDD_SETHANDLER(name)                                     \
@@ -928,6 +945,7 @@ DEFINE_DDD_SETHANDLER(XFERSCATTER)
 DEFINE_DDD_SETHANDLER(XFERGATHERX)
 DEFINE_DDD_SETHANDLER(XFERSCATTERX)
 DEFINE_DDD_SETHANDLER(XFERCOPYMANIP)
+DEFINE_DDD_SETHANDLER(XFERALLOC)
 
 #undef DEFINE_DDD_SETHANDLER
 
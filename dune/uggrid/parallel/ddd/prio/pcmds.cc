@@ -195,6 +195,7 @@ void DDD_PrioChange (const DDD::DDDContext& context, DDD_HDR hdr, DDD_PRIO prio)
                     OBJ_PRIO(hdr) = newprio;
      */
     OBJ_PRIO(hdr) = prio;
+    ddd_ObjCplDirty(context, hdr);
   }
 
   /* handle distributed objects
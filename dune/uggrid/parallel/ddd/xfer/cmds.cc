@@ -39,6 +39,7 @@
 #include <cstdio>
 #include <cstring>
 
+#include <chrono>
 #include <iomanip>
 
 #include <dune/common/exceptions.hh>
@@ -78,11 +79,8 @@ using namespace PPIF;
 /****************************************************************************/
 
 
-static int sort_XIDelCmd (const void *e1, const void *e2)
+static int sort_XIDelCmd (const XIDelCmd *item1, const XIDelCmd *item2)
 {
-  XIDelCmd *item1 = *((XIDelCmd **)e1);
-  XIDelCmd *item2 = *((XIDelCmd **)e2);
-
   /* ascending GID is needed for ExecLocalXIDelCmds */
   if (OBJ_GID(item1->hdr) < OBJ_GID(item2->hdr)) return(-1);
   if (OBJ_GID(item1->hdr) > OBJ_GID(item2->hdr)) return(1);
@@ -91,11 +89,8 @@ static int sort_XIDelCmd (const void *e1, const void *e2)
 }
 
 
-static int sort_XIDelObj (const void *e1, const void *e2)
+static int sort_XIDelObj (const XIDelObj *item1, const XIDelObj *item2)
 {
-  XIDelObj *item1 = *((XIDelObj **)e1);
-  XIDelObj *item2 = *((XIDelObj **)e2);
-
   /* ascending GID is needed for ExecLocalXIDelObjs */
   if (item1->gid < item2->gid) return(-1);
   if (item1->gid > item2->gid) return(1);
@@ -104,11 +99,8 @@ static int sort_XIDelObj (const void *e1, const void *e2)
 }
 
 
-static int sort_XINewCpl (const void *e1, const void *e2)
+static int sort_XINewCpl (const XINewCpl *item1, const XINewCpl *item2)
 {
-  XINewCpl *item1 = *((XINewCpl **)e1);
-  XINewCpl *item2 = *((XINewCpl **)e2);
-
   /* receiving processor */
   if (item1->to < item2->to) return(-1);
   if (item1->to > item2->to) return(1);
@@ -118,10 +110,8 @@ static int sort_XINewCpl (const void *e1, const void *e2)
 
 
 
-static int sort_XIOldCpl (const void *e1, const void *e2)
+static int sort_XIOldCpl (const XIOldCpl *item1, const XIOldCpl *item2)
 {
-  XIOldCpl *item1 = *((XIOldCpl **)e1);
-  XIOldCpl *item2 = *((XIOldCpl **)e2);
   DDD_GID gid1, gid2;
 
   /* receiving processor */
@@ -139,10 +129,8 @@ static int sort_XIOldCpl (const void *e1, const void *e2)
 
 
 
-static int sort_XIDelCpl (const void *e1, const void *e2)
+static int sort_XIDelCpl (const XIDelCpl *item1, const XIDelCpl *item2)
 {
-  XIDelCpl *item1 = *((XIDelCpl **)e1);
-  XIDelCpl *item2 = *((XIDelCpl **)e2);
   DDD_GID gid1, gid2;
 
   /* receiving processor */
@@ -159,10 +147,8 @@ static int sort_XIDelCpl (const void *e1, const void *e2)
 }
 
 
-static int sort_XIModCpl (const void *e1, const void *e2)
+static int sort_XIModCpl (const XIModCpl *item1, const XIModCpl *item2)
 {
-  XIModCpl *item1 = *((XIModCpl **)e1);
-  XIModCpl *item2 = *((XIModCpl **)e2);
   DDD_GID gid1, gid2;
 
   /* receiving processor */
@@ -186,10 +172,8 @@ static int sort_XIModCpl (const void *e1, const void *e2)
 }
 
 
-static int sort_XIAddCpl (const void *e1, const void *e2)
+static int sort_XIAddCpl (const XIAddCpl *item1, const XIAddCpl *item2)
 {
-  XIAddCpl *item1 = *((XIAddCpl **)e1);
-  XIAddCpl *item2 = *((XIAddCpl **)e2);
   DDD_GID gid1, gid2;
 
   /* receiving processor */
@@ -289,7 +273,7 @@ static void DisplayMemResources(const DDD::DDDContext& context)
 {
   const auto& ctx = context.xferContext();
 
-  int nSegms=0, nItems=0, nNodes=0;
+  int nSegms=0, nItems=0;
   size_t memAllocated=0, memUsed=0;
 
   GetSizesXIAddData(context, &nSegms, &nItems, &memAllocated, &memUsed);
@@ -298,54 +282,22 @@ static void DisplayMemResources(const DDD::DDDContext& context)
            nSegms, nItems, (long)memAllocated, (long)memUsed);
 
 
-  XICopyObjSet_GetResources(reinterpret_cast<XICopyObjSet*>(ctx.setXICopyObj),
-                            &nSegms, &nItems, &nNodes, &memAllocated, &memUsed);
-  if (nSegms>0) {
-    printf("XferEnd, XICopyObj "
-           "segms=%d items=%d nodes=%d allocated=%ld used=%ld\n",
-           nSegms, nItems, nNodes, (long)memAllocated, (long)memUsed);
-  }
-
-
-        #ifdef XICOPYOBJ_DETAILED_RESOURCES
-  /* this is a different version, split up into BTree and SegmList */
-  XICopyObjSegmList_GetResources(reinterpret_cast<XICopyObjSet*>(ctx.setXICopyObj)->list,
-                                 &nSegms, &nItems, &memAllocated, &memUsed);
-  if (nSegms>0)
-    printf("XferEnd, XICopyObj segms=%d items=%d allocated=%ld used=%ld\n",
-           nSegms, nItems, (long)memAllocated, (long)memUsed);
-
-  XICopyObjBTree_GetResources(reinterpret_cast<XICopyObjSet*>(ctx.setXICopyObj)->tree,
-                              &nNodes, &nItems, &memAllocated, &memUsed);
-  if (nItems>0)
-    printf("XferEnd, XICopyObj nodes=%d items=%d allocated=%ld used=%ld\n",
-           nNodes, nItems, (long)memAllocated, (long)memUsed);
-        #endif
-
-
-  XISetPrioSet_GetResources(reinterpret_cast<XISetPrioSet*>(ctx.setXISetPrio),
-                            &nSegms, &nItems, &nNodes, &memAllocated, &memUsed);
-  if (nSegms>0) {
-    printf("XferEnd, XISetPrio "
-           "segms=%d items=%d nodes=%d allocated=%ld used=%ld\n",
-           nSegms, nItems, nNodes, (long)memAllocated, (long)memUsed);
-  }
-
-
-#define SLL_GET_SIZES(T) do {                                           \
-    GetSizes##T(context, &nSegms, &nItems, &memAllocated, &memUsed);    \
+#define GET_SIZES(T,container) do {                                    \
+    ctx.container->getResources(&nSegms, &nItems, &memAllocated, &memUsed); \
     if (nSegms>0)                                                       \
       printf("XferEnd, " #T "  segms=%d items=%d allocated=%ld used=%ld\n", \
              nSegms, nItems, (long)memAllocated, (long)memUsed);    \
   } while(false)
-  SLL_GET_SIZES(XIDelCmd);
-  SLL_GET_SIZES(XIDelObj);
-  SLL_GET_SIZES(XINewCpl);
-  SLL_GET_SIZES(XIOldCpl);
-  SLL_GET_SIZES(XIDelCpl);
-  SLL_GET_SIZES(XIModCpl);
-  SLL_GET_SIZES(XIAddCpl);
-#undef SLL_GET_SIZES
+  GET_SIZES(XICopyObj, setXICopyObj);
+  GET_SIZES(XISetPrio, setXISetPrio);
+  GET_SIZES(XIDelCmd, listXIDelCmd);
+  GET_SIZES(XIDelObj, listXIDelObj);
+  GET_SIZES(XINewCpl, listXINewCpl);
+  GET_SIZES(XIOldCpl, listXIOldCpl);
+  GET_SIZES(XIDelCpl, listXIDelCpl);
+  GET_SIZES(XIModCpl, listXIModCpl);
+  GET_SIZES(XIAddCpl, listXIAddCpl);
+#undef GET_SIZES
 }
 
 
@@ -371,23 +323,25 @@ DDD_RET DDD_XferEnd(DDD::DDDContext& context)
   DDD_RET ret_code              = DDD_RET_OK;
   XICopyObj   **arrayNewOwners      = NULL;
   int nNewOwners;
-  XIDelCmd    **arrayXIDelCmd       = NULL;
+  std::vector<XIDelCmd*> arrayXIDelCmd;
   int remXIDelCmd, prunedXIDelCmd;
-  XIDelObj    **arrayXIDelObj       = NULL;
+  std::vector<XIDelObj*> arrayXIDelObj;
   std::vector<XISetPrio*> arrayXISetPrio;
-  XINewCpl    **arrayXINewCpl       = NULL;
-  XIOldCpl    **arrayXIOldCpl       = NULL;
-  XIDelCpl    **arrayXIDelCpl       = NULL;
+  std::vector<XINewCpl*> arrayXINewCpl;
+  std::vector<XIOldCpl*> arrayXIOldCpl;
+  std::vector<XIDelCpl*> arrayXIDelCpl;
   int remXIDelCpl;
-  XIModCpl    **arrayXIModCpl       = NULL;
+  std::vector<XIModCpl*> arrayXIModCpl;
   int remXIModCpl;
-  XIAddCpl    **arrayXIAddCpl       = NULL;
+  std::vector<XIAddCpl*> arrayXIAddCpl;
   int obsolete, nRecvMsgs;
   XFERMSG     *sendMsgs=NULL, *sm=NULL;
   LC_MSGHANDLE *recvMsgs            = NULL;
   std::vector<DDD_HDR> localCplObjs;
   size_t sendMem=0, recvMem=0;
   int DelCmds_were_pruned;
+  std::chrono::steady_clock::time_point start;
+  double packTime=0.0, unpackTime=0.0;
 
   STAT_SET_MODULE(DDD_MODULE_XFER);
   STAT_ZEROALL;
@@ -405,14 +359,15 @@ DDD_RET DDD_XferEnd(DDD::DDDContext& context)
    */
   STAT_RESET;
   /* get sorted array of XICopyObj-items */
-  std::vector<XICopyObj*> arrayXICopyObj = XICopyObjSet_GetArray(reinterpret_cast<XICopyObjSet*>(ctx.setXICopyObj));
-  obsolete = XICopyObjSet_GetNDiscarded(reinterpret_cast<XICopyObjSet*>(ctx.setXICopyObj));
+  std::vector<XICopyObj*> arrayXICopyObj = ctx.setXICopyObj->getArray();
+  obsolete = ctx.setXICopyObj->nDiscarded();
 
   /* debugging output, write all XICopyObjs to file
-     if (XICopyObjSet_GetNItems(ctx.setXICopyObj)>0)
+     if (!arrayXICopyObj.empty())
      {
           FILE *ff = fopen("xfer.dump","w");
-          XICopyObjSet_Print(ctx.setXICopyObj, 2, ff);
+          for (XICopyObj *xi : arrayXICopyObj)
+            XICopyObj_Print(xi, 2, ff);
           fclose(ff);
      }
    */
@@ -435,19 +390,12 @@ DDD_RET DDD_XferEnd(DDD::DDDContext& context)
     /* create sorted array of XIDelCmd-items, and unify it */
     /* in case of pruning set to OPT_OFF, this sorting/unifying
        step is done lateron. */
-    arrayXIDelCmd = SortedArrayXIDelCmd(context, sort_XIDelCmd);
-    if (arrayXIDelCmd==NULL && ctx.nXIDelCmd>0)
-    {
-      Dune::dwarn << "out of memory in DDD_XferEnd(), giving up.\n";
-      ret_code = DDD_RET_ERROR_NOMEM;
-      LC_Abort(context, EXCEPTION_LOWCOMM_USER);
-      goto exit;
-    }
-    remXIDelCmd   = UnifyXIDelCmd(context, arrayXIDelCmd, unify_XIDelCmd);
-    obsolete += (ctx.nXIDelCmd-remXIDelCmd);
+    arrayXIDelCmd = ctx.listXIDelCmd->sortedArray(sort_XIDelCmd);
+    remXIDelCmd   = XIDelCmdList::unify(context, arrayXIDelCmd, unify_XIDelCmd);
+    obsolete += (ctx.listXIDelCmd->size()-remXIDelCmd);
 
     /* do communication and actual pruning */
-    prunedXIDelCmd = PruneXIDelCmd(context, arrayXIDelCmd, remXIDelCmd, arrayXICopyObj);
+    prunedXIDelCmd = PruneXIDelCmd(context, arrayXIDelCmd.data(), remXIDelCmd, arrayXICopyObj);
     obsolete += prunedXIDelCmd;
     remXIDelCmd -= prunedXIDelCmd;
 
@@ -479,33 +427,16 @@ DDD_RET DDD_XferEnd(DDD::DDDContext& context)
     goto exit;
   }
 
-  /* create sorted array of XINewCpl- and XIOldCpl-items.
-     TODO. if efficiency is a problem here, use b-tree or similar
-           data structure to improve performance. */
-  arrayXINewCpl = SortedArrayXINewCpl(context, sort_XINewCpl);
-  if (arrayXINewCpl==NULL && ctx.nXINewCpl>0)
-  {
-    Dune::dwarn << "out of memory in DDD_XferEnd(), giving up.\n";
-    ret_code = DDD_RET_ERROR_NOMEM;
-    LC_Abort(context, EXCEPTION_LOWCOMM_USER);
-    goto exit;
-  }
-
-  arrayXIOldCpl = SortedArrayXIOldCpl(context, sort_XIOldCpl);
-  if (arrayXIOldCpl==NULL && ctx.nXIOldCpl>0)
-  {
-    Dune::dwarn << "out of memory in DDD_XferEnd(), giving up.\n";
-    ret_code = DDD_RET_ERROR_NOMEM;
-    LC_Abort(context, EXCEPTION_LOWCOMM_USER);
-    goto exit;
-  }
+  /* create sorted array of XINewCpl- and XIOldCpl-items. */
+  arrayXINewCpl = ctx.listXINewCpl->sortedArray(sort_XINewCpl);
+  arrayXIOldCpl = ctx.listXIOldCpl->sortedArray(sort_XIOldCpl);
 
 
   /* prepare msgs for objects and XINewCpl-items */
   PrepareObjMsgs(context,
                  arrayXICopyObj,
-                 arrayXINewCpl, ctx.nXINewCpl,
-                 arrayXIOldCpl, ctx.nXIOldCpl,
+                 arrayXINewCpl.data(), arrayXINewCpl.size(),
+                 arrayXIOldCpl.data(), arrayXIOldCpl.size(),
                  &sendMsgs, &sendMem);
 
 
@@ -550,6 +481,7 @@ DDD_RET DDD_XferEnd(DDD::DDDContext& context)
        will be able to shutdown safely, but other processors might hang. ***/
 
   STAT_RESET;
+  start = std::chrono::steady_clock::now();
   /* build obj msgs on sender side and start send */
   if (! IS_OK(XferPackMsgs(context, sendMsgs)))
   {
@@ -558,6 +490,7 @@ DDD_RET DDD_XferEnd(DDD::DDDContext& context)
     ret_code = DDD_RET_ERROR_UNKNOWN;
     goto exit;
   }
+  packTime = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
   STAT_TIMER(T_XFER_PACK_SEND);
 
   /*
@@ -566,23 +499,16 @@ DDD_RET DDD_XferEnd(DDD::DDDContext& context)
 
   /* create sorted array of XISetPrio-items, and unify it */
   STAT_RESET;
-  arrayXISetPrio = XISetPrioSet_GetArray(reinterpret_cast<XISetPrioSet*>(ctx.setXISetPrio));
-  obsolete += XISetPrioSet_GetNDiscarded(reinterpret_cast<XISetPrioSet*>(ctx.setXISetPrio));
+  arrayXISetPrio = ctx.setXISetPrio->getArray();
+  obsolete += ctx.setXISetPrio->nDiscarded();
 
 
   if (!DelCmds_were_pruned)
   {
     /* create sorted array of XIDelCmd-items, and unify it */
-    arrayXIDelCmd = SortedArrayXIDelCmd(context, sort_XIDelCmd);
-    if (arrayXIDelCmd==NULL && ctx.nXIDelCmd>0)
-    {
-      Dune::dwarn << "out of memory in DDD_XferEnd(), giving up.\n";
-      LC_Cleanup(context);
-      ret_code = DDD_RET_ERROR_NOMEM;
-      goto exit;
-    }
-    remXIDelCmd   = UnifyXIDelCmd(context, arrayXIDelCmd, unify_XIDelCmd);
-    obsolete += (ctx.nXIDelCmd-remXIDelCmd);
+    arrayXIDelCmd = ctx.listXIDelCmd->sortedArray(sort_XIDelCmd);
+    remXIDelCmd   = XIDelCmdList::unify(context, arrayXIDelCmd, unify_XIDelCmd);
+    obsolete += (ctx.listXIDelCmd->size()-remXIDelCmd);
   }
 
 
@@ -592,7 +518,7 @@ DDD_RET DDD_XferEnd(DDD::DDDContext& context)
   /* execute local commands */
   /* NOTE: messages have been build before in order to allow
            deletion of objects. */
-  ExecLocalXIDelCmd(context, arrayXIDelCmd,  remXIDelCmd);
+  ExecLocalXIDelCmd(context, arrayXIDelCmd.data(),  remXIDelCmd);
 
   /* now all XIDelObj-items have been created. these come from:
           1. application->DDD_XferDeleteObj->XIDelCmd->HdrDestructor->
@@ -602,13 +528,13 @@ DDD_RET DDD_XferEnd(DDD::DDDContext& context)
    */
 
   /* create sorted array of XIDelObj-items */
-  arrayXIDelObj = SortedArrayXIDelObj(context, sort_XIDelObj);
+  arrayXIDelObj = ctx.listXIDelObj->sortedArray(sort_XIDelObj);
 
   ExecLocalXISetPrio(context, arrayXISetPrio,
-                     arrayXIDelObj,  ctx.nXIDelObj,
+                     arrayXIDelObj.data(),  arrayXIDelObj.size(),
                      arrayNewOwners, nNewOwners);
   ExecLocalXIDelObj(context,
-                    arrayXIDelObj,  ctx.nXIDelObj,
+                    arrayXIDelObj.data(),  arrayXIDelObj.size(),
                     arrayNewOwners, nNewOwners);
 
 
@@ -616,9 +542,9 @@ DDD_RET DDD_XferEnd(DDD::DDDContext& context)
   {
     if (DDD_GetOption(context, OPT_INFO_XFER) & XFER_SHOW_OBSOLETE)
     {
-      int all = ctx.nXIDelObj+
-                XISetPrioSet_GetNItems(reinterpret_cast<XISetPrioSet*>(ctx.setXISetPrio))+
-                XICopyObjSet_GetNItems(reinterpret_cast<XICopyObjSet*>(ctx.setXICopyObj));
+      int all = ctx.listXIDelObj->size()+
+                ctx.setXISetPrio->size()+
+                ctx.setXICopyObj->size();
 
       using std::setw;
       Dune::dwarn
@@ -648,17 +574,16 @@ DDD_RET DDD_XferEnd(DDD::DDDContext& context)
   STAT_TIMER(T_XFER_WAIT_RECV);
 
 
-  /* display information about message buffer sizes */
-  if (DDD_GetOption(context, OPT_INFO_XFER) & XFER_SHOW_MEMUSAGE)
+  /* sum up sizes of receive mesg buffers */
+  if (DDD_GetOption(context, OPT_INFO_XFER) & (XFER_SHOW_MEMUSAGE|XFER_SHOW_THROUGHPUT))
   {
-    int k;
-
-    /* sum up sizes of receive mesg buffers */
-    for(k=0; k<nRecvMsgs; k++)
-    {
+    for(int k=0; k<nRecvMsgs; k++)
       recvMem += LC_GetBufferSize(recvMsgs[k]);
-    }
+  }
 
+  /* display information about message buffer sizes */
+  if (DDD_GetOption(context, OPT_INFO_XFER) & XFER_SHOW_MEMUSAGE)
+  {
     using std::setw;
     Dune::dwarn
       << "DDD MESG [" << setw(3) << me << "]: SHOW_MEM msgs "
@@ -683,36 +608,52 @@ DDD_RET DDD_XferEnd(DDD::DDDContext& context)
 
   /* unpack messages */
   STAT_RESET;
+  start = std::chrono::steady_clock::now();
   XferUnpack(context, recvMsgs, nRecvMsgs,
              localCplObjs.data(), nCpls,
              arrayXISetPrio,
-             arrayXIDelObj, ctx.nXIDelObj,
+             arrayXIDelObj.data(), arrayXIDelObj.size(),
              arrayXICopyObj,
              arrayNewOwners, nNewOwners);
   LC_Cleanup(context);
+  unpackTime = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
   STAT_TIMER(T_XFER_UNPACK);
 
+  /* display throughput of packing and unpacking the object messages */
+  if (DDD_GetOption(context, OPT_INFO_XFER) & XFER_SHOW_THROUGHPUT)
+  {
+    const auto MBperSec = [](std::size_t bytes, double seconds) {
+      return (seconds>0.0) ? 1e-6*bytes/seconds : 0.0;
+    };
+
+    using std::setw;
+    Dune::dwarn
+      << "DDD MESG [" << setw(3) << me << "]: SHOW_THROUGHPUT"
+      << std::fixed << std::setprecision(1)
+      << " pack=" << setw(9) << 1e-6*sendMem << " MB " << setw(8) << MBperSec(sendMem, packTime) << " MB/s"
+      << " unpack=" << setw(9) << 1e-6*recvMem << " MB " << setw(8) << MBperSec(recvMem, unpackTime) << " MB/s"
+      << std::defaultfloat << "\n";
+  }
+
   /* recreate sorted list of local coupled objects,
      old list might be corrupt due to creation of new objects */
   STAT_RESET;
   localCplObjs = LocalCoupledObjectsList(context);
 
 
-  /* create sorted array of XIDelCpl-, XIModCpl- and XIAddCpl-items.
-     TODO. if efficiency is a problem here, use b-tree or similar
-           data structure to improve performance. */
-  arrayXIDelCpl = SortedArrayXIDelCpl(context, sort_XIDelCpl);
-  arrayXIModCpl = SortedArrayXIModCpl(context, sort_XIModCpl);
-  arrayXIAddCpl = SortedArrayXIAddCpl(context, sort_XIAddCpl);
+  /* create sorted array of XIDelCpl-, XIModCpl- and XIAddCpl-items. */
+  arrayXIDelCpl = ctx.listXIDelCpl->sortedArray(sort_XIDelCpl);
+  arrayXIModCpl = ctx.listXIModCpl->sortedArray(sort_XIModCpl);
+  arrayXIAddCpl = ctx.listXIAddCpl->sortedArray(sort_XIAddCpl);
 
 
   /* some XIDelCpls have been invalidated by UpdateCoupling(),
      decrease list size to avoid sending them */
-  remXIDelCpl = ctx.nXIDelCpl;
+  remXIDelCpl = arrayXIDelCpl.size();
   while (remXIDelCpl>0 && arrayXIDelCpl[remXIDelCpl-1]->to == procs)
     remXIDelCpl--;
 
-  remXIModCpl   = UnifyXIModCpl(context, arrayXIModCpl, unify_XIModCpl);
+  remXIModCpl   = XIModCplList::unify(context, arrayXIModCpl, unify_XIModCpl);
   STAT_TIMER(T_XFER_PREP_CPL);
 
   /*
@@ -726,9 +667,9 @@ DDD_RET DDD_XferEnd(DDD::DDDContext& context)
 
   STAT_RESET;
   CommunicateCplMsgs(context,
-                     arrayXIDelCpl, remXIDelCpl,
-                     arrayXIModCpl, remXIModCpl,
-                     arrayXIAddCpl, ctx.nXIAddCpl,
+                     arrayXIDelCpl.data(), remXIDelCpl,
+                     arrayXIModCpl.data(), remXIModCpl,
+                     arrayXIAddCpl.data(), arrayXIAddCpl.size(),
                      localCplObjs.data(), nCpls);
   STAT_TIMER(T_XFER_CPLMSG);
 
@@ -738,34 +679,20 @@ DDD_RET DDD_XferEnd(DDD::DDDContext& context)
    */
 exit:
 
-  /* free temporary storage */
-  XICopyObjSet_Reset(reinterpret_cast<XICopyObjSet*>(ctx.setXICopyObj));
+  /* free temporary storage, the first segment of each list is kept */
+  ctx.setXICopyObj->clear();
 
   if (arrayNewOwners!=NULL) OO_Free (arrayNewOwners /*,0*/);
   FreeAllXIAddData(context);
 
-  XISetPrioSet_Reset(reinterpret_cast<XISetPrioSet*>(ctx.setXISetPrio));
-
-  if (arrayXIDelCmd!=NULL) OO_Free (arrayXIDelCmd /*,0*/);
-  FreeAllXIDelCmd(context);
-
-  if (arrayXIDelObj!=NULL) OO_Free (arrayXIDelObj /*,0*/);
-  FreeAllXIDelObj(context);
-
-  if (arrayXINewCpl!=NULL) OO_Free (arrayXINewCpl /*,0*/);
-  FreeAllXINewCpl(context);
-
-  if (arrayXIOldCpl!=NULL) OO_Free (arrayXIOldCpl /*,0*/);
-  FreeAllXIOldCpl(context);
-
-  if (arrayXIDelCpl!=NULL) OO_Free (arrayXIDelCpl /*,0*/);
-  FreeAllXIDelCpl(context);
-
-  if (arrayXIModCpl!=NULL) OO_Free (arrayXIModCpl /*,0*/);
-  FreeAllXIModCpl(context);
-
-  if (arrayXIAddCpl!=NULL) OO_Free (arrayXIAddCpl /*,0*/);
-  FreeAllXIAddCpl(context);
+  ctx.setXISetPrio->clear();
+  ctx.listXIDelCmd->clear();
+  ctx.listXIDelObj->clear();
+  ctx.listXINewCpl->clear();
+  ctx.listXIOldCpl->clear();
+  ctx.listXIDelCpl->clear();
+  ctx.listXIModCpl->clear();
+  ctx.listXIAddCpl->clear();
 
   for(; sendMsgs!=NULL; sendMsgs=sm)
   {
@@ -830,12 +757,12 @@ void DDD_XferPrioChange (DDD::DDDContext& context, DDD_HDR hdr, DDD_PRIO prio)
 {
   auto& ctx = context.xferContext();
 
-  XISetPrio *xi = XISetPrioSet_NewItem(reinterpret_cast<XISetPrioSet*>(ctx.setXISetPrio));
+  XISetPrio *xi = ctx.setXISetPrio->newItem();
   xi->hdr  = hdr;
   xi->gid  = OBJ_GID(hdr);
   xi->prio = prio;
 
-  if (! XISetPrioSet_ItemOK(reinterpret_cast<XISetPrioSet*>(ctx.setXISetPrio)))
+  if (! ctx.setXISetPrio->itemOK())
     return;
 
 #       if DebugXfer<=2
@@ -870,12 +797,12 @@ static void XferInitCopyInfo (DDD::DDDContext& context,
   if (dest==context.me())
   {
     /* XFER-C4: XferCopyObj degrades to SetPrio command */
-    XISetPrio *xi = XISetPrioSet_NewItem(reinterpret_cast<XISetPrioSet*>(ctx.setXISetPrio));
+    XISetPrio *xi = ctx.setXISetPrio->newItem();
     xi->hdr  = hdr;
     xi->gid  = OBJ_GID(hdr);
     xi->prio = prio;
 
-    if (! XISetPrioSet_ItemOK(reinterpret_cast<XISetPrioSet*>(ctx.setXISetPrio)))
+    if (! ctx.setXISetPrio->itemOK())
     {
       /* item has been inserted already, don't store it twice. */
       /* even don't call XFERCOPY-handler, this is a real API change! */
@@ -912,13 +839,13 @@ static void XferInitCopyInfo (DDD::DDDContext& context,
   else
   {
     /* this is a real transfer to remote proc */
-    XICopyObj  *xi = XICopyObjSet_NewItem(reinterpret_cast<XICopyObjSet*>(ctx.setXICopyObj));
+    XICopyObj  *xi = ctx.setXICopyObj->newItem();
     xi->hdr  = hdr;
     xi->gid  = OBJ_GID(hdr);
     xi->dest = dest;
     xi->prio = prio;
 
-    if (! XICopyObjSet_ItemOK(reinterpret_cast<XICopyObjSet*>(ctx.setXICopyObj)))
+    if (! ctx.setXICopyObj->itemOK())
     {
       /* item has been inserted already, don't store it twice. */
       /* even don't call XFERCOPY-handler, this is a real API change! */
@@ -1252,11 +1179,10 @@ bool DDD_XferWithAddData(const DDD::DDDContext& context)
 void DDD_XferDeleteObj (DDD::DDDContext& context, DDD_HDR hdr)
 {
   TYPE_DESC *desc =  &context.typeDefs()[OBJ_TYPE(hdr)];
-  XIDelCmd  *dc = NewXIDelCmd(context);
-
-  if (dc==NULL)
-    HARD_EXIT;
+  auto& list = *context.xferContext().listXIDelCmd;
+  XIDelCmd  *dc = list.newItem();
 
+  dc->n   = list.size();
   dc->hdr = hdr;
 
 #       if DebugXfer<=2
@@ -387,7 +387,7 @@ void CommunicateCplMsgs (
                                                  itemsAC, nAC);
 
   /* init communication topology */
-  int nRecvMsgs = LC_Connect(context, ctx.cplmsg_t);
+  LC_Connect(context, ctx.cplmsg_t);
 
   /* build and send messages */
   CplMsgSend(context, sendMsgs);
@@ -412,8 +412,11 @@ void CommunicateCplMsgs (
   }
 
 
-  /* communicate set of messages (send AND receive) */
-  LC_MSGHANDLE* recvMsgs = LC_Communicate(context);
+  /* communicate set of messages (send AND receive),
+     unpack each message as soon as possible */
+  LC_Communicate(context, [&](LC_MSGHANDLE xm) {
+    CplMsgUnpackSingle(context, xm, localCplObjs, nLCO);
+  });
 
 
   /* display information about recv-messages on lowcomm-level */
@@ -426,17 +429,6 @@ void CommunicateCplMsgs (
   }
 
 
-  for(int i=0; i<nRecvMsgs; i++)
-  {
-    CplMsgUnpackSingle(context, recvMsgs[i], localCplObjs, nLCO);
-
-    /*
-                    if (DDD_GetOption(context, OPT_DEBUG_XFERMESGS)==OPT_ON)
-                            CplMsgDisplay(context, "CR", recvMsgs[i]);
-     */
-  }
-
-
   /* cleanup low-comm layer */
   LC_Cleanup(context);
 }
@@ -43,16 +43,6 @@
 
 USING_UG_NAMESPACE
 
-/*
-        NOTE: all container-classes from ooppcc.h are implemented in this
-              source file by setting the following define.
- */
-#define ContainerImplementation
-/* this is the hardliner version, for debugging only
-   #define _CHECKALLOC(ptr)   assert(ptr!=NULL)
- */
-#define _CHECKALLOC(ptr)   if (ptr==NULL) return (NULL)
-
 #include "xfer.h"
 
 /****************************************************************************/
@@ -156,6 +146,27 @@ int Method(Compare) (ClassPtr item1, ClassPtr item2, const DDD::DDDContext* cont
 }
 
 
+/*
+        key order (dest,gid) of the compare-method without merging,
+        for sorting the XICopyObj-items.
+ */
+bool Method(Less) (const Class *item1, const Class *item2)
+{
+  if (item1->dest != item2->dest) return(item1->dest < item2->dest);
+  return(item1->gid < item2->gid);
+}
+
+
+/*
+        hash-method for finding double XICopyObj-items,
+        consistent with key (dest,gid) of the compare-method.
+ */
+std::size_t Method(Hash) (const Class *item)
+{
+  return std::size_t(item->gid) ^ (std::size_t(item->dest) * 2654435761u);
+}
+
+
 void Method(Print) (ParamThis _PRINTPARAMS)
 {
   fprintf(fp, "XICopyObj dest=%d gid=" DDD_GID_FMT " prio=%d\n",
@@ -216,51 +227,31 @@ int Method(Compare) (ClassPtr item1, ClassPtr item2, const DDD::DDDContext* cont
 }
 
 
-void Method(Print) (ParamThis _PRINTPARAMS)
+/*
+        key order (gid) of the compare-method without merging,
+        for sorting the XISetPrio-items.
+ */
+bool Method(Less) (const Class *item1, const Class *item2)
 {
-  fprintf(fp, "XISetPrio gid=" DDD_GID_FMT " prio=%d\n", This->gid, This->prio);
+  return(item1->gid < item2->gid);
 }
 
-#undef ClassName
-
-
-/****************************************************************************/
-
 
 /*
-    include templates
+        hash-method for finding double XISetPrio-items.
  */
-#define T XIDelCmd
-#define SLL_WithOrigOrder
-#include "sll.ct"
-#undef T
-
-#define T XIDelObj
-#include "sll.ct"
-#undef T
-
-#define T XINewCpl
-#include "sll.ct"
-#undef T
-
-#define T XIOldCpl
-#include "sll.ct"
-#undef T
-
-
-
-#define T XIAddCpl
-#include "sll.ct"
-#undef T
+std::size_t Method(Hash) (const Class *item)
+{
+  return std::size_t(item->gid);
+}
 
-#define T XIDelCpl
-#include "sll.ct"
-#undef T
 
-#define T XIModCpl
-#include "sll.ct"
-#undef T
+void Method(Print) (ParamThis _PRINTPARAMS)
+{
+  fprintf(fp, "XISetPrio gid=" DDD_GID_FMT " prio=%d\n", This->gid, This->prio);
+}
 
+#undef ClassName
 
 
 /****************************************************************************/
@@ -0,0 +1,172 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************/
+/*                                                                          */
+/* File:      unpack-benchmark.cc                                           */
+/*                                                                          */
+/* Purpose:   time DDD_XferEnd for a migration of many objects, once with   */
+/*            objects allocated one by one (DDD_ObjNew) and once with one   */
+/*            block per message from an XFERALLOC handler                   */
+/*                                                                          */
+/*            usage: unpack-benchmark [objects per processor] [repetitions] */
+/*                                                                          */
+/****************************************************************************/
+
+#include <config.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/uggrid/parallel/ppif/ppifcontext.hh>
+#include <dune/uggrid/parallel/ddd/dddi.h>
+
+USING_UG_NAMESPACES
+
+using Clock = std::chrono::steady_clock;
+
+static double SecondsSince (Clock::time_point start)
+{
+  return std::chrono::duration<double>(Clock::now()-start).count();
+}
+
+enum Prio { PrioMaster = 1, PrioGhost = 2 };
+
+/* the header comes first, so objects and headers have the same address */
+struct Object
+{
+  DDD_HEADER hdr;
+  Object *next;
+  double value[24];
+  int local;
+};
+
+/* memory of the received objects in XFERALLOC mode */
+static std::vector<std::unique_ptr<char[]> > blocks;
+
+static void ObjectXferAlloc (DDD::DDDContext&, DDD_TYPE, std::size_t size, int n, DDD_OBJ *objs)
+{
+  blocks.push_back(std::make_unique<char[]>(n*size));
+  for (int i=0; i<n; i++)
+    objs[i] = blocks.back().get() + i*size;
+}
+
+static void ObjectDelete (DDD::DDDContext& context, DDD_OBJ obj)
+{
+  DDD_HdrDestructor(context, &((Object *) obj)->hdr);
+}
+
+int main (int argc, char **argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+
+  const int n = (argc>1) ? std::atoi(argv[1]) : 200000;
+  const int repetitions = (argc>2) ? std::atoi(argv[2]) : 3;
+
+  auto ppifContext = std::make_shared<PPIF::PPIFContext>();
+  DDD::DDDContext context(ppifContext, nullptr);
+  DDD_Init(context);
+  DDD_SetOption(context, OPT_WARNING_DESTRUCT_HDR, OPT_OFF);
+  DDD_SetOption(context, OPT_IF_CREATE_EXPLICIT, OPT_ON);
+
+  DDD_TYPE type = DDD_TypeDeclare(context, "Object");
+  DDD_TypeDefine(context, type,
+                 EL_DDDHDR, offsetof(Object,hdr),
+                 EL_OBJPTR, offsetof(Object,next), sizeof(Object*), type,
+                 EL_GDATA,  offsetof(Object,value), sizeof(Object::value),
+                 EL_LDATA,  offsetof(Object,local), sizeof(int),
+                 EL_END,    sizeof(Object));
+
+  const int me = context.me();
+  const int procs = context.procs();
+  const DDD_PROC dest = (me+1)%procs;
+
+  /* a chain of objects, object i points to object i+1 */
+  std::vector<Object> objects(n);
+  for (int i=0; i<n; i++)
+  {
+    DDD_HdrConstructor(context, &objects[i].hdr, type, PrioMaster, 0);
+    objects[i].next = (i+1<n) ? &objects[i+1] : nullptr;
+    std::fill(objects[i].value, objects[i].value+24, double(i));
+    objects[i].local = -1;
+  }
+
+  int errors = 0;
+  const char *modes[] = {"DDD_ObjNew", "XFERALLOC"};
+  double time[2] = {1e100, 1e100};
+
+  for (int mode=0; mode<2; mode++)
+  {
+    DDD_SetHandlerXFERALLOC(context, type, mode ? ObjectXferAlloc : nullptr);
+    DDD_SetHandlerDELETE(context, type, mode ? ObjectDelete : nullptr);
+
+    for (int r=0; r<repetitions; r++)
+    {
+      DDD_SetOption(context, OPT_INFO_XFER,
+                    (r+1==repetitions) ? XFER_SHOW_THROUGHPUT : XFER_SHOW_NONE);
+
+      DDD_XferBegin(context);
+      for (auto& object : objects)
+        DDD_XferCopyObj(context, &object.hdr, dest, PrioGhost);
+      auto start = Clock::now();
+      DDD_XferEnd(context);
+      time[mode] = std::min(time[mode], SecondsSince(start));
+      DDD_SetOption(context, OPT_INFO_XFER, XFER_SHOW_NONE);
+
+      /* the copies form a chain again, with local data constructed */
+      std::vector<DDD_HDR> received;
+      for (int i=0; i<context.nObjs(); i++)
+      {
+        DDD_HDR hdr = context.objTable()[i];
+        if (hdr < &objects.front().hdr || hdr > &objects.back().hdr)
+          received.push_back(hdr);
+      }
+      if (procs>1)
+      {
+        errors += (int(received.size()) != n);
+        for (DDD_HDR hdr : received)
+        {
+          const Object *copy = (const Object *) hdr;
+          if (copy->next==nullptr)
+            errors += (copy->value[0] != n-1);
+          else
+            errors += (copy->next->value[23] != copy->value[0]+1);
+          errors += (copy->local != 0);
+        }
+      }
+
+      DDD_XferBegin(context);
+      for (DDD_HDR hdr : received)
+        DDD_XferDeleteObj(context, hdr);
+      DDD_XferEnd(context);
+      blocks.clear();
+
+      for (auto& object : objects)
+        OBJ_PRIO(&object.hdr) = PrioMaster;
+    }
+  }
+  errors += DDD_ConsCheck(context);
+
+  if (me==0)
+  {
+    printf("%d processors, %d objects of %d bytes per processor\n",
+           procs, n, int(sizeof(Object)));
+    for (int mode=0; mode<2; mode++)
+      printf("%-12s DDD_XferEnd %8.3f s  %7.1f MB/s\n", modes[mode], time[mode],
+             1e-6*n*sizeof(Object)/time[mode]);
+  }
+
+  for (auto& object : objects)
+    DDD_HdrDestructor(context, &object.hdr);
+  DDD_Exit(context);
+
+  if (errors)
+    printf("%d: unpack-benchmark: %d errors\n", me, errors);
+  return errors ? 1 : 0;
+}
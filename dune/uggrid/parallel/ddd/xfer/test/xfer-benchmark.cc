@@ -0,0 +1,161 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/****************************************************************************/
+/*                                                                          */
+/* File:      xfer-benchmark.cc                                             */
+/*                                                                          */
+/* Purpose:   time many DDD_XferCopyObj commands, some of them duplicates */
+/*            which are merged, the following DDD_XferEnd, and deleting     */
+/*            the copies again                                              */
+/*                                                                          */
+/*            usage: xfer-benchmark [objects per processor] [repetitions]   */
+/*                                  [shuffle]                               */
+/*                                                                          */
+/****************************************************************************/
+
+#include <config.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/uggrid/parallel/ppif/ppifcontext.hh>
+#include <dune/uggrid/parallel/ddd/dddi.h>
+
+USING_UG_NAMESPACES
+
+using Clock = std::chrono::steady_clock;
+
+static double SecondsSince (Clock::time_point start)
+{
+  return std::chrono::duration<double>(Clock::now()-start).count();
+}
+
+enum Prio { PrioMaster = 1, PrioGhost = 2 };
+
+/* the header comes first, so objects and headers have the same address */
+struct Object
+{
+  DDD_HEADER hdr;
+  double value[4];
+};
+
+/* objects in the table which are not in the local vector */
+static std::vector<DDD_HDR> Received (DDD::DDDContext& context, std::vector<Object>& objects)
+{
+  std::vector<DDD_HDR> received;
+  for (int i=0; i<context.nObjs(); i++)
+  {
+    DDD_HDR hdr = context.objTable()[i];
+    if (hdr < &objects.front().hdr || hdr > &objects.back().hdr)
+      received.push_back(hdr);
+  }
+  return received;
+}
+
+int main (int argc, char **argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+
+  const int n = (argc>1) ? std::atoi(argv[1]) : 1000000;
+  const int repetitions = (argc>2) ? std::atoi(argv[2]) : 3;
+  const bool shuffle = (argc>3) && std::atoi(argv[3]);
+
+  auto ppifContext = std::make_shared<PPIF::PPIFContext>();
+  DDD::DDDContext context(ppifContext, nullptr);
+  DDD_Init(context);
+  DDD_SetOption(context, OPT_WARNING_DESTRUCT_HDR, OPT_OFF);
+  DDD_SetOption(context, OPT_IF_CREATE_EXPLICIT, OPT_ON);
+
+  DDD_TYPE type = DDD_TypeDeclare(context, "Object");
+  DDD_TypeDefine(context, type,
+                 EL_DDDHDR, offsetof(Object,hdr),
+                 EL_GDATA,  offsetof(Object,value), sizeof(Object::value),
+                 EL_END,    sizeof(Object));
+
+  const int me = context.me();
+  const int procs = context.procs();
+  const DDD_PROC dest = (me+1)%procs;
+
+  std::vector<Object> objects(n);
+  for (auto& object : objects)
+    DDD_HdrConstructor(context, &object.hdr, type, PrioMaster, 0);
+
+  /* the order of the commands, by gid or random */
+  std::vector<int> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  if (shuffle)
+    std::shuffle(order.begin(), order.end(), std::mt19937(me));
+
+  int errors = 0;
+  double cmdTime = 1e100, copyTime = 1e100, deleteTime = 1e100;
+  const int nCmds = n + (n+3)/4;
+
+  for (int r=0; r<repetitions; r++)
+  {
+    /* copy every object to the next processor, every fourth object
+       twice with different priorities */
+    auto start = Clock::now();
+    DDD_XferBegin(context);
+    for (int i : order)
+    {
+      DDD_XferCopyObj(context, &objects[i].hdr, dest, PrioGhost);
+      if (i%4==0)
+        DDD_XferCopyObj(context, &objects[i].hdr, dest, PrioMaster);
+    }
+    cmdTime = std::min(cmdTime, SecondsSince(start));
+
+    start = Clock::now();
+    DDD_XferEnd(context);
+    copyTime = std::min(copyTime, SecondsSince(start));
+
+    const std::vector<DDD_HDR> received = Received(context, objects);
+    if (procs>1)
+    {
+      errors += (int(received.size()) != n);
+      for (auto& object : objects)
+        errors += (DDD_InfoNCopies(context, &object.hdr) != 1);
+    }
+    errors += DDD_ConsCheck(context);
+
+    /* delete the copies again */
+    DDD_XferBegin(context);
+    for (DDD_HDR hdr : received)
+      DDD_XferDeleteObj(context, hdr);
+    start = Clock::now();
+    DDD_XferEnd(context);
+    deleteTime = std::min(deleteTime, SecondsSince(start));
+
+    errors += !Received(context, objects).empty();
+    for (auto& object : objects)
+    {
+      errors += (DDD_InfoNCopies(context, &object.hdr) != 0);
+      OBJ_PRIO(&object.hdr) = PrioMaster;
+    }
+  }
+
+  if (me==0)
+  {
+    printf("%d processors, %d objects and %d copy commands per processor, %s\n",
+           procs, n, nCmds, shuffle ? "shuffled" : "ordered by gid");
+    printf("DDD_XferCopyObj     %8.3f s  %6.0f ns/command\n", cmdTime, 1e9*cmdTime/nCmds);
+    printf("DDD_XferEnd  copy   %8.3f s  %6.0f ns/command\n", copyTime, 1e9*copyTime/nCmds);
+    printf("DDD_XferEnd  delete %8.3f s  %6.0f ns/object\n", deleteTime, 1e9*deleteTime/n);
+  }
+
+  for (auto& object : objects)
+    DDD_HdrDestructor(context, &object.hdr);
+  DDD_Exit(context);
+
+  if (errors)
+    printf("%d: xfer-benchmark: %d errors\n", me, errors);
+  return errors ? 1 : 0;
+}
@@ -39,7 +39,10 @@
 
 #include <algorithm>
 #include <iomanip>
+#include <map>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 #include <dune/common/exceptions.hh>
 #include <dune/common/stdstreams.hh>
@@ -72,7 +75,7 @@ START_UGDIM_NAMESPACE
 
 static void NEW_AddCpl(DDD::DDDContext& context, DDD_PROC destproc, DDD_GID objgid, DDD_PROC cplproc, DDD_PRIO cplprio)
 {
-  XIAddCpl *xc = NewXIAddCpl(context);
+  XIAddCpl *xc = context.xferContext().listXIAddCpl->newItem();
   assert(xc);
   xc->to      = destproc;
   xc->te.gid  = objgid;
@@ -414,6 +417,66 @@ static void PutDepData (DDD::DDDContext& context,
 /****************************************************************************/
 
 
+/*
+        create local copies of the new objects of one message, in the
+        order of the message.
+
+        for types with an XFERALLOC handler the memory of all objects
+        of equal type and size is requested by one handler call, so
+        the objects of one message are adjacent in memory. the other
+        objects are allocated one by one via DDD_ObjNew.
+ */
+static void CreateNewObjects (DDD::DDDContext& context,
+                              const std::vector<OBJTAB_ENTRY*>& newObjs,
+                              const char *theObjects)
+{
+  struct Block
+  {
+    std::vector<DDD_OBJ> objs;
+    std::size_t next = 0;
+  };
+  std::map<std::pair<DDD_TYPE,std::size_t>, Block> blocks;
+
+  for (OBJTAB_ENTRY *ote : newObjs)
+    if (context.typeDefs()[OBJ_TYPE(ote->hdr)].handlerXFERALLOC)
+      blocks[std::make_pair(OBJ_TYPE(ote->hdr), ote->size)].objs.push_back(nullptr);
+
+  for (auto& [key, block] : blocks)
+    context.typeDefs()[key.first].handlerXFERALLOC(context, key.first, key.second,
+                                                   block.objs.size(), block.objs.data());
+
+  for (OBJTAB_ENTRY *ote : newObjs)
+  {
+    TYPE_DESC *desc = &context.typeDefs()[OBJ_TYPE(ote->hdr)];
+    DDD_PRIO new_prio = OBJ_PRIO(ote->hdr);
+    DDD_OBJ msgcopy, newcopy;
+
+    msgcopy = OTE_OBJ(context, theObjects,ote);
+    if (desc->handlerXFERALLOC)
+    {
+      Block& block = blocks[std::make_pair(OBJ_TYPE(ote->hdr), ote->size)];
+      newcopy = block.objs[block.next++];
+    }
+    else
+      newcopy = DDD_ObjNew(ote->size,
+                           OBJ_TYPE(ote->hdr), new_prio, OBJ_ATTR(ote->hdr));
+
+    /* overwrite pointer to hdr inside message */
+    ote->hdr = OBJ2HDR(newcopy,desc);
+
+    /* copy GDATA */
+    ObjCopyGlobalData(desc, newcopy, msgcopy, ote->size);
+
+    /* construct HDR */
+    DDD_HdrConstructorCopy(context, ote->hdr, new_prio);
+
+    /* construct LDATA */
+    if (desc->handlerLDATACONSTRUCTOR)
+      desc->handlerLDATACONSTRUCTOR(context, newcopy);
+  }
+}
+
+
 static void AcceptObjFromMsg (
   DDD::DDDContext& context,
   OBJTAB_ENTRY *theObjTab, int lenObjTab,
@@ -421,6 +484,7 @@ static void AcceptObjFromMsg (
   const DDD_HDR *localCplObjs, int nLocalCplObjs)
 {
   int i, j;
+  std::vector<OBJTAB_ENTRY*> newObjs;
 
   for(i=0, j=0; i<lenObjTab; i++)
   {
@@ -509,6 +573,7 @@ static void AcceptObjFromMsg (
       /* store old priority and set new one */
       OTE_PRIO(theObjects,ote) = newprio;
       ote->oldprio             = OBJ_PRIO(localCplObjs[j]);
+      ddd_ObjCplDirty(context, localCplObjs[j]);
 
       /* the next line is not useful. the current priority
          of the involved object will be changed to newprio-value
@@ -517,34 +582,18 @@ static void AcceptObjFromMsg (
     }
     else
     {
-      DDD_OBJ msgcopy, newcopy;
-      DDD_PRIO new_prio = OBJ_PRIO(ote->hdr);
-
 #                       if DebugUnpack<=1
       Dune::dvverb << "NewObject       " << OBJ_GID(ote->hdr)
-                   << ", prio=" << new_prio << "\n";
+                   << ", prio=" << OBJ_PRIO(ote->hdr) << "\n";
 #                       endif
 
-      /* new object, create local copy */
-      msgcopy = OTE_OBJ(context, theObjects,ote);
-      newcopy = DDD_ObjNew(ote->size,
-                           OBJ_TYPE(ote->hdr), new_prio, OBJ_ATTR(ote->hdr));
-
-      /* overwrite pointer to hdr inside message */
-      ote->hdr = OBJ2HDR(newcopy,desc);
-
-      /* copy GDATA */
-      ObjCopyGlobalData(desc, newcopy, msgcopy, ote->size);
+      /* new object, local copy is created below */
       ote->is_new = TOTALNEW;
-
-      /* construct HDR */
-      DDD_HdrConstructorCopy(context, ote->hdr, new_prio);
-
-      /* construct LDATA */
-      if (desc->handlerLDATACONSTRUCTOR)
-        desc->handlerLDATACONSTRUCTOR(context, newcopy);
+      newObjs.push_back(ote);
     }
   }
+
+  CreateNewObjects(context, newObjs, theObjects);
 }
 
 
@@ -596,6 +645,7 @@ static void AcceptReceivedObjects (DDD::DDDContext& context,
         OBJTAB_ENTRY *tmp;
 
         OBJ_PRIO(allRecObjs[i]->hdr) = newprio;
+        ddd_ObjCplDirty(context, allRecObjs[i]->hdr);
 
         /* switch first item i in second position i-1 */
         /* item on first position will be discarded */
@@ -607,6 +657,7 @@ static void AcceptReceivedObjects (DDD::DDDContext& context,
       {
         /* item i-1 is winner */
         OBJ_PRIO(allRecObjs[i-1]->hdr) = newprio;
+        ddd_ObjCplDirty(context, allRecObjs[i-1]->hdr);
       }
 
       /* mark item i invalid */
@@ -976,7 +1027,7 @@ static void PropagateIncomings (
       {
         if (newness==PARTNEW || newness==PRUNEDNEW)
         {
-          XIModCpl *xc = NewXIModCpl(context);
+          XIModCpl *xc = context.xferContext().listXIModCpl->newItem();
           if (xc==NULL)
             throw std::bad_alloc();
 
@@ -996,7 +1047,7 @@ static void PropagateIncomings (
                                         if (newness==PARTNEW || newness==PRUNEDNEW)
                                         {
          */
-        XIModCpl *xc = NewXIModCpl(context);
+        XIModCpl *xc = context.xferContext().listXIModCpl->newItem();
         if (xc==NULL)
           throw std::bad_alloc();
 
@@ -145,7 +145,7 @@ XICopyObj **CplClosureEstimate (DDD::DDDContext& context, const std::vector<XICo
       /* inform other owners of local copies (XINewCpl) */
       for(cpl=xicpl; cpl!=NULL; cpl=CPL_NEXT(cpl))
       {
-        XINewCpl *xc = NewXINewCpl(context);
+        XINewCpl *xc = context.xferContext().listXINewCpl->newItem();
         if (xc==NULL)
           throw std::bad_alloc();
 
@@ -162,7 +162,7 @@ XICopyObj **CplClosureEstimate (DDD::DDDContext& context, const std::vector<XICo
                with same gid (from different senders)  */
       for(cpl=xicpl; cpl!=NULL; cpl=CPL_NEXT(cpl))
       {
-        XIOldCpl *xc = NewXIOldCpl(context);
+        XIOldCpl *xc = context.xferContext().listXIOldCpl->newItem();
         if (xc==NULL)
           throw std::bad_alloc();
 
@@ -174,7 +174,7 @@ XICopyObj **CplClosureEstimate (DDD::DDDContext& context, const std::vector<XICo
 
       /* send one coupling (XIOldCpl) for local copy */
       {
-        XIOldCpl *xc = NewXIOldCpl(context);
+        XIOldCpl *xc = context.xferContext().listXIOldCpl->newItem();
         if (xc==NULL)
           throw std::bad_alloc();
 
@@ -239,7 +239,7 @@ XICopyObj **CplClosureEstimate (DDD::DDDContext& context, const std::vector<XICo
         /* inform other new-owners of same obj (also XINewCpl!)    */
         /* tell no1-dest that no2-dest gets a copy with no2->prio  */
         {
-          XINewCpl *xc = NewXINewCpl(context);
+          XINewCpl *xc = context.xferContext().listXINewCpl->newItem();
           if (xc==NULL)
             throw std::bad_alloc();
 
@@ -251,7 +251,7 @@ XICopyObj **CplClosureEstimate (DDD::DDDContext& context, const std::vector<XICo
         }
         /* tell no2->dest that no1-dest gets a copy with no1->prio */
         {
-          XINewCpl *xc = NewXINewCpl(context);
+          XINewCpl *xc = context.xferContext().listXINewCpl->newItem();
           if (xc==NULL)
             throw std::bad_alloc();
 
@@ -637,6 +637,7 @@ void ExecLocalXISetPrio (
 
       /* change actual priority to new value */
       OBJ_PRIO(hdr) = newprio;
+      ddd_ObjCplDirty(context, hdr);
 
 
       /* generate XIModCpl-items */
@@ -644,7 +645,7 @@ void ExecLocalXISetPrio (
       /* 1. for all existing couplings */
       for (COUPLING *cpl = ObjCplList(context, hdr); cpl != NULL; cpl = CPL_NEXT(cpl))
       {
-        XIModCpl *xc = NewXIModCpl(context);
+        XIModCpl *xc = context.xferContext().listXIModCpl->newItem();
         if (xc==NULL)
           throw std::bad_alloc();
 
@@ -656,7 +657,7 @@ void ExecLocalXISetPrio (
       /* 2. for all CopyObj-items with new-owner destinations */
       while (iNO<nNO && itemsNO[iNO]->gid==gid)
       {
-        XIModCpl *xc = NewXIModCpl(context);
+        XIModCpl *xc = context.xferContext().listXIModCpl->newItem();
         if (xc==NULL)
           throw std::bad_alloc();
 
@@ -701,7 +702,8 @@ void ExecLocalXIDelCmd (DDD::DDDContext& context, XIDelCmd  **itemsD, int nD)
 
   /* copy pointer array and resort it */
   memcpy(origD, itemsD, sizeof(XIDelCmd *) * nD);
-  OrigOrderXIDelCmd(context, origD, nD);
+  std::sort(origD, origD+nD,
+            [](const XIDelCmd *a, const XIDelCmd *b) { return a->n < b->n; });
 
 
   /* loop in original order (order of Del-cmd issuing) */
@@ -762,7 +764,7 @@ void ExecLocalXIDelObj (
     /* 2. for all CopyObj-items with new-owner destinations */
     while (iNO<nNO && itemsNO[iNO]->gid==gid)
     {
-      XIDelCpl *xc = NewXIDelCpl(context);
+      XIDelCpl *xc = context.xferContext().listXIDelCpl->newItem();
       if (xc==NULL)
         throw std::bad_alloc();
 
@@ -820,7 +822,7 @@ void PropagateCplInfos (
       /* generate additional XIModCpl-items for all valid NewCpl-items */
       while (iNC<nNC && NewCpl_GetGid(arrayNC[iNC])==gid)
       {
-        XIModCpl *xc = NewXIModCpl(context);
+        XIModCpl *xc = context.xferContext().listXIModCpl->newItem();
         if (xc==NULL)
           throw std::bad_alloc();
 
@@ -851,7 +853,7 @@ void PropagateCplInfos (
     /* generate additional XIDelCpl-items for all valid NewCpl-items */
     while (iNC<nNC && NewCpl_GetGid(arrayNC[iNC])==gid)
     {
-      XIDelCpl *xc = NewXIDelCpl(context);
+      XIDelCpl *xc = context.xferContext().listXIDelCpl->newItem();
       if (xc==NULL)
         throw std::bad_alloc();
 
@@ -883,7 +885,7 @@ void ddd_XferRegisterDelete (DDD::DDDContext& context, DDD_HDR hdr)
   XIDelObj *xi;
 
   /* create new XIDelObj */
-  xi      = NewXIDelObj(context);
+  xi      = context.xferContext().listXIDelObj->newItem();
   if (xi==NULL)
     throw std::bad_alloc();
 
@@ -900,7 +902,7 @@ void ddd_XferRegisterDelete (DDD::DDDContext& context, DDD_HDR hdr)
    */
   for(cpl=ObjCplList(context, hdr); cpl!=NULL; cpl=CPL_NEXT(cpl))
   {
-    XIDelCpl *xc = NewXIDelCpl(context);
+    XIDelCpl *xc = context.xferContext().listXIDelCpl->newItem();
     if (xc==NULL)
       throw std::bad_alloc();
 
@@ -1002,19 +1004,17 @@ void ddd_XferInit(DDD::DDDContext& context)
   auto& ctx = context.xferContext();
 
   /* init control structures for XferInfo-items in first (?) message */
-  ctx.setXICopyObj = reinterpret_cast<DDD::Xfer::XICopyObjSet*>(New_XICopyObjSet());
-  reinterpret_cast<XICopyObjSet*>(ctx.setXICopyObj)->tree->context = &context;
-  ctx.setXISetPrio = reinterpret_cast<DDD::Xfer::XISetPrioSet*>(New_XISetPrioSet());
-  reinterpret_cast<XISetPrioSet*>(ctx.setXISetPrio)->tree->context = &context;
-  InitXIDelCmd(context);
-  InitXIDelObj(context);
-  InitXINewCpl(context);
-  InitXIOldCpl(context);
+  ctx.setXICopyObj = new XICopyObjSet(XICopyObj_Compare, XICopyObj_Less, XICopyObj_Hash, &context);
+  ctx.setXISetPrio = new XISetPrioSet(XISetPrio_Compare, XISetPrio_Less, XISetPrio_Hash, &context);
+  ctx.listXIDelCmd = new XIDelCmdList;
+  ctx.listXIDelObj = new XIDelObjList;
+  ctx.listXINewCpl = new XINewCplList;
+  ctx.listXIOldCpl = new XIOldCplList;
 
   /* init control structures for XferInfo-items for second (?) message */
-  InitXIDelCpl(context);
-  InitXIModCpl(context);
-  InitXIAddCpl(context);
+  ctx.listXIDelCpl = new XIDelCplList;
+  ctx.listXIModCpl = new XIModCplList;
+  ctx.listXIAddCpl = new XIAddCplList;
 
 
   XferSetMode(context, DDD::Xfer::XferMode::XMODE_IDLE);
@@ -1050,8 +1050,15 @@ void ddd_XferExit(DDD::DDDContext& context)
   CmdMsgExit(context);
   CplMsgExit(context);
 
-  XICopyObjSet_Free(reinterpret_cast<XICopyObjSet*>(ctx.setXICopyObj));
-  XISetPrioSet_Free(reinterpret_cast<XISetPrioSet*>(ctx.setXISetPrio));
+  delete ctx.setXICopyObj;
+  delete ctx.setXISetPrio;
+  delete ctx.listXIDelCmd;
+  delete ctx.listXIDelObj;
+  delete ctx.listXINewCpl;
+  delete ctx.listXIOldCpl;
+  delete ctx.listXIDelCpl;
+  delete ctx.listXIModCpl;
+  delete ctx.listXIAddCpl;
 }
 
 
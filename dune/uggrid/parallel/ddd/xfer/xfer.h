@@ -48,7 +48,7 @@
 
 #include <dune/uggrid/parallel/ddd/basic/lowcomm.h>
 #include <dune/uggrid/parallel/ddd/basic/oopp.h>    /* for object-orientated style via preprocessor */
-#include "sll.h"           /* TODO: remove this in future versions */
+#include <dune/uggrid/parallel/ddd/basic/itemset.hh>
 
 START_UGDIM_NAMESPACE
 
@@ -186,16 +186,13 @@ using DDD::Xfer::XICopyObj;
 #define ClassName XICopyObj
 void Method(Print)   (DefThis _PRINTPARAMS);
 int  Method(Compare) (ClassPtr, ClassPtr, const DDD::DDDContext* context);
+bool Method(Less) (const Class *, const Class *);
+std::size_t Method(Hash) (const Class *);
 #undef ClassName
 
-
-/* define container class */
-#ifndef SetOf  /* necessary for inline documentation only */
-#define SetOf          XICopyObj
-#define Set_SegmSize   256
-#define Set_BTreeOrder 32
-#endif
-#include <dune/uggrid/parallel/ddd/basic/ooppcc.h>
+/* container class */
+using XICopyObjSet = DDD::Basic::ItemSet<XICopyObj>;
+typedef XICopyObj *XICopyObjPtr;
 
 
 /* usage of flags in XICopyObj */
@@ -218,26 +215,23 @@ int  Method(Compare) (ClassPtr, ClassPtr, const DDD::DDDContext* context);
 /* XIDelObj:                                                                */
 /****************************************************************************/
 
+END_UGDIM_NAMESPACE
+namespace DDD {
+namespace Xfer {
+
 /* XIDelCmd represents a XferDeleteObj-cmd by the application program */
 struct XIDelCmd
 {
-  SLL_INFO_WITH_COUNTER(XIDelCmd);
+  int n;                        /* unique index number, order of issuing        */
   DDD_HDR hdr;
 };
 
-/* include template */
-#define T XIDelCmd
-#define SLL_WithOrigOrder
-#include "sll.ht"
-#undef T
-
 
 struct XIDelCpl;
 
 /* XIDelObj represents an object-delete-action (cf. XferRegisterDelete()) */
 struct XIDelObj
 {
-  SLL_INFO(XIDelObj);
   DDD_GID gid;                  /* gid of local object                          */
 
   /* hdr is explicitly not stored here, because object may be deleted
@@ -247,39 +241,22 @@ struct XIDelObj
 
 };
 
-/* include template */
-#define T XIDelObj
-#include "sll.ht"
-#undef T
-
 
 
 /****************************************************************************/
 /* XISetPrio:                                                               */
 /****************************************************************************/
 
-#define ClassName XISetPrio
-Class_Data_Begin
-DDD_HDR hdr;                    /* local obj for which prio should be set       */
-DDD_GID gid;                    /* gid of local object                          */
-DDD_PRIO prio;                  /* new priority                                 */
-
-int is_valid;                   /* invalid iff there's a DelObj for same gid    */
-Class_Data_End
-void Method(Print)   (DefThis _PRINTPARAMS);
-int  Method(Compare) (ClassPtr, ClassPtr, const DDD::DDDContext*);
+struct XISetPrio
+{
+  DDD_HDR hdr;                    /* local obj for which prio should be set       */
+  DDD_GID gid;                    /* gid of local object                          */
+  DDD_PRIO prio;                  /* new priority                                 */
 
-#undef ClassName
+  int is_valid;                   /* invalid iff there's a DelObj for same gid    */
+};
 
 
-/* define container class */
-#ifndef SetOf  /* necessary for inline documentation only */
-#define SetOf          XISetPrio
-#define Set_SegmSize   256
-#define Set_BTreeOrder 32
-#endif
-#include <dune/uggrid/parallel/ddd/basic/ooppcc.h>
-
 
 /****************************************************************************/
 /* XINewCpl:                                                                */
@@ -314,16 +291,11 @@ struct TENewCpl
 
 struct XINewCpl
 {
-  SLL_INFO(XINewCpl);
   DDD_PROC to;                  /* receiver of this item                        */
   TENewCpl te;                  /* table entry (for message)                    */
 
 };
 
-/* include template */
-#define T XINewCpl
-#include "sll.ht"
-#undef T
 
 
 
@@ -341,15 +313,10 @@ struct TEOldCpl
 
 struct XIOldCpl
 {
-  SLL_INFO(XIOldCpl);
   DDD_PROC to;                  /* receiver of this item                        */
   TEOldCpl te;                  /* table entry (for message)                    */
 };
 
-/* include template */
-#define T XIOldCpl
-#include "sll.ht"
-#undef T
 
 
 /****************************************************************************/
@@ -366,16 +333,11 @@ struct TEAddCpl
 
 struct XIAddCpl
 {
-  SLL_INFO(XIAddCpl);
   DDD_PROC to;                  /* receiver of this item                        */
   TEAddCpl te;                  /* table entry (for message)                    */
 
 };
 
-/* include template */
-#define T XIAddCpl
-#include "sll.ht"
-#undef T
 
 
 
@@ -391,7 +353,6 @@ struct TEDelCpl
 
 struct XIDelCpl
 {
-  SLL_INFO(XIDelCpl);
   DDD_PROC to;                  /* receiver of this item                        */
   TEDelCpl te;                  /* table entry (for message)                    */
 
@@ -399,10 +360,6 @@ struct XIDelCpl
   XIDelCpl* next;               /* linked list of XIDelCpls                     */
 };
 
-/* include template */
-#define T XIDelCpl
-#include "sll.ht"
-#undef T
 
 
 
@@ -420,17 +377,51 @@ struct TEModCpl
 
 struct XIModCpl
 {
-  SLL_INFO(XIModCpl);
   DDD_PROC to;                  /* receiver of this item                        */
   TEModCpl te;                  /* table entry (for message)                    */
 
   DDD_TYPE typ;                 /* type of corresponding object                 */
 };
 
-/* include template */
-#define T XIModCpl
-#include "sll.ht"
-#undef T
+
+
+/****************************************************************************/
+
+} /* namespace Xfer */
+} /* namespace DDD */
+
+START_UGDIM_NAMESPACE
+
+using DDD::Xfer::XIDelCmd;
+using DDD::Xfer::XIDelObj;
+using DDD::Xfer::XISetPrio;
+using DDD::Xfer::TENewCpl;
+using DDD::Xfer::XINewCpl;
+using DDD::Xfer::TEOldCpl;
+using DDD::Xfer::XIOldCpl;
+using DDD::Xfer::TEAddCpl;
+using DDD::Xfer::XIAddCpl;
+using DDD::Xfer::TEDelCpl;
+using DDD::Xfer::XIDelCpl;
+using DDD::Xfer::TEModCpl;
+using DDD::Xfer::XIModCpl;
+
+#define ClassName XISetPrio
+void Method(Print)   (DefThis _PRINTPARAMS);
+int  Method(Compare) (ClassPtr, ClassPtr, const DDD::DDDContext*);
+bool Method(Less) (const Class *, const Class *);
+std::size_t Method(Hash) (const Class *);
+#undef ClassName
+
+/* container classes */
+using XISetPrioSet = DDD::Basic::ItemSet<XISetPrio>;
+using XIDelCmdList = DDD::Basic::ItemList<XIDelCmd>;
+using XIDelObjList = DDD::Basic::ItemList<XIDelObj>;
+using XINewCplList = DDD::Basic::ItemList<XINewCpl>;
+using XIOldCplList = DDD::Basic::ItemList<XIOldCpl>;
+using XIAddCplList = DDD::Basic::ItemList<XIAddCpl>;
+using XIDelCplList = DDD::Basic::ItemList<XIDelCpl>;
+using XIModCplList = DDD::Basic::ItemList<XIModCpl>;
 
 
 /****************************************************************************/
@@ -40,6 +40,8 @@
 #include <cstring>
 #include <cassert>
 
+#include <new>
+
 #include <dune/uggrid/ugdevices.h>
 #include <dune/uggrid/domain/domain.h>
 #include "parallel.h"
@@ -830,6 +832,38 @@ static void ElementDelete (DDD::DDDContext& context, DDD_OBJ obj)
 }
 
 
+/****************************************************************************/
+/*																			*/
+/* Function:  ElementXferAlloc												*/
+/*																			*/
+/* Purpose:   get memory for n received elements of equal type and size	*/
+/*			  in one slab of the multigrid heap. they are disposed one	*/
+/*			  by one by ElementDelete like locally created elements.		*/
+/*																			*/
+/* Input:	  DDD_TYPE	type:	DDD type of the elements					*/
+/*			  size_t	size:	size of one element							*/
+/*			  int		n:		number of elements							*/
+/*			  DDD_OBJ	*objs:	receives the memory of the elements		*/
+/*																			*/
+/* Output:	  void															*/
+/*																			*/
+/****************************************************************************/
+
+static void ElementXferAlloc (DDD::DDDContext& context, DDD_TYPE type,
+                              std::size_t size, int n, DDD_OBJ *objs)
+{
+  auto& dddctrl = ddd_ctrl(context);
+
+  if (GetObjectArray(MGHEAP(dddctrl.currMG), size, dddctrl.ugtypes[type],
+                     n, (void **) objs))
+    throw std::bad_alloc();
+
+  /* like memmgr_AllocOMEM */
+  for (int i=0; i<n; i++)
+    memset(objs[i], 0, size);
+}
+
+
 /****************************************************************************/
 /*																			*/
 /* Function:  ElementXferCopy	                                                                                        */
@@ -1607,6 +1641,8 @@ static void EdgeUpdate (DDD::DDDContext& context, DDD_OBJ obj)
 
   /* increment counter */
   NE(theGrid)++;
+
+  EdgeIndexInsert(theGrid,pe);
 }
 
 static void EdgePriorityUpdate (DDD::DDDContext& context, DDD_OBJ obj, DDD_PRIO new_)
@@ -1688,6 +1724,7 @@ static void ElemHandlerInit (DDD::DDDContext& context, DDD_TYPE etype, INT handl
 {
   DDD_SetHandlerLDATACONSTRUCTOR(context, etype, ElementLDataConstructor);
   DDD_SetHandlerDELETE          (context, etype, ElementDelete);
+  DDD_SetHandlerXFERALLOC       (context, etype, ElementXferAlloc);
   DDD_SetHandlerXFERCOPY        (context, etype, ElementXferCopy);
   DDD_SetHandlerSETPRIORITY     (context, etype, ElementPriorityUpdate);
 
@@ -202,7 +202,7 @@ static int CollectElementsNearSegment(MULTIGRID *theMG,
         for (side=0; side<SIDES_OF_ELEM(theElement); side++) {
           if (INNER_SIDE(theElement,side))
             continue;
-          BNDS_BndSDesc(ELEM_BNDS(theElement,side),
+          BNDS_BndSDesc(MG_BVP(theMG),ELEM_BNDS(theElement,side),
                         &sid,&nbsid);
           PARTITION(theElement) = dest;
         }
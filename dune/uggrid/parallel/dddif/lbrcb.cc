@@ -157,17 +157,12 @@ static void RecursiveCoordinateBisection (const PPIF::PPIFContext& ppifContext,
 }
 
 /**
- * Compute an element's center of mass
+ * Compute an element's center of mass, or take it from the geometry cache
  */
-static Dune::FieldVector<DOUBLE, DIM> CenterOfMass (ELEMENT *e)
+static Dune::FieldVector<DOUBLE, DIM> CenterOfMass (const GRID *theGrid, ELEMENT *e)
 {
-  Dune::FieldVector<DOUBLE, DIM> center(0.0);
-
-  const auto corners = CORNERS_OF_ELEM(e);
-  for(int i=0; i<corners; i++)
-    center +=  CVECT(MYVERTEX(CORNER(e,i)));
-
-  center /= corners;
+  Dune::FieldVector<DOUBLE, DIM> center;
+  CalculateCenterOfMass(theGrid, e, center);
   return center;
 }
 
@@ -243,7 +238,7 @@ void BalanceGridRCB (MULTIGRID *theMG, int level)
     for (auto e=FIRSTELEMENT(theGrid); e!=NULL; e=SUCCE(e))
     {
       lbinfo[i].elem = e;
-      lbinfo[i].center = CenterOfMass(e);
+      lbinfo[i].center = CenterOfMass(theGrid, e);
       ++i;
     }
 
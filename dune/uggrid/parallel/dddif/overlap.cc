@@ -355,7 +355,7 @@ INT ConnectGridOverlap (GRID *theGrid)
     {
       if (OBJT(theElement)==BEOBJ
           && SIDE_ON_BND(theElement,i)
-          && !INNER_BOUNDARY(theElement,i)) continue;
+          && !INNER_BOUNDARY(MYMG(theGrid),theElement,i)) continue;
 
       theNeighbor = NBELEM(theElement,i);
       if (theNeighbor == NULL) continue;
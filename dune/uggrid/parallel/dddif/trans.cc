@@ -717,6 +717,9 @@ int NS_DIM_PREFIX TransferGridFromLevel (MULTIGRID *theMG, INT level)
   /* the grid has changed at least on one processor, thus reset MGSTATUS on all processors */
   RESETMGSTATUS(theMG);
 
+  /* the new edges have no closure patterns yet, see AdaptMultiGrid */
+  theMG->closurePatternsReset = false;
+
         #ifdef STAT_OUT
   cons_end = CURRENT_TIME;
 
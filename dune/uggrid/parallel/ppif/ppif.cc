@@ -98,6 +98,9 @@ struct VChannel
 struct Msg
 {
   MPI_Request req;
+
+  /* persistent requests survive their completion, see StartPersistent */
+  bool persistent = false;
 };
 
 } /* namespace PPIF */
@@ -463,7 +466,7 @@ int PPIF::InfoASend(const PPIFContext&, VChannelPtr v, msgid m)
   {
     if (MPI_SUCCESS == MPI_Test (&m->req, &complete, MPI_STATUS_IGNORE) )
     {
-      if (complete)
+      if (complete && !m->persistent)
         delete m;
 
       return (complete);        /* complete is true for completed send, false otherwise */
@@ -481,7 +484,7 @@ int PPIF::InfoARecv(const PPIFContext&, VChannelPtr v, msgid m)
   {
     if (MPI_SUCCESS == MPI_Test (&m->req, &complete, MPI_STATUS_IGNORE) )
     {
-      if (complete)
+      if (complete && !m->persistent)
         delete m;
 
       return (complete);        /* complete is true for completed receive, false otherwise */
@@ -490,3 +493,120 @@ int PPIF::InfoARecv(const PPIFContext&, VChannelPtr v, msgid m)
 
   return (-1);          /* return -1 for FAILURE */
 }
+
+/*
+   check whether a message has arrived on channel v without receiving it.
+   returns 1 and the size of the message, 0 if there is none yet and -1
+   on failure. this allows receiving messages of unknown size.
+ */
+int PPIF::ProbeASync(const PPIFContext& context, VChannelPtr v, int *size)
+{
+  int arrived;
+  MPI_Status status;
+
+  if (MPI_SUCCESS != MPI_Iprobe (v->p, v->chanid, context.comm(), &arrived, &status) )
+    return (-1);
+
+  if (arrived)
+    MPI_Get_count (&status, MPI_BYTE, size);
+
+  return (arrived);
+}
+
+/*
+   store the requests of the n messages m in req, entries which are
+   NO_MSGID get MPI_REQUEST_NULL. the array is passed to WaitSome, which
+   keeps it up to date, so that it has to be set up only once.
+ */
+void PPIF::GetRequests(int n, const msgid m[], MPI_Request req[])
+{
+  for (int i=0; i<n; i++)
+    req[i] = (m[i]!=NO_MSGID) ? m[i]->req : MPI_REQUEST_NULL;
+}
+
+/*
+   wait until at least one of the n messages m has completed. req holds
+   the requests of m as set up by GetRequests. the indices of all
+   completed messages are stored in completed, their entries in m are set
+   to NO_MSGID and their entries in req are set to MPI_REQUEST_NULL (or
+   inactive for persistent messages) by MPI. entries which are NO_MSGID
+   already are ignored. returns the number of completed messages, 0 if
+   there is no message to wait for, and -1 on failure.
+ */
+int PPIF::WaitSome(const PPIFContext&, int n, msgid m[], MPI_Request req[], int completed[])
+{
+  int count;
+
+  if (MPI_SUCCESS != MPI_Waitsome (n, req, &count, completed, MPI_STATUSES_IGNORE) )
+    return (-1);
+
+  if (count==MPI_UNDEFINED)
+    return (0);
+
+  for (int k=0; k<count; k++)
+  {
+    msgid& mk = m[completed[k]];
+    if (mk->persistent)
+      mk->req = req[completed[k]];
+    else
+      delete mk;
+    mk = NO_MSGID;
+  }
+
+  return (count);
+}
+
+/*
+   persistent communication: the message is set up once and started
+   by StartPersistent as often as needed. InfoASend and InfoARecv
+   report completion of each start, but keep the message, until it is
+   released by FreePersistent.
+ */
+
+msgid PPIF::SendPersistent(const PPIFContext& context, VChannelPtr v, void *data, int size, int *error)
+{
+  msgid m = new PPIF::Msg;
+
+  if (MPI_SUCCESS == MPI_Send_init (data, size, MPI_BYTE,
+                                    v->p, v->chanid, context.comm(), &m->req) )
+  {
+    m->persistent = true;
+    *error = false;
+    return m;
+  }
+
+  delete m;
+  *error = true;
+  return NULL;
+}
+
+msgid PPIF::RecvPersistent(const PPIFContext& context, VChannelPtr v, void *data, int size, int *error)
+{
+  msgid m = new PPIF::Msg;
+
+  if (MPI_SUCCESS == MPI_Recv_init (data, size, MPI_BYTE,
+                                    v->p, v->chanid, context.comm(), &m->req) )
+  {
+    m->persistent = true;
+    *error = false;
+    return m;
+  }
+
+  delete m;
+  *error = true;
+  return NULL;
+}
+
+int PPIF::StartPersistent(const PPIFContext&, msgid m)
+{
+  if (MPI_SUCCESS != MPI_Start (&m->req) )
+    return (PPIF_FAILURE);
+
+  return (PPIF_SUCCESS);
+}
+
+void PPIF::FreePersistent(const PPIFContext&, msgid m)
+{
+  MPI_Request_free (&m->req);
+  delete m;
+}
@@ -32,6 +32,10 @@
 
 #include <memory>
 
+#if ModelP
+#  include <mpi.h>
+#endif
+
 #include <dune/uggrid/parallel/ppif/ppiftypes.hh>
 
 /****************************************************************************/
@@ -117,6 +121,17 @@ int         InfoAConn        (const PPIFContext& context, VChannelPtr vc);
 int         InfoADisc        (const PPIFContext& context, VChannelPtr vc);
 int         InfoASend        (const PPIFContext& context, VChannelPtr vc, msgid m);
 int         InfoARecv        (const PPIFContext& context, VChannelPtr vc, msgid m);
+int         ProbeASync       (const PPIFContext& context, VChannelPtr vc, int *size);
+#if ModelP
+void        GetRequests      (int n, const msgid m[], MPI_Request req[]);
+int         WaitSome         (const PPIFContext& context, int n, msgid m[], MPI_Request req[], int completed[]);
+#endif
+
+/* persistent communication */
+msgid       SendPersistent   (const PPIFContext& context, VChannelPtr vc, void *data, int size, int *error);
+msgid       RecvPersistent   (const PPIFContext& context, VChannelPtr vc, void *data, int size, int *error);
+int         StartPersistent  (const PPIFContext& context, msgid m);
+void        FreePersistent   (const PPIFContext& context, msgid m);
 
 }  // end namespace PPIF
 